@@ -73,6 +73,11 @@ REPOSITORY_LOCATIONS = dict(
         strip_prefix = "xxHash-0.7.3",
         urls = ["https://github.com/Cyan4973/xxHash/archive/v0.7.3.tar.gz"],
     ),
+    com_github_facebook_zstd = dict(
+        sha256 = "98e91c7c6bf162bf90e4e70fdbc41a8188b9fa8de5ad840c401198014406ce9e",
+        strip_prefix = "zstd-1.4.5",
+        urls = ["https://github.com/facebook/zstd/releases/download/v1.4.5/zstd-1.4.5.tar.gz"],
+    ),
     com_github_envoyproxy_sqlparser = dict(
         sha256 = "b2d3882698cf85b64c87121e208ce0b24d5fe2a00a5d058cf4571f1b25b45403",
         strip_prefix = "sql-parser-b14d010afd4313f2372a1cc96aa2327e674cc798",
@@ -172,6 +177,11 @@ REPOSITORY_LOCATIONS = dict(
         # 2019-04-14 development branch
         urls = ["https://github.com/madler/zlib/archive/79baebe50e4d6b73ae1f8b603f0ef41300110aa3.tar.gz"],
     ),
+    org_brotli = dict(
+        sha256 = "6e69be238ff61cef589a3fa88da11b649c7ff7a5932cb12d1e6251c8c2e17a2f",
+        strip_prefix = "brotli-1.0.7",
+        urls = ["https://github.com/google/brotli/archive/v1.0.7.tar.gz"],
+    ),
     com_github_jbeder_yaml_cpp = dict(
         sha256 = "77ea1b90b3718aa0c324207cb29418f5bced2354c2e483a9523d98c3460af1ed",
         strip_prefix = "yaml-cpp-yaml-cpp-0.6.3",
@@ -30,8 +30,12 @@ namespace Event {
  * All dispatcher stats. @see stats_macros.h
  */
 #define ALL_DISPATCHER_STATS(HISTOGRAM)                                                            \
+  HISTOGRAM(file_event_duration_us, Microseconds)                                                  \
   HISTOGRAM(loop_duration_us, Microseconds)                                                        \
-  HISTOGRAM(poll_delay_us, Microseconds)
+  HISTOGRAM(poll_delay_us, Microseconds)                                                           \
+  HISTOGRAM(post_duration_us, Microseconds)                                                        \
+  HISTOGRAM(post_queue_depth, Unspecified)                                                         \
+  HISTOGRAM(timer_duration_us, Microseconds)
 
 /**
  * Struct definition for all dispatcher stats. @see stats_macros.h
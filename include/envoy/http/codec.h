@@ -347,6 +347,11 @@ struct Http1Settings {
 
   // How header keys should be formatted when serializing HTTP/1.1 headers.
   HeaderKeyFormat header_key_format_{HeaderKeyFormat::Default};
+
+  // The maximum number of pipelined downstream requests that are dispatched concurrently.
+  // Responses are always written in request order. The default of 1 processes pipelined requests
+  // one at a time.
+  uint32_t max_pipelined_requests_{1};
 };
 
 /**
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
+#include <list>
 #include <memory>
 
 #include "envoy/network/connection.h"
@@ -43,6 +45,25 @@ public:
    */
   virtual void addListener(ListenerConfig& config) PURE;
 
+  /**
+   * Replace the config of an existing TCP listener without closing its listen socket or any of its
+   * connections. New connections are matched against the filter chains of the new config.
+   * @param config supplies the new listener configuration. Its tag is the tag of the listener it
+   *        replaces.
+   */
+  virtual void updateListener(ListenerConfig& config) PURE;
+
+  /**
+   * Close all the connections of the given filter chains of a listener. The completion is called
+   * once the connections have been destroyed.
+   * @param listener_tag supplies the tag passed to addListener().
+   * @param filter_chains supplies the filter chains whose connections are closed.
+   * @param completion supplies the completion to call once the connections are destroyed.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::list<const FilterChain*>& filter_chains,
+                                  std::function<void()> completion) PURE;
+
   /**
    * Remove listeners using the listener tag as a key. All connections owned by the removed
    * listeners will be closed.
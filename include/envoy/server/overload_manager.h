@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 
@@ -12,19 +13,36 @@
 namespace Envoy {
 namespace Server {
 
-enum class OverloadActionState {
-  /**
-   * Indicates that an overload action is active because at least one of its triggers has fired.
-   */
-  Active,
-  /**
-   * Indicates that an overload action is inactive because none of its triggers have fired.
-   */
-  Inactive
+/**
+ * The state of an overload action, as a value in [0, 1]. An action is inactive at 0, when none of
+ * its triggers fired, and saturated at 1, when at least one of its triggers fired entirely. Scaled
+ * triggers take actions through the values in between as the pressure on their resource rises, so
+ * that the action can be taken gradually, e.g. for a growing fraction of requests.
+ */
+class OverloadActionState {
+public:
+  explicit constexpr OverloadActionState(double value)
+      : action_value_(std::min(1.0, std::max(0.0, value))) {}
+
+  static constexpr OverloadActionState inactive() { return OverloadActionState(0); }
+  static constexpr OverloadActionState saturated() { return OverloadActionState(1); }
+
+  double value() const { return action_value_; }
+  bool isInactive() const { return action_value_ == 0; }
+  bool isSaturated() const { return action_value_ == 1; }
+
+  bool operator==(const OverloadActionState& other) const {
+    return action_value_ == other.action_value_;
+  }
+  bool operator!=(const OverloadActionState& other) const { return !(*this == other); }
+
+private:
+  double action_value_;
 };
 
 /**
- * Callback invoked when an overload action changes state.
+ * Callback invoked when an overload action changes state, including when a scaled action changes
+ * value.
  */
 using OverloadActionCb = std::function<void(OverloadActionState)>;
 
@@ -36,7 +54,7 @@ public:
   const OverloadActionState& getState(const std::string& action) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      it = actions_.insert(std::make_pair(action, OverloadActionState::Inactive)).first;
+      it = actions_.insert(std::make_pair(action, OverloadActionState::inactive())).first;
     }
     return it->second;
   }
@@ -44,7 +62,7 @@ public:
   void setState(const std::string& action, OverloadActionState state) {
     auto it = actions_.find(action);
     if (it == actions_.end()) {
-      actions_[action] = state;
+      actions_.insert(std::make_pair(action, state));
     } else {
       it->second = state;
     }
@@ -115,7 +133,7 @@ public:
    * is disabled).
    */
   static const OverloadActionState& getInactiveState() {
-    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::Inactive);
+    CONSTRUCT_ON_FIRST_USE(OverloadActionState, OverloadActionState::inactive());
   }
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <list>
 
 #include "envoy/server/guarddog.h"
 #include "envoy/server/overload_manager.h"
@@ -32,6 +33,17 @@ public:
   virtual void addListener(Network::ListenerConfig& listener,
                            AddListenerCompletion completion) PURE;
 
+  /**
+   * Replace the config of a listener that the worker already runs, keeping its listen socket and
+   * its connections. This is used for listener updates which only change filter chains.
+   * @param listener supplies the new listener config. Its tag is the tag of the listener it
+   *                 replaces.
+   * @param completion supplies the completion to be called when the listener has been updated.
+   *        This completion is called on the worker thread. No locking is performed by the worker.
+   */
+  virtual void updateListener(Network::ListenerConfig& listener,
+                              std::function<void()> completion) PURE;
+
   /**
    * @return uint64_t the number of connections across all listeners that the worker owns.
    */
@@ -65,6 +77,18 @@ public:
   virtual void removeListener(Network::ListenerConfig& listener,
                               std::function<void()> completion) PURE;
 
+  /**
+   * Close the connections of filter chains that were removed from a listener by an update.
+   * @param listener_tag supplies the tag of the listener.
+   * @param filter_chains supplies the removed filter chains.
+   * @param completion supplies the completion to be called when the connections of the filter
+   *        chains have been destroyed. This completion is called on the worker thread. No locking
+   *        is performed by the worker.
+   */
+  virtual void removeFilterChains(uint64_t listener_tag,
+                                  const std::list<const Network::FilterChain*>& filter_chains,
+                                  std::function<void()> completion) PURE;
+
   /**
    * Stop a listener from accepting new connections. This is used for server draining.
    * @param listener supplies the listener to stop.
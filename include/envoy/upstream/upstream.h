@@ -557,6 +557,9 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_prefetch)                                                                    \
+  COUNTER(upstream_cx_prefetch_hit)                                                                \
+  COUNTER(upstream_cx_prefetch_miss)                                                               \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -796,6 +799,19 @@ public:
    */
   virtual uint64_t maxRequestsPerConnection() const PURE;
 
+  /**
+   * @return float the number of requests that the connection pools of the cluster should be able
+   *         to serve without opening new connections, relative to the number of requests which are
+   *         active or pending. 1 indicates that connections are only opened on demand.
+   */
+  virtual float perUpstreamPrefetchRatio() const PURE;
+
+  /**
+   * @return uint32_t the number of connections without any requests on them that each connection
+   *         pool of the cluster keeps open or connecting. 0 indicates no prefetching.
+   */
+  virtual uint32_t prefetchMinIdleConnections() const PURE;
+
   /**
    * @return uint32_t the maximum number of response headers. The default value is 100. Results in a
    * reset if the number of headers exceeds this value.
@@ -1,7 +1,10 @@
 #include "common/access_log/access_log_formatter.h"
 
+#include <algorithm>
 #include <climits>
+#include <cmath>
 #include <cstdint>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <vector>
@@ -47,6 +50,90 @@ const std::regex& getStartTimeNewlinePattern() {
 }
 const std::regex& getNewlinePattern() { CONSTRUCT_ON_FIRST_USE(std::regex, "\n"); }
 
+// Number of bytes needed to represent c inside a JSON string, or 0 if c is copied as is.
+size_t jsonEscapedLength(char c) {
+  switch (c) {
+  case '"':
+  case '\\':
+  case '\b':
+  case '\f':
+  case '\n':
+  case '\r':
+  case '\t':
+    return 2;
+  default:
+    // Remaining control characters are written as \u00XX.
+    return static_cast<unsigned char>(c) < 0x20 ? 6 : 0;
+  }
+}
+
+// The character following the backslash in the two byte escape of c.
+char jsonEscapeLetter(char c) {
+  switch (c) {
+  case '\b':
+    return 'b';
+  case '\f':
+    return 'f';
+  case '\n':
+    return 'n';
+  case '\r':
+    return 'r';
+  case '\t':
+    return 't';
+  default:
+    return c;
+  }
+}
+
+// JSON escapes output[start, output.size()) in place. Values rarely need escaping, so the common
+// case is a single scan; otherwise the string grows once and is rewritten back to front.
+void escapeJsonTail(std::string& output, size_t start) {
+  size_t extra = 0;
+  for (size_t i = start; i < output.size(); ++i) {
+    const size_t escaped_length = jsonEscapedLength(output[i]);
+    if (escaped_length != 0) {
+      extra += escaped_length - 1;
+    }
+  }
+  if (extra == 0) {
+    return;
+  }
+
+  static const char* HexDigits = "0123456789abcdef";
+  size_t src = output.size();
+  output.resize(output.size() + extra);
+  size_t dst = output.size();
+  while (src > start) {
+    const char c = output[--src];
+    switch (jsonEscapedLength(c)) {
+    case 0:
+      output[--dst] = c;
+      break;
+    case 2:
+      output[--dst] = jsonEscapeLetter(c);
+      output[--dst] = '\\';
+      break;
+    default:
+      output[--dst] = HexDigits[c & 0xf];
+      output[--dst] = HexDigits[(c >> 4) & 0xf];
+      output[--dst] = '0';
+      output[--dst] = '0';
+      output[--dst] = 'u';
+      output[--dst] = '\\';
+      break;
+    }
+  }
+  ASSERT(dst == src);
+}
+
+void appendJsonString(absl::string_view value, std::string& output) {
+  output.push_back('"');
+  const size_t start = output.size();
+  output.append(value.data(), value.size());
+  escapeJsonTail(output, start);
+  output.push_back('"');
+}
+
 } // namespace
 
 const std::string AccessLogFormatUtils::DEFAULT_FORMAT =
@@ -97,19 +184,38 @@ std::string FormatterImpl::format(const Http::RequestHeaderMap& request_headers,
                                   const StreamInfo::StreamInfo& stream_info) const {
   std::string log_line;
   log_line.reserve(256);
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  return log_line;
+}
 
+void FormatterImpl::formatTo(const Http::RequestHeaderMap& request_headers,
+                             const Http::ResponseHeaderMap& response_headers,
+                             const Http::ResponseTrailerMap& response_trailers,
+                             const StreamInfo::StreamInfo& stream_info, std::string& output) const {
   for (const FormatterProviderPtr& provider : providers_) {
-    log_line += provider->format(request_headers, response_headers, response_trailers, stream_info);
+    provider->formatTo(request_headers, response_headers, response_trailers, stream_info, output);
   }
-
-  return log_line;
 }
 
 JsonFormatterImpl::JsonFormatterImpl(std::unordered_map<std::string, std::string>& format_mapping,
                                      bool preserve_types)
     : preserve_types_(preserve_types) {
+  // Emit keys in sorted order so that the output is stable across runs.
+  std::vector<std::string> keys;
+  keys.reserve(format_mapping.size());
   for (const auto& pair : format_mapping) {
-    json_output_format_.emplace(pair.first, AccessLogFormatParser::parse(pair.second));
+    keys.push_back(pair.first);
+  }
+  std::sort(keys.begin(), keys.end());
+
+  json_output_format_.reserve(keys.size());
+  for (const std::string& key : keys) {
+    JsonField field;
+    field.prefix_ = json_output_format_.empty() ? "{" : ",";
+    appendJsonString(key, field.prefix_);
+    field.prefix_.push_back(':');
+    field.providers_ = AccessLogFormatParser::parse(format_mapping.at(key));
+    json_output_format_.push_back(std::move(field));
   }
 }
 
@@ -117,42 +223,77 @@ std::string JsonFormatterImpl::format(const Http::RequestHeaderMap& request_head
                                       const Http::ResponseHeaderMap& response_headers,
                                       const Http::ResponseTrailerMap& response_trailers,
                                       const StreamInfo::StreamInfo& stream_info) const {
-  const auto output_struct =
-      toStruct(request_headers, response_headers, response_trailers, stream_info);
-
-  const std::string log_line = MessageUtil::getJsonStringFromMessage(output_struct, false, true);
-  return absl::StrCat(log_line, "\n");
-}
-
-ProtobufWkt::Struct JsonFormatterImpl::toStruct(const Http::RequestHeaderMap& request_headers,
-                                                const Http::ResponseHeaderMap& response_headers,
-                                                const Http::ResponseTrailerMap& response_trailers,
-                                                const StreamInfo::StreamInfo& stream_info) const {
-  ProtobufWkt::Struct output;
-  auto* fields = output.mutable_fields();
-  for (const auto& pair : json_output_format_) {
-    const auto& providers = pair.second;
-    ASSERT(!providers.empty());
-
-    if (providers.size() == 1) {
-      const auto& provider = providers.front();
-      const auto val =
-          preserve_types_ ? provider->formatValue(request_headers, response_headers,
-                                                  response_trailers, stream_info)
-                          : ValueUtil::stringValue(provider->format(
-                                request_headers, response_headers, response_trailers, stream_info));
-
-      (*fields)[pair.first] = val;
-    } else {
-      // Multiple providers forces string output.
-      std::string str;
-      for (const auto& provider : providers) {
-        str += provider->format(request_headers, response_headers, response_trailers, stream_info);
-      }
-      (*fields)[pair.first] = ValueUtil::stringValue(str);
+  std::string log_line;
+  log_line.reserve(256);
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  return log_line;
+}
+
+void JsonFormatterImpl::formatTo(const Http::RequestHeaderMap& request_headers,
+                                 const Http::ResponseHeaderMap& response_headers,
+                                 const Http::ResponseTrailerMap& response_trailers,
+                                 const StreamInfo::StreamInfo& stream_info,
+                                 std::string& output) const {
+  if (json_output_format_.empty()) {
+    output.append("{}\n");
+    return;
+  }
+
+  for (const JsonField& field : json_output_format_) {
+    ASSERT(!field.providers_.empty());
+    output.append(field.prefix_);
+
+    if (preserve_types_ && field.providers_.size() == 1) {
+      appendTypedValue(field.providers_.front()->formatValue(request_headers, response_headers,
+                                                             response_trailers, stream_info),
+                       output);
+      continue;
+    }
+
+    // Untyped output and multiple providers both produce a string: let the providers append
+    // straight into the output and escape what they wrote afterwards.
+    output.push_back('"');
+    const size_t start = output.size();
+    for (const FormatterProviderPtr& provider : field.providers_) {
+      provider->formatTo(request_headers, response_headers, response_trailers, stream_info, output);
+    }
+    escapeJsonTail(output, start);
+    output.push_back('"');
+  }
+  output.append("}\n");
+}
+
+void JsonFormatterImpl::appendTypedValue(const ProtobufWkt::Value& value,
+                                         std::string& output) const {
+  switch (value.kind_case()) {
+  case ProtobufWkt::Value::kNullValue:
+    output.append("null");
+    return;
+  case ProtobufWkt::Value::kBoolValue:
+    output.append(value.bool_value() ? "true" : "false");
+    return;
+  case ProtobufWkt::Value::kStringValue:
+    appendJsonString(value.string_value(), output);
+    return;
+  case ProtobufWkt::Value::kNumberValue: {
+    const double number = value.number_value();
+    // Integral values (durations, byte counts, response codes) are by far the most common and
+    // must not be printed with an exponent or fraction.
+    if (std::abs(number) < 9007199254740992.0 && number == std::trunc(number)) {
+      output.append(fmt::format_int(static_cast<int64_t>(number)).c_str());
+      return;
+    }
+    if (std::isfinite(number)) {
+      fmt::format_to(std::back_inserter(output), "{}", number);
+      return;
     }
+    break;
   }
-  return output;
+  default:
+    break;
+  }
+  // Structs, lists and non-finite numbers are rare enough to go through the protobuf serializer.
+  output.append(MessageUtil::getJsonStringFromMessage(value, false, true));
 }
 
 void AccessLogFormatParser::parseCommandHeader(const std::string& token, const size_t start,
@@ -766,6 +907,12 @@ std::string PlainStringFormatter::format(const Http::RequestHeaderMap&,
   return str_.string_value();
 }
 
+void PlainStringFormatter::formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                                    const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                                    std::string& output) const {
+  output.append(str_.string_value());
+}
+
 ProtobufWkt::Value PlainStringFormatter::formatValue(const Http::RequestHeaderMap&,
                                                      const Http::ResponseHeaderMap&,
                                                      const Http::ResponseTrailerMap&,
@@ -799,6 +946,20 @@ std::string HeaderFormatter::format(const Http::HeaderMap& headers) const {
   return val;
 }
 
+void HeaderFormatter::formatTo(const Http::HeaderMap& headers, std::string& output) const {
+  const Http::HeaderEntry* header = findHeader(headers);
+  if (!header) {
+    output.append(UnspecifiedValueString);
+    return;
+  }
+
+  absl::string_view val = header->value().getStringView();
+  if (max_length_) {
+    val = val.substr(0, max_length_.value());
+  }
+  output.append(val.data(), val.size());
+}
+
 ProtobufWkt::Value HeaderFormatter::formatValue(const Http::HeaderMap& headers) const {
   const Http::HeaderEntry* header = findHeader(headers);
   if (!header) {
@@ -822,6 +983,13 @@ std::string ResponseHeaderFormatter::format(const Http::RequestHeaderMap&,
   return HeaderFormatter::format(response_headers);
 }
 
+void ResponseHeaderFormatter::formatTo(const Http::RequestHeaderMap&,
+                                       const Http::ResponseHeaderMap& response_headers,
+                                       const Http::ResponseTrailerMap&,
+                                       const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(response_headers, output);
+}
+
 ProtobufWkt::Value ResponseHeaderFormatter::formatValue(
     const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
     const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&) const {
@@ -840,6 +1008,13 @@ std::string RequestHeaderFormatter::format(const Http::RequestHeaderMap& request
   return HeaderFormatter::format(request_headers);
 }
 
+void RequestHeaderFormatter::formatTo(const Http::RequestHeaderMap& request_headers,
+                                      const Http::ResponseHeaderMap&,
+                                      const Http::ResponseTrailerMap&,
+                                      const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(request_headers, output);
+}
+
 ProtobufWkt::Value
 RequestHeaderFormatter::formatValue(const Http::RequestHeaderMap& request_headers,
                                     const Http::ResponseHeaderMap&, const Http::ResponseTrailerMap&,
@@ -859,6 +1034,13 @@ std::string ResponseTrailerFormatter::format(const Http::RequestHeaderMap&,
   return HeaderFormatter::format(response_trailers);
 }
 
+void ResponseTrailerFormatter::formatTo(const Http::RequestHeaderMap&,
+                                        const Http::ResponseHeaderMap&,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo&, std::string& output) const {
+  HeaderFormatter::formatTo(response_trailers, output);
+}
+
 ProtobufWkt::Value
 ResponseTrailerFormatter::formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                       const Http::ResponseTrailerMap& response_trailers,
@@ -89,35 +89,51 @@ class FormatterImpl : public Formatter {
 public:
   FormatterImpl(const std::string& format);
 
-  // Formatter::format
+  // Formatter
   std::string format(const Http::RequestHeaderMap& request_headers,
                      const Http::ResponseHeaderMap& response_headers,
                      const Http::ResponseTrailerMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
   std::vector<FormatterProviderPtr> providers_;
 };
 
+/**
+ * JSON formatter implementation. The layout of the output object is compiled at construction:
+ * each field's key is escaped and quoted once, and values are escaped directly into the output
+ * string rather than being collected into a ProtobufWkt::Struct and serialized per log line.
+ */
 class JsonFormatterImpl : public Formatter {
 public:
   JsonFormatterImpl(std::unordered_map<std::string, std::string>& format_mapping,
                     bool preserve_types);
 
-  // Formatter::format
+  // Formatter
   std::string format(const Http::RequestHeaderMap& request_headers,
                      const Http::ResponseHeaderMap& response_headers,
                      const Http::ResponseTrailerMap& response_trailers,
                      const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
 
 private:
-  const bool preserve_types_;
-  std::map<const std::string, const std::vector<FormatterProviderPtr>> json_output_format_;
+  struct JsonField {
+    // Separator and quoted key preceding the value, e.g. ',"key":'.
+    std::string prefix_;
+    std::vector<FormatterProviderPtr> providers_;
+  };
+
+  void appendTypedValue(const ProtobufWkt::Value& value, std::string& output) const;
 
-  ProtobufWkt::Struct toStruct(const Http::RequestHeaderMap& request_headers,
-                               const Http::ResponseHeaderMap& response_headers,
-                               const Http::ResponseTrailerMap& response_trailers,
-                               const StreamInfo::StreamInfo& stream_info) const;
+  const bool preserve_types_;
+  std::vector<JsonField> json_output_format_;
 };
 
 /**
@@ -131,6 +147,9 @@ public:
   // FormatterProvider
   std::string format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -149,6 +168,7 @@ public:
 
 protected:
   std::string format(const Http::HeaderMap& headers) const;
+  void formatTo(const Http::HeaderMap& headers, std::string& output) const;
   ProtobufWkt::Value formatValue(const Http::HeaderMap& headers) const;
 
 private:
@@ -170,6 +190,9 @@ public:
   // FormatterProvider
   std::string format(const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap&,
                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::RequestHeaderMap& request_headers, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -186,6 +209,9 @@ public:
   // FormatterProvider
   std::string format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
                      const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap&, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&,
                                  const StreamInfo::StreamInfo&) const override;
@@ -203,6 +229,9 @@ public:
   std::string format(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                      const Http::ResponseTrailerMap& response_trailers,
                      const StreamInfo::StreamInfo&) const override;
+  void formatTo(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
+                const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo&,
+                std::string& output) const override;
   ProtobufWkt::Value formatValue(const Http::RequestHeaderMap&, const Http::ResponseHeaderMap&,
                                  const Http::ResponseTrailerMap&,
                                  const StreamInfo::StreamInfo&) const override;
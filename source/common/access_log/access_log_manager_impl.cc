@@ -6,8 +6,6 @@
 #include "common/common/fmt.h"
 #include "common/common/lock_guard.h"
 
-#include "absl/container/fixed_array.h"
-
 namespace Envoy {
 namespace AccessLog {
 
@@ -41,24 +39,100 @@ AccessLogFileSharedPtr AccessLogManagerImpl::createAccessLog(const std::string&
     return access_log->second;
   }
 
+  if (flusher_ == nullptr) {
+    flusher_ = std::make_shared<AccessLogFlusher>(dispatcher_, file_flush_interval_msec_,
+                                                  api_.threadFactory(), file_stats_);
+  }
+
   access_logs_[*file_name] = std::make_shared<AccessLogFileImpl>(
-      api_.fileSystem().createFile(*file_name), dispatcher_, lock_, file_stats_,
-      file_flush_interval_msec_, api_.threadFactory());
+      api_.fileSystem().createFile(*file_name), flusher_, lock_, file_stats_);
   return access_logs_[*file_name];
 }
 
-AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
-                                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
-                                     std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
-      flush_timer_(dispatcher.createTimer([this]() -> void {
+AccessLogFlusher::AccessLogFlusher(Event::Dispatcher& dispatcher,
+                                   std::chrono::milliseconds flush_interval_msec,
+                                   Thread::ThreadFactory& thread_factory,
+                                   AccessLogFileStats& stats)
+    : flush_timer_(dispatcher.createTimer([this]() -> void {
         stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
+        wake();
         flush_timer_->enableTimer(flush_interval_msec_);
       })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
+      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {}
+
+AccessLogFlusher::~AccessLogFlusher() {
+  {
+    Thread::LockGuard lock(wake_lock_);
+    exit_ = true;
+    wake_event_.notifyOne();
+  }
+
+  if (flush_thread_ != nullptr) {
+    flush_thread_->join();
+  }
+}
+
+void AccessLogFlusher::registerFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.insert(&file);
+}
+
+void AccessLogFlusher::unregisterFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.erase(&file);
+}
+
+void AccessLogFlusher::start() {
+  if (started_) {
+    return;
+  }
+
+  Thread::LockGuard lock(wake_lock_);
+  if (started_) {
+    return;
+  }
+  // Drain on the first loop, so that whatever triggered the start gets written out.
+  wake_ = true;
+  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
+  flush_timer_->enableTimer(flush_interval_msec_);
+  started_ = true;
+}
+
+void AccessLogFlusher::wake() {
+  Thread::LockGuard lock(wake_lock_);
+  wake_ = true;
+  wake_event_.notifyOne();
+}
+
+void AccessLogFlusher::flushThreadFunc() {
+  while (true) {
+    {
+      Thread::LockGuard lock(wake_lock_);
+      // wake_event_ can be woken up either by a file with enough buffered data or by the timer.
+      while (!wake_ && !exit_) {
+        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
+        wake_event_.wait(wake_lock_);
+      }
+
+      if (exit_) {
+        return;
+      }
+      wake_ = false;
+    }
+
+    // Drain every file in one pass. Files that have nothing buffered return immediately.
+    Thread::LockGuard lock(files_lock_);
+    for (AccessLogFileImpl* file : files_) {
+      file->flushPending();
+    }
+  }
+}
+
+AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, AccessLogFlusherSharedPtr flusher,
+                                     Thread::BasicLockable& lock, AccessLogFileStats& stats)
+    : file_(std::move(file)), flusher_(std::move(flusher)), file_lock_(lock), stats_(stats) {
   open();
+  flusher_->registerFile(*this);
 }
 
 Filesystem::FlagSet AccessLogFileImpl::defaultFlags() {
@@ -80,20 +154,17 @@ void AccessLogFileImpl::open() {
 void AccessLogFileImpl::reopen() { reopen_file_ = true; }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
-  {
-    Thread::LockGuard lock(write_lock_);
-    flush_thread_exit_ = true;
-    flush_event_.notifyOne();
-  }
-
-  if (flush_thread_ != nullptr) {
-    flush_thread_->join();
-  }
+  // After this the flush thread no longer touches this file.
+  flusher_->unregisterFile(*this);
 
   // Flush any remaining data. If file was not opened for some reason, skip flushing part.
   if (file_->isOpen()) {
-    if (flush_buffer_.length() > 0) {
-      doWrite(flush_buffer_);
+    {
+      Thread::LockGuard flush_lock(flush_lock_);
+      collectShards();
+      if (about_to_write_buffer_.length() > 0) {
+        doWrite(about_to_write_buffer_);
+      }
     }
 
     const Api::IoCallBoolResult result = file_->close();
@@ -131,91 +202,92 @@ void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
   buffer.drain(buffer.length());
 }
 
-void AccessLogFileImpl::flushThreadFunc() {
-
-  while (true) {
-    std::unique_lock<Thread::BasicLockable> flush_lock;
+void AccessLogFileImpl::collectShards() {
+  for (WriteShard& shard : shards_) {
+    Thread::LockGuard shard_lock(shard.lock_);
+    const uint64_t length = shard.buffer_.length();
+    if (length > 0) {
+      about_to_write_buffer_.move(shard.buffer_);
+      pending_bytes_ -= length;
+    }
+  }
+}
 
-    {
-      Thread::LockGuard write_lock(write_lock_);
+void AccessLogFileImpl::flushPending() {
+  if (pending_bytes_ == 0 && !reopen_file_) {
+    return;
+  }
 
-      // flush_event_ can be woken up either by large enough flush_buffer or by timer.
-      // In case it was timer, flush_buffer_ can be empty.
-      while (flush_buffer_.length() == 0 && !flush_thread_exit_ && !reopen_file_) {
-        // CondVar::wait() does not throw, so it's safe to pass the mutex rather than the guard.
-        flush_event_.wait(write_lock_);
-      }
+  Thread::LockGuard flush_lock(flush_lock_);
+  collectShards();
 
-      if (flush_thread_exit_) {
-        return;
+  // if we failed to open file before, then simply ignore
+  if (file_->isOpen()) {
+    try {
+      if (reopen_file_) {
+        reopen_file_ = false;
+        const Api::IoCallBoolResult result = file_->close();
+        ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                       result.err_->getErrorDetails()));
+        open();
       }
 
-      flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-      about_to_write_buffer_.move(flush_buffer_);
-      ASSERT(flush_buffer_.length() == 0);
-    }
-
-    // if we failed to open file before, then simply ignore
-    if (file_->isOpen()) {
-      try {
-        if (reopen_file_) {
-          reopen_file_ = false;
-          const Api::IoCallBoolResult result = file_->close();
-          ASSERT(result.rc_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                         result.err_->getErrorDetails()));
-          open();
-        }
-
-        doWrite(about_to_write_buffer_);
-      } catch (const EnvoyException&) {
-        stats_.reopen_failed_.inc();
-      }
+      doWrite(about_to_write_buffer_);
+    } catch (const EnvoyException&) {
+      stats_.reopen_failed_.inc();
     }
   }
 }
 
 void AccessLogFileImpl::flush() {
-  std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
-
-  {
-    Thread::LockGuard write_lock(write_lock_);
-
-    // flush_lock_ must be held while checking this or else it is
-    // possible that flushThreadFunc() has already moved data from
-    // flush_buffer_ to about_to_write_buffer_, has unlocked write_lock_,
-    // but has not yet completed doWrite(). This would allow flush() to
-    // return before the pending data has actually been written to disk.
-    flush_buffer_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
-
-    if (flush_buffer_.length() == 0) {
-      return;
-    }
-
-    about_to_write_buffer_.move(flush_buffer_);
-    ASSERT(flush_buffer_.length() == 0);
+  Thread::LockGuard flush_lock(flush_lock_);
+
+  // flush_lock_ must be held while collecting the shards or else it is possible that the flush
+  // thread has already moved data into about_to_write_buffer_ but has not yet completed
+  // doWrite(). This would allow flush() to return before the pending data has actually been
+  // written to disk.
+  collectShards();
+  if (about_to_write_buffer_.length() == 0) {
+    return;
   }
 
   doWrite(about_to_write_buffer_);
 }
 
-void AccessLogFileImpl::write(absl::string_view data) {
-  Thread::LockGuard lock(write_lock_);
+namespace {
 
-  if (flush_thread_ == nullptr) {
-    createFlushStructures();
+// Each thread is assigned a shard the first time it writes to any access log file, round robin,
+// so that up to WRITE_SHARDS concurrent writers never share a shard.
+uint32_t writeShardIndex() {
+  static std::atomic<uint32_t> next_shard{};
+  static thread_local const uint32_t shard =
+      next_shard.fetch_add(1, std::memory_order_relaxed) % AccessLogFileImpl::WRITE_SHARDS;
+  return shard;
+}
+
+} // namespace
+
+void AccessLogFileImpl::write(absl::string_view data) {
+  uint64_t pending;
+  {
+    WriteShard& shard = shards_[writeShardIndex()];
+    Thread::LockGuard lock(shard.lock_);
+    shard.buffer_.add(data.data(), data.size());
+    // Accounted under the shard lock so that collectShards() never subtracts bytes which have not
+    // been added yet.
+    pending = pending_bytes_.fetch_add(data.size()) + data.size();
   }
 
   stats_.write_buffered_.inc();
   stats_.write_total_buffered_.add(data.length());
-  flush_buffer_.add(data.data(), data.size());
-  if (flush_buffer_.length() > MIN_FLUSH_SIZE) {
-    flush_event_.notifyOne();
-  }
-}
 
-void AccessLogFileImpl::createFlushStructures() {
-  flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); });
-  flush_timer_->enableTimer(flush_interval_msec_);
+  // The data must be buffered before the flush thread is started, as it drains all files once on
+  // startup.
+  flusher_->start();
+  // Only the write that crosses the threshold wakes up the flush thread.
+  if (pending > MIN_FLUSH_SIZE && pending - data.size() <= MIN_FLUSH_SIZE) {
+    flusher_->wake();
+  }
 }
 
 } // namespace AccessLog
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -30,6 +33,65 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A single flush thread shared by all access log files of an AccessLogManagerImpl. The thread
+ * sleeps until a file has buffered enough data, the flush timer fires, or the flusher is started,
+ * and then drains every registered file in one pass. This keeps the number of threads constant
+ * no matter how many access log files are configured.
+ */
+class AccessLogFlusher : Logger::Loggable<Logger::Id::main> {
+public:
+  AccessLogFlusher(Event::Dispatcher& dispatcher, std::chrono::milliseconds flush_interval_msec,
+                   Thread::ThreadFactory& thread_factory, AccessLogFileStats& stats);
+  ~AccessLogFlusher();
+
+  /**
+   * Add a file to the set of files drained by the flush thread.
+   */
+  void registerFile(AccessLogFileImpl& file);
+
+  /**
+   * Remove a file from the set of files drained by the flush thread. Once this returns the flush
+   * thread no longer accesses the file.
+   */
+  void unregisterFile(AccessLogFileImpl& file);
+
+  /**
+   * Start the flush thread and the flush timer if they are not running yet. This is deferred
+   * until the first write so that no thread is created for files that are never written to.
+   */
+  void start();
+
+  /**
+   * Wake up the flush thread to drain all files.
+   */
+  void wake();
+
+private:
+  void flushThreadFunc();
+
+  Thread::MutexBasicLockable files_lock_; // Held by the flush thread while draining files, so
+                                          // that a file cannot be destroyed while it is being
+                                          // flushed.
+  std::unordered_set<AccessLogFileImpl*> files_ ABSL_GUARDED_BY(files_lock_);
+  Thread::MutexBasicLockable wake_lock_;
+  Thread::CondVar wake_event_;
+  bool wake_ ABSL_GUARDED_BY(wake_lock_){};
+  bool exit_ ABSL_GUARDED_BY(wake_lock_){};
+  std::atomic<bool> started_{};
+  Thread::ThreadPtr flush_thread_;
+  Event::TimerPtr flush_timer_;
+  Thread::ThreadFactory& thread_factory_;
+  const std::chrono::milliseconds flush_interval_msec_; // Time interval all files get flushed no
+                                                        // matter if they reached the
+                                                        // MIN_FLUSH_SIZE or not.
+  AccessLogFileStats& stats_;
+};
+
+using AccessLogFlusherSharedPtr = std::shared_ptr<AccessLogFlusher>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
@@ -51,22 +113,27 @@ private:
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
   AccessLogFileStats file_stats_;
+  // Created with the first access log file and shared with every file, since files may outlive
+  // the manager.
+  AccessLogFlusherSharedPtr flusher_;
   std::unordered_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * Writes are therefore only buffered by the calling thread and the actual disk writes are done by
+ * the AccessLogFlusher thread shared by all files.
+ *
+ * Writers are spread over a fixed number of buffer shards, each thread always writing to the same
+ * shard, so that workers logging to the same file rarely contend on a lock. Lines written by one
+ * thread keep their order; lines written by different threads may be reordered relative to each
+ * other, as they already could be before they reached the log.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
-  AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
-                    Thread::BasicLockable& lock, AccessLogFileStats& stats,
-                    std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+  AccessLogFileImpl(Filesystem::FilePtr&& file, AccessLogFlusherSharedPtr flusher,
+                    Thread::BasicLockable& lock, AccessLogFileStats& stats);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -80,58 +147,55 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * Write out everything buffered so far, reopening the file first if requested. Called by the
+   * flush thread.
+   */
+  void flushPending();
+
+  // Minimum size before the flush thread will be told to flush.
+  static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
+
+  // Number of buffer shards writers are spread over.
+  static const uint32_t WRITE_SHARDS = 32;
+
 private:
+  struct WriteShard {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
   void doWrite(Buffer::Instance& buffer);
-  void flushThreadFunc();
+  void collectShards() ABSL_EXCLUSIVE_LOCKS_REQUIRED(flush_lock_);
   void open();
-  void createFlushStructures();
 
   // return default flags set which used by open
   static Filesystem::FlagSet defaultFlags();
 
-  // Minimum size before the flush thread will be told to flush.
-  static const uint64_t MIN_FLUSH_SIZE = 1024 * 64;
-
   Filesystem::FilePtr file_;
+  const AccessLogFlusherSharedPtr flusher_;
 
   // These locks are always acquired in the following order if multiple locks are held:
-  //    1) write_lock_
-  //    2) flush_lock_
+  //    1) flush_lock_
+  //    2) WriteShard::lock_
   //    3) file_lock_
-  Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
-                                          // to disk. This is used to make sure that file blocks do
-                                          // not get interleaved by multiple processes writing to
-                                          // the same file during hot-restart.
+  Thread::BasicLockable& file_lock_;      // This lock is used only when writing to disk. This is
+                                          // used to make sure that file blocks do not get
+                                          // interleaved by multiple processes writing to the same
+                                          // file during hot-restart.
   Thread::MutexBasicLockable flush_lock_; // This lock is used to prevent simultaneous flushes from
                                           // the flush thread and a synchronous flush. This protects
                                           // concurrent access to the about_to_write_buffer_, fd_,
                                           // and all other data used during flushing and file
                                           // re-opening.
-  Thread::MutexBasicLockable
-      write_lock_; // The lock is used when filling the flush buffer. It allows
-                   // multiple threads to write to the same file at relatively
-                   // high performance. It is always local to the process.
-  Thread::ThreadPtr flush_thread_;
-  Thread::CondVar flush_event_;
-  std::atomic<bool> flush_thread_exit_{};
+  std::array<WriteShard, WRITE_SHARDS> shards_; // Filled by the writing threads and drained by
+                                                // whoever holds flush_lock_.
+  std::atomic<uint64_t> pending_bytes_{};       // Bytes buffered across all shards.
   std::atomic<bool> reopen_file_{};
-  Buffer::OwnedImpl
-      flush_buffer_ ABSL_GUARDED_BY(write_lock_); // This buffer is used by multiple threads. It
-                                                  // gets filled and then flushed either when max
-                                                  // size is reached or when a timer fires.
-  // TODO(jmarantz): this should be ABSL_GUARDED_BY(flush_lock_) but the analysis cannot poke
-  // through the std::make_unique assignment. I do not believe it's possible to annotate this
-  // properly now due to limitations in the clang thread annotation analysis.
-  Buffer::OwnedImpl about_to_write_buffer_; // This buffer is used only by the flush thread. Data
-                                            // is moved from flush_buffer_ under lock, and then
-                                            // the lock is released so that flush_buffer_ can
-                                            // continue to fill. This buffer is then used for the
-                                            // final write to disk.
-  Event::TimerPtr flush_timer_;
-  Thread::ThreadFactory& thread_factory_;
-  const std::chrono::milliseconds flush_interval_msec_; // Time interval buffer gets flushed no
-                                                        // matter if it reached the MIN_FLUSH_SIZE
-                                                        // or not.
+  Buffer::OwnedImpl about_to_write_buffer_ ABSL_GUARDED_BY(flush_lock_); // Data is moved from
+                                                                         // the shards into this
+                                                                         // buffer and then
+                                                                         // written to disk.
   AccessLogFileStats& stats_;
 };
 
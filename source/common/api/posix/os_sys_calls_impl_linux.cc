@@ -3,6 +3,8 @@
 #endif
 
 #include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include <cerrno>
 
@@ -17,5 +19,11 @@ SysCallIntResult LinuxOsSysCallsImpl::sched_getaffinity(pid_t pid, size_t cpuset
   return {rc, errno};
 }
 
+SysCallIntResult LinuxOsSysCallsImpl::bpf(int cmd, bpf_attr* attr, unsigned int size) {
+  // There is no libc wrapper for bpf(2).
+  const int rc = ::syscall(__NR_bpf, cmd, attr, size);
+  return {rc, errno};
+}
+
 } // namespace Api
 } // namespace Envoy
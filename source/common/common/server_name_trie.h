@@ -0,0 +1,117 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+
+/**
+ * Maps server names, i.e. SNI values, to values. Names are either exact, e.g. "www.example.com",
+ * or wildcards matching any name with a given suffix, e.g. "*.example.com" for "www.example.com"
+ * and "a.b.example.com" but not "example.com". The names are stored by label starting from the
+ * top-level domain, so that a lookup finds the exact match and the longest wildcard match in a
+ * single pass over the name, regardless of the number of names and wildcards.
+ */
+template <class Value> class ServerNameTrie {
+public:
+  /**
+   * @param name supplies an exact server name. The empty name is a valid name.
+   * @return the value for the name, which is default constructed when the name was not added yet.
+   */
+  Value& exact(absl::string_view name) { return valueFor(insert(name).exact_); }
+
+  /**
+   * @param suffix supplies the suffix of a wildcard name without the "*.", e.g. "example.com" for
+   * "*.example.com".
+   * @return the value for the wildcard, which is default constructed when it was not added yet.
+   */
+  Value& wildcard(absl::string_view suffix) { return valueFor(insert(suffix).wildcard_); }
+
+  /**
+   * @param name supplies the server name to look up.
+   * @return the value of the exact name if it was added, otherwise the value of the wildcard with
+   * the longest matching suffix, otherwise nullptr.
+   */
+  const Value* find(absl::string_view name) const {
+    const Node* node = &root_;
+    const Value* wildcard_match = nullptr;
+    size_t end = name.size();
+    while (true) {
+      // The label before end, i.e. everything after the previous dot.
+      const size_t dot = end == 0 ? absl::string_view::npos : name.rfind('.', end - 1);
+      const size_t begin = dot == absl::string_view::npos ? 0 : dot + 1;
+      if (node->wildcard_ != nullptr) {
+        // At least one more label precedes the suffix matched so far.
+        wildcard_match = node->wildcard_.get();
+      }
+      const auto child = node->children_.find(name.substr(begin, end - begin));
+      if (child == node->children_.end()) {
+        return wildcard_match;
+      }
+      node = child->second.get();
+      if (dot == absl::string_view::npos) {
+        break;
+      }
+      end = dot;
+    }
+    return node->exact_ != nullptr ? node->exact_.get() : wildcard_match;
+  }
+
+  /**
+   * Calls the given function with every value, exact ones and wildcards.
+   */
+  template <class Function> void forEach(Function function) { forEach(root_, function); }
+
+private:
+  struct Node {
+    absl::flat_hash_map<std::string, std::unique_ptr<Node>> children_;
+    std::unique_ptr<Value> exact_;
+    std::unique_ptr<Value> wildcard_;
+  };
+
+  // Returns the node of the given name, creating the nodes of all of its labels as needed. The
+  // empty name has a single empty label.
+  Node& insert(absl::string_view name) {
+    Node* node = &root_;
+    size_t end = name.size();
+    while (true) {
+      const size_t dot = end == 0 ? absl::string_view::npos : name.rfind('.', end - 1);
+      const size_t begin = dot == absl::string_view::npos ? 0 : dot + 1;
+      std::unique_ptr<Node>& child = node->children_[name.substr(begin, end - begin)];
+      if (child == nullptr) {
+        child = std::make_unique<Node>();
+      }
+      node = child.get();
+      if (dot == absl::string_view::npos) {
+        return *node;
+      }
+      end = dot;
+    }
+  }
+
+  static Value& valueFor(std::unique_ptr<Value>& value) {
+    if (value == nullptr) {
+      value = std::make_unique<Value>();
+    }
+    return *value;
+  }
+
+  template <class Function> static void forEach(Node& node, Function& function) {
+    if (node.exact_ != nullptr) {
+      function(*node.exact_);
+    }
+    if (node.wildcard_ != nullptr) {
+      function(*node.wildcard_);
+    }
+    for (auto& child : node.children_) {
+      forEach(*child.second, function);
+    }
+  }
+
+  Node root_;
+};
+
+} // namespace Envoy
@@ -0,0 +1,65 @@
+#include "common/compressor/brotli_compressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Compressor {
+
+BrotliCompressorImpl::BrotliCompressorImpl(uint32_t quality, uint32_t window_bits,
+                                           EncoderMode mode, uint32_t chunk_size)
+    : chunk_size_(chunk_size), chunk_ptr_(std::make_unique<uint8_t[]>(chunk_size)),
+      state_(BrotliEncoderCreateInstance(nullptr, nullptr, nullptr), &BrotliEncoderDestroyInstance),
+      avail_out_(chunk_size), next_out_(chunk_ptr_.get()) {
+  RELEASE_ASSERT(state_ != nullptr, "");
+  RELEASE_ASSERT(BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_QUALITY, quality) ==
+                     BROTLI_TRUE,
+                 "");
+  RELEASE_ASSERT(BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_LGWIN, window_bits) ==
+                     BROTLI_TRUE,
+                 "");
+  RELEASE_ASSERT(BrotliEncoderSetParameter(state_.get(), BROTLI_PARAM_MODE,
+                                           static_cast<uint32_t>(mode)) == BROTLI_TRUE,
+                 "");
+}
+
+void BrotliCompressorImpl::compress(Buffer::Instance& buffer, State state) {
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    size_t avail_in = input_slice.len_;
+    const uint8_t* next_in = static_cast<const uint8_t*>(input_slice.mem_);
+    // As with zlib, output produced while consuming the input is appended to the end of the buffer
+    // and the consumed input is drained from the front afterwards.
+    process(buffer, BROTLI_OPERATION_PROCESS, avail_in, next_in);
+    buffer.drain(input_slice.len_);
+  }
+
+  size_t avail_in = 0;
+  const uint8_t* next_in = nullptr;
+  process(buffer, state == State::Finish ? BROTLI_OPERATION_FINISH : BROTLI_OPERATION_FLUSH,
+          avail_in, next_in);
+  updateOutput(buffer);
+}
+
+void BrotliCompressorImpl::process(Buffer::Instance& output_buffer, BrotliEncoderOperation op,
+                                   size_t& avail_in, const uint8_t*& next_in) {
+  do {
+    const BROTLI_BOOL result = BrotliEncoderCompressStream(state_.get(), op, &avail_in, &next_in,
+                                                           &avail_out_, &next_out_, nullptr);
+    RELEASE_ASSERT(result == BROTLI_TRUE, "");
+    if (avail_out_ == 0) {
+      updateOutput(output_buffer);
+    }
+  } while (avail_in > 0 || BrotliEncoderHasMoreOutput(state_.get()) == BROTLI_TRUE ||
+           (op == BROTLI_OPERATION_FINISH && BrotliEncoderIsFinished(state_.get()) == BROTLI_FALSE));
+}
+
+void BrotliCompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
+  const uint64_t n_output = chunk_size_ - avail_out_;
+  if (n_output > 0) {
+    output_buffer.add(static_cast<void*>(chunk_ptr_.get()), n_output);
+  }
+  avail_out_ = chunk_size_;
+  next_out_ = chunk_ptr_.get();
+}
+
+} // namespace Compressor
+} // namespace Envoy
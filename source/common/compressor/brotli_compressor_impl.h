@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compressor/compressor.h"
+
+#include "brotli/encode.h"
+
+namespace Envoy {
+namespace Compressor {
+
+/**
+ * Implementation of compressor's interface backed by the Brotli encoder.
+ */
+class BrotliCompressorImpl : public Compressor {
+public:
+  /**
+   * Enum values used to hint the encoder about the kind of data being compressed.
+   * generic: no assumptions about the content. (default)
+   * text: UTF-8 formatted text, e.g. HTML, JSON or JavaScript.
+   * font: WOFF 2.0 fonts.
+   */
+  enum class EncoderMode : uint32_t {
+    Generic = BROTLI_MODE_GENERIC,
+    Text = BROTLI_MODE_TEXT,
+    Font = BROTLI_MODE_FONT,
+  };
+
+  /**
+   * @param quality controls the compression-speed vs compression-density tradeoff, from 0 to 11.
+   * @param window_bits sets the base two logarithm of the sliding window size, from 10 to 24.
+   * @param mode @see EncoderMode enum.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  BrotliCompressorImpl(uint32_t quality, uint32_t window_bits, EncoderMode mode,
+                       uint32_t chunk_size);
+
+  // Compressor
+  void compress(Buffer::Instance& buffer, State state) override;
+
+private:
+  void process(Buffer::Instance& output_buffer, BrotliEncoderOperation op, size_t& avail_in,
+               const uint8_t*& next_in);
+  void updateOutput(Buffer::Instance& output_buffer);
+
+  const uint32_t chunk_size_;
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<BrotliEncoderState, decltype(&BrotliEncoderDestroyInstance)> state_;
+  size_t avail_out_;
+  uint8_t* next_out_;
+};
+
+} // namespace Compressor
+} // namespace Envoy
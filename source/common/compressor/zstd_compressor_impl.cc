@@ -0,0 +1,59 @@
+#include "common/compressor/zstd_compressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Compressor {
+
+ZstdCompressorImpl::ZstdCompressorImpl(uint32_t compression_level, uint32_t window_log,
+                                       bool enable_checksum, uint32_t chunk_size)
+    : chunk_ptr_(std::make_unique<uint8_t[]>(chunk_size)), cctx_(ZSTD_createCCtx(), &ZSTD_freeCCtx),
+      output_{chunk_ptr_.get(), chunk_size, 0} {
+  RELEASE_ASSERT(cctx_ != nullptr, "");
+  RELEASE_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_compressionLevel,
+                                                      compression_level)),
+                 "");
+  RELEASE_ASSERT(
+      !ZSTD_isError(ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_windowLog, window_log)), "");
+  RELEASE_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx_.get(), ZSTD_c_checksumFlag,
+                                                      enable_checksum ? 1 : 0)),
+                 "");
+}
+
+void ZstdCompressorImpl::compress(Buffer::Instance& buffer, State state) {
+  for (const Buffer::RawSlice& input_slice : buffer.getRawSlices()) {
+    ZSTD_inBuffer input{input_slice.mem_, input_slice.len_, 0};
+    // Output produced while consuming the input is appended to the end of the buffer and the
+    // consumed input is drained from the front afterwards.
+    process(buffer, ZSTD_e_continue, input);
+    buffer.drain(input_slice.len_);
+  }
+
+  ZSTD_inBuffer input{nullptr, 0, 0};
+  process(buffer, state == State::Finish ? ZSTD_e_end : ZSTD_e_flush, input);
+  updateOutput(buffer);
+}
+
+void ZstdCompressorImpl::process(Buffer::Instance& output_buffer, ZSTD_EndDirective mode,
+                                 ZSTD_inBuffer& input) {
+  // With ZSTD_e_continue the call returns once all input is consumed; with ZSTD_e_flush and
+  // ZSTD_e_end it returns the number of bytes still to be flushed, so loop until that is zero.
+  size_t remaining;
+  do {
+    remaining = ZSTD_compressStream2(cctx_.get(), &output_, &input, mode);
+    RELEASE_ASSERT(!ZSTD_isError(remaining), ZSTD_getErrorName(remaining));
+    if (output_.pos == output_.size) {
+      updateOutput(output_buffer);
+    }
+  } while (input.pos < input.size || (mode != ZSTD_e_continue && remaining != 0));
+}
+
+void ZstdCompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
+  if (output_.pos > 0) {
+    output_buffer.add(output_.dst, output_.pos);
+  }
+  output_.pos = 0;
+}
+
+} // namespace Compressor
+} // namespace Envoy
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/compressor/compressor.h"
+
+#include "zstd.h"
+
+namespace Envoy {
+namespace Compressor {
+
+/**
+ * Implementation of compressor's interface backed by Zstandard.
+ */
+class ZstdCompressorImpl : public Compressor {
+public:
+  /**
+   * @param compression_level controls the compression-speed vs compression-density tradeoff, from
+   * 1 to ZSTD_maxCLevel().
+   * @param window_log sets the base two logarithm of the back-reference window size. Zero lets the
+   * library pick it from the compression level.
+   * @param enable_checksum whether a checksum of the content is written at the end of each frame.
+   * @param chunk_size amount of memory reserved for the compressor output.
+   */
+  ZstdCompressorImpl(uint32_t compression_level, uint32_t window_log, bool enable_checksum,
+                     uint32_t chunk_size);
+
+  // Compressor
+  void compress(Buffer::Instance& buffer, State state) override;
+
+private:
+  void process(Buffer::Instance& output_buffer, ZSTD_EndDirective mode, ZSTD_inBuffer& input);
+  void updateOutput(Buffer::Instance& output_buffer);
+
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)> cctx_;
+  ZSTD_outBuffer output_;
+};
+
+} // namespace Compressor
+} // namespace Envoy
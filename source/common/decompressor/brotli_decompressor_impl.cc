@@ -0,0 +1,51 @@
+#include "common/decompressor/brotli_decompressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Decompressor {
+
+BrotliDecompressorImpl::BrotliDecompressorImpl(uint32_t chunk_size)
+    : chunk_size_(chunk_size), chunk_ptr_(std::make_unique<uint8_t[]>(chunk_size)),
+      state_(BrotliDecoderCreateInstance(nullptr, nullptr, nullptr), &BrotliDecoderDestroyInstance),
+      avail_out_(chunk_size), next_out_(chunk_ptr_.get()) {
+  RELEASE_ASSERT(state_ != nullptr, "");
+}
+
+void BrotliDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                        Buffer::Instance& output_buffer) {
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    size_t avail_in = input_slice.len_;
+    const uint8_t* next_in = static_cast<const uint8_t*>(input_slice.mem_);
+    while (true) {
+      const BrotliDecoderResult result = BrotliDecoderDecompressStream(
+          state_.get(), &avail_in, &next_in, &avail_out_, &next_out_, nullptr);
+      if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+        updateOutput(output_buffer);
+        continue;
+      }
+      if (result == BROTLI_DECODER_RESULT_ERROR) {
+        decompression_error_ = BrotliDecoderGetErrorCode(state_.get());
+        ENVOY_LOG(trace, "brotli decompression error: {}",
+                  BrotliDecoderErrorString(BrotliDecoderGetErrorCode(state_.get())));
+        return;
+      }
+      // Either all input is consumed or the stream has ended.
+      break;
+    }
+  }
+
+  updateOutput(output_buffer);
+}
+
+void BrotliDecompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
+  const uint64_t n_output = chunk_size_ - avail_out_;
+  if (n_output > 0) {
+    output_buffer.add(static_cast<void*>(chunk_ptr_.get()), n_output);
+  }
+  avail_out_ = chunk_size_;
+  next_out_ = chunk_ptr_.get();
+}
+
+} // namespace Decompressor
+} // namespace Envoy
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/decompressor/decompressor.h"
+
+#include "common/common/logger.h"
+
+#include "brotli/decode.h"
+
+namespace Envoy {
+namespace Decompressor {
+
+/**
+ * Implementation of decompressor's interface backed by the Brotli decoder.
+ */
+class BrotliDecompressorImpl : public Decompressor,
+                               public Logger::Loggable<Logger::Id::decompression> {
+public:
+  /**
+   * @param chunk_size amount of memory reserved for the decompressor output.
+   */
+  explicit BrotliDecompressorImpl(uint32_t chunk_size);
+
+  // Decompressor
+  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+
+  // Flag to track whether error occurred during decompression.
+  // When an error occurs, the BrotliDecoderErrorCode (a negative int) will be stored in this
+  // variable.
+  int decompression_error_{0};
+
+private:
+  void updateOutput(Buffer::Instance& output_buffer);
+
+  const uint32_t chunk_size_;
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<BrotliDecoderState, decltype(&BrotliDecoderDestroyInstance)> state_;
+  size_t avail_out_;
+  uint8_t* next_out_;
+};
+
+} // namespace Decompressor
+} // namespace Envoy
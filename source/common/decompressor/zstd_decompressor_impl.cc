@@ -0,0 +1,46 @@
+#include "common/decompressor/zstd_decompressor_impl.h"
+
+#include "common/common/assert.h"
+
+namespace Envoy {
+namespace Decompressor {
+
+ZstdDecompressorImpl::ZstdDecompressorImpl(uint32_t chunk_size)
+    : chunk_ptr_(std::make_unique<uint8_t[]>(chunk_size)), dctx_(ZSTD_createDCtx(), &ZSTD_freeDCtx),
+      output_{chunk_ptr_.get(), chunk_size, 0} {
+  RELEASE_ASSERT(dctx_ != nullptr, "");
+}
+
+void ZstdDecompressorImpl::decompress(const Buffer::Instance& input_buffer,
+                                      Buffer::Instance& output_buffer) {
+  for (const Buffer::RawSlice& input_slice : input_buffer.getRawSlices()) {
+    ZSTD_inBuffer input{input_slice.mem_, input_slice.len_, 0};
+    bool more = true;
+    while (more) {
+      const size_t result = ZSTD_decompressStream(dctx_.get(), &output_, &input);
+      if (ZSTD_isError(result)) {
+        decompression_error_ = ZSTD_getErrorCode(result);
+        ENVOY_LOG(trace, "zstd decompression error: {}", ZSTD_getErrorName(result));
+        return;
+      }
+      const bool output_full = output_.pos == output_.size;
+      if (output_full) {
+        updateOutput(output_buffer);
+      }
+      // A full output chunk means the decoder may still be holding data for us.
+      more = input.pos < input.size || output_full;
+    }
+  }
+
+  updateOutput(output_buffer);
+}
+
+void ZstdDecompressorImpl::updateOutput(Buffer::Instance& output_buffer) {
+  if (output_.pos > 0) {
+    output_buffer.add(output_.dst, output_.pos);
+  }
+  output_.pos = 0;
+}
+
+} // namespace Decompressor
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <memory>
+
+#include "envoy/decompressor/decompressor.h"
+
+#include "common/common/logger.h"
+
+#include "zstd.h"
+#include "zstd_errors.h"
+
+namespace Envoy {
+namespace Decompressor {
+
+/**
+ * Implementation of decompressor's interface backed by Zstandard.
+ */
+class ZstdDecompressorImpl : public Decompressor,
+                             public Logger::Loggable<Logger::Id::decompression> {
+public:
+  /**
+   * @param chunk_size amount of memory reserved for the decompressor output.
+   */
+  explicit ZstdDecompressorImpl(uint32_t chunk_size);
+
+  // Decompressor
+  void decompress(const Buffer::Instance& input_buffer, Buffer::Instance& output_buffer) override;
+
+  // Flag to track whether error occurred during decompression.
+  // When an error occurs, the ZSTD_ErrorCode will be stored in this variable.
+  int decompression_error_{0};
+
+private:
+  void updateOutput(Buffer::Instance& output_buffer);
+
+  const std::unique_ptr<uint8_t[]> chunk_ptr_;
+  const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> dctx_;
+  ZSTD_outBuffer output_;
+};
+
+} // namespace Decompressor
+} // namespace Envoy
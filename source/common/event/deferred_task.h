@@ -0,0 +1,39 @@
+#pragma once
+
+#include <functional>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+
+namespace Envoy {
+namespace Event {
+
+/**
+ * A util to schedule a task to run in a future event loop cycle. One of the use cases is to run
+ * the task after the previously deferred deletable objects are destroyed.
+ */
+class DeferredTaskUtil {
+private:
+  class DeferredTask : public DeferredDeletable {
+  public:
+    DeferredTask(std::function<void()>&& task) : task_(std::move(task)) {}
+    ~DeferredTask() override { task_(); }
+
+  private:
+    std::function<void()> task_;
+  };
+
+public:
+  /**
+   * Run the task after the objects the dispatcher has already been asked to defer delete are
+   * destroyed. The deferred delete list is destroyed in FIFO order.
+   * @param dispatcher supplies the dispatcher of the current thread.
+   * @param func supplies the task to run.
+   */
+  static void deferredRun(Dispatcher& dispatcher, std::function<void()>&& func) {
+    dispatcher.deferredDelete(std::make_unique<DeferredTask>(std::move(func)));
+  }
+};
+
+} // namespace Event
+} // namespace Envoy
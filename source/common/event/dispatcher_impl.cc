@@ -206,6 +206,10 @@ void DispatcherImpl::updateApproximateMonotonicTime() {
 }
 
 void DispatcherImpl::runPostCallbacks() {
+  // The stats are read once, since initializeStats() itself runs as a posted callback.
+  DispatcherStats* stats = stats_.get();
+  const MonotonicTime start = stats != nullptr ? timeSource().monotonicTime() : MonotonicTime();
+  bool ran_callbacks = false;
   while (true) {
     // It is important that this declaration is inside the body of the loop so that the callback is
     // destructed while post_lock_ is not held. If callback is declared outside the loop and reused
@@ -214,16 +218,28 @@ void DispatcherImpl::runPostCallbacks() {
     // recursive mutex acquisition) if destroying the callback runs a destructor, which through some
     // callstack calls post() on this dispatcher.
     std::function<void()> callback;
+    size_t queue_depth;
     {
       Thread::LockGuard lock(post_lock_);
       if (post_callbacks_.empty()) {
-        return;
+        break;
       }
+      queue_depth = post_callbacks_.size();
       callback = post_callbacks_.front();
       post_callbacks_.pop_front();
     }
+    if (stats != nullptr && !ran_callbacks) {
+      stats->post_queue_depth_.recordValue(queue_depth);
+    }
+    ran_callbacks = true;
     callback();
   }
+
+  if (stats != nullptr && ran_callbacks) {
+    stats->post_duration_us_.recordValue(
+        std::chrono::duration_cast<std::chrono::microseconds>(timeSource().monotonicTime() - start)
+            .count());
+  }
 }
 
 } // namespace Event
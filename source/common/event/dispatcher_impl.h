@@ -77,6 +77,11 @@ public:
   MonotonicTime approximateMonotonicTime() const override;
   void updateApproximateMonotonicTime() override;
 
+  /**
+   * @return DispatcherStats* the stats of this dispatcher, or nullptr until they are initialized.
+   */
+  DispatcherStats* stats() const { return stats_.get(); }
+
   // FatalErrorInterface
   void onFatalError() const override {
     // Dump the state of the tracked object if it is in the current thread. This generally results
@@ -1,5 +1,10 @@
 #pragma once
 
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/stats/histogram.h"
+
 #include "event2/event_struct.h"
 
 namespace Envoy {
@@ -13,6 +18,28 @@ class ImplBase {
 protected:
   ~ImplBase();
 
+  /**
+   * Runs the event's callback, recording how long it took when dispatcher stats are enabled.
+   * Nothing owned by the event may be touched once the callback returns, since the callback may
+   * have deleted the event.
+   * @param histogram supplies the histogram to record into, or nullptr if stats are not enabled.
+   * @param time_source supplies the time source of the dispatcher running the callback.
+   * @param callback supplies the callback to run.
+   */
+  template <class Callback>
+  static void runCallback(Stats::Histogram* histogram, TimeSource& time_source,
+                          const Callback& callback) {
+    if (histogram == nullptr) {
+      callback();
+      return;
+    }
+    const MonotonicTime start = time_source.monotonicTime();
+    callback();
+    histogram->recordValue(std::chrono::duration_cast<std::chrono::microseconds>(
+                               time_source.monotonicTime() - start)
+                               .count());
+  }
+
   event raw_event_;
 };
 
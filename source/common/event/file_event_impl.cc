@@ -12,7 +12,7 @@ namespace Event {
 
 FileEventImpl::FileEventImpl(DispatcherImpl& dispatcher, os_fd_t fd, FileReadyCb cb,
                              FileTriggerType trigger, uint32_t events)
-    : cb_(cb), fd_(fd), trigger_(trigger) {
+    : dispatcher_(dispatcher), cb_(cb), fd_(fd), trigger_(trigger) {
 #ifdef WIN32
   RELEASE_ASSERT(trigger_ == FileTriggerType::Level,
                  "libevent does not support edge triggers on Windows");
@@ -66,7 +66,9 @@ void FileEventImpl::assignEvents(uint32_t events, event_base* base) {
         // https://github.com/libevent/libevent/issues/984 seems to be producing unexpected
         // behavior. The ASSERT should be restored once this issue is resolved.
         if (events) {
-          event->cb_(events);
+          DispatcherStats* stats = event->dispatcher_.stats();
+          runCallback(stats != nullptr ? &stats->file_event_duration_us_ : nullptr,
+                      event->dispatcher_.timeSource(), [event, events]() { event->cb_(events); });
         }
       },
       this);
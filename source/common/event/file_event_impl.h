@@ -26,6 +26,7 @@ public:
 private:
   void assignEvents(uint32_t events, event_base* base);
 
+  DispatcherImpl& dispatcher_;
   FileReadyCb cb_;
   os_fd_t fd_;
   FileTriggerType trigger_;
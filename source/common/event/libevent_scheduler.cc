@@ -20,7 +20,7 @@ LibeventScheduler::LibeventScheduler() : libevent_(event_base_new()) {
 }
 
 TimerPtr LibeventScheduler::createTimer(const TimerCb& cb, Dispatcher& dispatcher) {
-  return std::make_unique<TimerImpl>(libevent_, cb, dispatcher);
+  return std::make_unique<TimerImpl>(libevent_, cb, dispatcher, stats_);
 };
 
 void LibeventScheduler::run(Dispatcher::RunType mode) {
@@ -2,6 +2,8 @@
 
 #include <chrono>
 
+#include "envoy/event/dispatcher.h"
+
 #include "common/common/assert.h"
 
 #include "event2/event.h"
@@ -9,20 +11,23 @@
 namespace Envoy {
 namespace Event {
 
-TimerImpl::TimerImpl(Libevent::BasePtr& libevent, TimerCb cb, Dispatcher& dispatcher)
-    : cb_(cb), dispatcher_(dispatcher) {
+TimerImpl::TimerImpl(Libevent::BasePtr& libevent, TimerCb cb, Dispatcher& dispatcher,
+                     DispatcherStats* const& stats)
+    : cb_(cb), dispatcher_(dispatcher), stats_(stats) {
   ASSERT(cb_);
   evtimer_assign(
       &raw_event_, libevent.get(),
       [](evutil_socket_t, short, void* arg) -> void {
         TimerImpl* timer = static_cast<TimerImpl*>(arg);
+        Stats::Histogram* histogram =
+            timer->stats_ != nullptr ? &timer->stats_->timer_duration_us_ : nullptr;
         if (timer->object_ == nullptr) {
-          timer->cb_();
+          runCallback(histogram, timer->dispatcher_.timeSource(), timer->cb_);
           return;
         }
         ScopeTrackerScopeState scope(timer->object_, timer->dispatcher_);
         timer->object_ = nullptr;
-        timer->cb_();
+        runCallback(histogram, timer->dispatcher_.timeSource(), timer->cb_);
       },
       this);
 }
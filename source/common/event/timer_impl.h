@@ -11,6 +11,8 @@
 namespace Envoy {
 namespace Event {
 
+struct DispatcherStats;
+
 /**
  * Utility helper functions for Timer implementation.
  */
@@ -51,7 +53,8 @@ public:
  */
 class TimerImpl : public Timer, ImplBase {
 public:
-  TimerImpl(Libevent::BasePtr& libevent, TimerCb cb, Event::Dispatcher& dispatcher);
+  TimerImpl(Libevent::BasePtr& libevent, TimerCb cb, Event::Dispatcher& dispatcher,
+            DispatcherStats* const& stats);
 
   // Timer
   void disableTimer() override;
@@ -66,6 +69,8 @@ private:
   void internalEnableTimer(const timeval& tv, const ScopeTrackedObject* scope);
   TimerCb cb_;
   Dispatcher& dispatcher_;
+  // The stats of the scheduler that created this timer, null until they are initialized.
+  DispatcherStats* const& stats_;
   // This has to be atomic for alarms which are handled out of thread, for
   // example if the DispatcherImpl::post is called by two threads, they race to
   // both set this to null.
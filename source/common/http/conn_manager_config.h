@@ -12,6 +12,7 @@
 #include "common/http/date_provider.h"
 #include "common/network/utility.h"
 #include "common/stats/symbol_table_impl.h"
+#include "common/tracing/sampling_rate_limiter.h"
 
 namespace Envoy {
 namespace Http {
@@ -101,10 +102,12 @@ struct ConnectionManagerStats {
  */
 #define CONN_MAN_TRACING_STATS(COUNTER)                                                            \
   COUNTER(random_sampling)                                                                         \
+  COUNTER(random_sampling_limited)                                                                 \
   COUNTER(service_forced)                                                                          \
   COUNTER(client_enabled)                                                                          \
   COUNTER(not_traceable)                                                                           \
-  COUNTER(health_check)
+  COUNTER(health_check)                                                                            \
+  COUNTER(tail_sampling)
 
 /**
  * Wrapper struct for connection manager tracing stats. @see stats_macros.h
@@ -126,6 +129,12 @@ struct TracingConnectionManagerConfig {
   envoy::type::v3::FractionalPercent overall_sampling_;
   bool verbose_;
   uint32_t max_path_tag_length_;
+  // Limits the requests selected by random sampling, nullptr if unlimited.
+  Tracing::SamplingRateLimiterSharedPtr random_sampling_limiter_;
+  // Requests which were not traced up front are traced once complete if they took at least
+  // tail_sampling_min_duration_, or got a 5xx response when tail_sampling_server_errors_ is set.
+  absl::optional<std::chrono::milliseconds> tail_sampling_min_duration_;
+  bool tail_sampling_server_errors_;
 };
 
 using TracingConnectionManagerConfigPtr = std::unique_ptr<TracingConnectionManagerConfig>;
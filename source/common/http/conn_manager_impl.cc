@@ -223,12 +223,38 @@ void ConnectionManagerImpl::doEndStream(ActiveStream& stream) {
   // Also be sure to unwind any read-disable done by the prior downstream
   // connection.
   if (drain_state_ != DrainState::Closing && codec_->protocol() < Protocol::Http2) {
-    while (!read_callbacks_->connection().readEnabled()) {
-      read_callbacks_->connection().readDisable(false);
+    if (config_.http1Settings().max_pipelined_requests_ > 1 && !streams_.empty()) {
+      // Other pipelined requests are still in flight and may be applying flow control of their
+      // own, so only undo the read-disable done when the pipelining limit was reached.
+      if (pipelining_read_disabled_ && canDispatchPipelinedRequest()) {
+        pipelining_read_disabled_ = false;
+        read_callbacks_->connection().readDisable(false);
+      }
+    } else {
+      while (!read_callbacks_->connection().readEnabled()) {
+        read_callbacks_->connection().readDisable(false);
+      }
+      pipelining_read_disabled_ = false;
     }
   }
 }
 
+bool ConnectionManagerImpl::canDispatchPipelinedRequest() const {
+  // Only start on the next pipelined request once the newest one has been fully received and the
+  // connection is not going to be closed after it.
+  return !streams_.empty() && streams_.size() < config_.http1Settings().max_pipelined_requests_ &&
+         streams_.front()->state_.remote_complete_ &&
+         !streams_.front()->state_.saw_connection_close_ &&
+         drain_state_ == DrainState::NotDraining;
+}
+
+bool ConnectionManagerImpl::shouldTakeOverloadAction(const Server::OverloadActionState& state) {
+  if (state.isInactive() || state.isSaturated()) {
+    return state.isSaturated();
+  }
+  return random_generator_.random() % 1000000 < state.value() * 1000000;
+}
+
 void ConnectionManagerImpl::doDeferredStreamDestroy(ActiveStream& stream) {
   if (stream.max_stream_duration_timer_) {
     stream.max_stream_duration_timer_->disableTimer();
@@ -340,15 +366,19 @@ Network::FilterStatus ConnectionManagerImpl::onData(Buffer::Instance& data, bool
     // The HTTP/1 codec will pause dispatch after a single message is complete. We want to
     // either redispatch if there are no streams and we have more data. If we have a single
     // complete non-WebSocket stream but have not responded yet we will pause socket reads
-    // to apply back pressure.
+    // to apply back pressure. When concurrent pipelining is enabled, further requests are
+    // dispatched until the configured limit is reached.
     if (codec_->protocol() < Protocol::Http2) {
+      const bool can_pipeline = canDispatchPipelinedRequest();
       if (read_callbacks_->connection().state() == Network::Connection::State::Open &&
-          data.length() > 0 && streams_.empty()) {
+          data.length() > 0 && (streams_.empty() || can_pipeline)) {
         redispatch = true;
       }
 
-      if (!streams_.empty() && streams_.front()->state_.remote_complete_) {
+      if (!redispatch && !can_pipeline && !streams_.empty() &&
+          streams_.front()->state_.remote_complete_) {
         read_callbacks_->connection().readDisable(true);
+        pipelining_read_disabled_ = true;
       }
     }
   } while (redispatch);
@@ -641,6 +671,10 @@ ConnectionManagerImpl::ActiveStream::~ActiveStream() {
   }
 
   if (active_span_) {
+    if (tailSampled()) {
+      connection_manager_.config_.tracingStats().tail_sampling_.inc();
+      active_span_->setSampled(true);
+    }
     Tracing::HttpTracerUtility::finalizeDownstreamSpan(
         *active_span_, request_headers_.get(), response_headers_.get(), response_trailers_.get(),
         stream_info_, *this);
@@ -786,8 +820,8 @@ void ConnectionManagerImpl::ActiveStream::decodeHeaders(RequestHeaderMapPtr&& he
   maybeEndDecode(end_stream);
 
   // Drop new requests when overloaded as soon as we have decoded the headers.
-  if (connection_manager_.overload_stop_accepting_requests_ref_ ==
-      Server::OverloadActionState::Active) {
+  if (connection_manager_.shouldTakeOverloadAction(
+          connection_manager_.overload_stop_accepting_requests_ref_)) {
     // In this one special case, do not create the filter chain. If there is a risk of memory
     // overload it is more important to avoid unnecessary allocation than to create the filters.
     state_.created_filter_chain_ = true;
@@ -969,6 +1003,7 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
       Tracing::HttpTracerUtility::isTracing(stream_info_, *request_headers_);
   ConnectionManagerImpl::chargeTracingStats(tracing_decision.reason,
                                             connection_manager_.config_.tracingStats());
+  state_.traced_ = tracing_decision.traced;
 
   active_span_ = connection_manager_.tracer().startSpan(*this, *request_headers_, stream_info_,
                                                         tracing_decision);
@@ -1021,6 +1056,22 @@ void ConnectionManagerImpl::ActiveStream::traceRequest() {
   }
 }
 
+bool ConnectionManagerImpl::ActiveStream::tailSampled() {
+  if (state_.traced_ || stream_info_.healthCheck()) {
+    return false;
+  }
+  const TracingConnectionManagerConfig& config = *connection_manager_.config_.tracingConfig();
+  const bool slow =
+      config.tail_sampling_min_duration_ && stream_info_.requestComplete() &&
+      stream_info_.requestComplete().value() >= config.tail_sampling_min_duration_.value();
+  const bool failed = config.tail_sampling_server_errors_ && stream_info_.responseCode() &&
+                      stream_info_.responseCode().value() >= 500;
+  return (slow || failed) &&
+         ConnectionManagerUtility::tailSamplingEnabled(
+             *request_headers_, connection_manager_.runtime_, connection_manager_.config_,
+             cached_route_.has_value() ? cached_route_.value().get() : nullptr);
+}
+
 void ConnectionManagerImpl::ActiveStream::decodeHeaders(ActiveStreamDecoderFilter* filter,
                                                         RequestHeaderMap& headers,
                                                         bool end_stream) {
@@ -1647,7 +1698,8 @@ void ConnectionManagerImpl::ActiveStream::encodeHeadersInternal(ResponseHeaderMa
   }
 
   if (connection_manager_.drain_state_ == DrainState::NotDraining &&
-      connection_manager_.overload_disable_keepalive_ref_ == Server::OverloadActionState::Active) {
+      connection_manager_.shouldTakeOverloadAction(
+          connection_manager_.overload_disable_keepalive_ref_)) {
     ENVOY_STREAM_LOG(debug, "disabling keepalive due to envoy overload", *this);
     connection_manager_.drain_state_ = DrainState::Closing;
     connection_manager_.stats_.named_.downstream_cx_overload_disable_keepalive_.inc();
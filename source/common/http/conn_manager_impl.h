@@ -568,6 +568,9 @@ private:
     }
 
     void traceRequest();
+    // Whether a request which was not traced up front should be traced now that it is complete.
+    // A request which is tail sampled is charged against the sampling rate limit.
+    bool tailSampled();
 
     // Updates the snapped_route_config_ (by reselecting scoped route configuration), if a scope is
     // not found, snapped_route_config_ is set to Router::NullConfigImpl.
@@ -614,7 +617,7 @@ private:
           : remote_complete_(false), local_complete_(false), codec_saw_local_complete_(false),
             saw_connection_close_(false), successful_upgrade_(false), created_filter_chain_(false),
             is_internally_created_(false), decorated_propagate_(true), has_continue_headers_(false),
-            is_head_request_(false) {}
+            is_head_request_(false), traced_(false) {}
 
       uint32_t filter_call_state_{0};
       // The following 3 members are booleans rather than part of the space-saving bitfield as they
@@ -642,6 +645,8 @@ private:
       // is ever called, this is set to true so commonContinue resumes processing the 100-Continue.
       bool has_continue_headers_ : 1;
       bool is_head_request_ : 1;
+      // Whether the tracing decision made when the request started was to trace it.
+      bool traced_ : 1;
       // Whether a filter has indicated that the request should be treated as a headers only
       // request.
       bool decoding_headers_only_{false};
@@ -747,6 +752,20 @@ private:
    */
   void doEndStream(ActiveStream& stream);
 
+  /**
+   * @return bool whether the next pipelined HTTP/1.1 request may be dispatched while the requests
+   *         received so far are still being processed.
+   */
+  bool canDispatchPipelinedRequest() const;
+
+  /**
+   * @return bool whether to take an overload action for the current request or connection. A
+   *         saturated action is always taken, while a scaled action is taken at random with a
+   *         probability of its value, so that it applies to a growing fraction of the traffic as
+   *         the pressure rises.
+   */
+  bool shouldTakeOverloadAction(const Server::OverloadActionState& state);
+
   void resetAllStreams(absl::optional<StreamInfo::ResponseFlag> response_flag);
   void onIdleTimeout();
   void onConnectionDurationTimeout();
@@ -788,6 +807,9 @@ private:
   const Server::OverloadActionState& overload_disable_keepalive_ref_;
   TimeSource& time_source_;
   std::shared_ptr<StreamInfo::FilterState> filter_state_;
+  // Set when reads were disabled because the maximum number of concurrently dispatched pipelined
+  // HTTP/1.1 requests was reached.
+  bool pipelining_read_disabled_{};
 };
 
 } // namespace Http
@@ -258,6 +258,7 @@ void ConnectionManagerUtility::mutateTracingRequestHeader(RequestHeaderMap& requ
     overall_sampling = &route->tracingConfig()->getOverallSampling();
   }
 
+  bool random_sampled = false;
   // Do not apply tracing transformations if we are currently tracing.
   if (TraceStatus::NoTrace == rid_extension->getTraceStatus(request_headers)) {
     if (request_headers.ClientTraceId() &&
@@ -265,15 +266,49 @@ void ConnectionManagerUtility::mutateTracingRequestHeader(RequestHeaderMap& requ
       rid_extension->setTraceStatus(request_headers, TraceStatus::Client);
     } else if (request_headers.EnvoyForceTrace()) {
       rid_extension->setTraceStatus(request_headers, TraceStatus::Forced);
-    } else if (runtime.snapshot().featureEnabled("tracing.random_sampling", *random_sampling,
-                                                 result)) {
-      rid_extension->setTraceStatus(request_headers, TraceStatus::Sampled);
+    } else {
+      random_sampled =
+          runtime.snapshot().featureEnabled("tracing.random_sampling", *random_sampling, result);
     }
   }
 
   if (!runtime.snapshot().featureEnabled("tracing.global_enabled", *overall_sampling, result)) {
     rid_extension->setTraceStatus(request_headers, TraceStatus::NoTrace);
+    return;
+  }
+
+  // Only charge the rate limit for requests which are going to be traced.
+  if (random_sampled && trySampleWithinLimit(config)) {
+    rid_extension->setTraceStatus(request_headers, TraceStatus::Sampled);
+  }
+}
+
+bool ConnectionManagerUtility::tailSamplingEnabled(const RequestHeaderMap& request_headers,
+                                                   Runtime::Loader& runtime,
+                                                   ConnectionManagerConfig& config,
+                                                   const Router::Route* route) {
+  uint64_t result;
+  if (!config.requestIDExtension()->modBy(request_headers, result, 10000)) {
+    return false;
+  }
+
+  const envoy::type::v3::FractionalPercent* overall_sampling =
+      &config.tracingConfig()->overall_sampling_;
+  if (route && route->tracingConfig()) {
+    overall_sampling = &route->tracingConfig()->getOverallSampling();
+  }
+
+  return runtime.snapshot().featureEnabled("tracing.global_enabled", *overall_sampling, result) &&
+         trySampleWithinLimit(config);
+}
+
+bool ConnectionManagerUtility::trySampleWithinLimit(ConnectionManagerConfig& config) {
+  const auto& limiter = config.tracingConfig()->random_sampling_limiter_;
+  if (limiter == nullptr || limiter->trySample()) {
+    return true;
   }
+  config.tracingStats().random_sampling_limited_.inc();
+  return false;
 }
 
 void ConnectionManagerUtility::mutateXfccRequestHeader(RequestHeaderMap& request_headers,
@@ -76,7 +76,19 @@ public:
                                          Runtime::Loader& runtime, ConnectionManagerConfig& config,
                                          const Router::Route* route);
 
+  /**
+   * Check whether a request that was not traced up front may be tail sampled. Tail sampled
+   * requests are subject to the same overall sampling and sampling rate limit as randomly sampled
+   * ones. A request which may be traced is charged against the rate limit.
+   * @return bool whether the request may be traced.
+   */
+  static bool tailSamplingEnabled(const RequestHeaderMap& request_headers,
+                                  Runtime::Loader& runtime, ConnectionManagerConfig& config,
+                                  const Router::Route* route);
+
 private:
+  // Charge a sampled request against the sampling rate limit, if any.
+  static bool trySampleWithinLimit(ConnectionManagerConfig& config);
   static void mutateXfccRequestHeader(RequestHeaderMap& request_headers,
                                       Network::Connection& connection,
                                       ConnectionManagerConfig& config);
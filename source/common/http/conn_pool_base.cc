@@ -1,5 +1,7 @@
 #include "common/http/conn_pool_base.h"
 
+#include <cmath>
+
 #include "common/stats/timespan_impl.h"
 #include "common/upstream/upstream_impl.h"
 
@@ -18,6 +20,8 @@ ConnPoolImplBase::~ConnPoolImplBase() {
 }
 
 void ConnPoolImplBase::destructAllConnections() {
+  // The connections closed here must not be replaced by prefetched ones.
+  destructing_ = true;
   for (auto* list : {&ready_clients_, &busy_clients_}) {
     while (!list->empty()) {
       list->front()->close();
@@ -45,15 +49,84 @@ void ConnPoolImplBase::tryCreateNewConnection() {
   // prevent pending requests being queued to this upstream with no way to be processed.
   if (can_create_connection || (ready_clients_.empty() && busy_clients_.empty())) {
     ENVOY_LOG(debug, "creating a new connection");
-    ActiveClientPtr client = instantiateActiveClient();
-    ASSERT(client->state_ == ActiveClient::State::CONNECTING);
-    ASSERT(std::numeric_limits<uint64_t>::max() - connecting_request_capacity_ >=
-           client->effectiveConcurrentRequestLimit());
-    connecting_request_capacity_ += client->effectiveConcurrentRequestLimit();
-    client->moveIntoList(std::move(client), owningList(client->state_));
+    createNewConnection();
+  }
+}
+
+ConnPoolImplBase::ActiveClient& ConnPoolImplBase::createNewConnection() {
+  ActiveClientPtr client = instantiateActiveClient();
+  ASSERT(client->state_ == ActiveClient::State::CONNECTING);
+  ASSERT(std::numeric_limits<uint64_t>::max() - connecting_request_capacity_ >=
+         client->effectiveConcurrentRequestLimit());
+  connecting_request_capacity_ += client->effectiveConcurrentRequestLimit();
+  new_connection_request_capacity_ = client->effectiveConcurrentRequestLimit();
+  ActiveClient& client_ref = *client;
+  client->moveIntoList(std::move(client), owningList(client_ref.state_));
+  return client_ref;
+}
+
+void ConnPoolImplBase::prefetchConnections() {
+  while (shouldPrefetch()) {
+    if (!host_->cluster().resourceManager(priority_).connections().canCreate()) {
+      // Prefetching is best effort, so running into the circuit breaker is not an overflow.
+      return;
+    }
+    ENVOY_LOG(debug, "prefetching a new connection");
+    host_->cluster().stats().upstream_cx_prefetch_.inc();
+    createNewConnection().prefetched_ = true;
   }
 }
 
+bool ConnPoolImplBase::shouldPrefetch() const {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  const uint32_t min_idle_connections = host_->cluster().prefetchMinIdleConnections();
+  // A draining pool is about to go away, so it must not open any more connections.
+  if ((ratio <= 1.0 && min_idle_connections == 0) || !drained_callbacks_.empty() || destructing_ ||
+      connections_drained_) {
+    return false;
+  }
+
+  // Sums up the spare capacity in requests of the ready clients onto the given capacity. This
+  // stops once the wanted capacity is reached, so that a pool with plenty of connections does not
+  // have to look at all of them.
+  const uint64_t max = std::numeric_limits<uint64_t>::max();
+  const auto add_ready_capacity = [this, max](uint64_t capacity, uint64_t wanted) {
+    for (auto it = ready_clients_.begin(); it != ready_clients_.end() && capacity < wanted; ++it) {
+      const ActiveClient& client = **it;
+      const uint64_t spare = std::min<uint64_t>(
+          client.remaining_requests_,
+          client.concurrent_request_limit_ - client.codec_client_->numActiveRequests());
+      capacity += std::min(spare, max - capacity);
+    }
+    return capacity;
+  };
+
+  if (ratio > 1.0) {
+    // The capacity in requests which the pool has or is connecting, compared to the current
+    // demand scaled by the ratio.
+    const uint64_t wanted =
+        static_cast<uint64_t>(std::ceil((pending_requests_.size() + num_active_requests_) * ratio));
+    const uint64_t capacity =
+        num_active_requests_ + std::min(connecting_request_capacity_, max - num_active_requests_);
+    if (add_ready_capacity(capacity, wanted) < wanted) {
+      return true;
+    }
+  }
+
+  if (min_idle_connections == 0) {
+    return false;
+  }
+  // Idle capacity is measured in requests too, so that an HTTP/2 connection which is connecting
+  // for several pending requests does not count as idle. The pool wants the capacity of
+  // min_idle_connections new connections on top of what the pending requests are going to take.
+  const uint64_t idle_wanted = min_idle_connections > max / new_connection_request_capacity_
+                                   ? max
+                                   : min_idle_connections * new_connection_request_capacity_;
+  const uint64_t wanted =
+      idle_wanted + std::min<uint64_t>(pending_requests_.size(), max - idle_wanted);
+  return add_ready_capacity(connecting_request_capacity_, wanted) < wanted;
+}
+
 void ConnPoolImplBase::attachRequestToClient(ActiveClient& client,
                                              ResponseDecoder& response_decoder,
                                              ConnectionPool::Callbacks& callbacks) {
@@ -83,6 +156,10 @@ void ConnPoolImplBase::attachRequestToClient(ActiveClient& client,
     host_->cluster().stats().upstream_rq_total_.inc();
     host_->cluster().stats().upstream_rq_active_.inc();
     host_->cluster().resourceManager(priority_).requests().inc();
+    if (client.prefetched_) {
+      client.prefetched_ = false;
+      host_->cluster().stats().upstream_cx_prefetch_hit_.inc();
+    }
     callbacks.onPoolReady(new_encoder, client.real_host_description_,
                           client.codec_client_->streamInfo());
   }
@@ -109,14 +186,17 @@ void ConnPoolImplBase::onRequestClosed(ActiveClient& client, bool delay_attachin
       onUpstreamReady();
     }
   }
+  prefetchConnections();
 }
 
 ConnectionPool::Cancellable* ConnPoolImplBase::newStream(ResponseDecoder& response_decoder,
                                                          ConnectionPool::Callbacks& callbacks) {
+  connections_drained_ = false;
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing connection", *client.codec_client_);
     attachRequestToClient(client, response_decoder, callbacks);
+    prefetchConnections();
     return nullptr;
   }
 
@@ -126,6 +206,7 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStream(ResponseDecoder& respon
     // This must come after newPendingRequest() because this function uses the
     // length of pending_requests_ to determine if a new connection is needed.
     tryCreateNewConnection();
+    prefetchConnections();
 
     return pending;
   } else {
@@ -214,6 +295,8 @@ void ConnPoolImplBase::closeIdleConnections() {
 }
 
 void ConnPoolImplBase::drainConnections() {
+  // Neither the closed connections nor the draining ones are replaced until there is demand again.
+  connections_drained_ = true;
   closeIdleConnections();
 
   // closeIdleConnections() closes all connections in ready_clients_ with no active requests,
@@ -265,12 +348,17 @@ void ConnPoolImplBase::onConnectionEvent(ConnPoolImplBase::ActiveClient& client,
                    client.codec_client_->connectionFailureReason());
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (client.prefetched_) {
+      // The connection was created ahead of demand that never came.
+      host_->cluster().stats().upstream_cx_prefetch_miss_.inc();
+    }
     const bool incomplete_request = client.closingWithIncompleteRequest();
     if (incomplete_request) {
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
     }
 
-    if (client.state_ == ActiveClient::State::CONNECTING) {
+    const bool connect_failed = client.state_ == ActiveClient::State::CONNECTING;
+    if (connect_failed) {
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
 
@@ -301,6 +389,11 @@ void ConnPoolImplBase::onConnectionEvent(ConnPoolImplBase::ActiveClient& client,
     if (!pending_requests_.empty()) {
       tryCreateNewConnection();
     }
+    // Replace the lost connection ahead of demand. Connections which failed to connect are not
+    // replaced, so that an unreachable upstream is not connected to in a tight loop.
+    if (!connect_failed) {
+      prefetchConnections();
+    }
   } else if (event == Network::ConnectionEvent::Connected) {
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
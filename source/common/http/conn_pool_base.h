@@ -89,6 +89,8 @@ protected:
     Stats::TimespanPtr conn_length_;
     Event::TimerPtr connect_timer_;
     bool resources_released_{false};
+    // Whether the connection was created ahead of demand and has not served a request yet.
+    bool prefetched_{false};
   };
 
   using ActiveClientPtr = std::unique_ptr<ActiveClient>;
@@ -147,6 +149,16 @@ protected:
   // starving this pool.
   void tryCreateNewConnection();
 
+  // Creates a new connection, without checking with the resourceManager.
+  ActiveClient& createNewConnection();
+
+  // Creates connections ahead of demand, as configured by the cluster's prefetch policy, as long
+  // as allowed by resourceManager.
+  void prefetchConnections();
+
+  // Returns whether the pool has fewer connections than the cluster's prefetch policy asks for.
+  bool shouldPrefetch() const;
+
 public:
   const Upstream::HostConstSharedPtr host_;
   const Upstream::ResourcePriority priority_;
@@ -177,6 +189,18 @@ protected:
   // The number of requests that can be immediately dispatched
   // if all CONNECTING connections become connected.
   uint64_t connecting_request_capacity_{0};
+
+  // The number of requests a new connection can serve at once, taken from the last connection
+  // created. It only matters once the pool has a connection, since there is no idle capacity to
+  // measure in it before.
+  uint64_t new_connection_request_capacity_{1};
+
+  // Set once the pool closes all of its connections on destruction, so that none are prefetched.
+  bool destructing_{false};
+
+  // Set when the connections are drained, so that they are not replaced by prefetched ones until
+  // the next stream asks for a connection again.
+  bool connections_drained_{false};
 };
 } // namespace Http
 } // namespace Envoy
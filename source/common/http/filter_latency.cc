@@ -0,0 +1,174 @@
+#include "common/http/filter_latency.h"
+
+#include <chrono>
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+/**
+ * Forwards every callback to the wrapped filter, adding the time spent in the callback to the
+ * direction it belongs to. A decoder or encoder only filter is wrapped with the other side unset;
+ * the connection manager never invokes the callbacks of that side.
+ */
+class TimedStreamFilter : public StreamFilter {
+public:
+  TimedStreamFilter(StreamDecoderFilterSharedPtr decoder, StreamEncoderFilterSharedPtr encoder,
+                    FilterLatencyConfigSharedPtr config)
+      : decoder_(std::move(decoder)), encoder_(std::move(encoder)), config_(std::move(config)) {}
+
+  // Http::StreamFilterBase
+  void onDestroy() override {
+    if (decoder_ != nullptr) {
+      decoder_->onDestroy();
+    } else {
+      encoder_->onDestroy();
+    }
+    if (decode_time_.has_value()) {
+      config_->stats().decode_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(decode_time_.value()).count());
+    }
+    if (encode_time_.has_value()) {
+      config_->stats().encode_us_.recordValue(
+          std::chrono::duration_cast<std::chrono::microseconds>(encode_time_.value()).count());
+    }
+  }
+
+  // Http::StreamDecoderFilter
+  FilterHeadersStatus decodeHeaders(RequestHeaderMap& headers, bool end_stream) override {
+    ScopedTimer timer(*this, decode_time_);
+    return decoder_->decodeHeaders(headers, end_stream);
+  }
+  FilterDataStatus decodeData(Buffer::Instance& data, bool end_stream) override {
+    ScopedTimer timer(*this, decode_time_);
+    return decoder_->decodeData(data, end_stream);
+  }
+  FilterTrailersStatus decodeTrailers(RequestTrailerMap& trailers) override {
+    ScopedTimer timer(*this, decode_time_);
+    return decoder_->decodeTrailers(trailers);
+  }
+  FilterMetadataStatus decodeMetadata(MetadataMap& metadata_map) override {
+    ScopedTimer timer(*this, decode_time_);
+    return decoder_->decodeMetadata(metadata_map);
+  }
+  void setDecoderFilterCallbacks(StreamDecoderFilterCallbacks& callbacks) override {
+    decoder_->setDecoderFilterCallbacks(callbacks);
+  }
+  void decodeComplete() override {
+    ScopedTimer timer(*this, decode_time_);
+    decoder_->decodeComplete();
+  }
+
+  // Http::StreamEncoderFilter
+  FilterHeadersStatus encode100ContinueHeaders(ResponseHeaderMap& headers) override {
+    ScopedTimer timer(*this, encode_time_);
+    return encoder_->encode100ContinueHeaders(headers);
+  }
+  FilterHeadersStatus encodeHeaders(ResponseHeaderMap& headers, bool end_stream) override {
+    ScopedTimer timer(*this, encode_time_);
+    return encoder_->encodeHeaders(headers, end_stream);
+  }
+  FilterDataStatus encodeData(Buffer::Instance& data, bool end_stream) override {
+    ScopedTimer timer(*this, encode_time_);
+    return encoder_->encodeData(data, end_stream);
+  }
+  FilterTrailersStatus encodeTrailers(ResponseTrailerMap& trailers) override {
+    ScopedTimer timer(*this, encode_time_);
+    return encoder_->encodeTrailers(trailers);
+  }
+  FilterMetadataStatus encodeMetadata(MetadataMap& metadata_map) override {
+    ScopedTimer timer(*this, encode_time_);
+    return encoder_->encodeMetadata(metadata_map);
+  }
+  void setEncoderFilterCallbacks(StreamEncoderFilterCallbacks& callbacks) override {
+    encoder_->setEncoderFilterCallbacks(callbacks);
+  }
+  void encodeComplete() override {
+    ScopedTimer timer(*this, encode_time_);
+    encoder_->encodeComplete();
+  }
+
+private:
+  // Adds the time spent in its scope to the total of one direction.
+  class ScopedTimer {
+  public:
+    ScopedTimer(TimedStreamFilter& parent, absl::optional<std::chrono::nanoseconds>& total)
+        : time_source_(parent.config_->timeSource()), total_(total),
+          start_(time_source_.monotonicTime()) {}
+    ~ScopedTimer() {
+      total_ = total_.value_or(std::chrono::nanoseconds(0)) +
+               (time_source_.monotonicTime() - start_);
+    }
+
+  private:
+    TimeSource& time_source_;
+    absl::optional<std::chrono::nanoseconds>& total_;
+    const MonotonicTime start_;
+  };
+
+  const StreamDecoderFilterSharedPtr decoder_;
+  const StreamEncoderFilterSharedPtr encoder_;
+  const FilterLatencyConfigSharedPtr config_;
+  // Unset until the filter is first invoked in that direction.
+  absl::optional<std::chrono::nanoseconds> decode_time_;
+  absl::optional<std::chrono::nanoseconds> encode_time_;
+};
+
+/**
+ * Wraps every filter added by a filter factory in a TimedStreamFilter.
+ */
+class TimedFilterChainFactoryCallbacks : public FilterChainFactoryCallbacks {
+public:
+  TimedFilterChainFactoryCallbacks(FilterChainFactoryCallbacks& callbacks,
+                                   const FilterLatencyConfigSharedPtr& config)
+      : callbacks_(callbacks), config_(config) {}
+
+  // Http::FilterChainFactoryCallbacks
+  void addStreamDecoderFilter(StreamDecoderFilterSharedPtr filter) override {
+    callbacks_.addStreamDecoderFilter(
+        std::make_shared<TimedStreamFilter>(std::move(filter), nullptr, config_));
+  }
+  void addStreamEncoderFilter(StreamEncoderFilterSharedPtr filter) override {
+    callbacks_.addStreamEncoderFilter(
+        std::make_shared<TimedStreamFilter>(nullptr, std::move(filter), config_));
+  }
+  void addStreamFilter(StreamFilterSharedPtr filter) override {
+    callbacks_.addStreamFilter(std::make_shared<TimedStreamFilter>(filter, filter, config_));
+  }
+  void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
+    callbacks_.addAccessLogHandler(std::move(handler));
+  }
+
+private:
+  FilterChainFactoryCallbacks& callbacks_;
+  const FilterLatencyConfigSharedPtr& config_;
+};
+
+} // namespace
+
+FilterLatencyConfig::FilterLatencyConfig(const std::string& prefix, Stats::Scope& scope,
+                                         uint64_t sampling, Runtime::RandomGenerator& random,
+                                         TimeSource& time_source)
+    : stats_({ALL_FILTER_LATENCY_STATS(POOL_HISTOGRAM_PREFIX(scope, prefix))}),
+      sampling_(sampling), random_(random), time_source_(time_source) {}
+
+bool FilterLatencyConfig::sampled() const {
+  return sampling_ >= 10000 || (sampling_ > 0 && random_.random() % 10000 < sampling_);
+}
+
+FilterFactoryCb FilterLatencyConfig::wrapFactory(FilterFactoryCb factory,
+                                                 FilterLatencyConfigSharedPtr config) {
+  return [factory, config](FilterChainFactoryCallbacks& callbacks) -> void {
+    if (!config->sampled()) {
+      factory(callbacks);
+      return;
+    }
+    TimedFilterChainFactoryCallbacks timed_callbacks(callbacks, config);
+    factory(timed_callbacks);
+  };
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+#include "envoy/http/filter.h"
+#include "envoy/runtime/runtime.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+namespace Envoy {
+namespace Http {
+
+/**
+ * All per filter latency stats. @see stats_macros.h
+ */
+#define ALL_FILTER_LATENCY_STATS(HISTOGRAM)                                                        \
+  HISTOGRAM(decode_us, Microseconds)                                                               \
+  HISTOGRAM(encode_us, Microseconds)
+
+/**
+ * Struct definition for per filter latency stats. @see stats_macros.h
+ */
+struct FilterLatencyStats {
+  ALL_FILTER_LATENCY_STATS(GENERATE_HISTOGRAM_STRUCT)
+};
+
+/**
+ * Sampled latency instrumentation of one configured HTTP filter. For a sampled stream, every
+ * callback into the filter instances created by the filter's factory is timed, and once the
+ * stream is destroyed the time the stream spent in the filter in each direction is recorded. The
+ * time includes any work the filter triggers synchronously from within a callback, such as other
+ * filters encoding a local reply.
+ */
+class FilterLatencyConfig {
+public:
+  /**
+   * @param prefix supplies the prefix of the filter's histograms.
+   * @param scope supplies the scope the histograms are created in.
+   * @param sampling supplies the number of streams out of 10000 that are timed.
+   * @param random supplies the random generator used to sample streams.
+   * @param time_source supplies the time source used to time the callbacks.
+   */
+  FilterLatencyConfig(const std::string& prefix, Stats::Scope& scope, uint64_t sampling,
+                      Runtime::RandomGenerator& random, TimeSource& time_source);
+
+  /**
+   * @return whether the filter instances of a new stream should be timed.
+   */
+  bool sampled() const;
+
+  FilterLatencyStats& stats() { return stats_; }
+  TimeSource& timeSource() { return time_source_; }
+
+  /**
+   * Wrap a filter factory so that the filters it creates for sampled streams are timed.
+   * @param factory supplies the factory of the filter.
+   * @param config supplies the instrumentation of the filter, which the timed filters keep alive.
+   * @return FilterFactoryCb the wrapping factory.
+   */
+  static FilterFactoryCb wrapFactory(FilterFactoryCb factory,
+                                     std::shared_ptr<FilterLatencyConfig> config);
+
+private:
+  FilterLatencyStats stats_;
+  const uint64_t sampling_;
+  Runtime::RandomGenerator& random_;
+  TimeSource& time_source_;
+};
+
+using FilterLatencyConfigSharedPtr = std::shared_ptr<FilterLatencyConfig>;
+
+} // namespace Http
+} // namespace Envoy
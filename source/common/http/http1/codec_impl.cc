@@ -1,5 +1,6 @@
 #include "common/http/http1/codec_impl.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -181,7 +182,7 @@ void StreamEncoderImpl::encodeHeadersBase(const RequestOrResponseHeaderMap& head
   if (end_stream) {
     endEncode();
   } else {
-    connection_.flushOutput();
+    flushOutput();
   }
 }
 
@@ -203,7 +204,7 @@ void StreamEncoderImpl::encodeData(Buffer::Instance& data, bool end_stream) {
   if (end_stream) {
     endEncode();
   } else {
-    connection_.flushOutput();
+    flushOutput();
   }
 }
 
@@ -225,12 +226,12 @@ void StreamEncoderImpl::encodeTrailersBase(const HeaderMap& trailers) {
         },
         this);
 
-    connection_.flushOutput();
+    flushOutput();
     connection_.buffer().add(CRLF);
   }
 
-  connection_.flushOutput();
-  connection_.onEncodeComplete();
+  flushOutput();
+  onEncodeComplete();
 }
 
 void StreamEncoderImpl::encodeMetadata(const MetadataMapVector&) {
@@ -243,8 +244,47 @@ void StreamEncoderImpl::endEncode() {
     connection_.buffer().add(CRLF);
   }
 
-  connection_.flushOutput(true);
-  connection_.onEncodeComplete();
+  flushOutput(true);
+  onEncodeComplete();
+}
+
+void ResponseEncoderImpl::deferOutput() {
+  ASSERT(deferred_output_ == nullptr);
+  deferred_output_ = std::make_unique<Buffer::WatermarkBuffer>(
+      [this]() -> void { runLowWatermarkCallbacks(); },
+      [this]() -> void { runHighWatermarkCallbacks(); });
+  deferred_output_->setWatermarks(connection_.bufferLimit());
+}
+
+void ResponseEncoderImpl::resumeOutput() {
+  ASSERT(deferred_output_ != nullptr);
+  Buffer::WatermarkBufferPtr deferred_output = std::move(deferred_output_);
+  connection_.buffer().move(*deferred_output);
+  connection_.flushOutput();
+}
+
+void ResponseEncoderImpl::flushOutput(bool end_encode) {
+  if (deferred_output_ == nullptr) {
+    StreamEncoderImpl::flushOutput(end_encode);
+    return;
+  }
+
+  // Keep the flood protection sentinel with the response so that it is only released once the
+  // response has actually been written out.
+  if (end_encode) {
+    connection_.maybeAddSentinelBufferFragment(connection_.buffer());
+  }
+  deferred_output_->move(connection_.buffer());
+}
+
+void ResponseEncoderImpl::onEncodeComplete() {
+  encode_complete_ = true;
+  if (deferred_output_ != nullptr) {
+    // The stream is done as far as higher layers are concerned, so watermark events caused by the
+    // queued response being written later must not be raised.
+    local_end_stream_ = true;
+  }
+  StreamEncoderImpl::onEncodeComplete();
 }
 
 void ServerConnectionImpl::maybeAddSentinelBufferFragment(Buffer::WatermarkBuffer& output_buffer) {
@@ -267,9 +307,16 @@ void ServerConnectionImpl::doFloodProtectionChecks() const {
   if (!flood_protection_) {
     return;
   }
+  // Responses to earlier pipelined requests which are still being encoded will be queued as well.
+  uint32_t pending_responses = 0;
+  for (auto it = active_requests_.begin(); it != active_requests_.end(); ++it) {
+    if (std::next(it) != active_requests_.end() && !it->response_encoder_.encodeComplete()) {
+      ++pending_responses;
+    }
+  }
   // Before processing another request, make sure that we are below the response flood protection
   // threshold.
-  if (outbound_responses_ >= max_outbound_responses_) {
+  if (outbound_responses_ + pending_responses >= max_outbound_responses_) {
     ENVOY_CONN_LOG(trace, "error accepting request: too many pending responses queued",
                    connection_);
     stats_.response_flood_.inc();
@@ -703,17 +750,28 @@ ServerConnectionImpl::ServerConnectionImpl(
       // no one objects. If you use this integer to restore prior behavior, contact the
       // maintainer team as it will otherwise be removed entirely soon.
       max_outbound_responses_(
-          Runtime::getInteger("envoy.do_not_use_going_away_max_http2_outbound_responses", 2)),
+          Runtime::getInteger("envoy.do_not_use_going_away_max_http2_outbound_responses", 2) +
+          std::max(settings.max_pipelined_requests_, 1U) - 1),
       flood_protection_(
           Runtime::runtimeFeatureEnabled("envoy.reloadable_features.http1_flood_protection")),
       headers_with_underscores_action_(headers_with_underscores_action) {}
 
 void ServerConnectionImpl::onEncodeComplete() {
-  if (active_request_.value().remote_complete_) {
-    // Only do this if remote is complete. If we are replying before the request is complete the
-    // only logical thing to do is for higher level code to reset() / close the connection so we
-    // leave the request around so that it can fire reset callbacks.
-    active_request_.reset();
+  // Responses are written in request order. Release every finished request from the front of the
+  // queue and let the next response in line write directly to the connection.
+  while (!active_requests_.empty()) {
+    auto& active_request = active_requests_.front();
+    if (!active_request.response_encoder_.encodeComplete() || !active_request.remote_complete_) {
+      // Only release the request if remote is complete. If we are replying before the request is
+      // complete the only logical thing to do is for higher level code to reset() / close the
+      // connection so we leave the request around so that it can fire reset callbacks.
+      break;
+    }
+
+    active_requests_.pop_front();
+    if (!active_requests_.empty()) {
+      active_requests_.front().response_encoder_.resumeOutput();
+    }
   }
 }
 
@@ -723,7 +781,7 @@ void ServerConnectionImpl::handlePath(RequestHeaderMap& headers, unsigned int me
   bool is_connect = (method == HTTP_CONNECT);
 
   // The url is relative or a wildcard when the method is OPTIONS. Nothing to do here.
-  auto& active_request = active_request_.value();
+  auto& active_request = active_requests_.back();
   if (!active_request.request_url_.getStringView().empty() &&
       (active_request.request_url_.getStringView()[0] == '/' ||
        ((method == HTTP_OPTIONS) && active_request.request_url_.getStringView()[0] == '*'))) {
@@ -765,8 +823,9 @@ int ServerConnectionImpl::onHeadersComplete() {
   // Handle the case where response happens prior to request complete. It's up to upper layer code
   // to disconnect the connection but we shouldn't fire any more events since it doesn't make
   // sense.
-  if (active_request_.has_value()) {
-    auto& active_request = active_request_.value();
+  ActiveRequest* active_request_ptr = decodingRequest();
+  if (active_request_ptr != nullptr) {
+    auto& active_request = *active_request_ptr;
     auto& headers = absl::get<RequestHeaderMapPtr>(headers_or_trailers_);
     ENVOY_CONN_LOG(trace, "Server: onHeadersComplete size={}", connection_, headers->size());
     const char* method_string = http_method_str(static_cast<http_method>(parser_.method));
@@ -827,9 +886,15 @@ int ServerConnectionImpl::onHeadersComplete() {
 
 void ServerConnectionImpl::onMessageBegin() {
   if (!resetStreamCalled()) {
-    ASSERT(!active_request_.has_value());
-    active_request_.emplace(*this, header_key_formatter_.get());
-    auto& active_request = active_request_.value();
+    ASSERT(active_requests_.size() < std::max(codec_settings_.max_pipelined_requests_, 1U));
+    ASSERT(active_requests_.empty() || active_requests_.back().remote_complete_);
+    active_requests_.emplace_back(*this, header_key_formatter_.get());
+    auto& active_request = active_requests_.back();
+    if (active_requests_.size() > 1) {
+      // Responses to pipelined requests must be written in request order, so hold this response
+      // back until every earlier response is complete.
+      active_request.response_encoder_.deferOutput();
+    }
     active_request.request_decoder_ = &callbacks_.newStream(active_request.response_encoder_);
 
     // Check for pipelined request flood as we prepare to accept a new request.
@@ -840,22 +905,25 @@ void ServerConnectionImpl::onMessageBegin() {
 }
 
 void ServerConnectionImpl::onUrl(const char* data, size_t length) {
-  if (active_request_.has_value()) {
-    active_request_.value().request_url_.append(data, length);
+  ActiveRequest* active_request = decodingRequest();
+  if (active_request != nullptr) {
+    active_request->request_url_.append(data, length);
   }
 }
 
 void ServerConnectionImpl::onBody(Buffer::Instance& data) {
   ASSERT(!deferred_end_stream_headers_);
-  if (active_request_.has_value()) {
+  ActiveRequest* active_request = decodingRequest();
+  if (active_request != nullptr) {
     ENVOY_CONN_LOG(trace, "body size={}", connection_, data.length());
-    active_request_.value().request_decoder_->decodeData(data, false);
+    active_request->request_decoder_->decodeData(data, false);
   }
 }
 
 void ServerConnectionImpl::onMessageComplete() {
-  if (active_request_.has_value()) {
-    auto& active_request = active_request_.value();
+  ActiveRequest* active_request_ptr = decodingRequest();
+  if (active_request_ptr != nullptr) {
+    auto& active_request = *active_request_ptr;
     active_request.remote_complete_ = true;
     if (deferred_end_stream_headers_) {
       active_request.request_decoder_->decodeHeaders(
@@ -880,20 +948,31 @@ void ServerConnectionImpl::onMessageComplete() {
 }
 
 void ServerConnectionImpl::onResetStream(StreamResetReason reason) {
-  active_request_.value().response_encoder_.runResetCallbacks(reason);
-  active_request_.reset();
+  ASSERT(!active_requests_.empty());
+  // A reset ends the HTTP/1.1 connection, so every pipelined request on it is reset as well.
+  std::list<ActiveRequest> active_requests;
+  active_requests.swap(active_requests_);
+  for (auto& active_request : active_requests) {
+    active_request.response_encoder_.runResetCallbacks(reason);
+  }
 }
 
 void ServerConnectionImpl::sendProtocolError(absl::string_view details) {
-  if (active_request_.has_value()) {
-    active_request_.value().response_encoder_.setDetails(details);
+  ActiveRequest* active_request = decodingRequest();
+  if (active_request != nullptr) {
+    active_request->response_encoder_.setDetails(details);
   }
   // We do this here because we may get a protocol error before we have a logical stream. Higher
   // layers can only operate on streams, so there is no coherent way to allow them to send an error
   // "out of band." On one hand this is kind of a hack but on the other hand it normalizes HTTP/1.1
   // to look more like HTTP/2 to higher layers.
-  if (!active_request_.has_value() ||
-      !active_request_.value().response_encoder_.startedResponse()) {
+  //
+  // If responses to earlier pipelined requests are still outstanding the error response cannot be
+  // written without corrupting them, so the connection is simply closed by higher layers.
+  const bool earlier_responses_pending =
+      !active_requests_.empty() && &active_requests_.front() != active_request;
+  if (!earlier_responses_pending &&
+      (active_request == nullptr || !active_request->response_encoder_.startedResponse())) {
     Buffer::OwnedImpl bad_request_response(
         absl::StrCat("HTTP/1.1 ", error_code_, " ", CodeUtility::toString(error_code_),
                      "\r\ncontent-length: 0\r\nconnection: close\r\n\r\n"));
@@ -903,13 +982,13 @@ void ServerConnectionImpl::sendProtocolError(absl::string_view details) {
 }
 
 void ServerConnectionImpl::onAboveHighWatermark() {
-  if (active_request_.has_value()) {
-    active_request_.value().response_encoder_.runHighWatermarkCallbacks();
+  for (auto& active_request : active_requests_) {
+    active_request.response_encoder_.runHighWatermarkCallbacks();
   }
 }
 void ServerConnectionImpl::onBelowLowWatermark() {
-  if (active_request_.has_value()) {
-    active_request_.value().response_encoder_.runLowWatermarkCallbacks();
+  for (auto& active_request : active_requests_) {
+    active_request.response_encoder_.runLowWatermarkCallbacks();
   }
 }
 
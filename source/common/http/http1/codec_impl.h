@@ -80,6 +80,17 @@ protected:
   void encodeHeadersBase(const RequestOrResponseHeaderMap& headers, bool end_stream);
   void encodeTrailersBase(const HeaderMap& headers);
 
+  /**
+   * Flush the output this encoder has staged in the connection's output buffer.
+   * @param end_encode supplies whether this is the final flush for the stream.
+   */
+  virtual void flushOutput(bool end_encode = false) { connection_.flushOutput(end_encode); }
+
+  /**
+   * Called when the outbound half of the stream has been completely encoded.
+   */
+  virtual void onEncodeComplete() { connection_.onEncodeComplete(); }
+
   static const std::string CRLF;
   static const std::string LAST_CHUNK;
 
@@ -127,6 +138,18 @@ public:
       : StreamEncoderImpl(connection, header_key_formatter) {}
 
   bool startedResponse() { return started_response_; }
+  bool encodeComplete() const { return encode_complete_; }
+
+  /**
+   * Buffer all further output of this encoder instead of writing it to the connection. This is
+   * used while the response is queued behind the responses to earlier pipelined requests.
+   */
+  void deferOutput();
+
+  /**
+   * Write any output buffered since deferOutput() to the connection and resume writing directly.
+   */
+  void resumeOutput();
 
   // Http::ResponseEncoder
   void encode100ContinueHeaders(const ResponseHeaderMap& headers) override;
@@ -134,7 +157,14 @@ public:
   void encodeTrailers(const ResponseTrailerMap& trailers) override { encodeTrailersBase(trailers); }
 
 private:
+  // StreamEncoderImpl
+  void flushOutput(bool end_encode = false) override;
+  void onEncodeComplete() override;
+
   bool started_response_{};
+  bool encode_complete_{};
+  // Holds the encoded response while it waits for earlier pipelined responses to complete.
+  Buffer::WatermarkBufferPtr deferred_output_;
 };
 
 /**
@@ -393,7 +423,9 @@ public:
 
 private:
   /**
-   * An active HTTP/1.1 request.
+   * An active HTTP/1.1 request. Pipelined requests are queued in request order; the request at the
+   * front of the queue owns the response being written to the connection and the request at the
+   * back is the one being decoded.
    */
   struct ActiveRequest {
     ActiveRequest(ConnectionImpl& connection, HeaderKeyFormatter* header_key_formatter)
@@ -415,6 +447,17 @@ private:
    */
   void handlePath(RequestHeaderMap& headers, unsigned int method);
 
+  /**
+   * @return ActiveRequest* the request currently being decoded, or nullptr if the parser is between
+   *         requests.
+   */
+  ActiveRequest* decodingRequest() {
+    if (active_requests_.empty() || active_requests_.back().remote_complete_) {
+      return nullptr;
+    }
+    return &active_requests_.back();
+  }
+
   // ConnectionImpl
   void onEncodeComplete() override;
   void onMessageBegin() override;
@@ -453,13 +496,13 @@ private:
   void checkHeaderNameForUnderscores() override;
 
   ServerConnectionCallbacks& callbacks_;
-  absl::optional<ActiveRequest> active_request_;
+  std::list<ActiveRequest> active_requests_;
   Http1Settings codec_settings_;
   const Buffer::OwnedBufferFragmentImpl::Releasor response_buffer_releasor_;
   uint32_t outbound_responses_{};
-  // This defaults to 2, which functionally disables pipelining. If any users
-  // of Envoy wish to enable pipelining (which is dangerous and ill supported)
-  // we could make this configurable.
+  // This defaults to 2, which functionally disables pipelining. When concurrent pipelining is
+  // enabled via Http1Settings::max_pipelined_requests_ the limit is raised so that every
+  // in-flight request may have a queued response.
   uint32_t max_outbound_responses_{};
   bool flood_protection_{};
   // TODO(mattklein123): This should be a member of ActiveRequest but this change needs dedicated
@@ -71,14 +71,6 @@ bool Utility::reconstituteCrumbledCookies(const HeaderString& key, const HeaderS
 
 ConnectionImpl::Http2Callbacks ConnectionImpl::http2_callbacks_;
 
-/**
- * Helper to remove const during a cast. nghttp2 takes non-const pointers for headers even though
- * it copies them.
- */
-template <typename T> static T* remove_const(const void* object) {
-  return const_cast<T*>(reinterpret_cast<const T*>(object));
-}
-
 ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_limit)
     : parent_(parent), local_end_stream_sent_(false), remote_end_stream_(false),
       data_deferred_(false), waiting_for_non_informational_headers_(false),
@@ -89,31 +81,9 @@ ConnectionImpl::StreamImpl::StreamImpl(ConnectionImpl& parent, uint32_t buffer_l
   }
 }
 
-static void insertHeader(std::vector<nghttp2_nv>& headers, const HeaderEntry& header) {
-  uint8_t flags = 0;
-  if (header.key().isReference()) {
-    flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
-  }
-  if (header.value().isReference()) {
-    flags |= NGHTTP2_NV_FLAG_NO_COPY_VALUE;
-  }
-  const absl::string_view header_key = header.key().getStringView();
-  const absl::string_view header_value = header.value().getStringView();
-  headers.push_back({remove_const<uint8_t>(header_key.data()),
-                     remove_const<uint8_t>(header_value.data()), header_key.size(),
-                     header_value.size(), flags});
-}
-
 void ConnectionImpl::StreamImpl::buildHeaders(std::vector<nghttp2_nv>& final_headers,
                                               const HeaderMap& headers) {
-  final_headers.reserve(headers.size());
-  headers.iterate(
-      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
-        std::vector<nghttp2_nv>* final_headers = static_cast<std::vector<nghttp2_nv>*>(context);
-        insertHeader(*final_headers, header);
-        return HeaderMap::Iterate::Continue;
-      },
-      &final_headers);
+  parent_.header_interner_.buildHeaders(final_headers, headers);
 }
 
 void ConnectionImpl::ServerStreamImpl::encode100ContinueHeaders(const ResponseHeaderMap& headers) {
@@ -452,24 +422,37 @@ ConnectionImpl::ConnectionImpl(Network::Connection& connection, Stats::Scope& st
 ConnectionImpl::~ConnectionImpl() { nghttp2_session_del(session_); }
 
 void ConnectionImpl::dispatch(Buffer::Instance& data) {
-  ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, data.length());
-  for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+  const uint64_t dispatch_length = data.length();
+  ENVOY_CONN_LOG(trace, "dispatching {} bytes", connection_, dispatch_length);
+  // Slices are handed to nghttp2 one at a time from the front of the buffer. While a slice is being
+  // parsed, onData() may move DATA payloads out of it rather than copying them, so the buffer is
+  // drained as we go instead of all at once at the end.
+  uint64_t remaining = dispatch_length;
+  while (remaining > 0) {
+    const Buffer::RawSlice slice = data.getRawSlices(1).front();
+    const size_t slice_length = std::min<uint64_t>(slice.len_, remaining);
+    dispatch_buffer_ = &data;
+    dispatch_cursor_ = static_cast<const uint8_t*>(slice.mem_);
+    dispatch_end_ = dispatch_cursor_ + slice_length;
     dispatching_ = true;
     ssize_t rc =
-        nghttp2_session_mem_recv(session_, static_cast<const uint8_t*>(slice.mem_), slice.len_);
+        nghttp2_session_mem_recv(session_, static_cast<const uint8_t*>(slice.mem_), slice_length);
+    dispatch_buffer_ = nullptr;
     if (rc == NGHTTP2_ERR_FLOODED || flood_detected_) {
       throw FrameFloodException(
           "Flooding was detected in this HTTP/2 session, and it must be closed");
     }
-    if (rc != static_cast<ssize_t>(slice.len_)) {
+    if (rc != static_cast<ssize_t>(slice_length)) {
       throw CodecProtocolException(fmt::format("{}", nghttp2_strerror(rc)));
     }
 
     dispatching_ = false;
+    // Drain whatever part of the slice was not moved into a stream by onData().
+    data.drain(dispatch_end_ - dispatch_cursor_);
+    remaining -= slice_length;
   }
 
-  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, data.length());
-  data.drain(data.length());
+  ENVOY_CONN_LOG(trace, "dispatched {} bytes", connection_, dispatch_length);
 
   // Decoding incoming frames can generate outbound frames so flush pending.
   sendPendingFrames();
@@ -483,7 +466,16 @@ int ConnectionImpl::onData(int32_t stream_id, const uint8_t* data, size_t len) {
   StreamImpl* stream = getStream(stream_id);
   // If this results in buffering too much data, the watermark buffer will call
   // pendingRecvBufferHighWatermark, resulting in ++read_disable_count_
-  stream->pending_recv_data_.add(data, len);
+  if (dispatch_buffer_ != nullptr && data >= dispatch_cursor_ && data + len <= dispatch_end_) {
+    // The payload lives in the slice currently being dispatched. Drop the bytes in front of it and
+    // move it into the stream buffer. When the payload runs to the end of the slice, which is the
+    // common case for large DATA frames, the slice itself changes owner and nothing is copied.
+    dispatch_buffer_->drain(data - dispatch_cursor_);
+    stream->pending_recv_data_.move(*dispatch_buffer_, len);
+    dispatch_cursor_ = data + len;
+  } else {
+    stream->pending_recv_data_.add(data, len);
+  }
   // Update the window to the peer unless some consumer of this stream's data has hit a flow control
   // limit and disabled reads on this stream
   if (!stream->buffers_overrun()) {
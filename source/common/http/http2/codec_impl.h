@@ -19,6 +19,7 @@
 #include "common/common/logger.h"
 #include "common/http/codec_helper.h"
 #include "common/http/header_map_impl.h"
+#include "common/http/http2/header_interner.h"
 #include "common/http/http2/metadata_decoder.h"
 #include "common/http/http2/metadata_encoder.h"
 #include "common/http/utility.h"
@@ -155,7 +156,7 @@ protected:
     ssize_t onDataSourceRead(uint64_t length, uint32_t* data_flags);
     int onDataSourceSend(const uint8_t* framehd, size_t length);
     void resetStreamWorker(StreamResetReason reason);
-    static void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
+    void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
     void saveHeader(HeaderString&& name, HeaderString&& value);
     void encodeHeadersBase(const std::vector<nghttp2_nv>& final_headers, bool end_stream);
     virtual void submitHeaders(const std::vector<nghttp2_nv>& final_headers,
@@ -359,6 +360,9 @@ protected:
   static Http2Callbacks http2_callbacks_;
 
   std::list<StreamImplPtr> active_streams_;
+  // Recurring header pairs passed to nghttp2 without a copy. Queued frames may reference the
+  // interned storage, so it must outlive session_, which is deleted in the destructor body.
+  HeaderInterner header_interner_;
   nghttp2_session* session_{};
   CodecStats stats_;
   Network::Connection& connection_;
@@ -457,6 +461,11 @@ private:
   void releaseOutboundFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
   void releaseOutboundControlFrame(const Buffer::OwnedBufferFragmentImpl* fragment);
 
+  // The buffer being dispatched and the part of its front slice that has not yet been drained or
+  // moved into a stream. Only set while nghttp2 is parsing that slice.
+  Buffer::Instance* dispatch_buffer_{};
+  const uint8_t* dispatch_cursor_{};
+  const uint8_t* dispatch_end_{};
   bool dispatching_ : 1;
   bool raised_goaway_ : 1;
   bool pending_deferred_reset_ : 1;
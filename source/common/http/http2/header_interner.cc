@@ -0,0 +1,93 @@
+#include "common/http/http2/header_interner.h"
+
+#include "common/common/hash.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+namespace {
+
+/**
+ * nghttp2 takes non-const pointers for headers even though it never modifies them.
+ */
+uint8_t* toNghttp2Pointer(absl::string_view view) {
+  return const_cast<uint8_t*>(reinterpret_cast<const uint8_t*>(view.data()));
+}
+
+} // namespace
+
+void HeaderInterner::buildHeaders(std::vector<nghttp2_nv>& final_headers,
+                                  const HeaderMap& headers) {
+  final_headers.reserve(headers.size());
+  std::pair<HeaderInterner*, std::vector<nghttp2_nv>*> context(this, &final_headers);
+  headers.iterate(
+      [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+        auto* interner_and_headers =
+            static_cast<std::pair<HeaderInterner*, std::vector<nghttp2_nv>*>*>(context);
+        interner_and_headers->first->insertInternedHeader(*interner_and_headers->second, header);
+        return HeaderMap::Iterate::Continue;
+      },
+      &context);
+}
+
+void HeaderInterner::insertHeader(std::vector<nghttp2_nv>& final_headers,
+                                  const HeaderEntry& header) {
+  uint8_t flags = 0;
+  if (header.key().isReference()) {
+    flags |= NGHTTP2_NV_FLAG_NO_COPY_NAME;
+  }
+  if (header.value().isReference()) {
+    flags |= NGHTTP2_NV_FLAG_NO_COPY_VALUE;
+  }
+  const absl::string_view header_key = header.key().getStringView();
+  const absl::string_view header_value = header.value().getStringView();
+  final_headers.push_back({toNghttp2Pointer(header_key), toNghttp2Pointer(header_value),
+                           header_key.size(), header_value.size(), flags});
+}
+
+void HeaderInterner::insertInternedHeader(std::vector<nghttp2_nv>& final_headers,
+                                          const HeaderEntry& header) {
+  const absl::string_view header_key = header.key().getStringView();
+  const absl::string_view header_value = header.value().getStringView();
+  // Pairs made only of static strings are never copied by nghttp2, and large values such as
+  // cookies or tokens are unlikely to recur.
+  if ((header.key().isReference() && header.value().isReference()) ||
+      header_key.size() + header_value.size() > max_entry_size_) {
+    insertHeader(final_headers, header);
+    return;
+  }
+
+  auto it = interned_.find(HeaderKey(header_key, header_value));
+  if (it == interned_.end()) {
+    if (interned_.size() >= max_entries_) {
+      insertHeader(final_headers, header);
+      return;
+    }
+
+    // Only intern a pair on its second sighting so that per-request values such as request IDs do
+    // not use up the table.
+    const uint64_t hash = HashUtil::xxHash64(header_value, HashUtil::xxHash64(header_key));
+    if (candidates_.erase(hash) == 0) {
+      if (candidates_.size() >= max_entries_ * 4) {
+        candidates_.clear();
+      }
+      candidates_.insert(hash);
+      insertHeader(final_headers, header);
+      return;
+    }
+
+    auto interned = std::make_unique<InternedHeader>(header_key, header_value);
+    const HeaderKey key(interned->name_, interned->value_);
+    it = interned_.emplace(key, std::move(interned)).first;
+  }
+
+  const InternedHeader& interned = *it->second;
+  final_headers.push_back({toNghttp2Pointer(interned.name_), toNghttp2Pointer(interned.value_),
+                           interned.name_.size(), interned.value_.size(),
+                           NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE});
+}
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
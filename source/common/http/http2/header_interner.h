@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "envoy/http/header_map.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "nghttp2/nghttp2.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+/**
+ * Per-connection table of recurring header name/value pairs used when building nghttp2 header
+ * blocks.
+ *
+ * nghttp2 takes a private copy of every header name and value that is not flagged as NO_COPY when
+ * a header block is submitted, so constant headers such as server or content-type are copied again
+ * for every stream. A pair that is seen a second time on a connection is interned into storage
+ * owned by this table and handed to nghttp2 with the NO_COPY flags set. The HPACK encoding of the
+ * pair is left to the nghttp2 deflater, which already emits dynamic table indices for pairs it has
+ * indexed before.
+ *
+ * nghttp2 may still reference interned storage from frames that have not been serialized yet, so
+ * entries are never evicted. The table is bounded by entry count and entry size instead, and must
+ * outlive the nghttp2 session it is used with.
+ */
+class HeaderInterner {
+public:
+  static constexpr uint32_t DEFAULT_MAX_ENTRIES = 64;
+  static constexpr uint32_t DEFAULT_MAX_ENTRY_SIZE = 256;
+
+  HeaderInterner(uint32_t max_entries = DEFAULT_MAX_ENTRIES,
+                 uint32_t max_entry_size = DEFAULT_MAX_ENTRY_SIZE)
+      : max_entries_(max_entries), max_entry_size_(max_entry_size) {}
+
+  /**
+   * Append an nghttp2_nv for every header in a header map, using interned storage for pairs that
+   * recur on this connection.
+   * @param final_headers supplies the vector to append to.
+   * @param headers supplies the headers to encode.
+   */
+  void buildHeaders(std::vector<nghttp2_nv>& final_headers, const HeaderMap& headers);
+
+  /**
+   * Append an nghttp2_nv for a single header without interning it. Only static reference strings
+   * are passed to nghttp2 without a copy.
+   * @param final_headers supplies the vector to append to.
+   * @param header supplies the header to encode.
+   */
+  static void insertHeader(std::vector<nghttp2_nv>& final_headers, const HeaderEntry& header);
+
+  /**
+   * @return uint32_t the number of interned header pairs.
+   */
+  uint32_t size() const { return interned_.size(); }
+
+private:
+  struct InternedHeader {
+    InternedHeader(absl::string_view name, absl::string_view value) : name_(name), value_(value) {}
+
+    const std::string name_;
+    const std::string value_;
+  };
+  using InternedHeaderPtr = std::unique_ptr<InternedHeader>;
+  using HeaderKey = std::pair<absl::string_view, absl::string_view>;
+
+  void insertInternedHeader(std::vector<nghttp2_nv>& final_headers, const HeaderEntry& header);
+
+  const uint32_t max_entries_;
+  const uint32_t max_entry_size_;
+  // Interned pairs, keyed by views into the owned InternedHeader storage.
+  absl::flat_hash_map<HeaderKey, InternedHeaderPtr> interned_;
+  // Hashes of pairs that have been seen once and will be interned if they are seen again.
+  absl::flat_hash_set<uint64_t> candidates_;
+};
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
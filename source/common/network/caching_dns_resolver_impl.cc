@@ -0,0 +1,220 @@
+#include "common/network/caching_dns_resolver_impl.h"
+
+#include <algorithm>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/assert.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Network {
+
+SINGLETON_MANAGER_REGISTRATION(caching_dns_resolver);
+
+CachingDnsResolverImpl::CachingDnsResolverImpl(
+    DnsResolverSharedPtr resolver, TimeSource& time_source, Stats::Scope& scope,
+    const envoy::config::bootstrap::v3::DnsCache& config)
+    : resolver_(std::move(resolver)), time_source_(time_source),
+      scope_(scope.createScope("dns_resolver_cache.")),
+      stats_{ALL_CACHING_DNS_RESOLVER_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))},
+      min_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, min_ttl, 0)),
+      max_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, max_ttl, 300000)),
+      negative_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, negative_ttl, 5000)),
+      prefetch_threshold_(PROTOBUF_PERCENT_TO_DOUBLE_OR_DEFAULT(config, prefetch_threshold, 10) /
+                          100.0),
+      max_entries_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_entries, 10000)) {
+  if (min_ttl_ > max_ttl_) {
+    throw EnvoyException(fmt::format("DNS cache min_ttl of {}ms exceeds its max_ttl of {}ms",
+                                     min_ttl_.count(), max_ttl_.count()));
+  }
+}
+
+CachingDnsResolverImpl::~CachingDnsResolverImpl() {
+  for (const auto& pending : pending_) {
+    if (pending.second->query_ != nullptr) {
+      pending.second->query_->cancel();
+    }
+  }
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::resolve(const std::string& dns_name,
+                                                DnsLookupFamily dns_lookup_family,
+                                                ResolveCb callback) {
+  Key key(dns_name, dns_lookup_family);
+  const auto cached = cache_.find(key);
+  if (cached != cache_.end()) {
+    const MonotonicTime now = time_source_.monotonicTime();
+    const auto remaining =
+        std::chrono::duration_cast<std::chrono::milliseconds>(cached->second.expiry_ - now);
+    if (remaining.count() > 0) {
+      lru_.splice(lru_.begin(), lru_, cached->second.lru_entry_);
+      const ResolutionStatus status = cached->second.status_;
+      if (cached->second.response_.empty()) {
+        ENVOY_LOG(debug, "negative DNS cache hit for '{}'", dns_name);
+        stats_.negative_hits_.inc();
+        callback(status, {});
+        return nullptr;
+      }
+
+      ENVOY_LOG(debug, "DNS cache hit for '{}'", dns_name);
+      stats_.hits_.inc();
+      // Hand out the remaining part of the TTL, so that callers which refresh according to the
+      // TTL do not refresh later than the cache does.
+      const auto remaining_ttl = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+      std::list<DnsResponse> response;
+      for (const DnsResponse& cached_response : cached->second.response_) {
+        response.emplace_back(cached_response.address_, remaining_ttl);
+      }
+      // The prefetch may complete inline and change the cache, so it goes after the copy.
+      if (remaining < cached->second.ttl_ * prefetch_threshold_ &&
+          pending_.find(key) == pending_.end()) {
+        ENVOY_LOG(debug, "prefetching '{}' with {}ms left", dns_name, remaining.count());
+        stats_.prefetches_.inc();
+        startLookup(key, nullptr);
+      }
+      callback(status, std::move(response));
+      return nullptr;
+    }
+
+    removeAnswer(cached);
+  }
+
+  const auto pending = pending_.find(key);
+  if (pending != pending_.end()) {
+    ENVOY_LOG(debug, "joining pending DNS lookup for '{}'", dns_name);
+    stats_.coalesced_.inc();
+    return &addWaiter(*pending->second, callback);
+  }
+
+  ENVOY_LOG(debug, "DNS cache miss for '{}'", dns_name);
+  stats_.misses_.inc();
+  return startLookup(key, callback);
+}
+
+CachingDnsResolverImpl::Waiter& CachingDnsResolverImpl::addWaiter(PendingLookup& lookup,
+                                                                  ResolveCb callback) {
+  lookup.waiters_.emplace_back(std::make_unique<Waiter>(lookup, callback));
+  lookup.live_waiters_++;
+  return *lookup.waiters_.back();
+}
+
+ActiveDnsQuery* CachingDnsResolverImpl::startLookup(const Key& key, ResolveCb callback) {
+  auto lookup = std::make_unique<PendingLookup>(*this, key);
+  PendingLookup& lookup_ref = *lookup;
+  Waiter* waiter = callback ? &addWaiter(lookup_ref, callback) : nullptr;
+  pending_.emplace(key, std::move(lookup));
+
+  ActiveDnsQuery* query =
+      resolver_->resolve(key.first, key.second,
+                         [this, key](ResolutionStatus status, std::list<DnsResponse>&& response) {
+                           onResolved(key, status, std::move(response));
+                         });
+  if (query == nullptr) {
+    // The lookup completed inline, and is gone along with its waiter.
+    return nullptr;
+  }
+  lookup_ref.query_ = query;
+  return waiter;
+}
+
+void CachingDnsResolverImpl::Waiter::cancel() {
+  ASSERT(!cancelled_);
+  cancelled_ = true;
+  parent_.live_waiters_--;
+  parent_.parent_.onCancelled(parent_);
+}
+
+void CachingDnsResolverImpl::onCancelled(PendingLookup& lookup) {
+  // A lookup which lost all of its waiters is of no use to anyone. Prefetches never had any
+  // waiters, and waiters which cancel while the lookup completes have a null query.
+  if (lookup.live_waiters_ > 0 || lookup.query_ == nullptr) {
+    return;
+  }
+  lookup.query_->cancel();
+  // This destroys the lookup and the cancelled waiter, which is the caller.
+  pending_.erase(lookup.key_);
+}
+
+void CachingDnsResolverImpl::onResolved(const Key& key, ResolutionStatus status,
+                                        std::list<DnsResponse>&& response) {
+  const auto pending = pending_.find(key);
+  ASSERT(pending != pending_.end());
+  PendingLookupPtr lookup = std::move(pending->second);
+  pending_.erase(pending);
+  lookup->query_ = nullptr;
+
+  ENVOY_LOG(debug, "DNS lookup for '{}' completed with {} addresses", key.first, response.size());
+  cacheAnswer(key, status, response);
+
+  // The callbacks may cancel the waiters after them, or look the name up again, which then hits
+  // the cache.
+  for (const WaiterPtr& waiter : lookup->waiters_) {
+    if (!waiter->cancelled_) {
+      waiter->callback_(status, std::list<DnsResponse>(response));
+    }
+  }
+}
+
+void CachingDnsResolverImpl::cacheAnswer(const Key& key, ResolutionStatus status,
+                                         const std::list<DnsResponse>& response) {
+  // A successful lookup without any addresses is as good as a failure.
+  const bool negative = status == ResolutionStatus::Failure || response.empty();
+  std::chrono::milliseconds ttl = negative_ttl_;
+  if (!negative) {
+    std::chrono::seconds min_response_ttl = response.front().ttl_;
+    for (const DnsResponse& answer : response) {
+      min_response_ttl = std::min(min_response_ttl, answer.ttl_);
+    }
+    ttl = std::max(min_ttl_, std::min<std::chrono::milliseconds>(max_ttl_, min_response_ttl));
+  }
+
+  const MonotonicTime now = time_source_.monotonicTime();
+  const auto previous = cache_.find(key);
+  if (previous != cache_.end()) {
+    // A failed lookup, most likely a prefetch, does not replace an answer which is still valid, so
+    // that a flaky DNS server does not turn names which resolved into failures.
+    if (status == ResolutionStatus::Failure && !previous->second.response_.empty() &&
+        previous->second.expiry_ > now) {
+      ENVOY_LOG(debug, "keeping the cached answer for '{}' after a failed lookup", key.first);
+      return;
+    }
+    // DnsResponse is not assignable, so the previous answer is replaced rather than updated.
+    removeAnswer(previous);
+  }
+
+  if (ttl.count() == 0) {
+    return;
+  }
+
+  if (cache_.size() >= max_entries_) {
+    ENVOY_LOG(debug, "DNS cache full, evicting '{}'", lru_.back().first);
+    stats_.evictions_.inc();
+    removeAnswer(cache_.find(lru_.back()));
+  }
+
+  lru_.push_front(key);
+  cache_.emplace(key, CachedAnswer{status, response, ttl, now + ttl, lru_.begin()});
+  stats_.num_entries_.set(cache_.size());
+}
+
+void CachingDnsResolverImpl::removeAnswer(CacheMap::iterator answer) {
+  ASSERT(answer != cache_.end());
+  lru_.erase(answer->second.lru_entry_);
+  cache_.erase(answer);
+  stats_.num_entries_.set(cache_.size());
+}
+
+void registerSharedCachingDnsResolver(Singleton::Manager& singleton_manager,
+                                      std::shared_ptr<CachingDnsResolverImpl> resolver) {
+  singleton_manager.getTyped<CachingDnsResolverImpl>(
+      SINGLETON_MANAGER_REGISTERED_NAME(caching_dns_resolver), [resolver] { return resolver; });
+}
+
+DnsResolverSharedPtr sharedCachingDnsResolver(Singleton::Manager& singleton_manager) {
+  return singleton_manager.getTyped<CachingDnsResolverImpl>(
+      SINGLETON_MANAGER_REGISTERED_NAME(caching_dns_resolver), [] { return nullptr; });
+}
+
+} // namespace Network
+} // namespace Envoy
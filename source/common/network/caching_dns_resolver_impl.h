@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "envoy/common/time.h"
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+#include "envoy/network/dns.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/singleton/manager.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
+#include "common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * All DNS resolver cache stats. @see stats_macros.h
+ */
+#define ALL_CACHING_DNS_RESOLVER_STATS(COUNTER, GAUGE)                                             \
+  COUNTER(coalesced)                                                                               \
+  COUNTER(evictions)                                                                               \
+  COUNTER(hits)                                                                                    \
+  COUNTER(misses)                                                                                  \
+  COUNTER(negative_hits)                                                                           \
+  COUNTER(prefetches)                                                                              \
+  GAUGE(num_entries, NeverImport)
+
+/**
+ * Struct definition for all DNS resolver cache stats. @see stats_macros.h
+ */
+struct CachingDnsResolverStats {
+  ALL_CACHING_DNS_RESOLVER_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+/**
+ * Implementation of DnsResolver that caches the answers of another resolver according to their TTL,
+ * caches failures for a configured time, sends concurrent lookups of the same name to the other
+ * resolver only once, and looks names in active use up again shortly before their answer expires.
+ * Answers from the cache are delivered inline, in which case resolve() returns nullptr. All calls
+ * and callbacks are assumed to happen on the thread that owns the dispatcher of the other resolver,
+ * which for the server's resolver is the main thread.
+ */
+class CachingDnsResolverImpl : public DnsResolver,
+                               public Singleton::Instance,
+                               Logger::Loggable<Logger::Id::upstream> {
+public:
+  CachingDnsResolverImpl(DnsResolverSharedPtr resolver, TimeSource& time_source,
+                         Stats::Scope& scope, const envoy::config::bootstrap::v3::DnsCache& config);
+  ~CachingDnsResolverImpl() override;
+
+  // Network::DnsResolver
+  ActiveDnsQuery* resolve(const std::string& dns_name, DnsLookupFamily dns_lookup_family,
+                          ResolveCb callback) override;
+
+private:
+  using Key = std::pair<std::string, DnsLookupFamily>;
+  struct PendingLookup;
+
+  struct Waiter : public ActiveDnsQuery {
+    Waiter(PendingLookup& parent, ResolveCb callback) : parent_(parent), callback_(callback) {}
+
+    // Network::ActiveDnsQuery
+    void cancel() override;
+
+    PendingLookup& parent_;
+    const ResolveCb callback_;
+    bool cancelled_{};
+  };
+  using WaiterPtr = std::unique_ptr<Waiter>;
+
+  // A lookup of a name which was sent to the other resolver, along with everyone waiting for it.
+  struct PendingLookup {
+    PendingLookup(CachingDnsResolverImpl& parent, const Key& key) : parent_(parent), key_(key) {}
+
+    CachingDnsResolverImpl& parent_;
+    const Key key_;
+    std::list<WaiterPtr> waiters_;
+    uint32_t live_waiters_{};
+    // The query of the other resolver, nullptr once it completed.
+    ActiveDnsQuery* query_{};
+  };
+  using PendingLookupPtr = std::unique_ptr<PendingLookup>;
+
+  struct CachedAnswer {
+    ResolutionStatus status_;
+    std::list<DnsResponse> response_;
+    std::chrono::milliseconds ttl_;
+    MonotonicTime expiry_;
+    // The position of the answer in lru_.
+    std::list<Key>::iterator lru_entry_;
+  };
+  using CacheMap = absl::flat_hash_map<Key, CachedAnswer>;
+
+  Waiter& addWaiter(PendingLookup& lookup, ResolveCb callback);
+  // Sends a lookup to the other resolver, on behalf of the given callback if any. Returns the
+  // waiter of the callback, or nullptr if there is no callback or the lookup completed inline.
+  ActiveDnsQuery* startLookup(const Key& key, ResolveCb callback);
+  void onCancelled(PendingLookup& lookup);
+  void onResolved(const Key& key, ResolutionStatus status, std::list<DnsResponse>&& response);
+  void cacheAnswer(const Key& key, ResolutionStatus status, const std::list<DnsResponse>& response);
+  void removeAnswer(CacheMap::iterator answer);
+
+  const DnsResolverSharedPtr resolver_;
+  TimeSource& time_source_;
+  Stats::ScopePtr scope_;
+  CachingDnsResolverStats stats_;
+  const std::chrono::milliseconds min_ttl_;
+  const std::chrono::milliseconds max_ttl_;
+  const std::chrono::milliseconds negative_ttl_;
+  const double prefetch_threshold_;
+  const uint32_t max_entries_;
+  CacheMap cache_;
+  // The keys of the cached answers, from the most to the least recently used.
+  std::list<Key> lru_;
+  absl::flat_hash_map<Key, PendingLookupPtr> pending_;
+};
+
+/**
+ * Makes the given resolver the server's caching resolver, so that extensions which own their own
+ * resolver, such as the dynamic forward proxy, can share its cache via sharedCachingDnsResolver().
+ * The singleton manager only holds a weak reference, the caller must keep the resolver alive.
+ */
+void registerSharedCachingDnsResolver(Singleton::Manager& singleton_manager,
+                                      std::shared_ptr<CachingDnsResolverImpl> resolver);
+
+/**
+ * @return the server's caching resolver if the bootstrap configured one, otherwise nullptr.
+ */
+DnsResolverSharedPtr sharedCachingDnsResolver(Singleton::Manager& singleton_manager);
+
+} // namespace Network
+} // namespace Envoy
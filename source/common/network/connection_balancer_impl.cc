@@ -34,5 +34,41 @@ ExactConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler&) {
   return *min_connection_handler;
 }
 
+void TwoChoiceConnectionBalancerImpl::registerHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  updateHandlers([&handler](Handlers& handlers) { handlers.push_back(&handler); });
+}
+
+void TwoChoiceConnectionBalancerImpl::unregisterHandler(BalancedConnectionHandler& handler) {
+  absl::MutexLock lock(&lock_);
+  updateHandlers([&handler](Handlers& handlers) {
+    handlers.erase(std::find(handlers.begin(), handlers.end(), &handler));
+  });
+}
+
+void TwoChoiceConnectionBalancerImpl::updateHandlers(
+    const std::function<void(Handlers&)>& update) {
+  auto handlers = published_.empty() ? std::make_unique<Handlers>()
+                                     : std::make_unique<Handlers>(*published_.back());
+  update(*handlers);
+  handlers_.store(handlers.get(), std::memory_order_release);
+  published_.push_back(std::move(handlers));
+}
+
+BalancedConnectionHandler&
+TwoChoiceConnectionBalancerImpl::pickTargetHandler(BalancedConnectionHandler& current_handler) {
+  BalancedConnectionHandler* target_handler = &current_handler;
+  const Handlers* handlers = handlers_.load(std::memory_order_acquire);
+  if (handlers != nullptr && handlers->size() > 1) {
+    BalancedConnectionHandler* other_handler = (*handlers)[random_.random() % handlers->size()];
+    if (other_handler->numConnections() < current_handler.numConnections()) {
+      target_handler = other_handler;
+    }
+  }
+
+  target_handler->incNumConnections();
+  return *target_handler;
+}
+
 } // namespace Network
 } // namespace Envoy
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
 #include "envoy/network/connection_balancer.h"
+#include "envoy/runtime/runtime.h"
 
 #include "absl/synchronization/mutex.h"
 
@@ -27,6 +33,39 @@ private:
   std::vector<BalancedConnectionHandler*> handlers_ GUARDED_BY(lock_);
 };
 
+/**
+ * Implementation of connection balancer that compares the handler which accepted a connection with
+ * one other handler picked at random, and hands the connection to the one with fewer connections
+ * (the "power of two choices"). Picking takes no lock and does not depend on the number of
+ * handlers, so unlike ExactConnectionBalancerImpl it does not limit accept throughput. Balancing
+ * is approximate, as concurrent picks may all choose the same handler, but the counts converge as
+ * connections keep coming.
+ */
+class TwoChoiceConnectionBalancerImpl : public ConnectionBalancer {
+public:
+  explicit TwoChoiceConnectionBalancerImpl(Runtime::RandomGenerator& random) : random_(random) {}
+
+  // ConnectionBalancer
+  void registerHandler(BalancedConnectionHandler& handler) override;
+  void unregisterHandler(BalancedConnectionHandler& handler) override;
+  BalancedConnectionHandler& pickTargetHandler(BalancedConnectionHandler& current_handler) override;
+
+private:
+  using Handlers = std::vector<BalancedConnectionHandler*>;
+
+  // Publishes a copy of the current handlers with the given change applied.
+  void updateHandlers(const std::function<void(Handlers&)>& update)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  Runtime::RandomGenerator& random_;
+  // Serializes registerHandler() and unregisterHandler(); pickTargetHandler() only reads handlers_.
+  absl::Mutex lock_;
+  // Every published list of handlers. A list is only freed with the balancer as a concurrent pick
+  // may still be reading it. Each worker registers and unregisters once, so few accumulate.
+  std::vector<std::unique_ptr<const Handlers>> published_ GUARDED_BY(lock_);
+  std::atomic<const Handlers*> handlers_{};
+};
+
 /**
  * A NOP connection balancer implementation that always continues execution after incrementing
  * the handler's connection count.
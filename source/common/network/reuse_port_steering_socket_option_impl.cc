@@ -0,0 +1,225 @@
+#include "common/network/reuse_port_steering_socket_option_impl.h"
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_ether.h>
+
+#include <cstddef>
+#endif
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/macros.h"
+
+#if defined(__linux__)
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Network {
+
+namespace {
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+// Stack offsets of the source address read from the packet, and of the key of the map lookup.
+constexpr int16_t AddressOffset = -16;
+constexpr int16_t KeyOffset = -20;
+
+uint64_t bpfPointer(const void* pointer) { return reinterpret_cast<uintptr_t>(pointer); }
+
+/**
+ * Builds the program which computes a slot from the connection and selects the socket in that slot
+ * of the map. r6 keeps the context, r0 the value the slot is computed from.
+ */
+std::vector<bpf_insn>
+steeringProgram(envoy::config::listener::v3::Listener::ReusePortSteering steering,
+                uint32_t socket_count, int map_fd) {
+  std::vector<bpf_insn> program;
+  const auto emit = [&program](uint8_t code, uint8_t dst, uint8_t src, int16_t off,
+                               int32_t imm) -> size_t {
+    bpf_insn insn{};
+    insn.code = code;
+    insn.dst_reg = dst;
+    insn.src_reg = src;
+    insn.off = off;
+    insn.imm = imm;
+    program.push_back(insn);
+    return program.size() - 1;
+  };
+  // Makes the jump at the given index continue at the next instruction that is emitted.
+  const auto land = [&program](size_t jump) {
+    program[jump].off = static_cast<int16_t>(program.size() - jump - 1);
+  };
+  // Jumps which give up on steering and leave the choice to the kernel.
+  std::vector<size_t> pass_jumps;
+
+  emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0);
+  switch (steering) {
+  case envoy::config::listener::v3::Listener::SOURCE_IP: {
+    // Copies len bytes at the given offset of the IP header onto the stack, and loads the first
+    // word of them into r0.
+    const auto load_source_address = [&](int32_t offset, int32_t len) {
+      emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0);
+      emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_2, 0, 0, offset);
+      emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0);
+      emit(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, AddressOffset);
+      emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, len);
+      emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_5, 0, 0, BPF_HDR_START_NET);
+      emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_skb_load_bytes_relative);
+      pass_jumps.push_back(emit(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_0, 0, 0, 0));
+      emit(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_0, BPF_REG_10, AddressOffset, 0);
+    };
+    // Hashes the IPv4 source address, or the four words of the IPv6 one folded by xor, with a
+    // multiplicative hash so that the slot depends on all bits of the address. The IP version is
+    // taken from the packet since IPv6 listeners may accept IPv4 connections.
+    emit(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_6, offsetof(sk_reuseport_md, eth_protocol),
+         0);
+    const size_t to_ipv6 = emit(BPF_JMP | BPF_JNE | BPF_K, BPF_REG_2, 0, 0, htons(ETH_P_IP));
+    load_source_address(12, 4);
+    const size_t to_hash = emit(BPF_JMP | BPF_JA, 0, 0, 0, 0);
+    land(to_ipv6);
+    load_source_address(8, 16);
+    for (int16_t word = 1; word < 4; ++word) {
+      emit(BPF_LDX | BPF_MEM | BPF_W, BPF_REG_1, BPF_REG_10, AddressOffset + 4 * word, 0);
+      emit(BPF_ALU | BPF_XOR | BPF_X, BPF_REG_0, BPF_REG_1, 0, 0);
+    }
+    land(to_hash);
+    emit(BPF_ALU | BPF_MUL | BPF_K, BPF_REG_0, 0, 0, static_cast<int32_t>(0x9e3779b1));
+    emit(BPF_ALU | BPF_RSH | BPF_K, BPF_REG_0, 0, 0, 16);
+    break;
+  }
+  case envoy::config::listener::v3::Listener::CPU:
+    emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_get_smp_processor_id);
+    break;
+  default:
+    NOT_REACHED_GCOVR_EXCL_LINE;
+  }
+
+  // Selects the socket in slot r0 % socket_count of the map.
+  emit(BPF_ALU | BPF_MOD | BPF_K, BPF_REG_0, 0, 0, socket_count);
+  emit(BPF_STX | BPF_MEM | BPF_W, BPF_REG_10, BPF_REG_0, KeyOffset, 0);
+  emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_1, BPF_REG_6, 0, 0);
+  emit(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_2, BPF_PSEUDO_MAP_FD, 0, map_fd);
+  emit(0, 0, 0, 0, 0);
+  emit(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_3, BPF_REG_10, 0, 0);
+  emit(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_3, 0, 0, KeyOffset);
+  emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_4, 0, 0, 0);
+  emit(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_sk_select_reuseport);
+
+  // When no socket was selected, e.g. as the slot is empty, the kernel picks one by its own hash.
+  for (const size_t jump : pass_jumps) {
+    land(jump);
+  }
+  emit(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, SK_PASS);
+  emit(BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+  return program;
+}
+#endif
+
+} // namespace
+
+ReusePortSteeringSocketOptionImpl::ReusePortSteeringSocketOptionImpl(
+    envoy::config::listener::v3::Listener::ReusePortSteering steering, uint32_t socket_count)
+    : socket_count_(socket_count) {
+  ASSERT(socket_count > 0);
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+  auto& linux_os_syscalls = Api::LinuxOsSysCallsSingleton::get();
+
+  bpf_attr map_attr{};
+  map_attr.map_type = BPF_MAP_TYPE_REUSEPORT_SOCKARRAY;
+  map_attr.key_size = sizeof(uint32_t);
+  map_attr.value_size = sizeof(uint64_t);
+  map_attr.max_entries = socket_count;
+  const Api::SysCallIntResult map_result =
+      linux_os_syscalls.bpf(BPF_MAP_CREATE, &map_attr, sizeof(map_attr));
+  if (map_result.rc_ < 0) {
+    ENVOY_LOG(warn,
+              "Creating the reuse_port_steering socket map failed, using the kernel default: {}",
+              strerror(map_result.errno_));
+    return;
+  }
+  map_fd_ = map_result.rc_;
+
+  const std::vector<bpf_insn> program = steeringProgram(steering, socket_count, map_fd_);
+  static const char License[] = "Apache-2.0";
+  bpf_attr prog_attr{};
+  prog_attr.prog_type = BPF_PROG_TYPE_SK_REUSEPORT;
+  prog_attr.insns = bpfPointer(program.data());
+  prog_attr.insn_cnt = program.size();
+  prog_attr.license = bpfPointer(License);
+  const Api::SysCallIntResult prog_result =
+      linux_os_syscalls.bpf(BPF_PROG_LOAD, &prog_attr, sizeof(prog_attr));
+  if (prog_result.rc_ < 0) {
+    ENVOY_LOG(warn,
+              "Loading the reuse_port_steering program failed, using the kernel default: {}",
+              strerror(prog_result.errno_));
+    return;
+  }
+  prog_fd_ = prog_result.rc_;
+
+  option_ = std::make_unique<SocketOptionImpl>(
+      envoy::config::core::v3::SocketOption::STATE_LISTENING, ENVOY_ATTACH_REUSEPORT_EBPF,
+      prog_fd_);
+#else
+  UNREFERENCED_PARAMETER(steering);
+  ENVOY_LOG(warn,
+            "reuse_port_steering is not supported on this platform, using the kernel default");
+#endif
+}
+
+ReusePortSteeringSocketOptionImpl::~ReusePortSteeringSocketOptionImpl() {
+  // The program and the map stay alive in the kernel as long as the program is attached.
+  auto& os_syscalls = Api::OsSysCallsSingleton::get();
+  if (SOCKET_VALID(prog_fd_)) {
+    os_syscalls.close(prog_fd_);
+  }
+  if (SOCKET_VALID(map_fd_)) {
+    os_syscalls.close(map_fd_);
+  }
+}
+
+bool ReusePortSteeringSocketOptionImpl::setOption(
+    Socket& socket, envoy::config::core::v3::SocketOption::SocketState state) const {
+  if (option_ == nullptr || state != envoy::config::core::v3::SocketOption::STATE_LISTENING) {
+    return true;
+  }
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+  // A socket can only be put into the map once it listens, and so is part of the group.
+  const uint32_t slot = next_slot_++;
+  if (slot < socket_count_) {
+    const uint64_t fd = socket.ioHandle().fd();
+    bpf_attr attr{};
+    attr.map_fd = map_fd_;
+    attr.key = bpfPointer(&slot);
+    attr.value = bpfPointer(&fd);
+    attr.flags = BPF_ANY;
+    const Api::SysCallIntResult result =
+        Api::LinuxOsSysCallsSingleton::get().bpf(BPF_MAP_UPDATE_ELEM, &attr, sizeof(attr));
+    if (result.rc_ != 0) {
+      ENVOY_LOG(warn, "Adding socket to the reuse_port_steering map failed: {}",
+                strerror(result.errno_));
+      return false;
+    }
+  } else {
+    ENVOY_LOG(warn,
+              "All {} slots of the reuse_port_steering map are taken, socket is not steered to",
+              socket_count_);
+  }
+#endif
+
+  // Attaching replaces the program of the whole group, including the one of a hot restart parent.
+  return option_->setOption(socket, state);
+}
+
+absl::optional<Socket::Option::Details> ReusePortSteeringSocketOptionImpl::getOptionDetails(
+    const Socket& socket, envoy::config::core::v3::SocketOption::SocketState state) const {
+  if (option_ == nullptr) {
+    return absl::nullopt;
+  }
+  return option_->getOptionDetails(socket, state);
+}
+
+} // namespace Network
+} // namespace Envoy
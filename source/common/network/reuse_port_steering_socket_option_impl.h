@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/listener/v3/listener.pb.h"
+#include "envoy/network/listen_socket.h"
+
+#include "common/common/logger.h"
+#include "common/network/socket_option_impl.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * Socket option which steers the new connections of a SO_REUSEPORT group between the listen
+ * sockets of one listener. The option loads an eBPF program together with a socket array map, and
+ * adds every socket it is applied to into the map once the socket listens. The program picks a
+ * slot of the map for each new connection, so that only the sockets of this listener are chosen,
+ * even while the group still holds the sockets of a hot restart parent or of a previous version of
+ * the listener. The kernel falls back to its own 4-tuple hash over the whole group when the chosen
+ * slot is empty, and for all connections when the program cannot be loaded.
+ */
+class ReusePortSteeringSocketOptionImpl : public Socket::Option,
+                                          Logger::Loggable<Logger::Id::connection> {
+public:
+  /**
+   * @param steering how connections are steered between the sockets of the listener.
+   * @param socket_count the number of sockets of the listener, i.e. the number of workers.
+   */
+  ReusePortSteeringSocketOptionImpl(
+      envoy::config::listener::v3::Listener::ReusePortSteering steering, uint32_t socket_count);
+  ~ReusePortSteeringSocketOptionImpl() override;
+
+  // Socket::Option
+  bool setOption(Socket& socket,
+                 envoy::config::core::v3::SocketOption::SocketState state) const override;
+  // The common socket options don't require a hash key.
+  void hashKey(std::vector<uint8_t>&) const override {}
+  absl::optional<Details>
+  getOptionDetails(const Socket& socket,
+                   envoy::config::core::v3::SocketOption::SocketState state) const override;
+
+  /**
+   * @return whether the program could be loaded, i.e. whether connections are steered at all.
+   */
+  bool isSupported() const { return option_ != nullptr; }
+
+private:
+  const uint32_t socket_count_;
+  os_fd_t map_fd_{INVALID_SOCKET};
+  os_fd_t prog_fd_{INVALID_SOCKET};
+  // The slot of the map the next socket goes into. The sockets start listening on the workers.
+  mutable std::atomic<uint32_t> next_slot_{0};
+  // Attaches the program to the group, only set once the program is loaded.
+  std::unique_ptr<SocketOptionImpl> option_;
+};
+
+} // namespace Network
+} // namespace Envoy
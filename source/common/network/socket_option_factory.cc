@@ -1,9 +1,11 @@
 #include "common/network/socket_option_factory.h"
 
 #include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/listener/v3/listener.pb.h"
 
 #include "common/common/fmt.h"
 #include "common/network/addr_family_aware_socket_option_impl.h"
+#include "common/network/reuse_port_steering_socket_option_impl.h"
 #include "common/network/socket_option_impl.h"
 
 namespace Envoy {
@@ -124,5 +126,13 @@ std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortOptions() {
   return options;
 }
 
+std::unique_ptr<Socket::Options> SocketOptionFactory::buildReusePortSteeringOptions(
+    envoy::config::listener::v3::Listener::ReusePortSteering steering, uint32_t socket_count) {
+  std::unique_ptr<Socket::Options> options = std::make_unique<Socket::Options>();
+  options->push_back(
+      std::make_shared<Network::ReusePortSteeringSocketOptionImpl>(steering, socket_count));
+  return options;
+}
+
 } // namespace Network
 } // namespace Envoy
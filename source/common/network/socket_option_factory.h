@@ -2,6 +2,7 @@
 
 #include "envoy/common/platform.h"
 #include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/listener/v3/listener.pb.h"
 #include "envoy/network/listen_socket.h"
 
 #include "common/common/logger.h"
@@ -32,6 +33,8 @@ public:
   static std::unique_ptr<Socket::Options> buildIpPacketInfoOptions();
   static std::unique_ptr<Socket::Options> buildRxQueueOverFlowOptions();
   static std::unique_ptr<Socket::Options> buildReusePortOptions();
+  static std::unique_ptr<Socket::Options> buildReusePortSteeringOptions(
+      envoy::config::listener::v3::Listener::ReusePortSteering steering, uint32_t socket_count);
 };
 } // namespace Network
 } // namespace Envoy
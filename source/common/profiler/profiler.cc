@@ -5,6 +5,7 @@
 #ifdef PROFILER_AVAILABLE
 
 #include "gperftools/heap-profiler.h"
+#include "gperftools/malloc_extension.h"
 #include "gperftools/profiler.h"
 
 namespace Envoy {
@@ -38,6 +39,12 @@ bool Heap::stopProfiler() {
   return true;
 }
 
+std::string Heap::sample() {
+  std::string output;
+  MallocExtension::instance()->GetHeapSample(&output);
+  return output;
+}
+
 } // namespace Profiler
 } // namespace Envoy
 
@@ -54,6 +61,7 @@ bool Heap::profilerEnabled() { return false; }
 bool Heap::isProfilerStarted() { return false; }
 bool Heap::startProfiler(const std::string&) { return false; }
 bool Heap::stopProfiler() { return false; }
+std::string Heap::sample() { return ""; }
 } // namespace Profiler
 } // namespace Envoy
 
@@ -60,6 +60,13 @@ public:
    * @return bool whether the file is dumped
    */
   static bool stopProfiler();
+
+  /**
+   * Take a sample of the live heap, without writing any file. Allocations are only sampled when
+   * tcmalloc is run with TCMALLOC_SAMPLE_PARAMETER set.
+   * @return std::string the sampled allocations in pprof heap profile format.
+   */
+  static std::string sample();
 };
 
 } // namespace Profiler
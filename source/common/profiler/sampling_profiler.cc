@@ -0,0 +1,268 @@
+#include "common/profiler/sampling_profiler.h"
+
+#ifdef SAMPLING_PROFILER_AVAILABLE
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <ucontext.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/debugging/stacktrace.h"
+#include "absl/debugging/symbolize.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+struct Sample {
+  // Odd while the signal handler is writing the sample, and 2 * (index + 1) once it is complete,
+  // so that readers can tell a torn or overwritten sample from a consistent one.
+  std::atomic<uint64_t> sequence_{0};
+  int64_t time_ns_;
+  int32_t thread_id_;
+  int32_t depth_;
+  // frames_[0] is the interrupted program counter, the following frames are return addresses.
+  void* frames_[SamplingCpu::MaxFrames];
+};
+
+// Allocated on the first start() and never freed, since a signal may still be in flight on
+// another thread after stop().
+Sample* samples = nullptr;
+std::atomic<uint64_t> next_sample{0};
+bool running = false;
+struct sigaction previous_handler;
+
+int64_t monotonicNowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+void* interruptedPc(const void* ucontext) {
+  const mcontext_t& context = static_cast<const ucontext_t*>(ucontext)->uc_mcontext;
+#if defined(__x86_64__)
+  return reinterpret_cast<void*>(context.gregs[REG_RIP]);
+#elif defined(__i386__)
+  return reinterpret_cast<void*>(context.gregs[REG_EIP]);
+#elif defined(__aarch64__)
+  return reinterpret_cast<void*>(context.pc);
+#endif
+}
+
+// Runs in signal context: only async-signal-safe calls are allowed, and nothing may allocate.
+void onSigProf(int, siginfo_t*, void* ucontext) {
+  const int saved_errno = errno;
+  const uint64_t index = next_sample.fetch_add(1, std::memory_order_relaxed);
+  Sample& sample = samples[index % SamplingCpu::MaxSamples];
+  sample.sequence_.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  sample.time_ns_ = monotonicNowNs();
+  sample.thread_id_ = static_cast<int32_t>(syscall(SYS_gettid));
+  // As gperftools does, the leaf is the exact program counter of the interrupted context and the
+  // callers are unwound from there, skipping this handler's own frame.
+  sample.frames_[0] = interruptedPc(ucontext);
+  int depth = absl::GetStackTraceWithContext(sample.frames_ + 1, SamplingCpu::MaxFrames - 1, 1,
+                                             ucontext, nullptr);
+  if (depth > 0 && sample.frames_[1] == sample.frames_[0]) {
+    // Unwinders that do not use frame pointers may report the program counter again.
+    std::memmove(sample.frames_ + 1, sample.frames_ + 2, (depth - 1) * sizeof(void*));
+    --depth;
+  }
+  sample.depth_ = depth + 1;
+
+  sample.sequence_.store(2 * index + 2, std::memory_order_release);
+  errno = saved_errno;
+}
+
+bool setTimer(uint32_t frequency_hz) {
+  struct itimerval timer;
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = frequency_hz == 0 ? 0 : 1000000 / frequency_hz;
+  timer.it_value = timer.it_interval;
+  return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+}
+
+struct StackKey {
+  int32_t thread_id_;
+  std::vector<void*> frames_;
+
+  bool operator==(const StackKey& other) const {
+    return thread_id_ == other.thread_id_ && frames_ == other.frames_;
+  }
+
+  template <typename H> friend H AbslHashValue(H h, const StackKey& key) {
+    return H::combine(std::move(h), key.thread_id_, key.frames_);
+  }
+};
+
+std::string symbolize(void* address) {
+  char name[1024];
+  if (absl::Symbolize(address, name, sizeof(name))) {
+    return name;
+  }
+  return fmt::format("{}", address);
+}
+
+} // namespace
+
+bool SamplingCpu::profilerAvailable() { return true; }
+
+bool SamplingCpu::isRunning() { return running; }
+
+bool SamplingCpu::start(uint32_t frequency_hz) {
+  if (frequency_hz == 0 || frequency_hz > 1000) {
+    return false;
+  }
+  if (running) {
+    return setTimer(frequency_hz);
+  }
+
+  if (samples == nullptr) {
+    samples = new Sample[MaxSamples];
+  }
+  for (uint32_t i = 0; i < MaxSamples; ++i) {
+    samples[i].sequence_.store(0, std::memory_order_relaxed);
+  }
+  next_sample.store(0, std::memory_order_release);
+
+  struct sigaction action;
+  std::memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  action.sa_sigaction = onSigProf;
+  if (sigaction(SIGPROF, &action, &previous_handler) != 0) {
+    return false;
+  }
+  if (!setTimer(frequency_hz)) {
+    RELEASE_ASSERT(sigaction(SIGPROF, &previous_handler, nullptr) == 0, "");
+    return false;
+  }
+  running = true;
+  return true;
+}
+
+void SamplingCpu::stop() {
+  if (!running) {
+    return;
+  }
+  RELEASE_ASSERT(setTimer(0), "");
+  // No SIGPROF is generated once the timer is disarmed, but one generated before may still be
+  // pending. It must not reach the original disposition, whose default action terminates the
+  // process, so it is consumed here before the original disposition is restored.
+  sigset_t sigprof;
+  sigemptyset(&sigprof);
+  sigaddset(&sigprof, SIGPROF);
+  sigset_t previous_mask;
+  RELEASE_ASSERT(pthread_sigmask(SIG_BLOCK, &sigprof, &previous_mask) == 0, "");
+  const struct timespec no_wait = {0, 0};
+  while (sigtimedwait(&sigprof, nullptr, &no_wait) == SIGPROF) {
+  }
+  RELEASE_ASSERT(sigaction(SIGPROF, &previous_handler, nullptr) == 0, "");
+  RELEASE_ASSERT(pthread_sigmask(SIG_SETMASK, &previous_mask, nullptr) == 0, "");
+  running = false;
+}
+
+std::string SamplingCpu::collapsedStacks(std::chrono::seconds window, bool per_thread) {
+  if (samples == nullptr) {
+    return "";
+  }
+
+  const int64_t oldest_ns =
+      monotonicNowNs() - std::chrono::duration_cast<std::chrono::nanoseconds>(window).count();
+  absl::flat_hash_map<StackKey, uint64_t> counts;
+  for (uint32_t i = 0; i < MaxSamples; ++i) {
+    Sample& sample = samples[i];
+    const uint64_t sequence = sample.sequence_.load(std::memory_order_acquire);
+    if (sequence == 0 || sequence % 2 == 1) {
+      continue;
+    }
+    const int64_t time_ns = sample.time_ns_;
+    const int32_t depth = std::max<int32_t>(std::min<int32_t>(sample.depth_, MaxFrames), 0);
+    StackKey key{per_thread ? sample.thread_id_ : 0,
+                 std::vector<void*>(sample.frames_, sample.frames_ + depth)};
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sample.sequence_.load(std::memory_order_relaxed) != sequence || time_ns < oldest_ns ||
+        key.frames_.empty()) {
+      continue;
+    }
+    ++counts[key];
+  }
+
+  // Node based, so that the names referenced from the stack being joined stay put.
+  absl::node_hash_map<void*, std::string> symbols;
+  // Samples taken at different program counters of the same functions collapse into one stack.
+  absl::flat_hash_map<std::string, uint64_t> stacks;
+  std::vector<absl::string_view> names;
+  for (const auto& entry : counts) {
+    const StackKey& key = entry.first;
+    names.clear();
+    std::string thread;
+    if (per_thread) {
+      thread = absl::StrCat("thread_", key.thread_id_);
+      names.push_back(thread);
+    }
+    // Frames are recorded leaf first, collapsed stacks list them root first.
+    for (auto it = key.frames_.rbegin(); it != key.frames_.rend(); ++it) {
+      // Only the leaf is an exact program counter. The other frames hold return addresses, which
+      // may already point at the next function when the call is the last instruction of the
+      // caller, so they are looked up one byte earlier.
+      void* address = static_cast<char*>(*it) - (it == key.frames_.rend() - 1 ? 0 : 1);
+      auto symbol = symbols.find(address);
+      if (symbol == symbols.end()) {
+        symbol = symbols.emplace(address, symbolize(address)).first;
+      }
+      names.push_back(symbol->second);
+    }
+    stacks[absl::StrJoin(names, ";")] += entry.second;
+  }
+
+  std::vector<std::pair<const std::string*, uint64_t>> sorted;
+  sorted.reserve(stacks.size());
+  for (const auto& entry : stacks) {
+    sorted.emplace_back(&entry.first, entry.second);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const auto& a, const auto& b) { return a.second > b.second; });
+
+  std::string output;
+  for (const auto& entry : sorted) {
+    absl::StrAppend(&output, *entry.first, " ", entry.second, "\n");
+  }
+  return output;
+}
+
+} // namespace Profiler
+} // namespace Envoy
+
+#else
+
+namespace Envoy {
+namespace Profiler {
+
+bool SamplingCpu::profilerAvailable() { return false; }
+bool SamplingCpu::isRunning() { return false; }
+bool SamplingCpu::start(uint32_t) { return false; }
+void SamplingCpu::stop() {}
+std::string SamplingCpu::collapsedStacks(std::chrono::seconds, bool) { return ""; }
+
+} // namespace Profiler
+} // namespace Envoy
+
+#endif // #ifdef SAMPLING_PROFILER_AVAILABLE
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// The sampling profiler relies on ITIMER_PROF delivering SIGPROF to the thread that consumed the
+// CPU time, which is the behavior of Linux, and reads the interrupted program counter from the
+// signal context, whose layout is architecture specific.
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+#define SAMPLING_PROFILER_AVAILABLE
+#endif
+
+namespace Envoy {
+namespace Profiler {
+
+/**
+ * Process wide, low overhead CPU sampling. While running, SIGPROF fires at the configured
+ * frequency of consumed CPU time and the handler records the stack of the interrupted thread into
+ * a fixed size ring of samples. The ring holds a rolling window of the most recent samples, which
+ * can be aggregated on demand without stopping the profiler or writing any file, so it is cheap
+ * enough to leave running in production.
+ *
+ * This uses the same signal as the gperftools CPU profiler, so only one of them can run at a time.
+ */
+class SamplingCpu {
+public:
+  // The deepest stack recorded per sample. Deeper stacks are truncated at the root.
+  static constexpr uint32_t MaxFrames = 32;
+  // The number of samples kept. At 99Hz this is close to three minutes of a fully busy core.
+  static constexpr uint32_t MaxSamples = 16384;
+
+  /**
+   * @return whether the sampling profiler is supported on this platform.
+   */
+  static bool profilerAvailable();
+
+  /**
+   * @return whether the sampling profiler is running.
+   */
+  static bool isRunning();
+
+  /**
+   * Start sampling, or change the frequency if already running.
+   * @param frequency_hz supplies the number of samples per second of consumed CPU time.
+   * @return bool whether the profiler was started.
+   */
+  static bool start(uint32_t frequency_hz);
+
+  /**
+   * Stop sampling. The samples taken so far stay available until the next start().
+   */
+  static void stop();
+
+  /**
+   * Aggregate the recorded samples into collapsed stacks: one line per distinct stack with its
+   * frames from the root down separated by ';', followed by a space and the number of samples.
+   * This is the input format of flamegraph.pl and most flamegraph viewers.
+   * @param window only samples taken within this period before now are included.
+   * @param per_thread whether to root every stack at the id of the thread that was sampled.
+   * @return std::string the collapsed stacks, the most frequent first.
+   */
+  static std::string collapsedStacks(std::chrono::seconds window, bool per_thread);
+};
+
+} // namespace Profiler
+} // namespace Envoy
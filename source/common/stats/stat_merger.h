@@ -33,6 +33,16 @@ public:
      */
     StatName makeDynamicStatName(const std::string& name, const DynamicsMap& map);
 
+    /**
+     * Generates a StatName with mixed dynamic/symbolic components based on
+     * the string and its dynamic spans.
+     *
+     * @param name The string corresponding to the desired StatName.
+     * @param dynamic_spans the spans of tokens in the stat-name which are dynamic.
+     * @return the generated StatName, valid as long as the DynamicContext.
+     */
+    StatName makeDynamicStatName(absl::string_view name, const DynamicSpans& dynamic_spans);
+
   private:
     SymbolTable& symbol_table_;
     StatNamePool symbolic_pool_;
@@ -48,11 +58,17 @@ public:
                   const Protobuf::Map<std::string, uint64_t>& gauges,
                   const DynamicsMap& dynamics = DynamicsMap());
 
+  // Merge a single counter delta or gauge value, along with the dynamic spans of its name. Used
+  // to merge stats which do not come in protobuf maps, e.g. from a snapshot in shared memory.
+  void mergeCounter(absl::string_view name, uint64_t delta, const DynamicSpans& dynamic_spans);
+  void mergeGauge(absl::string_view name, uint64_t value, const DynamicSpans& dynamic_spans);
+
 private:
   void mergeCounters(const Protobuf::Map<std::string, uint64_t>& counter_deltas,
                      const DynamicsMap& dynamics_map);
   void mergeGauges(const Protobuf::Map<std::string, uint64_t>& gauges,
                    const DynamicsMap& dynamics_map);
+  void mergeGaugeValue(StatName stat_name, uint64_t value);
 
   StatNameHashMap<uint64_t> parent_gauge_values_;
   // A stats Scope for our in-the-merging-process counters to live in. Scopes conceptually hold
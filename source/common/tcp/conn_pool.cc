@@ -1,5 +1,6 @@
 #include "common/tcp/conn_pool.h"
 
+#include <cmath>
 #include <memory>
 
 #include "envoy/event/dispatcher.h"
@@ -21,6 +22,8 @@ ConnPoolImpl::ConnPoolImpl(Event::Dispatcher& dispatcher, Upstream::HostConstSha
       upstream_ready_timer_(dispatcher_.createTimer([this]() { onUpstreamReady(); })) {}
 
 ConnPoolImpl::~ConnPoolImpl() {
+  // The connections closed here must not be replaced by prefetched ones.
+  destructing_ = true;
   while (!ready_conns_.empty()) {
     ready_conns_.front()->conn_->close(Network::ConnectionCloseType::NoFlush);
   }
@@ -38,6 +41,8 @@ ConnPoolImpl::~ConnPoolImpl() {
 }
 
 void ConnPoolImpl::drainConnections() {
+  // Neither the closed connections nor the draining ones are replaced until there is demand again.
+  connections_drained_ = true;
   while (!ready_conns_.empty()) {
     ready_conns_.front()->conn_->close(Network::ConnectionCloseType::NoFlush);
   }
@@ -61,6 +66,10 @@ void ConnPoolImpl::addDrainedCallback(DrainedCb cb) {
 void ConnPoolImpl::assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks) {
   ASSERT(conn.wrapper_ == nullptr);
   conn.wrapper_ = std::make_shared<ConnectionWrapper>(conn);
+  if (conn.prefetched_) {
+    conn.prefetched_ = false;
+    host_->cluster().stats().upstream_cx_prefetch_hit_.inc();
+  }
 
   callbacks.onPoolReady(std::make_unique<ConnectionDataImpl>(conn.wrapper_),
                         conn.real_host_description_);
@@ -79,17 +88,55 @@ void ConnPoolImpl::checkForDrained() {
   }
 }
 
-void ConnPoolImpl::createNewConnection() {
+ConnPoolImpl::ActiveConn& ConnPoolImpl::createNewConnection() {
   ENVOY_LOG(debug, "creating a new connection");
   ActiveConnPtr conn(new ActiveConn(*this));
   conn->moveIntoList(std::move(conn), pending_conns_);
+  return *pending_conns_.front();
+}
+
+void ConnPoolImpl::prefetchConnections() {
+  while (shouldPrefetch()) {
+    if (!host_->cluster().resourceManager(priority_).connections().canCreate()) {
+      // Prefetching is best effort, so running into the circuit breaker is not an overflow.
+      return;
+    }
+    host_->cluster().stats().upstream_cx_prefetch_.inc();
+    createNewConnection().prefetched_ = true;
+  }
+}
+
+bool ConnPoolImpl::shouldPrefetch() const {
+  const float ratio = host_->cluster().perUpstreamPrefetchRatio();
+  const uint32_t min_idle_connections = host_->cluster().prefetchMinIdleConnections();
+  // A draining pool is about to go away, so it must not open any more connections.
+  if ((ratio <= 1.0 && min_idle_connections == 0) || !drained_callbacks_.empty() || destructing_ ||
+      connections_drained_) {
+    return false;
+  }
+
+  // Every connection serves a single request at a time, so the demand is the number of assigned
+  // and pending requests, and pending connections count as idle unless a request waits for them.
+  const uint64_t demand = pending_requests_.size() + busy_conns_.size();
+  const uint64_t connections = pending_conns_.size() + ready_conns_.size() + busy_conns_.size();
+  if (ratio > 1.0 && connections < static_cast<uint64_t>(std::ceil(demand * ratio))) {
+    return true;
+  }
+
+  const uint64_t idle_connections =
+      ready_conns_.size() + (pending_conns_.size() > pending_requests_.size()
+                                 ? pending_conns_.size() - pending_requests_.size()
+                                 : 0);
+  return idle_connections < min_idle_connections;
 }
 
 ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbacks& callbacks) {
+  connections_drained_ = false;
   if (!ready_conns_.empty()) {
     ready_conns_.front()->moveBetweenLists(ready_conns_, busy_conns_);
     ENVOY_CONN_LOG(debug, "using existing connection", *busy_conns_.front()->conn_);
     assignConnection(*busy_conns_.front(), callbacks);
+    prefetchConnections();
     return nullptr;
   }
 
@@ -109,7 +156,11 @@ ConnectionPool::Cancellable* ConnPoolImpl::newConnection(ConnectionPool::Callbac
     ENVOY_LOG(debug, "queueing request due to no available connections");
     PendingRequestPtr pending_request(new PendingRequest(*this, callbacks));
     pending_request->moveIntoList(std::move(pending_request), pending_requests_);
-    return pending_requests_.front().get();
+    ConnectionPool::Cancellable* pending = pending_requests_.front().get();
+
+    // This must come after queueing the request, so that the request counts towards the demand.
+    prefetchConnections();
+    return pending;
   } else {
     ENVOY_LOG(debug, "max pending requests overflow");
     callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, nullptr);
@@ -124,9 +175,14 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
     ENVOY_CONN_LOG(debug, "client disconnected", *conn.conn_);
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (conn.prefetched_) {
+      // The connection was created ahead of demand that never came.
+      host_->cluster().stats().upstream_cx_prefetch_miss_.inc();
+    }
 
     ActiveConnPtr removed;
     bool check_for_drained = true;
+    bool connect_failed = false;
     if (conn.wrapper_ != nullptr) {
       if (!conn.wrapper_->released_) {
         Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -142,6 +198,7 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
       check_for_drained = false;
     } else {
       // The only time this happens is if we actually saw a connect failure.
+      connect_failed = true;
       host_->cluster().stats().upstream_cx_connect_fail_.inc();
       host_->stats().cx_connect_fail_.inc();
       removed = conn.removeFromList(pending_conns_);
@@ -178,6 +235,11 @@ void ConnPoolImpl::onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent
         (ready_conns_.size() + busy_conns_.size() + pending_conns_.size())) {
       createNewConnection();
     }
+    // Replace the lost connection ahead of demand. Connections which failed to connect are not
+    // replaced, so that an unreachable upstream is not connected to in a tight loop.
+    if (!connect_failed) {
+      prefetchConnections();
+    }
 
     if (check_for_drained) {
       checkForDrained();
@@ -232,6 +294,7 @@ void ConnPoolImpl::onConnReleased(ActiveConn& conn) {
     // https://github.com/envoyproxy/envoy/issues/2715
     processIdleConnection(conn, false, true);
   }
+  prefetchConnections();
 }
 
 void ConnPoolImpl::onConnDestroyed(ActiveConn& conn) {
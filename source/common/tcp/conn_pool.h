@@ -117,6 +117,8 @@ protected:
     Stats::TimespanPtr conn_length_;
     uint64_t remaining_requests_;
     bool timed_out_;
+    // Whether the connection was created ahead of demand and has not been assigned yet.
+    bool prefetched_{false};
   };
 
   using ActiveConnPtr = std::unique_ptr<ActiveConn>;
@@ -137,7 +139,9 @@ protected:
   using PendingRequestPtr = std::unique_ptr<PendingRequest>;
 
   void assignConnection(ActiveConn& conn, ConnectionPool::Callbacks& callbacks);
-  void createNewConnection();
+  ActiveConn& createNewConnection();
+  void prefetchConnections();
+  bool shouldPrefetch() const;
   void onConnectionEvent(ActiveConn& conn, Network::ConnectionEvent event);
   void onPendingRequestCancel(PendingRequest& request, ConnectionPool::CancelPolicy cancel_policy);
   virtual void onConnReleased(ActiveConn& conn);
@@ -160,6 +164,11 @@ protected:
   Stats::TimespanPtr conn_connect_ms_;
   Event::TimerPtr upstream_ready_timer_;
   bool upstream_ready_enabled_{false};
+  // Set once the pool closes all of its connections on destruction, so that none are prefetched.
+  bool destructing_{false};
+  // Set when the connections are drained, so that they are not replaced by prefetched ones until
+  // the next request asks for a connection again.
+  bool connections_drained_{false};
 };
 
 } // namespace Tcp
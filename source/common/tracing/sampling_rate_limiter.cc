@@ -0,0 +1,25 @@
+#include "common/tracing/sampling_rate_limiter.h"
+
+#include <chrono>
+
+namespace Envoy {
+namespace Tracing {
+
+SamplingRateLimiter::SamplingRateLimiter(uint32_t max_per_second, TimeSource& time_source)
+    : max_per_second_(max_per_second), time_source_(time_source) {}
+
+bool SamplingRateLimiter::trySample() {
+  const uint64_t now = std::chrono::duration_cast<std::chrono::seconds>(
+                           time_source_.monotonicTime().time_since_epoch())
+                           .count();
+  uint64_t second = current_second_.load(std::memory_order_relaxed);
+  if (second != now && current_second_.compare_exchange_strong(second, now)) {
+    // Whoever moves the limiter to a new second resets the budget. Callers racing with the reset
+    // may still be charged to the previous second.
+    sampled_.store(0, std::memory_order_relaxed);
+  }
+  return sampled_.fetch_add(1, std::memory_order_relaxed) < max_per_second_;
+}
+
+} // namespace Tracing
+} // namespace Envoy
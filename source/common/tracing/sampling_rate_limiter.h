@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "envoy/common/time.h"
+
+namespace Envoy {
+namespace Tracing {
+
+/**
+ * Caps the number of traces started per second. A single limiter is shared by all workers of a
+ * connection manager, so the budget is enforced with atomics rather than a lock. The limit is
+ * approximate around the turn of a second.
+ */
+class SamplingRateLimiter {
+public:
+  SamplingRateLimiter(uint32_t max_per_second, TimeSource& time_source);
+
+  /**
+   * @return bool whether another trace fits into the budget of the current second.
+   */
+  bool trySample();
+
+private:
+  const uint32_t max_per_second_;
+  TimeSource& time_source_;
+  std::atomic<uint64_t> current_second_{0};
+  std::atomic<uint32_t> sampled_{0};
+};
+
+using SamplingRateLimiterSharedPtr = std::shared_ptr<SamplingRateLimiter>;
+
+} // namespace Tracing
+} // namespace Envoy
@@ -563,6 +563,8 @@ public:
   bool maintenanceMode() const override;
   uint64_t maxRequestsPerConnection() const override { return max_requests_per_connection_; }
   uint32_t maxResponseHeadersCount() const override { return max_response_headers_count_; }
+  float perUpstreamPrefetchRatio() const override { return per_upstream_prefetch_ratio_; }
+  uint32_t prefetchMinIdleConnections() const override { return prefetch_min_idle_connections_; }
   const std::string& name() const override { return name_; }
   ResourceManager& resourceManager(ResourcePriority priority) const override;
   TransportSocketMatcher& transportSocketMatcher() const override { return *socket_matcher_; }
@@ -615,6 +617,8 @@ private:
   const envoy::config::cluster::v3::Cluster::DiscoveryType type_;
   const uint64_t max_requests_per_connection_;
   const uint32_t max_response_headers_count_;
+  const float per_upstream_prefetch_ratio_;
+  const uint32_t prefetch_min_idle_connections_;
   const std::chrono::milliseconds connect_timeout_;
   absl::optional<std::chrono::milliseconds> idle_timeout_;
   const uint32_t per_connection_buffer_limit_bytes_;
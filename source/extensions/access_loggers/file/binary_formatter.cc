@@ -0,0 +1,64 @@
+#include "extensions/access_loggers/file/binary_formatter.h"
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/grpc/grpc_access_log_utils.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+BinaryFormatterImpl::BinaryFormatterImpl(
+    const envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat& config) {
+  *common_config_.mutable_filter_state_objects_to_log() = config.filter_state_objects_to_log();
+
+  for (const auto& header : config.additional_request_headers_to_log()) {
+    request_headers_to_log_.emplace_back(header);
+  }
+
+  for (const auto& header : config.additional_response_headers_to_log()) {
+    response_headers_to_log_.emplace_back(header);
+  }
+
+  for (const auto& header : config.additional_response_trailers_to_log()) {
+    response_trailers_to_log_.emplace_back(header);
+  }
+}
+
+std::string BinaryFormatterImpl::format(const Http::RequestHeaderMap& request_headers,
+                                        const Http::ResponseHeaderMap& response_headers,
+                                        const Http::ResponseTrailerMap& response_trailers,
+                                        const StreamInfo::StreamInfo& stream_info) const {
+  std::string log_entry;
+  formatTo(request_headers, response_headers, response_trailers, stream_info, log_entry);
+  return log_entry;
+}
+
+void BinaryFormatterImpl::formatTo(const Http::RequestHeaderMap& request_headers,
+                                   const Http::ResponseHeaderMap& response_headers,
+                                   const Http::ResponseTrailerMap& response_trailers,
+                                   const StreamInfo::StreamInfo& stream_info,
+                                   std::string& output) const {
+  envoy::data::accesslog::v3::HTTPAccessLogEntry log_entry;
+  GrpcCommon::Utility::extractHttpAccessLogEntry(
+      log_entry, request_headers, response_headers, response_trailers, stream_info, common_config_,
+      request_headers_to_log_, response_headers_to_log_, response_trailers_to_log_);
+
+  // Serialize the length prefix and the entry straight into the output, without an intermediate
+  // string.
+  const uint32_t entry_size = log_entry.ByteSizeLong();
+  const size_t prefix_size = Protobuf::io::CodedOutputStream::VarintSize32(entry_size);
+  const size_t start = output.size();
+  output.resize(start + prefix_size + entry_size);
+  uint8_t* data = reinterpret_cast<uint8_t*>(&output[start]);
+  data = Protobuf::io::CodedOutputStream::WriteVarint32ToArray(entry_size, data);
+  log_entry.SerializeWithCachedSizesToArray(data);
+}
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "envoy/access_log/access_log.h"
+#include "envoy/extensions/access_loggers/file/v3/file.pb.h"
+#include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
+#include "envoy/http/header_map.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+
+/**
+ * Formatter which renders each log entry as a varint length prefixed, serialized
+ * envoy::data::accesslog::v3::HTTPAccessLogEntry. The output is not text and is meant to be read
+ * back with ParseDelimitedFromZeroCopyStream() or the access_log_reader tool.
+ */
+class BinaryFormatterImpl : public AccessLog::Formatter {
+public:
+  BinaryFormatterImpl(
+      const envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat& config);
+
+  // AccessLog::Formatter
+  std::string format(const Http::RequestHeaderMap& request_headers,
+                     const Http::ResponseHeaderMap& response_headers,
+                     const Http::ResponseTrailerMap& response_trailers,
+                     const StreamInfo::StreamInfo& stream_info) const override;
+  void formatTo(const Http::RequestHeaderMap& request_headers,
+                const Http::ResponseHeaderMap& response_headers,
+                const Http::ResponseTrailerMap& response_trailers,
+                const StreamInfo::StreamInfo& stream_info, std::string& output) const override;
+
+private:
+  // Only filter_state_objects_to_log is used, when extracting the common log properties.
+  envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig common_config_;
+  std::vector<Http::LowerCaseString> request_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_headers_to_log_;
+  std::vector<Http::LowerCaseString> response_trailers_to_log_;
+};
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -12,6 +12,7 @@
 #include "common/common/logger.h"
 #include "common/protobuf/protobuf.h"
 
+#include "extensions/access_loggers/file/binary_formatter.h"
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 #include "extensions/access_loggers/well_known_names.h"
 
@@ -49,10 +50,14 @@ FileAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config,
                  kTypedJsonFormat) {
     auto json_format_map = this->convertJsonFormatToMap(fal_config.typed_json_format());
     formatter = std::make_unique<AccessLog::JsonFormatterImpl>(json_format_map, true);
+  } else if (fal_config.access_log_format_case() ==
+             envoy::extensions::access_loggers::file::v3::FileAccessLog::AccessLogFormatCase::
+                 kBinaryFormat) {
+    formatter = std::make_unique<BinaryFormatterImpl>(fal_config.binary_format());
   } else {
     throw EnvoyException(
-        "Invalid access_log format provided. Only 'format', 'json_format', or 'typed_json_format' "
-        "are supported.");
+        "Invalid access_log format provided. Only 'format', 'json_format', 'typed_json_format', or "
+        "'binary_format' are supported.");
   }
 
   return std::make_shared<FileAccessLog>(fal_config.path(), std::move(filter), std::move(formatter),
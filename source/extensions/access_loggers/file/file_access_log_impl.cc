@@ -16,8 +16,12 @@ void FileAccessLog::emitLog(const Http::RequestHeaderMap& request_headers,
                             const Http::ResponseHeaderMap& response_headers,
                             const Http::ResponseTrailerMap& response_trailers,
                             const StreamInfo::StreamInfo& stream_info) {
-  log_file_->write(
-      formatter_->format(request_headers, response_headers, response_trailers, stream_info));
+  // The log line is reused across calls on the same thread so that formatting does not allocate
+  // once the buffer has grown to the typical line length. AccessLogFile::write() copies the data.
+  static thread_local std::string log_line;
+  log_line.clear();
+  formatter_->formatTo(request_headers, response_headers, response_trailers, stream_info, log_line);
+  log_file_->write(log_line);
 }
 
 } // namespace File
@@ -1,7 +1,10 @@
 #include "extensions/access_loggers/grpc/config_utils.h"
 
+#include "envoy/common/exception.h"
 #include "envoy/singleton/manager.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
@@ -16,9 +19,20 @@ getGrpcAccessLoggerCacheSingleton(Server::Configuration::FactoryContext& context
       SINGLETON_MANAGER_REGISTERED_NAME(grpc_access_logger_cache), [&context] {
         return std::make_shared<GrpcCommon::GrpcAccessLoggerCacheImpl>(
             context.clusterManager().grpcAsyncClientManager(), context.scope(),
-            context.threadLocal(), context.localInfo());
+            context.threadLocal(), context.localInfo(), context.dispatcher());
       });
 }
+
+void validateCommonConfig(
+    const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config) {
+  // Only the Google gRPC client compresses messages.
+  if (config.message_compression() !=
+          envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::NONE &&
+      !config.grpc_service().has_google_grpc()) {
+    throw EnvoyException(absl::StrCat("gRPC access log '", config.log_name(),
+                                      "': message_compression requires google_grpc"));
+  }
+}
 } // namespace GrpcCommon
 } // namespace AccessLoggers
 } // namespace Extensions
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
 #include "envoy/server/filter_config.h"
 
 #include "extensions/access_loggers/grpc/grpc_access_log_impl.h"
@@ -12,6 +13,13 @@ namespace GrpcCommon {
 GrpcAccessLoggerCacheSharedPtr
 getGrpcAccessLoggerCacheSingleton(Server::Configuration::FactoryContext& context);
 
+/**
+ * Validate the parts of the common gRPC access log configuration that proto validation cannot
+ * express. Throws EnvoyException on an invalid configuration.
+ */
+void validateCommonConfig(
+    const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config);
+
 } // namespace GrpcCommon
 } // namespace AccessLoggers
 } // namespace Extensions
@@ -5,14 +5,62 @@
 #include "envoy/upstream/upstream.h"
 
 #include "common/common/assert.h"
+#include "common/common/macros.h"
 #include "common/network/utility.h"
 #include "common/stream_info/utility.h"
 
+#include "absl/strings/str_cat.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
+namespace {
+
+using CommonGrpcAccessLogConfig =
+    envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig;
+
+// Request metadata read by the Google gRPC client to select the message compression algorithm.
+const Http::LowerCaseString& compressionRequestHeader() {
+  CONSTRUCT_ON_FIRST_USE(Http::LowerCaseString, "grpc-internal-encoding-request");
+}
+
+std::chrono::milliseconds bufferFlushInterval(const CommonGrpcAccessLogConfig& config) {
+  return std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000));
+}
+
+uint64_t bufferSizeBytes(const CommonGrpcAccessLogConfig& config) {
+  return PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384);
+}
+
+std::unique_ptr<GrpcAccessLoggerImpl>
+createLogger(const CommonGrpcAccessLogConfig& config,
+             Grpc::AsyncClientManager& async_client_manager, Stats::Scope& scope,
+             Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info) {
+  const Grpc::AsyncClientFactoryPtr factory =
+      async_client_manager.factoryForGrpcService(config.grpc_service(), scope, false);
+  return std::make_unique<GrpcAccessLoggerImpl>(
+      factory->create(), config.log_name(), bufferFlushInterval(config), bufferSizeBytes(config),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_pending_bytes, 1024 * 1024),
+      config.overflow_policy(), config.message_compression(), dispatcher, local_info, scope);
+}
+
+} // namespace
+
+void GrpcAccessLoggerImpl::LocalStream::onCreateInitialMetadata(Http::RequestHeaderMap& metadata) {
+  switch (parent_.message_compression_) {
+  case CommonGrpcAccessLogConfig::GZIP:
+    metadata.addReferenceKey(compressionRequestHeader(), "gzip");
+    break;
+  case CommonGrpcAccessLogConfig::DEFLATE:
+    metadata.addReferenceKey(compressionRequestHeader(), "deflate");
+    break;
+  default:
+    break;
+  }
+}
+
 void GrpcAccessLoggerImpl::LocalStream::onRemoteClose(Grpc::Status::GrpcStatus,
                                                       const std::string&) {
   ASSERT(parent_.stream_ != absl::nullopt);
@@ -25,31 +73,51 @@ void GrpcAccessLoggerImpl::LocalStream::onRemoteClose(Grpc::Status::GrpcStatus,
 
 GrpcAccessLoggerImpl::GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std::string log_name,
                                            std::chrono::milliseconds buffer_flush_interval_msec,
-                                           uint64_t buffer_size_bytes,
+                                           uint64_t buffer_size_bytes, uint64_t max_pending_bytes,
+                                           OverflowPolicy overflow_policy,
+                                           MessageCompression message_compression,
                                            Event::Dispatcher& dispatcher,
-                                           const LocalInfo::LocalInfo& local_info)
-    : client_(std::move(client)), log_name_(log_name),
+                                           const LocalInfo::LocalInfo& local_info,
+                                           Stats::Scope& scope)
+    : scope_(scope.createScope(absl::StrCat("access_logs.grpc_access_log.", log_name, "."))),
+      stats_({ALL_GRPC_ACCESS_LOGGER_STATS(POOL_COUNTER(*scope_))}), client_(std::move(client)),
+      log_name_(log_name),
       buffer_flush_interval_msec_(buffer_flush_interval_msec),
       flush_timer_(dispatcher.createTimer([this]() {
         flush();
         flush_timer_->enableTimer(buffer_flush_interval_msec_);
       })),
-      buffer_size_bytes_(buffer_size_bytes), local_info_(local_info) {
+      buffer_size_bytes_(buffer_size_bytes), max_pending_bytes_(max_pending_bytes),
+      overflow_policy_(overflow_policy), message_compression_(message_compression),
+      local_info_(local_info) {
   flush_timer_->enableTimer(buffer_flush_interval_msec_);
 }
 
-void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) {
-  approximate_message_size_bytes_ += entry.ByteSizeLong();
-  message_.mutable_http_logs()->mutable_log_entry()->Add(std::move(entry));
-  if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
-    flush();
+void GrpcAccessLoggerImpl::log(envoy::service::accesslog::v3::StreamAccessLogsMessage&& batch) {
+  for (auto& entry : *batch.mutable_http_logs()->mutable_log_entry()) {
+    log(std::move(entry));
+  }
+  for (auto& entry : *batch.mutable_tcp_logs()->mutable_log_entry()) {
+    log(std::move(entry));
   }
 }
 
+void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) {
+  addEntry(*message_.mutable_http_logs()->mutable_log_entry(), std::move(entry));
+}
+
 void GrpcAccessLoggerImpl::log(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) {
+  addEntry(*message_.mutable_tcp_logs()->mutable_log_entry(), std::move(entry));
+}
+
+template <class Entry>
+void GrpcAccessLoggerImpl::addEntry(Protobuf::RepeatedPtrField<Entry>& entries, Entry&& entry) {
   approximate_message_size_bytes_ += entry.ByteSizeLong();
-  message_.mutable_tcp_logs()->mutable_log_entry()->Add(std::move(entry));
-  if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
+  entries.Add(std::move(entry));
+  if (stream_start_failed_) {
+    // Do not retry the stream for every entry; the flush timer will.
+    trimPendingEntries(entries);
+  } else if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
     flush();
   }
 }
@@ -76,23 +144,136 @@ void GrpcAccessLoggerImpl::flush() {
   }
 
   if (stream_->stream_ != nullptr) {
+    stream_start_failed_ = false;
     stream_->stream_->sendMessage(message_, false);
+    stats_.logs_written_.add(pendingEntries());
   } else {
-    // Clear out the stream data due to stream creation failure.
+    // Clear out the stream data due to stream creation failure and keep what fits of the pending
+    // entries for the next attempt.
     stream_.reset();
+    stream_start_failed_ = true;
+    trimPendingEntries();
+    if (pendingEntries() > 0) {
+      return;
+    }
   }
 
-  // Clear the message regardless of the success.
   approximate_message_size_bytes_ = 0;
   message_.Clear();
 }
 
+int GrpcAccessLoggerImpl::pendingEntries() const {
+  return message_.http_logs().log_entry_size() + message_.tcp_logs().log_entry_size();
+}
+
+void GrpcAccessLoggerImpl::trimPendingEntries() {
+  if (message_.has_http_logs()) {
+    trimPendingEntries(*message_.mutable_http_logs()->mutable_log_entry());
+  }
+  if (message_.has_tcp_logs()) {
+    trimPendingEntries(*message_.mutable_tcp_logs()->mutable_log_entry());
+  }
+}
+
+template <class Entry>
+void GrpcAccessLoggerImpl::trimPendingEntries(Protobuf::RepeatedPtrField<Entry>& entries) {
+  if (overflow_policy_ == CommonGrpcAccessLogConfig::SAMPLE) {
+    // Halve the pending entries, keeping every other one, until the rest fit.
+    const int pending = entries.size();
+    while (approximate_message_size_bytes_ > max_pending_bytes_ && !entries.empty()) {
+      int kept = 0;
+      for (int i = 0; i < entries.size(); ++i) {
+        if (i % 2 == 1 || entries.size() == 1) {
+          approximate_message_size_bytes_ -= entries.Get(i).ByteSizeLong();
+          continue;
+        }
+        entries.SwapElements(kept++, i);
+      }
+      entries.DeleteSubrange(kept, entries.size() - kept);
+    }
+    stats_.logs_dropped_.add(pending - entries.size());
+    return;
+  }
+
+  const bool drop_oldest = overflow_policy_ == CommonGrpcAccessLogConfig::DROP_OLDEST;
+  int dropped = 0;
+  while (approximate_message_size_bytes_ > max_pending_bytes_ && dropped < entries.size()) {
+    const int index = drop_oldest ? dropped : entries.size() - 1 - dropped;
+    approximate_message_size_bytes_ -= entries.Get(index).ByteSizeLong();
+    ++dropped;
+  }
+  if (dropped == 0) {
+    return;
+  }
+  entries.DeleteSubrange(drop_oldest ? 0 : entries.size() - dropped, dropped);
+  stats_.logs_dropped_.add(dropped);
+}
+
+SharedStreamGrpcAccessLogger::SharedStreamGrpcAccessLogger(
+    SharedLoggerSharedPtr shared_logger, std::chrono::milliseconds buffer_flush_interval_msec,
+    uint64_t buffer_size_bytes, Event::Dispatcher& dispatcher,
+    Event::Dispatcher& main_thread_dispatcher)
+    : shared_logger_(std::move(shared_logger)),
+      buffer_flush_interval_msec_(buffer_flush_interval_msec),
+      flush_timer_(dispatcher.createTimer([this]() {
+        flush();
+        flush_timer_->enableTimer(buffer_flush_interval_msec_);
+      })),
+      buffer_size_bytes_(buffer_size_bytes), main_thread_dispatcher_(main_thread_dispatcher) {
+  flush_timer_->enableTimer(buffer_flush_interval_msec_);
+}
+
+SharedStreamGrpcAccessLogger::~SharedStreamGrpcAccessLogger() {
+  // The shared logger owns a timer of the main thread, so make sure it is released there.
+  main_thread_dispatcher_.post([shared_logger = shared_logger_]() {});
+}
+
+void SharedStreamGrpcAccessLogger::SharedLogger::log(
+    envoy::service::accesslog::v3::StreamAccessLogsMessage&& batch) {
+  if (logger_ == nullptr) {
+    logger_ = factory_();
+  }
+  logger_->log(std::move(batch));
+}
+
+void SharedStreamGrpcAccessLogger::log(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) {
+  addEntry(*message_.mutable_http_logs()->mutable_log_entry(), std::move(entry));
+}
+
+void SharedStreamGrpcAccessLogger::log(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) {
+  addEntry(*message_.mutable_tcp_logs()->mutable_log_entry(), std::move(entry));
+}
+
+template <class Entry>
+void SharedStreamGrpcAccessLogger::addEntry(Protobuf::RepeatedPtrField<Entry>& entries,
+                                            Entry&& entry) {
+  approximate_message_size_bytes_ += entry.ByteSizeLong();
+  entries.Add(std::move(entry));
+  if (approximate_message_size_bytes_ >= buffer_size_bytes_) {
+    flush();
+  }
+}
+
+void SharedStreamGrpcAccessLogger::flush() {
+  if (!message_.has_http_logs() && !message_.has_tcp_logs()) {
+    // Nothing to flush.
+    return;
+  }
+
+  auto batch = std::make_shared<envoy::service::accesslog::v3::StreamAccessLogsMessage>();
+  batch->Swap(&message_);
+  approximate_message_size_bytes_ = 0;
+  main_thread_dispatcher_.post(
+      [shared_logger = shared_logger_, batch]() { shared_logger->log(std::move(*batch)); });
+}
+
 GrpcAccessLoggerCacheImpl::GrpcAccessLoggerCacheImpl(Grpc::AsyncClientManager& async_client_manager,
                                                      Stats::Scope& scope,
                                                      ThreadLocal::SlotAllocator& tls,
-                                                     const LocalInfo::LocalInfo& local_info)
+                                                     const LocalInfo::LocalInfo& local_info,
+                                                     Event::Dispatcher& main_thread_dispatcher)
     : async_client_manager_(async_client_manager), scope_(scope), tls_slot_(tls.allocateSlot()),
-      local_info_(local_info) {
+      local_info_(local_info), main_thread_dispatcher_(main_thread_dispatcher) {
   tls_slot_->set(
       [](Event::Dispatcher& dispatcher) { return std::make_shared<ThreadLocalCache>(dispatcher); });
 }
@@ -107,17 +288,36 @@ GrpcAccessLoggerSharedPtr GrpcAccessLoggerCacheImpl::getOrCreateLogger(
   if (it != cache.access_loggers_.end()) {
     return it->second;
   }
-  const Grpc::AsyncClientFactoryPtr factory =
-      async_client_manager_.factoryForGrpcService(config.grpc_service(), scope_, false);
-  const GrpcAccessLoggerSharedPtr logger = std::make_shared<GrpcAccessLoggerImpl>(
-      factory->create(), config.log_name(),
-      std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, buffer_flush_interval, 1000)),
-      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, buffer_size_bytes, 16384), cache.dispatcher_,
-      local_info_);
+  GrpcAccessLoggerSharedPtr logger;
+  if (config.share_stream_across_workers()) {
+    logger = std::make_shared<SharedStreamGrpcAccessLogger>(
+        getOrCreateSharedLogger(config, cache_key), bufferFlushInterval(config),
+        bufferSizeBytes(config), cache.dispatcher_, main_thread_dispatcher_);
+  } else {
+    logger = createLogger(config, async_client_manager_, scope_, cache.dispatcher_, local_info_);
+  }
   cache.access_loggers_.emplace(cache_key, logger);
   return logger;
 }
 
+SharedStreamGrpcAccessLogger::SharedLoggerSharedPtr
+GrpcAccessLoggerCacheImpl::getOrCreateSharedLogger(
+    const CommonGrpcAccessLogConfig& config,
+    const std::pair<std::size_t, GrpcAccessLoggerType>& cache_key) {
+  absl::MutexLock lock(&shared_loggers_lock_);
+  auto& shared_logger = shared_loggers_[cache_key];
+  if (shared_logger == nullptr) {
+    // The logger is created on the main thread by the first batch posted to it. Only objects that
+    // outlive the workers are captured, as batches may still be in flight when the cache is gone.
+    shared_logger = std::make_shared<SharedStreamGrpcAccessLogger::SharedLogger>(
+        [config, &async_client_manager = async_client_manager_, &scope = scope_,
+         &dispatcher = main_thread_dispatcher_, &local_info = local_info_]() {
+          return createLogger(config, async_client_manager, scope, dispatcher, local_info);
+        });
+  }
+  return shared_logger;
+}
+
 } // namespace GrpcCommon
 } // namespace AccessLoggers
 } // namespace Extensions
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <unordered_map>
 #include <vector>
 
@@ -10,18 +11,34 @@
 #include "envoy/local_info/local_info.h"
 #include "envoy/service/accesslog/v3/als.pb.h"
 #include "envoy/singleton/instance.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/grpc/typed_async_client.h"
 
 #include "extensions/access_loggers/common/access_log_base.h"
 
+#include "absl/synchronization/mutex.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace AccessLoggers {
 namespace GrpcCommon {
 
-// TODO(mattklein123): Stats
+/**
+ * All stats for the gRPC access logger. @see stats_macros.h
+ */
+#define ALL_GRPC_ACCESS_LOGGER_STATS(COUNTER)                                                      \
+  COUNTER(logs_written)                                                                            \
+  COUNTER(logs_dropped)
+
+/**
+ * Wrapper struct for gRPC access logger stats. @see stats_macros.h
+ */
+struct GrpcAccessLoggerStats {
+  ALL_GRPC_ACCESS_LOGGER_STATS(GENERATE_COUNTER_STRUCT)
+};
 
 /**
  * Interface for an access logger. The logger provides abstraction on top of gRPC stream, deals with
@@ -70,10 +87,23 @@ using GrpcAccessLoggerCacheSharedPtr = std::shared_ptr<GrpcAccessLoggerCache>;
 
 class GrpcAccessLoggerImpl : public GrpcAccessLogger {
 public:
+  using OverflowPolicy =
+      envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::OverflowPolicy;
+  using MessageCompression =
+      envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::MessageCompression;
+
   GrpcAccessLoggerImpl(Grpc::RawAsyncClientPtr&& client, std::string log_name,
                        std::chrono::milliseconds buffer_flush_interval_msec,
-                       uint64_t buffer_size_bytes, Event::Dispatcher& dispatcher,
-                       const LocalInfo::LocalInfo& local_info);
+                       uint64_t buffer_size_bytes, uint64_t max_pending_bytes,
+                       OverflowPolicy overflow_policy, MessageCompression message_compression,
+                       Event::Dispatcher& dispatcher, const LocalInfo::LocalInfo& local_info,
+                       Stats::Scope& scope);
+
+  /**
+   * Log all entries of a batch collected by another logger.
+   * @param batch supplies the entries to log. The identifier is ignored.
+   */
+  void log(envoy::service::accesslog::v3::StreamAccessLogsMessage&& batch);
 
   // Extensions::AccessLoggers::GrpcCommon::GrpcAccessLogger
   void log(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) override;
@@ -85,7 +115,7 @@ private:
     LocalStream(GrpcAccessLoggerImpl& parent) : parent_(parent) {}
 
     // Grpc::AsyncStreamCallbacks
-    void onCreateInitialMetadata(Http::RequestHeaderMap&) override {}
+    void onCreateInitialMetadata(Http::RequestHeaderMap& metadata) override;
     void onReceiveInitialMetadata(Http::ResponseHeaderMapPtr&&) override {}
     void onReceiveMessage(
         std::unique_ptr<envoy::service::accesslog::v3::StreamAccessLogsResponse>&&) override {}
@@ -96,8 +126,16 @@ private:
     Grpc::AsyncStream<envoy::service::accesslog::v3::StreamAccessLogsMessage> stream_{};
   };
 
+  template <class Entry>
+  void addEntry(Protobuf::RepeatedPtrField<Entry>& entries, Entry&& entry);
   void flush();
+  int pendingEntries() const;
+  // Discards pending entries beyond max_pending_bytes_ according to overflow_policy_.
+  void trimPendingEntries();
+  template <class Entry> void trimPendingEntries(Protobuf::RepeatedPtrField<Entry>& entries);
 
+  const Stats::ScopePtr scope_;
+  GrpcAccessLoggerStats stats_;
   Grpc::AsyncClient<envoy::service::accesslog::v3::StreamAccessLogsMessage,
                     envoy::service::accesslog::v3::StreamAccessLogsResponse>
       client_;
@@ -105,17 +143,73 @@ private:
   const std::chrono::milliseconds buffer_flush_interval_msec_;
   const Event::TimerPtr flush_timer_;
   const uint64_t buffer_size_bytes_;
+  const uint64_t max_pending_bytes_;
+  const OverflowPolicy overflow_policy_;
+  const MessageCompression message_compression_;
   uint64_t approximate_message_size_bytes_ = 0;
+  // Set when the last attempt to start a stream failed. Entries are then held, within
+  // max_pending_bytes_, until the flush timer retries the stream.
+  bool stream_start_failed_{};
   envoy::service::accesslog::v3::StreamAccessLogsMessage message_;
   absl::optional<LocalStream> stream_;
   const LocalInfo::LocalInfo& local_info_;
 };
 
+/**
+ * Access logger used by worker threads when the stream is shared across workers. Entries are
+ * batched on the worker and each batch is handed to a single GrpcAccessLoggerImpl owned by the
+ * main thread.
+ */
+class SharedStreamGrpcAccessLogger : public GrpcAccessLogger {
+public:
+  /**
+   * The logger shared by all workers. It is created lazily on the main thread by the first batch
+   * posted to it and is only ever accessed from the main thread.
+   */
+  class SharedLogger {
+  public:
+    using LoggerFactory = std::function<std::unique_ptr<GrpcAccessLoggerImpl>()>;
+
+    SharedLogger(LoggerFactory factory) : factory_(std::move(factory)) {}
+
+    void log(envoy::service::accesslog::v3::StreamAccessLogsMessage&& batch);
+
+  private:
+    LoggerFactory factory_;
+    std::unique_ptr<GrpcAccessLoggerImpl> logger_;
+  };
+
+  using SharedLoggerSharedPtr = std::shared_ptr<SharedLogger>;
+
+  SharedStreamGrpcAccessLogger(SharedLoggerSharedPtr shared_logger,
+                               std::chrono::milliseconds buffer_flush_interval_msec,
+                               uint64_t buffer_size_bytes, Event::Dispatcher& dispatcher,
+                               Event::Dispatcher& main_thread_dispatcher);
+  ~SharedStreamGrpcAccessLogger() override;
+
+  // Extensions::AccessLoggers::GrpcCommon::GrpcAccessLogger
+  void log(envoy::data::accesslog::v3::HTTPAccessLogEntry&& entry) override;
+  void log(envoy::data::accesslog::v3::TCPAccessLogEntry&& entry) override;
+
+private:
+  template <class Entry>
+  void addEntry(Protobuf::RepeatedPtrField<Entry>& entries, Entry&& entry);
+  void flush();
+
+  const SharedLoggerSharedPtr shared_logger_;
+  const std::chrono::milliseconds buffer_flush_interval_msec_;
+  const Event::TimerPtr flush_timer_;
+  const uint64_t buffer_size_bytes_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  uint64_t approximate_message_size_bytes_ = 0;
+  envoy::service::accesslog::v3::StreamAccessLogsMessage message_;
+};
+
 class GrpcAccessLoggerCacheImpl : public Singleton::Instance, public GrpcAccessLoggerCache {
 public:
   GrpcAccessLoggerCacheImpl(Grpc::AsyncClientManager& async_client_manager, Stats::Scope& scope,
-                            ThreadLocal::SlotAllocator& tls,
-                            const LocalInfo::LocalInfo& local_info);
+                            ThreadLocal::SlotAllocator& tls, const LocalInfo::LocalInfo& local_info,
+                            Event::Dispatcher& main_thread_dispatcher);
 
   GrpcAccessLoggerSharedPtr getOrCreateLogger(
       const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
@@ -134,10 +228,20 @@ private:
         access_loggers_;
   };
 
+  SharedStreamGrpcAccessLogger::SharedLoggerSharedPtr getOrCreateSharedLogger(
+      const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& config,
+      const std::pair<std::size_t, GrpcAccessLoggerType>& cache_key);
+
   Grpc::AsyncClientManager& async_client_manager_;
   Stats::Scope& scope_;
   ThreadLocal::SlotPtr tls_slot_;
   const LocalInfo::LocalInfo& local_info_;
+  Event::Dispatcher& main_thread_dispatcher_;
+  absl::Mutex shared_loggers_lock_;
+  // Loggers shared by all workers, indexed like the per-thread cache.
+  absl::flat_hash_map<std::pair<std::size_t, GrpcAccessLoggerType>,
+                      SharedStreamGrpcAccessLogger::SharedLoggerSharedPtr>
+      shared_loggers_ ABSL_GUARDED_BY(shared_loggers_lock_);
 };
 
 } // namespace GrpcCommon
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+
 #include "envoy/data/accesslog/v3/accesslog.pb.h"
 #include "envoy/extensions/access_loggers/grpc/v3/als.pb.h"
+#include "envoy/http/header_map.h"
 #include "envoy/stream_info/stream_info.h"
 
 namespace Envoy {
@@ -20,6 +23,21 @@ public:
   static void responseFlagsToAccessLogResponseFlags(
       envoy::data::accesslog::v3::AccessLogCommon& common_access_log,
       const StreamInfo::StreamInfo& stream_info);
+
+  /**
+   * Populate an HTTP access log entry, including its common properties, from a completed request.
+   * The listed headers and trailers are recorded in addition to the fixed set of request and
+   * response properties.
+   */
+  static void extractHttpAccessLogEntry(
+      envoy::data::accesslog::v3::HTTPAccessLogEntry& log_entry,
+      const Http::RequestHeaderMap& request_headers,
+      const Http::ResponseHeaderMap& response_headers,
+      const Http::ResponseTrailerMap& response_trailers, const StreamInfo::StreamInfo& stream_info,
+      const envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig& common_config,
+      const std::vector<Http::LowerCaseString>& request_headers_to_log,
+      const std::vector<Http::LowerCaseString>& response_headers_to_log,
+      const std::vector<Http::LowerCaseString>& response_trailers_to_log);
 };
 
 } // namespace GrpcCommon
@@ -29,6 +29,7 @@ HttpGrpcAccessLogFactory::createAccessLogInstance(const Protobuf::Message& confi
   const auto& proto_config = MessageUtil::downcastAndValidate<
       const envoy::extensions::access_loggers::grpc::v3::HttpGrpcAccessLogConfig&>(
       config, context.messageValidationVisitor());
+  GrpcCommon::validateCommonConfig(proto_config.common_config());
 
   return std::make_shared<HttpGrpcAccessLog>(
       std::move(filter), proto_config, context.threadLocal(),
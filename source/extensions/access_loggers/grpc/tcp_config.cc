@@ -29,6 +29,7 @@ TcpGrpcAccessLogFactory::createAccessLogInstance(const Protobuf::Message& config
   const auto& proto_config = MessageUtil::downcastAndValidate<
       const envoy::extensions::access_loggers::grpc::v3::TcpGrpcAccessLogConfig&>(
       config, context.messageValidationVisitor());
+  GrpcCommon::validateCommonConfig(proto_config.common_config());
 
   return std::make_shared<TcpGrpcAccessLog>(std::move(filter), proto_config, context.threadLocal(),
                                             GrpcCommon::getGrpcAccessLoggerCacheSingleton(context));
@@ -1,5 +1,8 @@
 #include "extensions/clusters/dynamic_forward_proxy/cluster.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/extensions/clusters/dynamic_forward_proxy/v3/cluster.pb.h"
 #include "envoy/extensions/clusters/dynamic_forward_proxy/v3/cluster.pb.validate.h"
@@ -8,6 +11,8 @@
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache_manager_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Clusters {
@@ -18,15 +23,15 @@ Cluster::Cluster(
     const envoy::extensions::clusters::dynamic_forward_proxy::v3::ClusterConfig& config,
     Runtime::Loader& runtime,
     Extensions::Common::DynamicForwardProxy::DnsCacheManagerFactory& cache_manager_factory,
-    const LocalInfo::LocalInfo& local_info,
     Server::Configuration::TransportSocketFactoryContextImpl& factory_context,
     Stats::ScopePtr&& stats_scope, bool added_via_api)
     : Upstream::BaseDynamicClusterImpl(cluster, runtime, factory_context, std::move(stats_scope),
                                        added_via_api),
       dns_cache_manager_(cache_manager_factory.get()),
       dns_cache_(dns_cache_manager_->getCache(config.dns_cache_config())),
-      update_callbacks_handle_(dns_cache_->addUpdateCallbacks(*this)), local_info_(local_info),
-      host_map_(std::make_shared<HostInfoMap>()) {
+      update_callbacks_handle_(dns_cache_->addUpdateCallbacks(*this)),
+      host_map_(std::make_shared<HostInfoMap>()),
+      update_timer_(factory_context.dispatcher().createTimer([this]() { updatePrioritySet(); })) {
   // Block certain TLS context parameters that don't make sense on a cluster-wide scale. We will
   // support these parameters dynamically in the future. This is not an exhaustive list of
   // parameters that don't make sense but should be the most obvious ones that a user might set
@@ -46,12 +51,10 @@ void Cluster::startPreInit() {
   // If we are attaching to a pre-populated cache we need to initialize our hosts.
   auto existing_hosts = dns_cache_->hosts();
   if (!existing_hosts.empty()) {
-    std::shared_ptr<HostInfoMap> new_host_map;
-    std::unique_ptr<Upstream::HostVector> hosts_added;
     for (const auto& existing_host : existing_hosts) {
-      addOrUpdateWorker(existing_host.first, existing_host.second, new_host_map, hosts_added);
+      addOrUpdateWorker(existing_host.first, existing_host.second);
     }
-    swapAndUpdateMap(new_host_map, *hosts_added, {});
+    updatePrioritySet();
   }
 
   onPreInitComplete();
@@ -59,9 +62,7 @@ void Cluster::startPreInit() {
 
 void Cluster::addOrUpdateWorker(
     const std::string& host,
-    const Extensions::Common::DynamicForwardProxy::DnsHostInfoSharedPtr& host_info,
-    std::shared_ptr<HostInfoMap>& new_host_map,
-    std::unique_ptr<Upstream::HostVector>& hosts_added) {
+    const Extensions::Common::DynamicForwardProxy::DnsHostInfoSharedPtr& host_info) {
   // We should never get a host with no address from the cache.
   ASSERT(host_info->address() != nullptr);
 
@@ -71,9 +72,8 @@ void Cluster::addOrUpdateWorker(
   // marginal memory cost above that already used by connections and requests, so relying on
   // connection/request circuit breakers is sufficient. We may have to revisit this in the future.
 
-  HostInfoMapSharedPtr current_map = getCurrentHostMap();
-  const auto host_map_it = current_map->find(host);
-  if (host_map_it != current_map->end()) {
+  const auto existing_host = host_map_->find(host);
+  if (existing_host.has_value()) {
     // If we only have an address change, we can do that swap inline without any other updates.
     // The appropriate R/W locking is in place to allow this. The details of this locking are:
     //  - Hosts are not thread local, they are global.
@@ -90,77 +90,87 @@ void Cluster::addOrUpdateWorker(
     //                     semantics, meaning the cache would expose multiple addresses and the
     //                     cluster would create multiple logical hosts based on those addresses.
     //                     We will leave this is a follow up depending on need.
-    ASSERT(host_info == host_map_it->second.shared_host_info_);
-    ASSERT(host_map_it->second.shared_host_info_->address() !=
-           host_map_it->second.logical_host_->address());
+    ASSERT(host_info == existing_host->shared_host_info_);
+    ASSERT(existing_host->shared_host_info_->address() != existing_host->logical_host_->address());
     ENVOY_LOG(debug, "updating dfproxy cluster host address '{}'", host);
-    host_map_it->second.logical_host_->setNewAddress(host_info->address(), dummy_lb_endpoint_);
+    existing_host->logical_host_->setNewAddress(host_info->address(), dummy_lb_endpoint_);
     return;
   }
 
   ENVOY_LOG(debug, "adding new dfproxy cluster host '{}'", host);
 
-  if (new_host_map == nullptr) {
-    new_host_map = std::make_shared<HostInfoMap>(*current_map);
-  }
-  const auto emplaced =
-      new_host_map->try_emplace(host, host_info,
-                                std::make_shared<Upstream::LogicalHost>(
-                                    info(), host, host_info->address(), dummy_locality_lb_endpoint_,
-                                    dummy_lb_endpoint_, nullptr));
-  if (hosts_added == nullptr) {
-    hosts_added = std::make_unique<Upstream::HostVector>();
-  }
-  hosts_added->emplace_back(emplaced.first->second.logical_host_);
+  const auto logical_host =
+      std::make_shared<Upstream::LogicalHost>(info(), host, host_info->address(),
+                                              dummy_locality_lb_endpoint_, dummy_lb_endpoint_,
+                                              nullptr);
+  host_map_->insert(host, HostInfo(host_info, logical_host));
+  pending_hosts_added_.emplace_back(logical_host);
 }
 
 void Cluster::onDnsHostAddOrUpdate(
     const std::string& host,
     const Extensions::Common::DynamicForwardProxy::DnsHostInfoSharedPtr& host_info) {
-  std::shared_ptr<HostInfoMap> new_host_map;
-  std::unique_ptr<Upstream::HostVector> hosts_added;
-  addOrUpdateWorker(host, host_info, new_host_map, hosts_added);
-  if (hosts_added != nullptr) {
-    ASSERT(!new_host_map->empty());
-    ASSERT(!hosts_added->empty());
-    // Swap in the new map. This will be picked up when the per-worker LBs are recreated via
-    // the host set update.
-    swapAndUpdateMap(new_host_map, *hosts_added, {});
+  addOrUpdateWorker(host, host_info);
+  if (!pending_hosts_added_.empty()) {
+    scheduleUpdate();
   }
 }
 
-void Cluster::swapAndUpdateMap(const HostInfoMapSharedPtr& new_hosts_map,
-                               const Upstream::HostVector& hosts_added,
-                               const Upstream::HostVector& hosts_removed) {
-  {
-    absl::WriterMutexLock lock(&host_map_lock_);
-    host_map_ = new_hosts_map;
+void Cluster::onDnsHostRemove(const std::string& host) {
+  const auto existing_host = host_map_->find(host);
+  ASSERT(existing_host.has_value());
+  host_map_->erase(host);
+  ENVOY_LOG(debug, "removing dfproxy cluster host '{}'", host);
+
+  // A host which is removed before the priority set learned about it never makes it there.
+  const auto pending_host_it = std::find(pending_hosts_added_.begin(), pending_hosts_added_.end(),
+                                         existing_host->logical_host_);
+  if (pending_host_it != pending_hosts_added_.end()) {
+    pending_hosts_added_.erase(pending_host_it);
+  } else {
+    pending_hosts_removed_.emplace_back(existing_host->logical_host_);
   }
+  scheduleUpdate();
+}
 
-  Upstream::PriorityStateManager priority_state_manager(*this, local_info_, nullptr);
-  priority_state_manager.initializePriorityFor(dummy_locality_lb_endpoint_);
-  for (const auto& host : (*new_hosts_map)) {
-    priority_state_manager.registerHostForPriority(host.second.logical_host_,
-                                                   dummy_locality_lb_endpoint_);
+void Cluster::scheduleUpdate() {
+  // The LBs pick up the change right away via the shared map. Any other changes which happen
+  // before the timer fires, e.g. because a burst of new hosts finished resolving, are folded into
+  // the same update of the priority set.
+  if (!update_timer_->enabled()) {
+    update_timer_->enableTimer(std::chrono::milliseconds(0));
   }
-  priority_state_manager.updateClusterPrioritySet(
-      0, std::move(priority_state_manager.priorityState()[0].first), hosts_added, hosts_removed,
-      absl::nullopt, absl::nullopt);
 }
 
-void Cluster::onDnsHostRemove(const std::string& host) {
-  HostInfoMapSharedPtr current_map = getCurrentHostMap();
-  const auto host_map_it = current_map->find(host);
-  ASSERT(host_map_it != current_map->end());
-  const auto new_host_map = std::make_shared<HostInfoMap>(*current_map);
+void Cluster::updatePrioritySet() {
+  Upstream::HostVector hosts_added;
   Upstream::HostVector hosts_removed;
-  hosts_removed.emplace_back(host_map_it->second.logical_host_);
-  new_host_map->erase(host);
-  ENVOY_LOG(debug, "removing dfproxy cluster host '{}'", host);
+  hosts_added.swap(pending_hosts_added_);
+  hosts_removed.swap(pending_hosts_removed_);
+  if (hosts_added.empty() && hosts_removed.empty()) {
+    return;
+  }
 
-  // Swap in the new map. This will be picked up when the per-worker LBs are recreated via
-  // the host set update.
-  swapAndUpdateMap(new_host_map, {}, hosts_removed);
+  // The new hosts of the priority set are derived from its current hosts and the changes, rather
+  // than from the host map, so that an update neither walks nor locks the shards of the map.
+  const Upstream::HostVector& current_hosts = priority_set_.getOrCreateHostSet(0).hosts();
+  auto hosts = std::make_shared<Upstream::HostVector>();
+  hosts->reserve(current_hosts.size() + hosts_added.size());
+  if (hosts_removed.empty()) {
+    hosts->insert(hosts->end(), current_hosts.begin(), current_hosts.end());
+  } else {
+    const absl::flat_hash_set<Upstream::HostSharedPtr> removed(hosts_removed.begin(),
+                                                               hosts_removed.end());
+    std::copy_if(current_hosts.begin(), current_hosts.end(), std::back_inserter(*hosts),
+                 [&removed](const Upstream::HostSharedPtr& host) {
+                   return removed.find(host) == removed.end();
+                 });
+  }
+  hosts->insert(hosts->end(), hosts_added.begin(), hosts_added.end());
+  priority_set_.updateHosts(
+      0,
+      Upstream::HostSetImpl::partitionHosts(hosts, Upstream::HostsPerLocalityImpl::empty()),
+      {}, hosts_added, hosts_removed, absl::nullopt);
 }
 
 Upstream::HostConstSharedPtr
@@ -169,13 +179,12 @@ Cluster::LoadBalancer::chooseHost(Upstream::LoadBalancerContext* context) {
     return nullptr;
   }
 
-  const auto host_it =
-      host_map_->find(context->downstreamHeaders()->Host()->value().getStringView());
-  if (host_it == host_map_->end()) {
+  const auto host = host_map_->find(context->downstreamHeaders()->Host()->value().getStringView());
+  if (!host.has_value()) {
     return nullptr;
   } else {
-    host_it->second.shared_host_info_->touch();
-    return host_it->second.logical_host_;
+    host->shared_host_info_->touch();
+    return host->logical_host_;
   }
 }
 
@@ -203,7 +212,7 @@ ClusterFactory::createClusterWithConfig(
   }
 
   auto new_cluster = std::make_shared<Cluster>(
-      cluster_config, proto_config, context.runtime(), cache_manager_factory, context.localInfo(),
+      cluster_config, proto_config, context.runtime(), cache_manager_factory,
       socket_factory_context, std::move(stats_scope), context.addedViaApi());
   auto lb = std::make_unique<Cluster::ThreadAwareLoadBalancer>(*new_cluster);
   return std::make_pair(new_cluster, std::move(lb));
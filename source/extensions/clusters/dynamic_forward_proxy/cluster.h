@@ -2,6 +2,7 @@
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/extensions/clusters/dynamic_forward_proxy/v3/cluster.pb.h"
 #include "envoy/extensions/clusters/dynamic_forward_proxy/v3/cluster.pb.validate.h"
 
@@ -10,6 +11,7 @@
 
 #include "extensions/clusters/well_known_names.h"
 #include "extensions/common/dynamic_forward_proxy/dns_cache.h"
+#include "extensions/common/dynamic_forward_proxy/sharded_host_map.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -23,7 +25,6 @@ public:
           const envoy::extensions::clusters::dynamic_forward_proxy::v3::ClusterConfig& config,
           Runtime::Loader& runtime,
           Extensions::Common::DynamicForwardProxy::DnsCacheManagerFactory& cache_manager_factory,
-          const LocalInfo::LocalInfo& local_info,
           Server::Configuration::TransportSocketFactoryContextImpl& factory_context,
           Stats::ScopePtr&& stats_scope, bool added_via_api);
 
@@ -51,7 +52,9 @@ private:
     const Upstream::LogicalHostSharedPtr logical_host_;
   };
 
-  using HostInfoMap = absl::flat_hash_map<std::string, HostInfo>;
+  // The hosts are shared by the cluster and the per-worker LBs, so that the LBs see hosts as soon
+  // as they are added or removed, without copying the whole map for every change.
+  using HostInfoMap = Extensions::Common::DynamicForwardProxy::ShardedHostMap<HostInfo>;
   using HostInfoMapSharedPtr = std::shared_ptr<const HostInfoMap>;
 
   struct LoadBalancer : public Upstream::LoadBalancer {
@@ -68,7 +71,7 @@ private:
 
     // Upstream::LoadBalancerFactory
     Upstream::LoadBalancerPtr create() override {
-      return std::make_unique<LoadBalancer>(cluster_.getCurrentHostMap());
+      return std::make_unique<LoadBalancer>(cluster_.host_map_);
     }
 
     Cluster& cluster_;
@@ -86,19 +89,11 @@ private:
     Cluster& cluster_;
   };
 
-  HostInfoMapSharedPtr getCurrentHostMap() {
-    absl::ReaderMutexLock lock(&host_map_lock_);
-    return host_map_;
-  }
-
   void
   addOrUpdateWorker(const std::string& host,
-                    const Extensions::Common::DynamicForwardProxy::DnsHostInfoSharedPtr& host_info,
-                    std::shared_ptr<HostInfoMap>& new_host_map,
-                    std::unique_ptr<Upstream::HostVector>& hosts_added);
-  void swapAndUpdateMap(const HostInfoMapSharedPtr& new_hosts_map,
-                        const Upstream::HostVector& hosts_added,
-                        const Upstream::HostVector& hosts_removed);
+                    const Extensions::Common::DynamicForwardProxy::DnsHostInfoSharedPtr& host_info);
+  void scheduleUpdate();
+  void updatePrioritySet();
 
   const Extensions::Common::DynamicForwardProxy::DnsCacheManagerSharedPtr dns_cache_manager_;
   const Extensions::Common::DynamicForwardProxy::DnsCacheSharedPtr dns_cache_;
@@ -106,10 +101,13 @@ private:
       update_callbacks_handle_;
   const envoy::config::endpoint::v3::LocalityLbEndpoints dummy_locality_lb_endpoint_;
   const envoy::config::endpoint::v3::LbEndpoint dummy_lb_endpoint_;
-  const LocalInfo::LocalInfo& local_info_;
 
-  absl::Mutex host_map_lock_;
-  HostInfoMapSharedPtr host_map_ ABSL_GUARDED_BY(host_map_lock_);
+  const std::shared_ptr<HostInfoMap> host_map_;
+  // Changes to the hosts are applied to the priority set in batches, as every update of the
+  // priority set goes through all of the hosts.
+  const Event::TimerPtr update_timer_;
+  Upstream::HostVector pending_hosts_added_;
+  Upstream::HostVector pending_hosts_removed_;
 
   friend class ClusterFactory;
   friend class ClusterTest;
@@ -60,6 +60,12 @@ public:
      * Called when the DNS cache load is complete (or failed).
      */
     virtual void onLoadDnsCacheComplete() PURE;
+
+    /**
+     * Called when the host could not be added because the DNS cache is full and no host could be
+     * evicted. This is the asynchronous counterpart of LoadDnsCacheEntryStatus::Overflow.
+     */
+    virtual void onLoadDnsCacheOverflow() PURE;
   };
 
   /**
@@ -17,10 +17,13 @@ namespace DynamicForwardProxy {
 DnsCacheImpl::DnsCacheImpl(
     Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
     Runtime::RandomGenerator& random, Stats::Scope& root_scope,
+    Network::DnsResolverSharedPtr resolver,
     const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config)
     : main_thread_dispatcher_(main_thread_dispatcher),
       dns_lookup_family_(Upstream::getDnsLookupFamilyFromEnum(config.dns_lookup_family())),
-      resolver_(main_thread_dispatcher.createDnsResolver({}, false)), tls_slot_(tls.allocateSlot()),
+      resolver_(resolver != nullptr ? std::move(resolver)
+                                    : main_thread_dispatcher.createDnsResolver({}, false)),
+      tls_slot_(tls.allocateSlot()),
       scope_(root_scope.createScope(fmt::format("dns_cache.{}.", config.name()))),
       stats_{ALL_DNS_CACHE_STATS(POOL_COUNTER(*scope_), POOL_GAUGE(*scope_))},
       refresh_interval_(PROTOBUF_GET_MS_OR_DEFAULT(config, dns_refresh_rate, 60000)),
@@ -29,9 +32,9 @@ DnsCacheImpl::DnsCacheImpl(
               envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig>(
               config, refresh_interval_.count(), random)),
       host_ttl_(PROTOBUF_GET_MS_OR_DEFAULT(config, host_ttl, 300000)),
-      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)) {
+      max_hosts_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, max_hosts, 1024)),
+      evict_least_recently_used_(config.evict_least_recently_used()) {
   tls_slot_->set([](Event::Dispatcher&) { return std::make_shared<ThreadLocalHostInfo>(); });
-  updateTlsHostsMap();
 }
 
 DnsCacheImpl::~DnsCacheImpl() {
@@ -51,11 +54,10 @@ DnsCacheImpl::loadDnsCacheEntry(absl::string_view host, uint16_t default_port,
                                 LoadDnsCacheEntryCallbacks& callbacks) {
   ENVOY_LOG(debug, "thread local lookup for host '{}'", host);
   auto& tls_host_info = tls_slot_->getTyped<ThreadLocalHostInfo>();
-  auto tls_host = tls_host_info.host_map_->find(host);
-  if (tls_host != tls_host_info.host_map_->end()) {
+  if (host_map_.contains(host)) {
     ENVOY_LOG(debug, "thread local hit for host '{}'", host);
     return {LoadDnsCacheEntryStatus::InCache, nullptr};
-  } else if (tls_host_info.host_map_->size() >= max_hosts_) {
+  } else if (!evict_least_recently_used_ && host_map_.size() >= max_hosts_) {
     // Given that we do this check in thread local context, it's possible for two threads to race
     // and potentially go slightly above the configured max hosts. This is an OK given compromise
     // given how much simpler the implementation is.
@@ -98,6 +100,18 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
     return;
   }
 
+  if (evict_least_recently_used_ && primary_hosts_.size() >= max_hosts_ &&
+      !evictLeastRecentlyUsedHost()) {
+    // Rather than going above the max hosts, the host is not cached, and the workers waiting for it
+    // are told that the cache overflowed.
+    ENVOY_LOG(debug, "DNS cache overflow for host '{}', no host to evict", host);
+    stats_.host_overflow_.inc();
+    tls_slot_->runOnAllThreads([this, host]() {
+      tls_slot_->getTyped<ThreadLocalHostInfo>().onHostLoaded(host, /* overflow */ true);
+    });
+    return;
+  }
+
   const auto host_attributes = Http::Utility::parseAuthority(host);
 
   // TODO(mattklein123): Right now, the same host with different ports will become two
@@ -111,6 +125,8 @@ void DnsCacheImpl::startCacheLoad(const std::string& host, uint16_t default_port
                                                    host_attributes.is_ip_address_,
                                                    [this, host]() { onReResolve(host); }))
                             .first->second;
+  primary_host.lru_entry_ = lru_hosts_.insert(lru_hosts_.end(), host);
+  primary_host.lru_used_time_ = primary_host.host_info_->last_used_time_;
   startResolve(host, primary_host);
 }
 
@@ -125,19 +141,55 @@ void DnsCacheImpl::onReResolve(const std::string& host) {
             primary_host_it->second->host_info_->last_used_time_.load().count());
   if (now_duration - primary_host_it->second->host_info_->last_used_time_.load() > host_ttl_) {
     ENVOY_LOG(debug, "host='{}' TTL expired, removing", host);
-    // If the host has no address then that means that the DnsCacheImpl has never
-    // runAddUpdateCallbacks for this host, and thus the callback targets are not aware of it.
-    // Therefore, runRemoveCallbacks should only be ran if the host's address != nullptr.
-    if (primary_host_it->second->host_info_->address_) {
-      runRemoveCallbacks(host);
-    }
-    primary_hosts_.erase(primary_host_it);
-    updateTlsHostsMap();
+    removeHost(primary_host_it);
   } else {
     startResolve(host, *primary_host_it->second);
   }
 }
 
+void DnsCacheImpl::removeHost(
+    absl::flat_hash_map<std::string, PrimaryHostInfoPtr>::iterator primary_host_it) {
+  const std::string host = primary_host_it->first;
+  PrimaryHostInfo& primary_host = *primary_host_it->second;
+  if (primary_host.active_query_ != nullptr) {
+    primary_host.active_query_->cancel();
+  }
+  // If the host has no address then that means that the DnsCacheImpl has never
+  // runAddUpdateCallbacks for this host, and thus the callback targets are not aware of it.
+  // Therefore, runRemoveCallbacks should only be ran if the host's address != nullptr.
+  if (primary_host.host_info_->address_) {
+    runRemoveCallbacks(host);
+  }
+  host_map_.erase(host);
+  lru_hosts_.erase(primary_host.lru_entry_);
+  primary_hosts_.erase(primary_host_it);
+}
+
+bool DnsCacheImpl::evictLeastRecentlyUsedHost() {
+  // This is the second chance algorithm: a host which was used since it was last considered goes
+  // to the back of the list instead of being evicted. Every host is considered at most twice, so
+  // that hosts which are used all the time do not keep this going. Hosts whose first resolution is
+  // in progress have workers waiting for them, and are never evicted.
+  const size_t max_considered = 2 * lru_hosts_.size();
+  for (size_t considered = 0; considered < max_considered; considered++) {
+    const auto primary_host_it = primary_hosts_.find(lru_hosts_.front());
+    ASSERT(primary_host_it != primary_hosts_.end());
+    PrimaryHostInfo& primary_host = *primary_host_it->second;
+    const std::chrono::steady_clock::duration last_used_time =
+        primary_host.host_info_->last_used_time_;
+    if (primary_host.host_info_->first_resolve_complete_ &&
+        last_used_time == primary_host.lru_used_time_) {
+      ENVOY_LOG(debug, "evicting least recently used host '{}'", primary_host_it->first);
+      stats_.host_evicted_.inc();
+      removeHost(primary_host_it);
+      return true;
+    }
+    primary_host.lru_used_time_ = last_used_time;
+    lru_hosts_.splice(lru_hosts_.end(), lru_hosts_, primary_host.lru_entry_);
+  }
+  return false;
+}
+
 void DnsCacheImpl::startResolve(const std::string& host, PrimaryHostInfo& host_info) {
   ENVOY_LOG(debug, "starting main thread resolve for host='{}' dns='{}' port='{}'", host,
             host_info.host_info_->resolved_host_, host_info.port_);
@@ -185,18 +237,16 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   //
   // This means that once a host gets an address it will stick even in the case of a subsequent
   // resolution failure.
-  bool address_changed = false;
   if (new_address != nullptr && (primary_host_info.host_info_->address_ == nullptr ||
                                  *primary_host_info.host_info_->address_ != *new_address)) {
     ENVOY_LOG(debug, "host '{}' address has changed", host);
     primary_host_info.host_info_->address_ = new_address;
     runAddUpdateCallbacks(host, primary_host_info.host_info_);
-    address_changed = true;
     stats_.host_address_changed_.inc();
   }
 
-  if (first_resolve || address_changed) {
-    updateTlsHostsMap();
+  if (first_resolve) {
+    addTlsHost(host, primary_host_info.host_info_);
   }
 
   // Kick off the refresh timer.
@@ -228,17 +278,12 @@ void DnsCacheImpl::runRemoveCallbacks(const std::string& host) {
   }
 }
 
-void DnsCacheImpl::updateTlsHostsMap() {
-  TlsHostMapSharedPtr new_host_map = std::make_shared<TlsHostMap>();
-  for (const auto& primary_host : primary_hosts_) {
-    // Do not include hosts that have not resolved at least once.
-    if (primary_host.second->host_info_->first_resolve_complete_) {
-      new_host_map->emplace(primary_host.first, primary_host.second->host_info_);
-    }
-  }
-
-  tls_slot_->runOnAllThreads([this, new_host_map]() {
-    tls_slot_->getTyped<ThreadLocalHostInfo>().updateHostMap(new_host_map);
+void DnsCacheImpl::addTlsHost(const std::string& host, const DnsHostInfoSharedPtr& host_info) {
+  // The workers see the host in the shared map right away. Only the callbacks which are pending on
+  // the workers need to be told about it, which is a single host rather than the whole map.
+  host_map_.insert(host, host_info);
+  tls_slot_->runOnAllThreads([this, host]() {
+    tls_slot_->getTyped<ThreadLocalHostInfo>().onHostLoaded(host, /* overflow */ false);
   });
 }
 
@@ -249,16 +294,19 @@ DnsCacheImpl::ThreadLocalHostInfo::~ThreadLocalHostInfo() {
   }
 }
 
-void DnsCacheImpl::ThreadLocalHostInfo::updateHostMap(const TlsHostMapSharedPtr& new_host_map) {
-  host_map_ = new_host_map;
+void DnsCacheImpl::ThreadLocalHostInfo::onHostLoaded(const std::string& host, bool overflow) {
   for (auto pending_resolution_it = pending_resolutions_.begin();
        pending_resolution_it != pending_resolutions_.end();) {
     auto& pending_resolution = **pending_resolution_it;
-    if (host_map_->count(pending_resolution.host_) != 0) {
+    if (pending_resolution.host_ == host) {
       auto& callbacks = pending_resolution.callbacks_;
       pending_resolution.cancel();
       pending_resolution_it = pending_resolutions_.erase(pending_resolution_it);
-      callbacks.onLoadDnsCacheComplete();
+      if (overflow) {
+        callbacks.onLoadDnsCacheOverflow();
+      } else {
+        callbacks.onLoadDnsCacheComplete();
+      }
     } else {
       ++pending_resolution_it;
     }
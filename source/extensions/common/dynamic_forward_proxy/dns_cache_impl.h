@@ -8,6 +8,7 @@
 #include "common/common/cleanup.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache.h"
+#include "extensions/common/dynamic_forward_proxy/sharded_host_map.h"
 
 #include "absl/container/flat_hash_map.h"
 
@@ -25,6 +26,7 @@ namespace DynamicForwardProxy {
   COUNTER(dns_query_success)                                                                       \
   COUNTER(host_added)                                                                              \
   COUNTER(host_address_changed)                                                                    \
+  COUNTER(host_evicted)                                                                            \
   COUNTER(host_overflow)                                                                           \
   COUNTER(host_removed)                                                                            \
   GAUGE(num_hosts, NeverImport)
@@ -38,8 +40,13 @@ struct DnsCacheStats {
 
 class DnsCacheImpl : public DnsCache, Logger::Loggable<Logger::Id::forward_proxy> {
 public:
+  /**
+   * @param resolver supplies the resolver to share with the rest of the server, or nullptr for the
+   *        cache to create its own.
+   */
   DnsCacheImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
                Runtime::RandomGenerator& random, Stats::Scope& root_scope,
+               Network::DnsResolverSharedPtr resolver,
                const envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig& config);
   ~DnsCacheImpl() override;
 
@@ -50,9 +57,6 @@ public:
   absl::flat_hash_map<std::string, DnsHostInfoSharedPtr> hosts() override;
 
 private:
-  using TlsHostMap = absl::flat_hash_map<std::string, DnsHostInfoSharedPtr>;
-  using TlsHostMapSharedPtr = std::shared_ptr<TlsHostMap>;
-
   struct LoadDnsCacheEntryHandleImpl : public LoadDnsCacheEntryHandle,
                                        RaiiListElement<LoadDnsCacheEntryHandleImpl*> {
     LoadDnsCacheEntryHandleImpl(std::list<LoadDnsCacheEntryHandleImpl*>& parent,
@@ -64,12 +68,14 @@ private:
     LoadDnsCacheEntryCallbacks& callbacks_;
   };
 
-  // Per-thread DNS cache info including the currently known hosts as well as any pending callbacks.
+  // Per-thread DNS cache info, i.e. the pending callbacks. The known hosts are shared by all
+  // threads in host_map_.
   struct ThreadLocalHostInfo : public ThreadLocal::ThreadLocalObject {
     ~ThreadLocalHostInfo() override;
-    void updateHostMap(const TlsHostMapSharedPtr& new_host_map);
+    // Completes the pending resolutions of a host which was added, or which could not be added
+    // because the cache is full.
+    void onHostLoaded(const std::string& host, bool overflow);
 
-    TlsHostMapSharedPtr host_map_;
     std::list<LoadDnsCacheEntryHandleImpl*> pending_resolutions_;
   };
 
@@ -108,6 +114,10 @@ private:
     const Event::TimerPtr refresh_timer_;
     const DnsHostInfoImplSharedPtr host_info_;
     Network::ActiveDnsQuery* active_query_{};
+    // The host's entry in lru_hosts_, and its last used time when the entry was last moved to the
+    // back of the list.
+    std::list<std::string>::iterator lru_entry_;
+    std::chrono::steady_clock::duration lru_used_time_;
   };
 
   using PrimaryHostInfoPtr = std::unique_ptr<PrimaryHostInfo>;
@@ -127,8 +137,11 @@ private:
                      std::list<Network::DnsResponse>&& response);
   void runAddUpdateCallbacks(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void runRemoveCallbacks(const std::string& host);
-  void updateTlsHostsMap();
+  void addTlsHost(const std::string& host, const DnsHostInfoSharedPtr& host_info);
   void onReResolve(const std::string& host);
+  void removeHost(absl::flat_hash_map<std::string, PrimaryHostInfoPtr>::iterator primary_host_it);
+  // Returns false if no host could be evicted.
+  bool evictLeastRecentlyUsedHost();
 
   Event::Dispatcher& main_thread_dispatcher_;
   const Network::DnsLookupFamily dns_lookup_family_;
@@ -138,10 +151,15 @@ private:
   DnsCacheStats stats_;
   std::list<AddUpdateCallbacksHandleImpl*> update_callbacks_;
   absl::flat_hash_map<std::string, PrimaryHostInfoPtr> primary_hosts_;
+  // The hosts which completed their first resolution, which the workers look up directly.
+  ShardedHostMap<DnsHostInfoSharedPtr> host_map_;
+  // The primary hosts, roughly from the least to the most recently used.
+  std::list<std::string> lru_hosts_;
   const std::chrono::milliseconds refresh_interval_;
   const BackOffStrategyPtr failure_backoff_strategy_;
   const std::chrono::milliseconds host_ttl_;
   const uint32_t max_hosts_;
+  const bool evict_least_recently_used_;
 };
 
 } // namespace DynamicForwardProxy
@@ -2,6 +2,7 @@
 
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 
+#include "common/network/caching_dns_resolver_impl.h"
 #include "common/protobuf/protobuf.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
@@ -28,7 +29,8 @@ DnsCacheSharedPtr DnsCacheManagerImpl::getCache(
   }
 
   DnsCacheSharedPtr new_cache =
-      std::make_shared<DnsCacheImpl>(main_thread_dispatcher_, tls_, random_, root_scope_, config);
+      std::make_shared<DnsCacheImpl>(main_thread_dispatcher_, tls_, random_, root_scope_,
+                                     shared_resolver_, config);
   caches_.emplace(config.name(), ActiveCache{config, new_cache});
   return new_cache;
 }
@@ -40,9 +42,10 @@ DnsCacheManagerSharedPtr getCacheManager(Singleton::Manager& singleton_manager,
                                          Stats::Scope& root_scope) {
   return singleton_manager.getTyped<DnsCacheManager>(
       SINGLETON_MANAGER_REGISTERED_NAME(dns_cache_manager),
-      [&main_thread_dispatcher, &tls, &random, &root_scope] {
-        return std::make_shared<DnsCacheManagerImpl>(main_thread_dispatcher, tls, random,
-                                                     root_scope);
+      [&singleton_manager, &main_thread_dispatcher, &tls, &random, &root_scope] {
+        return std::make_shared<DnsCacheManagerImpl>(
+            main_thread_dispatcher, tls, random, root_scope,
+            Network::sharedCachingDnsResolver(singleton_manager));
       });
 }
 
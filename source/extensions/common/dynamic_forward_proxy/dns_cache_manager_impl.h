@@ -1,6 +1,7 @@
 #pragma once
 
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
+#include "envoy/network/dns.h"
 
 #include "extensions/common/dynamic_forward_proxy/dns_cache.h"
 
@@ -14,9 +15,10 @@ namespace DynamicForwardProxy {
 class DnsCacheManagerImpl : public DnsCacheManager, public Singleton::Instance {
 public:
   DnsCacheManagerImpl(Event::Dispatcher& main_thread_dispatcher, ThreadLocal::SlotAllocator& tls,
-                      Runtime::RandomGenerator& random, Stats::Scope& root_scope)
+                      Runtime::RandomGenerator& random, Stats::Scope& root_scope,
+                      Network::DnsResolverSharedPtr shared_resolver)
       : main_thread_dispatcher_(main_thread_dispatcher), tls_(tls), random_(random),
-        root_scope_(root_scope) {}
+        root_scope_(root_scope), shared_resolver_(std::move(shared_resolver)) {}
 
   // DnsCacheManager
   DnsCacheSharedPtr getCache(
@@ -36,6 +38,8 @@ private:
   ThreadLocal::SlotAllocator& tls_;
   Runtime::RandomGenerator& random_;
   Stats::Scope& root_scope_;
+  // The server's caching resolver if the bootstrap configured one, which all caches then share.
+  const Network::DnsResolverSharedPtr shared_resolver_;
   absl::flat_hash_map<std::string, ActiveCache> caches_;
 };
 
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace DynamicForwardProxy {
+
+/**
+ * A map from host names to values which is updated on the main thread and read by the workers.
+ * The map is split into shards which have a lock each, so that every update only touches a single
+ * shard rather than copying the whole map, and lookups on the workers rarely contend with each
+ * other or with updates. Values are copied out of the map, so they should be cheap to copy, e.g.
+ * shared pointers.
+ */
+template <class Value> class ShardedHostMap {
+public:
+  /**
+   * @return the value of the host, or absl::nullopt if the host is not in the map.
+   */
+  absl::optional<Value> find(absl::string_view host) const {
+    const Shard& shard = shardFor(host);
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    const auto it = shard.map_.find(host);
+    if (it == shard.map_.end()) {
+      return absl::nullopt;
+    }
+    return it->second;
+  }
+
+  /**
+   * @return whether the host is in the map.
+   */
+  bool contains(absl::string_view host) const {
+    const Shard& shard = shardFor(host);
+    absl::ReaderMutexLock lock(&shard.mutex_);
+    return shard.map_.contains(host);
+  }
+
+  /**
+   * Adds a host to the map, unless it is in the map already.
+   * @return whether the host was added.
+   */
+  bool insert(absl::string_view host, const Value& value) {
+    Shard& shard = shardFor(host);
+    absl::MutexLock lock(&shard.mutex_);
+    if (!shard.map_.try_emplace(host, value).second) {
+      return false;
+    }
+    size_++;
+    return true;
+  }
+
+  /**
+   * Removes a host from the map.
+   * @return whether the host was in the map.
+   */
+  bool erase(absl::string_view host) {
+    Shard& shard = shardFor(host);
+    absl::MutexLock lock(&shard.mutex_);
+    const auto it = shard.map_.find(host);
+    if (it == shard.map_.end()) {
+      return false;
+    }
+    shard.map_.erase(it);
+    size_--;
+    return true;
+  }
+
+  /**
+   * @return the number of hosts in the map.
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * Calls the given function with every host and its value. The function is called with the lock
+   * of the host's shard held, so it must not access the map.
+   */
+  template <class Function> void forEach(Function function) const {
+    for (const Shard& shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex_);
+      for (const auto& entry : shard.map_) {
+        function(entry.first, entry.second);
+      }
+    }
+  }
+
+private:
+  static constexpr size_t NumShards = 64;
+
+  struct Shard {
+    mutable absl::Mutex mutex_;
+    absl::flat_hash_map<std::string, Value> map_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shardFor(absl::string_view host) {
+    return shards_[absl::Hash<absl::string_view>()(host) % NumShards];
+  }
+  const Shard& shardFor(absl::string_view host) const {
+    return shards_[absl::Hash<absl::string_view>()(host) % NumShards];
+  }
+
+  std::array<Shard, NumShards> shards_;
+  std::atomic<size_t> size_{};
+};
+
+} // namespace DynamicForwardProxy
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
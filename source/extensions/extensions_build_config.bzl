@@ -42,6 +42,7 @@ EXTENSIONS = {
     "envoy.filters.http.adaptive_concurrency":          "//source/extensions/filters/http/adaptive_concurrency:config",
     "envoy.filters.http.aws_lambda":                    "//source/extensions/filters/http/aws_lambda:config",
     "envoy.filters.http.aws_request_signing":           "//source/extensions/filters/http/aws_request_signing:config",
+    "envoy.filters.http.brotli":                        "//source/extensions/filters/http/brotli:config",
     "envoy.filters.http.buffer":                        "//source/extensions/filters/http/buffer:config",
     "envoy.filters.http.cache":                         "//source/extensions/filters/http/cache:config",
     "envoy.filters.http.cors":                          "//source/extensions/filters/http/cors:config",
@@ -69,6 +70,7 @@ EXTENSIONS = {
     "envoy.filters.http.squash":                        "//source/extensions/filters/http/squash:config",
     "envoy.filters.http.tap":                           "//source/extensions/filters/http/tap:config",
     "envoy.filters.http.wasm":                          "//source/extensions/filters/http/wasm:config",
+    "envoy.filters.http.zstd":                          "//source/extensions/filters/http/zstd:config",
 
     #
     # Listener filters
@@ -119,6 +121,9 @@ EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.cgroup_cpu":               "//source/extensions/resource_monitors/cgroup_cpu:config",
+    "envoy.resource_monitors.cgroup_memory":            "//source/extensions/resource_monitors/cgroup_memory:config",
+    "envoy.resource_monitors.event_loop_delay":         "//source/extensions/resource_monitors/event_loop_delay:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
@@ -290,6 +295,7 @@ WINDOWS_EXTENSIONS = {
     # Resource monitors
     #
 
+    "envoy.resource_monitors.event_loop_delay":         "//source/extensions/resource_monitors/event_loop_delay:config",
     "envoy.resource_monitors.fixed_heap":               "//source/extensions/resource_monitors/fixed_heap:config",
     "envoy.resource_monitors.injected_resource":        "//source/extensions/resource_monitors/injected_resource:config",
 
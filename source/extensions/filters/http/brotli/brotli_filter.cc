@@ -0,0 +1,53 @@
+#include "extensions/filters/http/brotli/brotli_filter.h"
+
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Brotli {
+
+namespace {
+// Default quality. Level 3 is roughly as fast as zlib's default level while compressing better.
+const uint32_t DefaultQuality = 3;
+
+// Default compression window size.
+const uint32_t DefaultWindowBits = 18;
+
+// Default size of the compressor's output buffer.
+const uint32_t DefaultChunkSize = 4096;
+
+} // namespace
+
+BrotliFilterConfig::BrotliFilterConfig(
+    const envoy::extensions::filters::http::brotli::v3::Brotli& brotli,
+    const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime)
+    : CompressorFilterConfig(brotli.compressor(), stats_prefix + "brotli.", scope, runtime,
+                             Http::Headers::get().ContentEncodingValues.Brotli),
+      quality_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, quality, DefaultQuality)),
+      window_bits_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, window_bits, DefaultWindowBits)),
+      encoder_mode_(encoderModeEnum(brotli.encoder_mode())),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(brotli, chunk_size, DefaultChunkSize)) {}
+
+std::unique_ptr<Compressor::Compressor> BrotliFilterConfig::makeCompressor() {
+  return std::make_unique<Compressor::BrotliCompressorImpl>(quality_, window_bits_, encoder_mode_,
+                                                            chunk_size_);
+}
+
+Compressor::BrotliCompressorImpl::EncoderMode BrotliFilterConfig::encoderModeEnum(
+    envoy::extensions::filters::http::brotli::v3::Brotli::EncoderMode encoder_mode) {
+  switch (encoder_mode) {
+  case envoy::extensions::filters::http::brotli::v3::Brotli::TEXT:
+    return Compressor::BrotliCompressorImpl::EncoderMode::Text;
+  case envoy::extensions::filters::http::brotli::v3::Brotli::FONT:
+    return Compressor::BrotliCompressorImpl::EncoderMode::Font;
+  default:
+    return Compressor::BrotliCompressorImpl::EncoderMode::Generic;
+  }
+}
+
+} // namespace Brotli
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "envoy/extensions/filters/http/brotli/v3/brotli.pb.h"
+
+#include "common/compressor/brotli_compressor_impl.h"
+
+#include "extensions/filters/http/common/compressor/compressor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Brotli {
+
+/**
+ * Configuration for the brotli filter.
+ */
+class BrotliFilterConfig : public Common::Compressors::CompressorFilterConfig {
+public:
+  BrotliFilterConfig(const envoy::extensions::filters::http::brotli::v3::Brotli& brotli,
+                     const std::string& stats_prefix, Stats::Scope& scope,
+                     Runtime::Loader& runtime);
+
+  std::unique_ptr<Compressor::Compressor> makeCompressor() override;
+
+  uint32_t quality() const { return quality_; }
+  uint32_t windowBits() const { return window_bits_; }
+  Compressor::BrotliCompressorImpl::EncoderMode encoderMode() const { return encoder_mode_; }
+  uint32_t chunkSize() const { return chunk_size_; }
+
+private:
+  static Compressor::BrotliCompressorImpl::EncoderMode encoderModeEnum(
+      envoy::extensions::filters::http::brotli::v3::Brotli::EncoderMode encoder_mode);
+
+  const uint32_t quality_;
+  const uint32_t window_bits_;
+  const Compressor::BrotliCompressorImpl::EncoderMode encoder_mode_;
+  const uint32_t chunk_size_;
+};
+
+} // namespace Brotli
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
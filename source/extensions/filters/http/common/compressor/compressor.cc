@@ -1,7 +1,9 @@
 #include "extensions/filters/http/common/compressor/compressor.h"
 
 #include "common/buffer/buffer_impl.h"
+#include "common/common/hash.h"
 #include "common/http/header_map_impl.h"
+#include "common/protobuf/utility.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -14,6 +16,10 @@ namespace {
 // Default minimum length of an upstream response that allows compression.
 const uint64_t DefaultMinimumContentLength = 30;
 
+// Default maximum length of an upstream response that is kept in the response cache.
+const uint64_t DefaultMaxCachedContentLength = 1024 * 1024;
+const uint64_t DefaultMaxCachedTotalBytes = 64 * 1024 * 1024;
+
 // Default content types will be used if any is provided by the user.
 const std::vector<std::string>& defaultContentEncoding() {
   CONSTRUCT_ON_FIRST_USE(
@@ -43,7 +49,7 @@ CompressorFilterConfig::CompressorFilterConfig(
       disable_on_etag_header_(compressor.disable_on_etag_header()),
       remove_accept_encoding_header_(compressor.remove_accept_encoding_header()),
       stats_(generateStats(stats_prefix, scope)), enabled_(compressor.runtime_enabled(), runtime),
-      content_encoding_(content_encoding) {}
+      content_encoding_(content_encoding), response_cache_(createResponseCache(compressor)) {}
 
 StringUtil::CaseUnorderedSet
 CompressorFilterConfig::contentTypeSet(const Protobuf::RepeatedPtrField<std::string>& types) {
@@ -57,6 +63,19 @@ uint32_t CompressorFilterConfig::contentLengthUint(Protobuf::uint32 length) {
   return length > 0 ? length : DefaultMinimumContentLength;
 }
 
+ResponseCachePtr CompressorFilterConfig::createResponseCache(
+    const envoy::extensions::filters::http::compressor::v3::Compressor& compressor) {
+  if (!compressor.has_response_cache()) {
+    return nullptr;
+  }
+  return std::make_unique<ResponseCache>(
+      compressor.response_cache().max_entries(),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(compressor.response_cache(), max_entry_bytes,
+                                      DefaultMaxCachedContentLength),
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(compressor.response_cache(), max_total_bytes,
+                                      DefaultMaxCachedTotalBytes));
+}
+
 CompressorFilter::CompressorFilter(const CompressorFilterConfigSharedPtr config)
     : skip_compression_{true}, config_(std::move(config)) {}
 
@@ -72,6 +91,12 @@ Http::FilterHeadersStatus CompressorFilter::decodeHeaders(Http::RequestHeaderMap
     headers.removeAcceptEncoding();
   }
 
+  if (config_->responseCache() != nullptr) {
+    const absl::string_view host = headers.Host() ? headers.Host()->value().getStringView() : "";
+    const absl::string_view path = headers.Path() ? headers.Path()->value().getStringView() : "";
+    cache_request_key_ = absl::StrCat(host, "\n", path);
+  }
+
   return Http::FilterHeadersStatus::Continue;
 }
 
@@ -105,13 +130,23 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
       !hasCacheControlNoTransform(headers) && isEtagAllowed(headers) &&
       isTransferEncodingAllowed(headers) && !headers.ContentEncoding()) {
     skip_compression_ = false;
+    if (config_->responseCache() != nullptr) {
+      // This has to look at the etag before it is sanitized.
+      prepareResponseCache(headers);
+    }
     sanitizeEtagHeader(headers);
     insertVaryHeader(headers);
-    headers.removeContentLength();
+    if (cached_body_ != nullptr) {
+      headers.setContentLength(cached_body_->size());
+    } else {
+      headers.removeContentLength();
+    }
     headers.setContentEncoding(config_->contentEncoding());
     config_->stats().compressed_.inc();
-    // Finally instantiate the compressor.
-    compressor_ = config_->makeCompressor();
+    // Finally instantiate the compressor, unless the body is served from the cache.
+    if (cached_body_ == nullptr) {
+      compressor_ = config_->makeCompressor();
+    }
   } else {
     config_->stats().not_compressed_.inc();
   }
@@ -119,24 +154,125 @@ Http::FilterHeadersStatus CompressorFilter::encodeHeaders(Http::ResponseHeaderMa
 }
 
 Http::FilterDataStatus CompressorFilter::encodeData(Buffer::Instance& data, bool end_stream) {
-  if (!skip_compression_) {
-    config_->stats().total_uncompressed_bytes_.add(data.length());
-    compressor_->compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
-    config_->stats().total_compressed_bytes_.add(data.length());
+  if (skip_compression_) {
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (cached_body_ != nullptr) {
+    serveCachedBody(data);
+    return Http::FilterDataStatus::Continue;
+  }
+
+  if (buffer_for_cache_) {
+    cache_buffer_.move(data);
+    const bool within_limit = cache_buffer_.length() <= config_->responseCache()->maxEntryBytes();
+    if (!end_stream && within_limit) {
+      return Http::FilterDataStatus::StopIterationNoBuffer;
+    }
+    data.move(cache_buffer_);
+    if (within_limit) {
+      compressForCache(data);
+      return Http::FilterDataStatus::Continue;
+    }
+    // The body turned out to be larger than its content-length said. Stop caching and stream it.
+    buffer_for_cache_ = false;
   }
+
+  config_->stats().total_uncompressed_bytes_.add(data.length());
+  compressor_->compress(data, end_stream ? Compressor::State::Finish : Compressor::State::Flush);
+  config_->stats().total_compressed_bytes_.add(data.length());
   return Http::FilterDataStatus::Continue;
 }
 
 Http::FilterTrailersStatus CompressorFilter::encodeTrailers(Http::ResponseTrailerMap&) {
   if (!skip_compression_) {
-    Buffer::OwnedImpl empty_buffer;
-    compressor_->compress(empty_buffer, Compressor::State::Finish);
-    config_->stats().total_compressed_bytes_.add(empty_buffer.length());
-    encoder_callbacks_->addEncodedData(empty_buffer, true);
+    Buffer::OwnedImpl buffer;
+    if (cached_body_ != nullptr) {
+      serveCachedBody(buffer);
+    } else if (buffer_for_cache_) {
+      buffer.move(cache_buffer_);
+      compressForCache(buffer);
+    } else {
+      compressor_->compress(buffer, Compressor::State::Finish);
+      config_->stats().total_compressed_bytes_.add(buffer.length());
+    }
+    if (buffer.length() > 0) {
+      encoder_callbacks_->addEncodedData(buffer, true);
+    }
   }
   return Http::FilterTrailersStatus::Continue;
 }
 
+// Decide whether the response may go through the response cache. Responses with a strong etag are
+// looked up right away by resource and etag; other responses are buffered and looked up by content
+// once complete. Only full responses of a known, bounded length are considered.
+void CompressorFilter::prepareResponseCache(Http::ResponseHeaderMap& headers) {
+  uint64_t content_length;
+  if (headers.Status() == nullptr || headers.Status()->value().getStringView() != "200" ||
+      headers.ContentLength() == nullptr ||
+      !absl::SimpleAtoi(headers.ContentLength()->value().getStringView(), &content_length) ||
+      content_length > config_->responseCache()->maxEntryBytes()) {
+    return;
+  }
+
+  const Http::HeaderEntry* etag = headers.Etag();
+  if (etag != nullptr) {
+    const absl::string_view value = etag->value().getStringView();
+    if (!(value.length() > 2 && (value[0] == 'w' || value[0] == 'W') && value[1] == '/')) {
+      cache_key_ = absl::StrCat(config_->contentEncoding(), "\n", cache_request_key_, "\n", value);
+      cached_body_ = config_->responseCache()->lookup(cache_key_);
+      if (cached_body_ != nullptr) {
+        config_->stats().response_cache_hit_.inc();
+        return;
+      }
+      config_->stats().response_cache_miss_.inc();
+    }
+  }
+  buffer_for_cache_ = true;
+}
+
+// Compress a complete buffered body and insert the result in the cache. If the body has no etag,
+// first try to find an earlier compression of the same content. The hash only narrows the lookup
+// down, a hit requires the cached content to be identical, so that colliding bodies can never be
+// served in place of each other.
+void CompressorFilter::compressForCache(Buffer::Instance& data) {
+  config_->stats().total_uncompressed_bytes_.add(data.length());
+  std::string content;
+  if (cache_key_.empty()) {
+    uint64_t hash = 0;
+    for (const Buffer::RawSlice& slice : data.getRawSlices()) {
+      hash = HashUtil::xxHash64(
+          absl::string_view(static_cast<const char*>(slice.mem_), slice.len_), hash);
+    }
+    cache_key_ = absl::StrCat(config_->contentEncoding(), "\n", data.length(), "\n", hash);
+    cached_body_ = config_->responseCache()->lookup(cache_key_, data);
+    if (cached_body_ != nullptr) {
+      config_->stats().response_cache_hit_.inc();
+      data.drain(data.length());
+      serveCachedBody(data);
+      return;
+    }
+    config_->stats().response_cache_miss_.inc();
+    content = data.toString();
+  }
+
+  compressor_->compress(data, Compressor::State::Finish);
+  config_->stats().total_compressed_bytes_.add(data.length());
+  config_->responseCache()->insert(cache_key_, std::make_shared<const std::string>(data.toString()),
+                                   content);
+}
+
+// Replace the upstream body with the cached one. The cached body is emitted once, with the first
+// frame; the rest of the upstream body is discarded.
+void CompressorFilter::serveCachedBody(Buffer::Instance& data) {
+  data.drain(data.length());
+  if (!cached_body_served_) {
+    cached_body_served_ = true;
+    data.add(*cached_body_);
+    config_->stats().total_compressed_bytes_.add(data.length());
+  }
+}
+
 bool CompressorFilter::hasCacheControlNoTransform(Http::ResponseHeaderMap& headers) const {
   const Http::HeaderEntry* cache_control = headers.CacheControl();
   if (cache_control) {
@@ -386,7 +522,10 @@ bool CompressorFilter::isTransferEncodingAllowed(Http::ResponseHeaderMap& header
           // or any other compression type known to Envoy
           absl::EqualsIgnoreCase(trimmed_value, Http::Headers::get().TransferEncodingValues.Gzip) ||
           absl::EqualsIgnoreCase(trimmed_value,
-                                 Http::Headers::get().TransferEncodingValues.Deflate)) {
+                                 Http::Headers::get().TransferEncodingValues.Deflate) ||
+          absl::EqualsIgnoreCase(trimmed_value,
+                                 Http::Headers::get().TransferEncodingValues.Brotli) ||
+          absl::EqualsIgnoreCase(trimmed_value, Http::Headers::get().TransferEncodingValues.Zstd)) {
         return false;
       }
     }
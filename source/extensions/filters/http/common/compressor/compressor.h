@@ -6,9 +6,11 @@
 #include "envoy/stats/stats_macros.h"
 #include "envoy/stream_info/filter_state.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/protobuf/protobuf.h"
 #include "common/runtime/runtime_protos.h"
 
+#include "extensions/filters/http/common/compressor/response_cache.h"
 #include "extensions/filters/http/common/pass_through_filter.h"
 
 namespace Envoy {
@@ -32,6 +34,9 @@ namespace Compressors {
  *
  * "header_gzip" is specific to the gzip filter and is deprecated since it duplicates
  * "header_compressor_used".
+ *
+ * "response_cache_hit" and "response_cache_miss" count lookups in the compressed response cache,
+ * when one is configured.
  */
 #define ALL_COMPRESSOR_STATS(COUNTER)                                                              \
   COUNTER(compressed)                                                                              \
@@ -46,7 +51,9 @@ namespace Compressors {
   COUNTER(total_uncompressed_bytes)                                                                \
   COUNTER(total_compressed_bytes)                                                                  \
   COUNTER(content_length_too_small)                                                                \
-  COUNTER(not_compressed_etag)
+  COUNTER(not_compressed_etag)                                                                     \
+  COUNTER(response_cache_hit)                                                                      \
+  COUNTER(response_cache_miss)
 
 /**
  * Struct definition for compressor stats. @see stats_macros.h
@@ -70,6 +77,8 @@ public:
   uint32_t minimumLength() const { return content_length_; }
   const std::string contentEncoding() const { return content_encoding_; };
   const std::map<std::string, uint32_t> registeredCompressors() const;
+  // @return the compressed response cache, or nullptr if caching is not configured.
+  ResponseCache* responseCache() const { return response_cache_.get(); }
 
 protected:
   CompressorFilterConfig(
@@ -83,6 +92,9 @@ private:
 
   static uint32_t contentLengthUint(Protobuf::uint32 length);
 
+  static ResponseCachePtr createResponseCache(
+      const envoy::extensions::filters::http::compressor::v3::Compressor& compressor);
+
   static CompressorStats generateStats(const std::string& prefix, Stats::Scope& scope) {
     return CompressorStats{ALL_COMPRESSOR_STATS(POOL_COUNTER_PREFIX(scope, prefix))};
   }
@@ -95,6 +107,7 @@ private:
   const CompressorStats stats_;
   Runtime::FeatureFlag enabled_;
   const std::string content_encoding_;
+  const ResponseCachePtr response_cache_;
 };
 using CompressorFilterConfigSharedPtr = std::shared_ptr<CompressorFilterConfig>;
 
@@ -131,6 +144,10 @@ private:
   void sanitizeEtagHeader(Http::ResponseHeaderMap& headers);
   void insertVaryHeader(Http::ResponseHeaderMap& headers);
 
+  void prepareResponseCache(Http::ResponseHeaderMap& headers);
+  void compressForCache(Buffer::Instance& data);
+  void serveCachedBody(Buffer::Instance& data);
+
   class EncodingDecision : public StreamInfo::FilterState::Object {
   public:
     enum class HeaderStat { NotValid, Identity, Wildcard, ValidCompressor };
@@ -151,6 +168,17 @@ private:
   std::unique_ptr<Compressor::Compressor> compressor_;
   const CompressorFilterConfigSharedPtr config_;
   std::unique_ptr<std::string> accept_encoding_;
+
+  // Response cache state, only used when the config has a cache. The request key identifies the
+  // resource (host and path) for etag based lookups; the cache key is set once a response is known
+  // to be cacheable. The body is buffered until it is complete so that it can be compressed and
+  // inserted, or looked up by content, as a whole.
+  std::string cache_request_key_;
+  std::string cache_key_;
+  bool buffer_for_cache_{false};
+  bool cached_body_served_{false};
+  Buffer::OwnedImpl cache_buffer_;
+  ResponseCache::BodySharedPtr cached_body_;
 };
 
 } // namespace Compressors
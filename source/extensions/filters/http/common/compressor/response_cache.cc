@@ -0,0 +1,94 @@
+#include "extensions/filters/http/common/compressor/response_cache.h"
+
+#include <iterator>
+
+#include "common/common/lock_guard.h"
+
+#include "absl/strings/match.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+
+namespace {
+
+bool contentEquals(absl::string_view cached, const Buffer::Instance& content) {
+  if (cached.size() != content.length()) {
+    return false;
+  }
+  for (const Buffer::RawSlice& slice : content.getRawSlices()) {
+    const absl::string_view part(static_cast<const char*>(slice.mem_), slice.len_);
+    if (!absl::StartsWith(cached, part)) {
+      return false;
+    }
+    cached.remove_prefix(part.size());
+  }
+  return true;
+}
+
+} // namespace
+
+ResponseCache::BodySharedPtr ResponseCache::lookup(const std::string& key) {
+  Thread::LockGuard lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->body_;
+}
+
+ResponseCache::BodySharedPtr ResponseCache::lookup(const std::string& key,
+                                                   const Buffer::Instance& content) {
+  Thread::LockGuard lock(lock_);
+  auto it = index_.find(key);
+  if (it == index_.end() || !contentEquals(it->second->content_, content)) {
+    return nullptr;
+  }
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->body_;
+}
+
+void ResponseCache::insert(const std::string& key, BodySharedPtr body, absl::string_view content) {
+  Entry entry{key, std::move(body), std::string(content)};
+  if (entry.bytes() > max_total_bytes_) {
+    return;
+  }
+
+  Thread::LockGuard lock(lock_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    erase(it->second);
+  }
+  while (!entries_.empty() &&
+         (entries_.size() >= max_entries_ || bytes_ + entry.bytes() > max_total_bytes_)) {
+    erase(std::prev(entries_.end()));
+  }
+  bytes_ += entry.bytes();
+  entries_.emplace_front(std::move(entry));
+  index_.emplace(key, entries_.begin());
+}
+
+void ResponseCache::erase(EntryList::iterator it) {
+  bytes_ -= it->bytes();
+  index_.erase(it->key_);
+  entries_.erase(it);
+}
+
+size_t ResponseCache::size() {
+  Thread::LockGuard lock(lock_);
+  return entries_.size();
+}
+
+uint64_t ResponseCache::bytes() {
+  Thread::LockGuard lock(lock_);
+  return bytes_;
+}
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
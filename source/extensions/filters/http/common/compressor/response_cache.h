@@ -0,0 +1,93 @@
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/buffer/buffer.h"
+
+#include "common/common/thread.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+
+/**
+ * Bounded LRU cache of compressed response bodies. It is shared by all workers of a filter config,
+ * so all operations are synchronized. Bodies are immutable once inserted and handed out by shared
+ * pointer so that they stay valid after eviction. The cache is bounded both by the number of
+ * entries and by the total size of the keys, bodies and uncompressed contents it holds.
+ */
+class ResponseCache {
+public:
+  using BodySharedPtr = std::shared_ptr<const std::string>;
+
+  ResponseCache(uint32_t max_entries, uint64_t max_entry_bytes, uint64_t max_total_bytes)
+      : max_entries_(max_entries), max_entry_bytes_(max_entry_bytes),
+        max_total_bytes_(max_total_bytes) {}
+
+  /**
+   * @return the cached body for the key or nullptr. A hit makes the entry most recently used.
+   */
+  BodySharedPtr lookup(const std::string& key);
+
+  /**
+   * Looks up a body which was inserted along with its uncompressed content. As the key is only a
+   * hash of the content, the hit is only returned if the cached content is identical to the given
+   * one.
+   * @return the cached body for the key and content or nullptr.
+   */
+  BodySharedPtr lookup(const std::string& key, const Buffer::Instance& content);
+
+  /**
+   * Insert or replace the body for the key, evicting least recently used entries until the cache
+   * is within its bounds. Entries which are larger than the whole cache are not inserted.
+   * @param content the uncompressed content, for entries which are looked up by content.
+   */
+  void insert(const std::string& key, BodySharedPtr body, absl::string_view content = {});
+
+  /**
+   * @return the size in bytes of the largest uncompressed response worth caching.
+   */
+  uint64_t maxEntryBytes() const { return max_entry_bytes_; }
+
+  size_t size();
+
+  /**
+   * @return the total size in bytes of the cached entries.
+   */
+  uint64_t bytes();
+
+private:
+  struct Entry {
+    uint64_t bytes() const { return key_.size() + body_->size() + content_.size(); }
+
+    std::string key_;
+    BodySharedPtr body_;
+    std::string content_;
+  };
+  using EntryList = std::list<Entry>;
+
+  void erase(EntryList::iterator it) ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  const uint32_t max_entries_;
+  const uint64_t max_entry_bytes_;
+  const uint64_t max_total_bytes_;
+  Thread::MutexBasicLockable lock_;
+  // Front is most recently used.
+  EntryList entries_ ABSL_GUARDED_BY(lock_);
+  uint64_t bytes_ ABSL_GUARDED_BY(lock_){};
+  absl::flat_hash_map<std::string, EntryList::iterator> index_ ABSL_GUARDED_BY(lock_);
+};
+using ResponseCachePtr = std::unique_ptr<ResponseCache>;
+
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
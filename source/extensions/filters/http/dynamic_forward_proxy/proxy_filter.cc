@@ -133,6 +133,15 @@ void ProxyFilter::onLoadDnsCacheComplete() {
   decoder_callbacks_->continueDecoding();
 }
 
+void ProxyFilter::onLoadDnsCacheOverflow() {
+  ENVOY_STREAM_LOG(debug, "DNS cache overflow while loading", *decoder_callbacks_);
+  ASSERT(circuit_breaker_ != nullptr);
+  circuit_breaker_.reset();
+  decoder_callbacks_->sendLocalReply(Http::Code::ServiceUnavailable,
+                                     ResponseStrings::get().DnsCacheOverflow, nullptr,
+                                     absl::nullopt, ResponseStrings::get().DnsCacheOverflow);
+}
+
 } // namespace DynamicForwardProxy
 } // namespace HttpFilters
 } // namespace Extensions
@@ -56,6 +56,7 @@ public:
 
   // Extensions::Common::DynamicForwardProxy::DnsCache::LoadDnsCacheEntryCallbacks
   void onLoadDnsCacheComplete() override;
+  void onLoadDnsCacheOverflow() override;
 
 private:
   const ProxyFilterConfigSharedPtr config_;
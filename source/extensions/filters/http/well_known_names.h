@@ -12,6 +12,8 @@ namespace HttpFilters {
  */
 class HttpFilterNameValues {
 public:
+  // Brotli filter
+  const std::string Brotli = "envoy.filters.http.brotli";
   // Buffer filter
   const std::string Buffer = "envoy.filters.http.buffer";
   // Cache filter
@@ -72,6 +74,8 @@ public:
   const std::string AwsRequestSigning = "envoy.filters.http.aws_request_signing";
   // AWS Lambda filter
   const std::string AwsLambda = "envoy.filters.http.aws_lambda";
+  // Zstd filter
+  const std::string Zstd = "envoy.filters.http.zstd";
 };
 
 using HttpFilterNames = ConstSingleton<HttpFilterNameValues>;
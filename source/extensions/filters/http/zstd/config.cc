@@ -0,0 +1,28 @@
+#include "extensions/filters/http/zstd/config.h"
+
+#include "extensions/filters/http/zstd/zstd_filter.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Zstd {
+
+Http::FilterFactoryCb ZstdFilterFactory::createFilterFactoryFromProtoTyped(
+    const envoy::extensions::filters::http::zstd::v3::Zstd& proto_config,
+    const std::string& stats_prefix, Server::Configuration::FactoryContext& context) {
+  Common::Compressors::CompressorFilterConfigSharedPtr config = std::make_shared<ZstdFilterConfig>(
+      proto_config, stats_prefix, context.scope(), context.runtime());
+  return [config](Http::FilterChainFactoryCallbacks& callbacks) -> void {
+    callbacks.addStreamFilter(std::make_shared<Common::Compressors::CompressorFilter>(config));
+  };
+}
+
+/**
+ * Static registration for the zstd filter. @see NamedHttpFilterConfigFactory.
+ */
+REGISTER_FACTORY(ZstdFilterFactory, Server::Configuration::NamedHttpFilterConfigFactory);
+
+} // namespace Zstd
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "envoy/extensions/filters/http/zstd/v3/zstd.pb.h"
+#include "envoy/extensions/filters/http/zstd/v3/zstd.pb.validate.h"
+
+#include "extensions/filters/http/common/factory_base.h"
+#include "extensions/filters/http/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Zstd {
+
+/**
+ * Config registration for the zstd filter. @see NamedHttpFilterConfigFactory.
+ */
+class ZstdFilterFactory
+    : public Common::FactoryBase<envoy::extensions::filters::http::zstd::v3::Zstd> {
+public:
+  ZstdFilterFactory() : FactoryBase(HttpFilterNames::get().Zstd) {}
+
+private:
+  Http::FilterFactoryCb
+  createFilterFactoryFromProtoTyped(const envoy::extensions::filters::http::zstd::v3::Zstd& config,
+                                    const std::string& stats_prefix,
+                                    Server::Configuration::FactoryContext& context) override;
+};
+
+DECLARE_FACTORY(ZstdFilterFactory);
+
+} // namespace Zstd
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,42 @@
+#include "extensions/filters/http/zstd/zstd_filter.h"
+
+#include "common/http/headers.h"
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Zstd {
+
+namespace {
+// Default compression level.
+const uint32_t DefaultCompressionLevel = 3;
+
+// Zero lets the library derive the window size from the compression level.
+const uint32_t DefaultWindowLog = 0;
+
+// Default size of the compressor's output buffer.
+const uint32_t DefaultChunkSize = 4096;
+
+} // namespace
+
+ZstdFilterConfig::ZstdFilterConfig(const envoy::extensions::filters::http::zstd::v3::Zstd& zstd,
+                                   const std::string& stats_prefix, Stats::Scope& scope,
+                                   Runtime::Loader& runtime)
+    : CompressorFilterConfig(zstd.compressor(), stats_prefix + "zstd.", scope, runtime,
+                             Http::Headers::get().ContentEncodingValues.Zstd),
+      compression_level_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, compression_level, DefaultCompressionLevel)),
+      window_log_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, window_log, DefaultWindowLog)),
+      enable_checksum_(zstd.enable_checksum()),
+      chunk_size_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(zstd, chunk_size, DefaultChunkSize)) {}
+
+std::unique_ptr<Compressor::Compressor> ZstdFilterConfig::makeCompressor() {
+  return std::make_unique<Compressor::ZstdCompressorImpl>(compression_level_, window_log_,
+                                                          enable_checksum_, chunk_size_);
+}
+
+} // namespace Zstd
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
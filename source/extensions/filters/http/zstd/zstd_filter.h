@@ -0,0 +1,39 @@
+#pragma once
+
+#include "envoy/extensions/filters/http/zstd/v3/zstd.pb.h"
+
+#include "common/compressor/zstd_compressor_impl.h"
+
+#include "extensions/filters/http/common/compressor/compressor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Zstd {
+
+/**
+ * Configuration for the zstd filter.
+ */
+class ZstdFilterConfig : public Common::Compressors::CompressorFilterConfig {
+public:
+  ZstdFilterConfig(const envoy::extensions::filters::http::zstd::v3::Zstd& zstd,
+                   const std::string& stats_prefix, Stats::Scope& scope, Runtime::Loader& runtime);
+
+  std::unique_ptr<Compressor::Compressor> makeCompressor() override;
+
+  uint32_t compressionLevel() const { return compression_level_; }
+  uint32_t windowLog() const { return window_log_; }
+  bool enableChecksum() const { return enable_checksum_; }
+  uint32_t chunkSize() const { return chunk_size_; }
+
+private:
+  const uint32_t compression_level_;
+  const uint32_t window_log_;
+  const bool enable_checksum_;
+  const uint32_t chunk_size_;
+};
+
+} // namespace Zstd
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
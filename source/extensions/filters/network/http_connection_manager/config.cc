@@ -19,6 +19,7 @@
 #include "common/config/utility.h"
 #include "common/http/conn_manager_utility.h"
 #include "common/http/default_server_string.h"
+#include "common/http/filter_latency.h"
 #include "common/http/http1/codec_impl.h"
 #include "common/http/http2/codec_impl.h"
 #include "common/http/http3/quic_codec_factory.h"
@@ -31,6 +32,7 @@
 #include "common/runtime/runtime_impl.h"
 #include "common/tracing/http_tracer_config_impl.h"
 #include "common/tracing/http_tracer_manager_impl.h"
+#include "common/tracing/sampling_rate_limiter.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -368,10 +370,23 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     const uint32_t max_path_tag_length = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
         tracing_config, max_path_tag_length, Tracing::DefaultMaxPathTagLength);
 
+    Tracing::SamplingRateLimiterSharedPtr random_sampling_limiter;
+    if (tracing_config.has_max_random_samples_per_second()) {
+      random_sampling_limiter = std::make_shared<Tracing::SamplingRateLimiter>(
+          tracing_config.max_random_samples_per_second().value(),
+          context_.dispatcher().timeSource());
+    }
+    absl::optional<std::chrono::milliseconds> tail_sampling_min_duration;
+    if (tracing_config.tail_sampling().has_min_duration()) {
+      tail_sampling_min_duration = std::chrono::milliseconds(
+          DurationUtil::durationToMilliseconds(tracing_config.tail_sampling().min_duration()));
+    }
+
     tracing_config_ =
         std::make_unique<Http::TracingConnectionManagerConfig>(Http::TracingConnectionManagerConfig{
             tracing_operation_name, custom_tags, client_sampling, random_sampling, overall_sampling,
-            tracing_config.verbose(), max_path_tag_length});
+            tracing_config.verbose(), max_path_tag_length, random_sampling_limiter,
+            tail_sampling_min_duration, tracing_config.tail_sampling().server_errors()});
   }
 
   for (const auto& access_log : config.access_log()) {
@@ -409,6 +424,11 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     NOT_REACHED_GCOVR_EXCL_LINE;
   }
 
+  if (config.has_filter_latency_stats()) {
+    filter_latency_sampling_ = PROTOBUF_PERCENT_TO_ROUNDED_INTEGER_OR_DEFAULT(
+        config.filter_latency_stats(), sampling, 10000, 10000);
+  }
+
   const auto& filters = config.http_filters();
   for (int32_t i = 0; i < filters.size(); i++) {
     processFilter(filters[i], i, "http", filter_factories_, "http", i == filters.size() - 1);
@@ -464,6 +484,14 @@ void HttpConnectionManagerConfig::processFilter(
   bool is_terminal = factory.isTerminalFilter();
   Config::Utility::validateTerminalFilters(proto_config.name(), factory.name(), filter_chain_type,
                                            is_terminal, last_filter_in_current_config);
+  if (filter_latency_sampling_.has_value()) {
+    callback = Http::FilterLatencyConfig::wrapFactory(
+        std::move(callback),
+        std::make_shared<Http::FilterLatencyConfig>(
+            fmt::format("{}filter_latency.{}.", stats_prefix_, proto_config.name()),
+            context_.scope(), filter_latency_sampling_.value(), context_.random(),
+            context_.timeSource()));
+  }
   filter_factories.push_back(callback);
 }
 
@@ -224,6 +224,8 @@ private:
   const bool merge_slashes_;
   const envoy::config::core::v3::HttpProtocolOptions::HeadersWithUnderscoresAction
       headers_with_underscores_action_;
+  // The number of streams out of 10000 whose filters are timed, unset if filters are not timed.
+  absl::optional<uint64_t> filter_latency_sampling_;
 
   // Default idle timeout is 5 minutes if nothing is specified in the HCM config.
   static const uint64_t StreamIdleTimeoutMs = 5 * 60 * 1000;
@@ -0,0 +1,43 @@
+#include "extensions/resource_monitors/cgroup_cpu/cgroup_cpu_monitor.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupCpuMonitor {
+
+CgroupCpuMonitor::CgroupCpuMonitor(
+    const envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig& config,
+    Common::CgroupStatsReaderPtr stats, TimeSource& time_source)
+    : max_cpus_(config.max_cpus()), stats_(std::move(stats)), time_source_(time_source) {}
+
+void CgroupCpuMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  try {
+    const double cpus = stats_->cpuLimit().value_or(max_cpus_);
+    if (cpus == 0) {
+      throw EnvoyException("cgroup has no CPU quota");
+    }
+    const Sample sample{time_source_.monotonicTime(), stats_->cpuUsage()};
+    // The first update has no interval to measure the usage over yet.
+    usage.resource_pressure_ = 0;
+    if (last_sample_.has_value() && sample.time_ > last_sample_->time_ &&
+        sample.usage_ >= last_sample_->usage_) {
+      const std::chrono::duration<double> used = sample.usage_ - last_sample_->usage_;
+      const std::chrono::duration<double> elapsed = sample.time_ - last_sample_->time_;
+      usage.resource_pressure_ = used / (elapsed * cpus);
+    }
+    last_sample_ = sample;
+  } catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+    return;
+  }
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CgroupCpuMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupCpuMonitor {
+
+/**
+ * CPU monitor of the cgroup Envoy runs in, relative to the CFS bandwidth quota of the cgroup. The
+ * pressure is the CPU time consumed between two updates over the CPU time the quota allows in the
+ * same interval.
+ */
+class CgroupCpuMonitor : public Server::ResourceMonitor {
+public:
+  CgroupCpuMonitor(
+      const envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig& config,
+      Common::CgroupStatsReaderPtr stats, TimeSource& time_source);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  struct Sample {
+    MonotonicTime time_;
+    std::chrono::microseconds usage_;
+  };
+
+  const double max_cpus_;
+  Common::CgroupStatsReaderPtr stats_;
+  TimeSource& time_source_;
+  absl::optional<Sample> last_sample_;
+};
+
+} // namespace CgroupCpuMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,33 @@
+#include "extensions/resource_monitors/cgroup_cpu/config.h"
+
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.h"
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/cgroup_cpu/cgroup_cpu_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupCpuMonitor {
+
+Server::ResourceMonitorPtr CgroupCpuMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<CgroupCpuMonitor>(
+      config,
+      std::make_unique<Common::CgroupStatsReaderImpl>(
+          config.cgroup_root().empty() ? Common::DefaultCgroupRoot : config.cgroup_root(),
+          Common::ProcSelfCgroup),
+      context.api().timeSource());
+}
+
+/**
+ * Static registration for the cgroup CPU monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CgroupCpuMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CgroupCpuMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.h"
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupCpuMonitor {
+
+class CgroupCpuMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig> {
+public:
+  CgroupCpuMonitorFactory() : FactoryBase(ResourceMonitorNames::get().CgroupCpu) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig& config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace CgroupCpuMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
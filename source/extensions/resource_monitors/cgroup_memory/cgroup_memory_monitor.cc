@@ -0,0 +1,34 @@
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "envoy/common/exception.h"
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+CgroupMemoryMonitor::CgroupMemoryMonitor(
+    const envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig& config,
+    Common::CgroupStatsReaderPtr stats)
+    : max_memory_(config.max_memory_bytes()), stats_(std::move(stats)) {}
+
+void CgroupMemoryMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  Server::ResourceUsage usage;
+  try {
+    const uint64_t limit = stats_->memoryLimit().value_or(max_memory_);
+    if (limit == 0) {
+      throw EnvoyException("cgroup has no memory limit");
+    }
+    usage.resource_pressure_ = stats_->memoryUsage() / static_cast<double>(limit);
+  } catch (const EnvoyException& error) {
+    callbacks.onFailure(error);
+    return;
+  }
+  callbacks.onSuccess(usage);
+}
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
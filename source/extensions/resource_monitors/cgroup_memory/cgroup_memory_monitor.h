@@ -0,0 +1,33 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.h"
+#include "envoy/server/resource_monitor.h"
+
+#include "extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+/**
+ * Memory monitor of the cgroup Envoy runs in, relative to the memory limit of the cgroup.
+ */
+class CgroupMemoryMonitor : public Server::ResourceMonitor {
+public:
+  CgroupMemoryMonitor(
+      const envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig& config,
+      Common::CgroupStatsReaderPtr stats);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  const uint64_t max_memory_;
+  Common::CgroupStatsReaderPtr stats_;
+};
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
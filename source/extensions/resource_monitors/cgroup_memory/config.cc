@@ -0,0 +1,31 @@
+#include "extensions/resource_monitors/cgroup_memory/config.h"
+
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.h"
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+
+Server::ResourceMonitorPtr CgroupMemoryMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig& config,
+    Server::Configuration::ResourceMonitorFactoryContext& /*unused_context*/) {
+  return std::make_unique<CgroupMemoryMonitor>(
+      config, std::make_unique<Common::CgroupStatsReaderImpl>(
+                  config.cgroup_root().empty() ? Common::DefaultCgroupRoot : config.cgroup_root(),
+                  Common::ProcSelfCgroup));
+}
+
+/**
+ * Static registration for the cgroup memory monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(CgroupMemoryMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,224 @@
+#include "extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "envoy/common/exception.h"
+
+#include "common/common/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+namespace {
+
+// cgroup v1 reports the lack of a memory limit as the largest page aligned 64-bit value, rather
+// than as "max" like cgroup v2 does. Anything above this is beyond any real memory size.
+constexpr uint64_t UnlimitedV1Memory = 1ULL << 62;
+
+// The largest cgroup file read, memory.stat, has a few dozen lines.
+constexpr size_t MaxFileSize = 16384;
+
+} // namespace
+
+CgroupStatsReaderImpl::CgroupStatsReaderImpl(const std::string& root,
+                                             const std::string& proc_cgroup)
+    : CgroupStatsReaderImpl(root, readCgroupPaths(proc_cgroup)) {}
+
+CgroupStatsReaderImpl::CgroupStatsReaderImpl(const std::string& root, const CgroupPaths& paths)
+    : v2_(::access(absl::StrCat(root, "/cgroup.controllers").c_str(), F_OK) == 0),
+      memory_usage_(absl::StrCat(cgroupDirectory(root, paths, "memory"),
+                                 v2_ ? "/memory.current" : "/memory.usage_in_bytes")),
+      memory_limit_(absl::StrCat(cgroupDirectory(root, paths, "memory"),
+                                 v2_ ? "/memory.max" : "/memory.limit_in_bytes")),
+      memory_stat_(absl::StrCat(cgroupDirectory(root, paths, "memory"), "/memory.stat")),
+      cpu_usage_(absl::StrCat(cgroupDirectory(root, paths, "cpuacct"),
+                              v2_ ? "/cpu.stat" : "/cpuacct.usage")),
+      cpu_quota_(absl::StrCat(cgroupDirectory(root, paths, "cpu"),
+                              v2_ ? "/cpu.max" : "/cpu.cfs_quota_us")),
+      // Only read for cgroup v1, cgroup v2 has the period in cpu.max along with the quota.
+      cpu_period_(absl::StrCat(cgroupDirectory(root, paths, "cpu"), "/cpu.cfs_period_us")) {}
+
+CgroupStatsReaderImpl::CgroupPaths
+CgroupStatsReaderImpl::readCgroupPaths(const std::string& proc_cgroup) {
+  // Each line is "hierarchy-ID:controller-list:cgroup-path", where cgroup v2 has hierarchy 0 and
+  // no controllers, e.g. "4:cpu,cpuacct:/kubepods/pod1" or "0::/kubepods/pod1".
+  CgroupPaths paths;
+  std::ifstream file(proc_cgroup);
+  std::string line;
+  while (std::getline(file, line)) {
+    const size_t first = line.find(':');
+    const size_t second = first == std::string::npos ? first : line.find(':', first + 1);
+    if (second == std::string::npos) {
+      continue;
+    }
+    const std::string path = line.substr(second + 1);
+    const absl::string_view controllers =
+        absl::string_view(line).substr(first + 1, second - first - 1);
+    if (controllers.empty()) {
+      paths[""] = path;
+    }
+    for (const absl::string_view controller : StringUtil::splitToken(controllers, ",", false)) {
+      paths[std::string(controller)] = path;
+    }
+  }
+  return paths;
+}
+
+std::string CgroupStatsReaderImpl::cgroupDirectory(const std::string& root,
+                                                   const CgroupPaths& paths,
+                                                   const std::string& controller) const {
+  const std::string hierarchy = v2_ ? root : absl::StrCat(root, "/", controller);
+  const auto it = paths.find(v2_ ? "" : controller);
+  if (it == paths.end() || it->second == "/") {
+    return hierarchy;
+  }
+  // Without a cgroup namespace, /proc/self/cgroup has the full path of the cgroup while container
+  // runtimes mount only the cgroup of the container, at the root of the hierarchy.
+  const std::string directory = absl::StrCat(hierarchy, it->second);
+  return ::access(directory.c_str(), F_OK) == 0 ? directory : hierarchy;
+}
+
+uint64_t CgroupStatsReaderImpl::memoryUsage() {
+  const absl::optional<uint64_t> usage = memory_usage_.readValue();
+  if (!usage.has_value()) {
+    throw EnvoyException("invalid cgroup memory usage");
+  }
+  const uint64_t inactive_file =
+      memory_stat_.readStat(v2_ ? "inactive_file" : "total_inactive_file");
+  return usage.value() > inactive_file ? usage.value() - inactive_file : 0;
+}
+
+absl::optional<uint64_t> CgroupStatsReaderImpl::memoryLimit() {
+  const absl::optional<uint64_t> limit = memory_limit_.readValue();
+  if (limit.has_value() && limit.value() >= UnlimitedV1Memory) {
+    return absl::nullopt;
+  }
+  return limit;
+}
+
+std::chrono::microseconds CgroupStatsReaderImpl::cpuUsage() {
+  if (v2_) {
+    return std::chrono::microseconds(cpu_usage_.readStat("usage_usec"));
+  }
+  const absl::optional<uint64_t> usage = cpu_usage_.readValue();
+  if (!usage.has_value()) {
+    throw EnvoyException("invalid cgroup CPU usage");
+  }
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::nanoseconds(usage.value()));
+}
+
+absl::optional<double> CgroupStatsReaderImpl::cpuLimit() {
+  absl::optional<uint64_t> quota;
+  uint64_t period;
+  if (v2_) {
+    // cpu.max holds the quota and the period, e.g. "50000 100000" or "max 100000".
+    const std::vector<absl::string_view> fields =
+        StringUtil::splitToken(cpu_quota_.read(), " \n", false);
+    if (fields.size() != 2 || !absl::SimpleAtoi(fields[1], &period)) {
+      throw EnvoyException("invalid cgroup CPU quota");
+    }
+    uint64_t value;
+    if (fields[0] != "max") {
+      if (!absl::SimpleAtoi(fields[0], &value)) {
+        throw EnvoyException("invalid cgroup CPU quota");
+      }
+      quota = value;
+    }
+  } else {
+    // cgroup v1 reports the lack of a quota as -1.
+    const absl::string_view value = StringUtil::trim(cpu_quota_.read());
+    int64_t signed_quota;
+    if (!absl::SimpleAtoi(value, &signed_quota)) {
+      throw EnvoyException("invalid cgroup CPU quota");
+    }
+    if (signed_quota >= 0) {
+      quota = signed_quota;
+    }
+    const absl::optional<uint64_t> v1_period = cpu_period_.readValue();
+    if (!v1_period.has_value()) {
+      throw EnvoyException("invalid cgroup CPU period");
+    }
+    period = v1_period.value();
+  }
+
+  if (!quota.has_value()) {
+    return absl::nullopt;
+  }
+  if (period == 0) {
+    throw EnvoyException("invalid cgroup CPU period");
+  }
+  return static_cast<double>(quota.value()) / period;
+}
+
+CgroupStatsReaderImpl::File::~File() {
+  if (fd_ != -1) {
+    ::close(fd_);
+  }
+}
+
+absl::string_view CgroupStatsReaderImpl::File::read() {
+  if (fd_ == -1) {
+    fd_ = ::open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+      throw EnvoyException(absl::StrCat("unable to open ", path_, ": ", ::strerror(errno)));
+    }
+    buffer_.resize(MaxFileSize);
+  }
+
+  // cgroup files are regenerated on each read from the start, so the file is read whole.
+  size_t size = 0;
+  while (size < buffer_.size()) {
+    const ssize_t rc = ::pread(fd_, &buffer_[size], buffer_.size() - size, size);
+    if (rc < 0) {
+      throw EnvoyException(absl::StrCat("unable to read ", path_, ": ", ::strerror(errno)));
+    }
+    if (rc == 0) {
+      break;
+    }
+    size += rc;
+  }
+  return absl::string_view(buffer_.data(), size);
+}
+
+absl::optional<uint64_t> CgroupStatsReaderImpl::File::readValue() {
+  const absl::string_view value = StringUtil::trim(read());
+  if (value == "max") {
+    return absl::nullopt;
+  }
+  uint64_t result;
+  if (!absl::SimpleAtoi(value, &result)) {
+    throw EnvoyException(absl::StrCat("invalid value in ", path_));
+  }
+  return result;
+}
+
+uint64_t CgroupStatsReaderImpl::File::readStat(absl::string_view key) {
+  for (const absl::string_view line : StringUtil::splitToken(read(), "\n", false)) {
+    const size_t space = line.find(' ');
+    if (space != absl::string_view::npos && line.substr(0, space) == key) {
+      uint64_t result;
+      if (!absl::SimpleAtoi(line.substr(space + 1), &result)) {
+        break;
+      }
+      return result;
+    }
+  }
+  throw EnvoyException(absl::StrCat("unable to find ", key, " in ", path_));
+}
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/pure.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+
+// Where container runtimes mount the cgroup file system of the container.
+constexpr char DefaultCgroupRoot[] = "/sys/fs/cgroup";
+// Where the kernel lists the cgroup of the process in each hierarchy.
+constexpr char ProcSelfCgroup[] = "/proc/self/cgroup";
+
+/**
+ * Reads the memory and CPU usage and limits of the cgroup Envoy runs in, which are the limits that
+ * the OOM killer and the CFS bandwidth control enforce in containers.
+ */
+class CgroupStatsReader {
+public:
+  virtual ~CgroupStatsReader() = default;
+
+  /**
+   * @return the memory charged to the cgroup in bytes, less the inactive file cache which the
+   *         kernel reclaims before it runs out of memory.
+   * @throw EnvoyException if the usage can't be read.
+   */
+  virtual uint64_t memoryUsage() PURE;
+
+  /**
+   * @return the memory limit of the cgroup in bytes, or absl::nullopt if there is no limit.
+   * @throw EnvoyException if the limit can't be read.
+   */
+  virtual absl::optional<uint64_t> memoryLimit() PURE;
+
+  /**
+   * @return the CPU time consumed by the cgroup since it was created.
+   * @throw EnvoyException if the usage can't be read.
+   */
+  virtual std::chrono::microseconds cpuUsage() PURE;
+
+  /**
+   * @return the CPU quota of the cgroup as a number of CPUs, or absl::nullopt if there is no quota.
+   * @throw EnvoyException if the quota can't be read.
+   */
+  virtual absl::optional<double> cpuLimit() PURE;
+};
+
+using CgroupStatsReaderPtr = std::unique_ptr<CgroupStatsReader>;
+
+/**
+ * Reads the cgroup stats from the cgroup file system mounted at a given root, in either the v1
+ * (one hierarchy per controller) or the v2 (unified hierarchy) layout. The cgroup of the process
+ * within each hierarchy is looked up in /proc/self/cgroup. The files are kept open and read from
+ * the start on each update, so that a refresh is one pread(2) per file.
+ */
+class CgroupStatsReaderImpl : public CgroupStatsReader {
+public:
+  /**
+   * @param root supplies the mount point of the cgroup file system, typically /sys/fs/cgroup.
+   * @param proc_cgroup supplies the file listing the cgroup of the process in each hierarchy,
+   *        typically /proc/self/cgroup.
+   */
+  CgroupStatsReaderImpl(const std::string& root, const std::string& proc_cgroup);
+
+  // Common::CgroupStatsReader
+  uint64_t memoryUsage() override;
+  absl::optional<uint64_t> memoryLimit() override;
+  std::chrono::microseconds cpuUsage() override;
+  absl::optional<double> cpuLimit() override;
+
+private:
+  // The cgroup path of the process by controller, or by the empty string for cgroup v2.
+  using CgroupPaths = absl::flat_hash_map<std::string, std::string>;
+
+  CgroupStatsReaderImpl(const std::string& root, const CgroupPaths& paths);
+
+  static CgroupPaths readCgroupPaths(const std::string& proc_cgroup);
+  std::string cgroupDirectory(const std::string& root, const CgroupPaths& paths,
+                              const std::string& controller) const;
+
+  // A cgroup file which is opened on first use.
+  class File {
+  public:
+    explicit File(std::string path) : path_(std::move(path)) {}
+    ~File();
+
+    // @return the contents of the file, which remain valid until the next read.
+    absl::string_view read();
+    // @return the number in the file, or absl::nullopt if the file contains "max".
+    absl::optional<uint64_t> readValue();
+    // @return the value of the given key in a file of "key value" lines.
+    uint64_t readStat(absl::string_view key);
+
+  private:
+    const std::string path_;
+    int fd_{-1};
+    std::string buffer_;
+  };
+
+  const bool v2_;
+  File memory_usage_;
+  File memory_limit_;
+  File memory_stat_;
+  File cpu_usage_;
+  File cpu_quota_;
+  File cpu_period_;
+};
+
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
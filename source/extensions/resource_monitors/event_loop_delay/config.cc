@@ -0,0 +1,30 @@
+#include "extensions/resource_monitors/event_loop_delay/config.h"
+
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+Server::ResourceMonitorPtr EventLoopDelayMonitorFactory::createResourceMonitorFromProtoTyped(
+    const envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig&
+        config,
+    Server::Configuration::ResourceMonitorFactoryContext& context) {
+  return std::make_unique<EventLoopDelayMonitor>(config, context.api().timeSource(),
+                                                 context.threadLocal());
+}
+
+/**
+ * Static registration for the event loop delay resource monitor factory. @see RegistryFactory.
+ */
+REGISTER_FACTORY(EventLoopDelayMonitorFactory, Server::Configuration::ResourceMonitorFactory);
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.validate.h"
+#include "envoy/server/resource_monitor_config.h"
+
+#include "extensions/resource_monitors/common/factory_base.h"
+#include "extensions/resource_monitors/well_known_names.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+class EventLoopDelayMonitorFactory
+    : public Common::FactoryBase<
+          envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig> {
+public:
+  EventLoopDelayMonitorFactory() : FactoryBase(ResourceMonitorNames::get().EventLoopDelay) {}
+
+private:
+  Server::ResourceMonitorPtr createResourceMonitorFromProtoTyped(
+      const envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig&
+          config,
+      Server::Configuration::ResourceMonitorFactoryContext& context) override;
+};
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+#include <algorithm>
+
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+
+#include "common/protobuf/utility.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+EventLoopDelayMonitor::EventLoopDelayMonitor(
+    const envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig& config,
+    TimeSource& time_source, ThreadLocal::SlotAllocator& thread_local)
+    : max_delay_(std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(config, max_delay))),
+      time_source_(time_source), slot_(thread_local.allocateSlot()),
+      state_(std::make_shared<ProbeState>()) {}
+
+void EventLoopDelayMonitor::updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) {
+  std::chrono::nanoseconds delay;
+  bool pending;
+  {
+    Thread::LockGuard lock(state_->mutex_);
+    delay = state_->last_delay_;
+    pending = state_->posted_.has_value();
+    if (pending) {
+      // The pending probe is delayed at least by as long as it has been pending.
+      delay = std::max(delay, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                  time_source_.monotonicTime() - state_->posted_.value()));
+    }
+  }
+
+  // Only one probe is in flight at a time, so that a stuck worker doesn't pile them up.
+  if (!pending) {
+    postProbe();
+  }
+
+  callbacks.onSuccess({static_cast<double>(delay.count()) / max_delay_.count()});
+}
+
+void EventLoopDelayMonitor::postProbe() {
+  {
+    Thread::LockGuard lock(state_->mutex_);
+    state_->posted_ = time_source_.monotonicTime();
+    state_->pending_delay_ = std::chrono::nanoseconds::zero();
+  }
+
+  // The main thread runs the probe synchronously, so the lock must not be held here.
+  slot_->runOnAllThreads(
+      [state = state_, &time_source = time_source_]() {
+        const MonotonicTime now = time_source.monotonicTime();
+        Thread::LockGuard lock(state->mutex_);
+        state->pending_delay_ =
+            std::max(state->pending_delay_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                now - state->posted_.value()));
+      },
+      [state = state_]() {
+        Thread::LockGuard lock(state->mutex_);
+        state->last_delay_ = state->pending_delay_;
+        state->posted_.reset();
+      });
+}
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
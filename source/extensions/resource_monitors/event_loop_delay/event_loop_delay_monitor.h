@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+
+#include "envoy/common/time.h"
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+#include "envoy/server/resource_monitor.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "common/common/thread.h"
+
+#include "absl/types/optional.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+
+/**
+ * Monitors how far behind the event loops of the worker threads are. On each update a probe is
+ * posted to every thread, and the delay with which the slowest thread runs it, relative to a
+ * statically configured maximum delay, is the resource pressure. While a probe has not run on all
+ * threads yet, the time it has been pending is a lower bound of the delay, so that a stuck worker
+ * is reported without waiting for it.
+ */
+class EventLoopDelayMonitor : public Server::ResourceMonitor {
+public:
+  EventLoopDelayMonitor(
+      const envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig&
+          config,
+      TimeSource& time_source, ThreadLocal::SlotAllocator& thread_local);
+
+  // Server::ResourceMonitor
+  void updateResourceUsage(Server::ResourceMonitor::Callbacks& callbacks) override;
+
+private:
+  // The state shared with the probes, which may still run after the monitor is gone.
+  struct ProbeState {
+    Thread::MutexBasicLockable mutex_;
+    // When the pending probe was posted, if any.
+    absl::optional<MonotonicTime> posted_ ABSL_GUARDED_BY(mutex_);
+    // The longest delay of the pending probe on the threads it ran on so far.
+    std::chrono::nanoseconds pending_delay_ ABSL_GUARDED_BY(mutex_){};
+    // The longest delay of the last probe which ran on all threads.
+    std::chrono::nanoseconds last_delay_ ABSL_GUARDED_BY(mutex_){};
+  };
+
+  void postProbe();
+
+  const std::chrono::nanoseconds max_delay_;
+  TimeSource& time_source_;
+  ThreadLocal::SlotPtr slot_;
+  const std::shared_ptr<ProbeState> state_;
+};
+
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -13,6 +13,15 @@ namespace ResourceMonitors {
  */
 class ResourceMonitorNameValues {
 public:
+  // CPU monitor of the cgroup Envoy runs in, relative to its CFS quota.
+  const std::string CgroupCpu = "envoy.resource_monitors.cgroup_cpu";
+
+  // Memory monitor of the cgroup Envoy runs in, relative to its memory limit.
+  const std::string CgroupMemory = "envoy.resource_monitors.cgroup_memory";
+
+  // Worker event loop delay monitor with statically configured max.
+  const std::string EventLoopDelay = "envoy.resource_monitors.event_loop_delay";
+
   // Heap monitor with statically configured max.
   const std::string FixedHeap = "envoy.resource_monitors.fixed_heap";
 
@@ -1,15 +1,18 @@
 #include "extensions/tracers/zipkin/span_buffer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "envoy/config/trace/v3/trace.pb.h"
 
-#include "common/protobuf/utility.h"
+#include "common/common/assert.h"
 
 #include "extensions/tracers/zipkin/util.h"
 #include "extensions/tracers/zipkin/zipkin_core_constants.h"
 #include "extensions/tracers/zipkin/zipkin_json_field_names.h"
 
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
-#include "absl/strings/str_replace.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -60,201 +63,333 @@ SerializerPtr SpanBuffer::makeSerializer(
   }
 }
 
-std::string JsonV1Serializer::serialize(const std::vector<Span>& zipkin_spans) {
+void JsonV1Serializer::serialize(const std::vector<Span>& zipkin_spans,
+                                 Buffer::Instance& output) {
   const std::string serialized_elements =
       absl::StrJoin(zipkin_spans, ",", [](std::string* element, const Span& zipkin_span) {
         absl::StrAppend(element, zipkin_span.toJson());
       });
-  return absl::StrCat("[", serialized_elements, "]");
+  output.add(absl::StrCat("[", serialized_elements, "]"));
 }
 
-JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
-    : shared_span_context_{shared_span_context} {}
+namespace {
 
-std::string JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans) {
-  Util::Replacements replacements;
-  const std::string serialized_elements = absl::StrJoin(
-      zipkin_spans, ",", [this, &replacements](std::string* out, const Span& zipkin_span) {
-        const auto& replacement_values = replacements;
-        absl::StrAppend(
-            out, absl::StrJoin(
-                     toListOfSpans(zipkin_span, replacements), ",",
-                     [&replacement_values](std::string* element, const ProtobufWkt::Struct& span) {
-                       const std::string json = MessageUtil::getJsonStringFromMessage(
-                           span, /* pretty_print */ false,
-                           /* always_print_primitive_fields */ true);
-
-                       // The Zipkin API V2 specification mandates to store timestamp value as int64
-                       // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463
-                       // (often translated as uint64 in some of the official implementations:
-                       // https://github.com/openzipkin/zipkin-go/blob/62dc8b26c05e0e8b88eb7536eff92498e65bbfc3/model/span.go#L114,
-                       // and see the discussion here:
-                       // https://github.com/openzipkin/zipkin-go/pull/161#issuecomment-598558072).
-                       // However, when the timestamp is stored as number value in a protobuf
-                       // struct, it is stored as a double. Because of how protobuf serializes
-                       // doubles, there is a possibility that the value will be rendered as a
-                       // number with scientific notation as reported in:
-                       // https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973. To
-                       // deal with that issue, here we do a workaround by storing the timestamp as
-                       // string and keeping track of that with the corresponding integer
-                       // replacements, and do the replacement here so we can meet the Zipkin API V2
-                       // requirements.
-                       //
-                       // TODO(dio): The right fix for this is to introduce additional knob when
-                       // serializing double in protobuf DoubleToBuffer function, and make it
-                       // available to be controlled at caller site.
-                       // https://github.com/envoyproxy/envoy/issues/10411).
-                       absl::StrAppend(element, absl::StrReplaceAll(json, replacement_values));
-                     }));
-      });
-  return absl::StrCat("[", serialized_elements, "]");
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Writes into reserved slices of a Buffer::Instance, so that the serialized spans do not have to be
+// built up elsewhere and copied into the buffer. No other mutation of the buffer may happen while
+// the writer is alive.
+class BufferWriter {
+public:
+  explicit BufferWriter(Buffer::Instance& output) : output_(output) {}
+  ~BufferWriter() { commit(); }
+
+  void push_back(char c) {
+    ensureSpace();
+    static_cast<char*>(slice_.mem_)[used_++] = c;
+  }
+
+  void append(absl::string_view data) {
+    while (!data.empty()) {
+      ensureSpace();
+      const uint64_t size = std::min<uint64_t>(data.size(), slice_.len_ - used_);
+      memcpy(static_cast<char*>(slice_.mem_) + used_, data.data(), size);
+      used_ += size;
+      data.remove_prefix(size);
+    }
+  }
+
+  template <class Number> void appendNumber(Number value) {
+    append(absl::AlphaNum(value).Piece());
+  }
+
+private:
+  static constexpr uint64_t ReservationSize = 16384;
+
+  void ensureSpace() {
+    if (used_ == slice_.len_) {
+      commit();
+      output_.reserve(ReservationSize, &slice_, 1);
+    }
+  }
+
+  void commit() {
+    if (slice_.mem_ == nullptr) {
+      return;
+    }
+    slice_.len_ = used_;
+    output_.commit(&slice_, 1);
+    slice_ = {};
+    used_ = 0;
+  }
+
+  Buffer::Instance& output_;
+  Buffer::RawSlice slice_;
+  uint64_t used_{0};
+};
+
+// Appends the 16 digit lower case hexadecimal representation of the value, as Hex::uint64ToHex.
+void appendHex(uint64_t value, BufferWriter& out) {
+  char hex[16];
+  for (int i = 15; i >= 0; --i) {
+    hex[i] = HEX_DIGITS[value & 0xf];
+    value >>= 4;
+  }
+  out.append(absl::string_view(hex, sizeof(hex)));
 }
 
-const std::vector<ProtobufWkt::Struct>
-JsonV2Serializer::toListOfSpans(const Span& zipkin_span, Util::Replacements& replacements) const {
-  std::vector<ProtobufWkt::Struct> spans;
-  spans.reserve(zipkin_span.annotations().size());
-  for (const auto& annotation : zipkin_span.annotations()) {
-    ProtobufWkt::Struct span;
-    auto* fields = span.mutable_fields();
+// Appends the value as a quoted and escaped JSON string.
+void appendJsonString(absl::string_view value, BufferWriter& out) {
+  out.push_back('"');
+  size_t run_start = 0;
+  for (size_t i = 0; i < value.size(); ++i) {
+    const unsigned char c = value[i];
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(value.substr(run_start, i - run_start));
+    run_start = i + 1;
+    switch (c) {
+    case '"':
+      out.append("\\\"");
+      break;
+    case '\\':
+      out.append("\\\\");
+      break;
+    case '\n':
+      out.append("\\n");
+      break;
+    case '\r':
+      out.append("\\r");
+      break;
+    case '\t':
+      out.append("\\t");
+      break;
+    default:
+      out.append("\\u00");
+      out.push_back(HEX_DIGITS[c >> 4]);
+      out.push_back(HEX_DIGITS[c & 0xf]);
+    }
+  }
+  out.append(value.substr(run_start));
+  out.push_back('"');
+}
 
+// Appends the value as a quoted hexadecimal JSON string.
+void appendJsonHex(uint64_t value, BufferWriter& out) {
+  out.push_back('"');
+  appendHex(value, out);
+  out.push_back('"');
+}
+
+// Writes the members of a JSON object, taking care of the separators between them.
+class JsonObjectWriter {
+public:
+  explicit JsonObjectWriter(BufferWriter& out) : out_(out) { out_.push_back('{'); }
+
+  /**
+   * Starts a member.
+   * @param name supplies the member name.
+   * @return BufferWriter& the writer the member value must be appended to.
+   */
+  BufferWriter& key(absl::string_view name) {
+    if (!empty_) {
+      out_.push_back(',');
+    }
+    empty_ = false;
+    appendJsonString(name, out_);
+    out_.push_back(':');
+    return out_;
+  }
+
+  void close() { out_.push_back('}'); }
+
+private:
+  BufferWriter& out_;
+  bool empty_{true};
+};
+
+void appendEndpoint(const Endpoint& zipkin_endpoint, BufferWriter& out) {
+  JsonObjectWriter endpoint(out);
+  const Network::Address::InstanceConstSharedPtr& address = zipkin_endpoint.address();
+  if (address) {
+    appendJsonString(address->ip()->addressAsString(),
+                     endpoint.key(address->ip()->version() == Network::Address::IpVersion::v4
+                                      ? ENDPOINT_IPV4
+                                      : ENDPOINT_IPV6));
+    endpoint.key(ENDPOINT_PORT).appendNumber(address->ip()->port());
+  }
+
+  const std::string& service_name = zipkin_endpoint.serviceName();
+  if (!service_name.empty()) {
+    appendJsonString(service_name, endpoint.key(ENDPOINT_SERVICE_NAME));
+  }
+  endpoint.close();
+}
+
+// Appends the Zipkin v2 spans of a span, one for each of its client send and server receive
+// annotations.
+void appendListOfSpans(const Span& zipkin_span, bool shared_span_context, bool& first,
+                       BufferWriter& out) {
+  for (const auto& annotation : zipkin_span.annotations()) {
+    absl::string_view kind;
+    bool shared = false;
     if (annotation.value() == CLIENT_SEND) {
-      (*fields)[SPAN_KIND] = ValueUtil::stringValue(KIND_CLIENT);
+      kind = KIND_CLIENT;
     } else if (annotation.value() == SERVER_RECV) {
-      if (shared_span_context_ && zipkin_span.annotations().size() > 1) {
-        (*fields)[SPAN_SHARED] = ValueUtil::boolValue(true);
-      }
-      (*fields)[SPAN_KIND] = ValueUtil::stringValue(KIND_SERVER);
+      shared = shared_span_context && zipkin_span.annotations().size() > 1;
+      kind = KIND_SERVER;
     } else {
       continue;
     }
 
-    if (annotation.isSetEndpoint()) {
-      // Usually we store number to a ProtobufWkt::Struct object via ValueUtil::numberValue.
-      // However, due to the possibility of rendering that to a number with scientific notation, we
-      // chose to store it as a string and keeping track the corresponding replacement. For example,
-      // we have 1584324295476870 if we stored it as a double value, MessageToJsonString gives
-      // us 1.58432429547687e+15. Instead we store it as the string of 1584324295476870 (when it is
-      // serialized: "1584324295476870"), and replace it post MessageToJsonString serialization with
-      // integer (1584324295476870 without `"`), see: JsonV2Serializer::serialize.
-      (*fields)[SPAN_TIMESTAMP] = Util::uint64Value(annotation.timestamp(), replacements);
-      (*fields)[SPAN_LOCAL_ENDPOINT] =
-          ValueUtil::structValue(toProtoEndpoint(annotation.endpoint()));
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    JsonObjectWriter span(out);
+
+    BufferWriter& trace_id = span.key(SPAN_TRACE_ID);
+    trace_id.push_back('"');
+    if (zipkin_span.isSetTraceIdHigh()) {
+      appendHex(zipkin_span.traceIdHigh(), trace_id);
     }
+    appendHex(zipkin_span.traceId(), trace_id);
+    trace_id.push_back('"');
 
-    (*fields)[SPAN_TRACE_ID] = ValueUtil::stringValue(zipkin_span.traceIdAsHexString());
     if (zipkin_span.isSetParentId()) {
-      (*fields)[SPAN_PARENT_ID] = ValueUtil::stringValue(zipkin_span.parentIdAsHexString());
+      appendJsonHex(zipkin_span.parentId(), span.key(SPAN_PARENT_ID));
     }
 
-    (*fields)[SPAN_ID] = ValueUtil::stringValue(zipkin_span.idAsHexString());
+    appendJsonHex(zipkin_span.id(), span.key(SPAN_ID));
+
+    appendJsonString(kind, span.key(SPAN_KIND));
+    if (shared) {
+      span.key(SPAN_SHARED).append("true");
+    }
 
     const auto& span_name = zipkin_span.name();
     if (!span_name.empty()) {
-      (*fields)[SPAN_NAME] = ValueUtil::stringValue(span_name);
+      appendJsonString(span_name, span.key(SPAN_NAME));
+    }
+
+    // The Zipkin API V2 specification mandates timestamps and durations to be int64 values, which
+    // is why they are written as plain integers here, see
+    // https://github.com/openzipkin/zipkin-api/blob/228fabe660f1b5d1e28eac9df41f7d1deed4a1c2/zipkin2-api.yaml#L447-L463
+    // and https://github.com/envoyproxy/envoy/issues/9341#issuecomment-566912973.
+    if (annotation.isSetEndpoint()) {
+      span.key(SPAN_TIMESTAMP).appendNumber(annotation.timestamp());
+      appendEndpoint(annotation.endpoint(), span.key(SPAN_LOCAL_ENDPOINT));
     }
 
     if (zipkin_span.isSetDuration()) {
-      // Since SPAN_DURATION has the same data type with SPAN_TIMESTAMP, we use Util::uint64Value to
-      // store it.
-      (*fields)[SPAN_DURATION] = Util::uint64Value(zipkin_span.duration(), replacements);
+      span.key(SPAN_DURATION).appendNumber(zipkin_span.duration());
     }
 
     const auto& binary_annotations = zipkin_span.binaryAnnotations();
     if (!binary_annotations.empty()) {
-      ProtobufWkt::Struct tags;
-      auto* tag_fields = tags.mutable_fields();
-      for (const auto& binary_annotation : binary_annotations) {
-        (*tag_fields)[binary_annotation.key()] = ValueUtil::stringValue(binary_annotation.value());
+      JsonObjectWriter tags(span.key(SPAN_TAGS));
+      for (auto it = binary_annotations.begin(); it != binary_annotations.end(); ++it) {
+        // A tag set more than once keeps its last value.
+        const auto same_key = [&it](const BinaryAnnotation& later) {
+          return later.key() == it->key();
+        };
+        if (std::any_of(it + 1, binary_annotations.end(), same_key)) {
+          continue;
+        }
+        appendJsonString(it->value(), tags.key(it->key()));
       }
-      (*fields)[SPAN_TAGS] = ValueUtil::structValue(tags);
+      tags.close();
     }
 
-    spans.push_back(std::move(span));
+    span.close();
   }
-  return spans;
 }
 
-const ProtobufWkt::Struct JsonV2Serializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  ProtobufWkt::Struct endpoint;
-  auto* fields = endpoint.mutable_fields();
+} // namespace
 
-  Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
-  if (address) {
-    if (address->ip()->version() == Network::Address::IpVersion::v4) {
-      (*fields)[ENDPOINT_IPV4] = ValueUtil::stringValue(address->ip()->addressAsString());
-    } else {
-      (*fields)[ENDPOINT_IPV6] = ValueUtil::stringValue(address->ip()->addressAsString());
-    }
-    (*fields)[ENDPOINT_PORT] = ValueUtil::numberValue(address->ip()->port());
-  }
+JsonV2Serializer::JsonV2Serializer(const bool shared_span_context)
+    : shared_span_context_{shared_span_context} {}
 
-  const std::string& service_name = zipkin_endpoint.serviceName();
-  if (!service_name.empty()) {
-    (*fields)[ENDPOINT_SERVICE_NAME] = ValueUtil::stringValue(service_name);
+void JsonV2Serializer::serialize(const std::vector<Span>& zipkin_spans,
+                                 Buffer::Instance& output) {
+  BufferWriter out(output);
+  out.push_back('[');
+  bool first = true;
+  for (const Span& zipkin_span : zipkin_spans) {
+    appendListOfSpans(zipkin_span, shared_span_context_, first, out);
   }
-
-  return endpoint;
+  out.push_back(']');
 }
 
 ProtobufSerializer::ProtobufSerializer(const bool shared_span_context)
     : shared_span_context_{shared_span_context} {}
 
-std::string ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans) {
+void ProtobufSerializer::serialize(const std::vector<Span>& zipkin_spans,
+                                   Buffer::Instance& output) {
   zipkin::proto3::ListOfSpans spans;
   for (const Span& zipkin_span : zipkin_spans) {
-    spans.MergeFrom(toListOfSpans(zipkin_span));
+    addListOfSpans(zipkin_span, spans);
+  }
+
+  // Serialize straight into the output buffer, as Grpc::Common::serializeMessage() does.
+  const uint32_t size = spans.ByteSizeLong();
+  if (size == 0) {
+    return;
   }
-  std::string serialized;
-  spans.SerializeToString(&serialized);
-  return serialized;
+  Buffer::RawSlice iovec;
+  output.reserve(size, &iovec, 1);
+  ASSERT(iovec.len_ >= size);
+  iovec.len_ = size;
+  spans.SerializeWithCachedSizesToArray(static_cast<uint8_t*>(iovec.mem_));
+  output.commit(&iovec, 1);
 }
 
-const zipkin::proto3::ListOfSpans ProtobufSerializer::toListOfSpans(const Span& zipkin_span) const {
-  zipkin::proto3::ListOfSpans spans;
+void ProtobufSerializer::addListOfSpans(const Span& zipkin_span,
+                                        zipkin::proto3::ListOfSpans& spans) const {
   for (const auto& annotation : zipkin_span.annotations()) {
-    zipkin::proto3::Span span;
+    zipkin::proto3::Span::Kind kind;
+    bool shared = false;
     if (annotation.value() == CLIENT_SEND) {
-      span.set_kind(zipkin::proto3::Span::CLIENT);
+      kind = zipkin::proto3::Span::CLIENT;
     } else if (annotation.value() == SERVER_RECV) {
-      span.set_shared(shared_span_context_ && zipkin_span.annotations().size() > 1);
-      span.set_kind(zipkin::proto3::Span::SERVER);
+      shared = shared_span_context_ && zipkin_span.annotations().size() > 1;
+      kind = zipkin::proto3::Span::SERVER;
     } else {
       continue;
     }
 
+    zipkin::proto3::Span* span = spans.add_spans();
+    span->set_kind(kind);
+    span->set_shared(shared);
+
     if (annotation.isSetEndpoint()) {
-      span.set_timestamp(annotation.timestamp());
-      span.mutable_local_endpoint()->MergeFrom(toProtoEndpoint(annotation.endpoint()));
+      span->set_timestamp(annotation.timestamp());
+      toProtoEndpoint(annotation.endpoint(), *span->mutable_local_endpoint());
     }
 
-    span.set_trace_id(zipkin_span.traceIdAsByteString());
+    span->set_trace_id(zipkin_span.traceIdAsByteString());
     if (zipkin_span.isSetParentId()) {
-      span.set_parent_id(zipkin_span.parentIdAsByteString());
+      span->set_parent_id(zipkin_span.parentIdAsByteString());
     }
 
-    span.set_id(zipkin_span.idAsByteString());
-    span.set_name(zipkin_span.name());
+    span->set_id(zipkin_span.idAsByteString());
+    span->set_name(zipkin_span.name());
 
     if (zipkin_span.isSetDuration()) {
-      span.set_duration(zipkin_span.duration());
+      span->set_duration(zipkin_span.duration());
     }
 
-    auto& tags = *span.mutable_tags();
+    auto& tags = *span->mutable_tags();
     for (const auto& binary_annotation : zipkin_span.binaryAnnotations()) {
       tags[binary_annotation.key()] = binary_annotation.value();
     }
-
-    auto* mutable_span = spans.add_spans();
-    mutable_span->MergeFrom(span);
   }
-  return spans;
 }
 
-const zipkin::proto3::Endpoint
-ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
-  zipkin::proto3::Endpoint endpoint;
-  Network::Address::InstanceConstSharedPtr address = zipkin_endpoint.address();
+void ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint,
+                                         zipkin::proto3::Endpoint& endpoint) const {
+  const Network::Address::InstanceConstSharedPtr& address = zipkin_endpoint.address();
   if (address) {
     if (address->ip()->version() == Network::Address::IpVersion::v4) {
       endpoint.set_ipv4(Util::toByteString(address->ip()->ipv4()->address()));
@@ -268,8 +403,6 @@ ProtobufSerializer::toProtoEndpoint(const Endpoint& zipkin_endpoint) const {
   if (!service_name.empty()) {
     endpoint.set_service_name(service_name);
   }
-
-  return endpoint;
 }
 
 } // namespace Zipkin
@@ -89,7 +89,7 @@ public:
   /**
    * @return the endpoint's address.
    */
-  Network::Address::InstanceConstSharedPtr address() const { return address_; }
+  const Network::Address::InstanceConstSharedPtr& address() const { return address_; }
 
   /**
    * Sets the endpoint's address
@@ -6,6 +6,7 @@
 #include "envoy/stats/scope.h"
 #include "envoy/stats/timespan.h"
 
+#include "common/event/deferred_task.h"
 #include "common/network/connection_impl.h"
 #include "common/network/utility.h"
 #include "common/stats/timespan_impl.h"
@@ -44,6 +45,34 @@ void ConnectionHandlerImpl::addListener(Network::ListenerConfig& config) {
   listeners_.emplace_back(config.listenSocketFactory().localAddress(), std::move(details));
 }
 
+void ConnectionHandlerImpl::updateListener(Network::ListenerConfig& config) {
+  for (auto& listener : listeners_) {
+    if (listener.second.listener_->listenerTag() == config.listenerTag()) {
+      // Only TCP listeners are updated in place.
+      ASSERT(listener.second.tcp_listener_.has_value());
+      listener.second.tcp_listener_->get().updateListenerConfig(config);
+      return;
+    }
+  }
+  NOT_REACHED_GCOVR_EXCL_LINE;
+}
+
+void ConnectionHandlerImpl::removeFilterChains(
+    uint64_t listener_tag, const std::list<const Network::FilterChain*>& filter_chains,
+    std::function<void()> completion) {
+  for (auto& listener : listeners_) {
+    if (listener.second.listener_->listenerTag() == listener_tag &&
+        listener.second.tcp_listener_.has_value()) {
+      listener.second.tcp_listener_->get().deferredRemoveFilterChains(filter_chains);
+      break;
+    }
+  }
+  // The listener may already be gone if it was removed while its filter chains were draining.
+  // Either way the completion runs after the closed connections are destroyed, since they may
+  // still reference the filter chains.
+  Event::DeferredTaskUtil::deferredRun(dispatcher_, std::move(completion));
+}
+
 void ConnectionHandlerImpl::removeListeners(uint64_t listener_tag) {
   for (auto listener = listeners_.begin(); listener != listeners_.end();) {
     if (listener->second.listener_->listenerTag() == listener_tag) {
@@ -109,7 +138,7 @@ ConnectionHandlerImpl::ActiveListenerImplBase::ActiveListenerImplBase(
       per_worker_stats_({ALL_PER_HANDLER_LISTENER_STATS(
           POOL_COUNTER_PREFIX(config.listenerScope(), parent.statPrefix()),
           POOL_GAUGE_PREFIX(config.listenerScope(), parent.statPrefix()))}),
-      config_(config) {}
+      config_(&config) {}
 
 ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImpl& parent,
                                                             Network::ListenerConfig& config)
@@ -130,7 +159,7 @@ ConnectionHandlerImpl::ActiveTcpListener::ActiveTcpListener(ConnectionHandlerImp
 
 ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
   is_deleting_ = true;
-  config_.connectionBalancer().unregisterHandler(*this);
+  config_->connectionBalancer().unregisterHandler(*this);
 
   // Purge sockets that have not progressed to connections. This should only happen when
   // a listener filter stops iteration and never resumes.
@@ -157,6 +186,35 @@ ConnectionHandlerImpl::ActiveTcpListener::~ActiveTcpListener() {
   ASSERT(num_listener_connections_ == 0);
 }
 
+void ConnectionHandlerImpl::ActiveTcpListener::updateListenerConfig(
+    Network::ListenerConfig& config) {
+  ENVOY_LOG(trace, "replacing the config of listener {}", config_->listenerTag());
+  ASSERT(config.listenerTag() == config_->listenerTag());
+  ASSERT(&config.connectionBalancer() == &config_->connectionBalancer());
+  config_ = &config;
+}
+
+void ConnectionHandlerImpl::ActiveTcpListener::deferredRemoveFilterChains(
+    const std::list<const Network::FilterChain*>& draining_filter_chains) {
+  // removeConnection() must not erase from connections_by_context_ while it is iterated here.
+  const bool was_deleting = is_deleting_;
+  is_deleting_ = true;
+  for (const auto* filter_chain : draining_filter_chains) {
+    auto iter = connections_by_context_.find(filter_chain);
+    if (iter == connections_by_context_.end()) {
+      continue;
+    }
+    // Closing the last connection hands the connection group to the deferred delete list.
+    ActiveConnections& active_connections = *iter->second;
+    while (!active_connections.connections_.empty()) {
+      active_connections.connections_.front()->connection_->close(
+          Network::ConnectionCloseType::NoFlush);
+    }
+    connections_by_context_.erase(iter);
+  }
+  is_deleting_ = was_deleting;
+}
+
 ConnectionHandlerImpl::ActiveTcpListenerOptRef
 ConnectionHandlerImpl::findActiveTcpListenerByAddress(const Network::Address::Instance& address) {
   // This is a linear operation, may need to add a map<address, listener> to improve performance.
@@ -292,7 +350,7 @@ void ConnectionHandlerImpl::ActiveTcpSocket::newConnection() {
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAccept(Network::ConnectionSocketPtr&& socket) {
-  onAcceptWorker(std::move(socket), config_.handOffRestoredDestinationConnections(), false);
+  onAcceptWorker(std::move(socket), config_->handOffRestoredDestinationConnections(), false);
 }
 
 void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
@@ -300,7 +358,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
     bool rebalanced) {
   if (!rebalanced) {
     Network::BalancedConnectionHandler& target_handler =
-        config_.connectionBalancer().pickTargetHandler(*this);
+        config_->connectionBalancer().pickTargetHandler(*this);
     if (&target_handler != this) {
       target_handler.post(std::move(socket));
       return;
@@ -311,7 +369,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::onAcceptWorker(
                                                          hand_off_restored_destination_connections);
 
   // Create and run the filters
-  config_.filterChainFactory().createListenerFilterChain(*active_socket);
+  config_->filterChainFactory().createListenerFilterChain(*active_socket);
   active_socket->continueFilterChain(true);
 
   // Move active_socket to the sockets_ list if filter iteration needs to continue later.
@@ -339,13 +397,13 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
   stream_info->setDownstreamDirectRemoteAddress(socket->directRemoteAddress());
 
   // Find matching filter chain.
-  const auto filter_chain = config_.filterChainManager().findFilterChain(*socket);
+  const auto filter_chain = config_->filterChainManager().findFilterChain(*socket);
   if (filter_chain == nullptr) {
     ENVOY_LOG(debug, "closing connection: no matching filter chain found");
     stats_.no_filter_chain_match_.inc();
     stream_info->setResponseFlag(StreamInfo::ResponseFlag::NoRouteFound);
     stream_info->setResponseCodeDetails(StreamInfo::ResponseCodeDetails::get().FilterChainNotFound);
-    emitLogs(config_, *stream_info);
+    emitLogs(*config_, *stream_info);
     socket->close();
     return;
   }
@@ -357,10 +415,10 @@ void ConnectionHandlerImpl::ActiveTcpListener::newConnection(
       std::move(socket), std::move(transport_socket), *stream_info);
   ActiveTcpConnectionPtr active_connection(
       new ActiveTcpConnection(active_connections, std::move(server_conn_ptr),
-                              parent_.dispatcher_.timeSource(), config_, std::move(stream_info)));
-  active_connection->connection_->setBufferLimits(config_.perConnectionBufferLimitBytes());
+                              parent_.dispatcher_.timeSource(), std::move(stream_info)));
+  active_connection->connection_->setBufferLimits(config_->perConnectionBufferLimitBytes());
 
-  const bool empty_filter_chain = !config_.filterChainFactory().createNetworkFilterChain(
+  const bool empty_filter_chain = !config_->filterChainFactory().createNetworkFilterChain(
       *active_connection->connection_, filter_chain->networkFilterFactories());
   if (empty_filter_chain) {
     ENVOY_CONN_LOG(debug, "closing connection: no filters", *active_connection->connection_);
@@ -402,7 +460,8 @@ void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr
   RebalancedSocketSharedPtr socket_to_rebalance = std::make_shared<RebalancedSocket>();
   socket_to_rebalance->socket = std::move(socket);
 
-  parent_.dispatcher_.post([socket_to_rebalance, tag = config_.listenerTag(), &parent = parent_]() {
+  parent_.dispatcher_.post([socket_to_rebalance, tag = config_->listenerTag(),
+                            &parent = parent_]() {
     // TODO(mattklein123): We should probably use a hash table here to lookup the tag instead of
     // iterating through the listener list.
     for (const auto& listener : parent.listeners_) {
@@ -414,7 +473,7 @@ void ConnectionHandlerImpl::ActiveTcpListener::post(Network::ConnectionSocketPtr
             std::move(socket_to_rebalance->socket),
             listener.second.tcp_listener_.value()
                 .get()
-                .config_.handOffRestoredDestinationConnections(),
+                .config_->handOffRestoredDestinationConnections(),
             true);
         return;
       }
@@ -433,13 +492,11 @@ ConnectionHandlerImpl::ActiveConnections::~ActiveConnections() {
 
 ConnectionHandlerImpl::ActiveTcpConnection::ActiveTcpConnection(
     ActiveConnections& active_connections, Network::ConnectionPtr&& new_connection,
-    TimeSource& time_source, Network::ListenerConfig& config,
-    std::unique_ptr<StreamInfo::StreamInfo>&& stream_info)
+    TimeSource& time_source, std::unique_ptr<StreamInfo::StreamInfo>&& stream_info)
     : stream_info_(std::move(stream_info)), active_connections_(active_connections),
       connection_(std::move(new_connection)),
       conn_length_(new Stats::HistogramCompletableTimespanImpl(
-          active_connections_.listener_.stats_.downstream_cx_length_ms_, time_source)),
-      config_(config) {
+          active_connections_.listener_.stats_.downstream_cx_length_ms_, time_source)) {
   // We just universally set no delay on connections. Theoretically we might at some point want
   // to make this configurable.
   connection_->noDelay(true);
@@ -456,7 +513,9 @@ ConnectionHandlerImpl::ActiveTcpConnection::ActiveTcpConnection(
 }
 
 ConnectionHandlerImpl::ActiveTcpConnection::~ActiveTcpConnection() {
-  emitLogs(config_, *stream_info_);
+  // The listener config may have been replaced since the connection was accepted, so log with the
+  // current one.
+  emitLogs(*active_connections_.listener_.config_, *stream_info_);
 
   active_connections_.listener_.stats_.downstream_cx_active_.dec();
   active_connections_.listener_.stats_.downstream_cx_destroy_.inc();
@@ -483,13 +542,13 @@ ActiveUdpListener::ActiveUdpListener(Network::ConnectionHandler& parent,
     : ConnectionHandlerImpl::ActiveListenerImplBase(parent, config),
       udp_listener_(std::move(listener)), read_filter_(nullptr) {
   // Create the filter chain on creating a new udp listener
-  config_.filterChainFactory().createUdpListenerFilterChain(*this, *this);
+  config_->filterChainFactory().createUdpListenerFilterChain(*this, *this);
 
   // If filter is nullptr, fail the creation of the listener
   if (read_filter_ == nullptr) {
     throw Network::CreateListenerException(
         fmt::format("Cannot create listener as no read filter registered for the udp listener: {} ",
-                    config_.name()));
+                    config_->name()));
   }
 }
 
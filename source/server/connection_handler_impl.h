@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <memory>
 
@@ -68,6 +69,10 @@ public:
   void incNumConnections() override;
   void decNumConnections() override;
   void addListener(Network::ListenerConfig& config) override;
+  void updateListener(Network::ListenerConfig& config) override;
+  void removeFilterChains(uint64_t listener_tag,
+                          const std::list<const Network::FilterChain*>& filter_chains,
+                          std::function<void()> completion) override;
   void removeListeners(uint64_t listener_tag) override;
   void stopListeners(uint64_t listener_tag) override;
   void stopListeners() override;
@@ -83,11 +88,12 @@ public:
     ActiveListenerImplBase(Network::ConnectionHandler& parent, Network::ListenerConfig& config);
 
     // Network::ConnectionHandler::ActiveListener.
-    uint64_t listenerTag() override { return config_.listenerTag(); }
+    uint64_t listenerTag() override { return config_->listenerTag(); }
 
     ListenerStats stats_;
     PerHandlerListenerStats per_worker_stats_;
-    Network::ListenerConfig& config_;
+    // Replaced by in place filter chain updates, see ActiveTcpListener::updateListenerConfig().
+    Network::ListenerConfig* config_;
   };
 
 private:
@@ -143,6 +149,20 @@ private:
 
     ActiveConnections& getOrCreateActiveConnections(const Network::FilterChain& filter_chain);
 
+    /**
+     * Use the new config for new connections. The listen socket, the connection balancer and the
+     * connections of the listener are kept.
+     * @param config supplies the new config, which has the same tag as the current one.
+     */
+    void updateListenerConfig(Network::ListenerConfig& config);
+
+    /**
+     * Close the connections of the given filter chains. The connections are deferred deleted.
+     * @param draining_filter_chains supplies the filter chains to remove.
+     */
+    void deferredRemoveFilterChains(
+        const std::list<const Network::FilterChain*>& draining_filter_chains);
+
     ConnectionHandlerImpl& parent_;
     Network::ListenerPtr listener_;
     const std::chrono::milliseconds listener_filters_timeout_;
@@ -179,7 +199,6 @@ private:
                                public Network::ConnectionCallbacks {
     ActiveTcpConnection(ActiveConnections& active_connections,
                         Network::ConnectionPtr&& new_connection, TimeSource& time_system,
-                        Network::ListenerConfig& config,
                         std::unique_ptr<StreamInfo::StreamInfo>&& stream_info);
     ~ActiveTcpConnection() override;
 
@@ -198,7 +217,6 @@ private:
     ActiveConnections& active_connections_;
     Network::ConnectionPtr connection_;
     Stats::TimespanPtr conn_length_;
-    Network::ListenerConfig& config_;
   };
 
   /**
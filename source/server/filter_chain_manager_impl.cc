@@ -267,19 +267,20 @@ void FilterChainManagerImpl::addFilterChainForServerNames(
   auto& server_names_map = *server_names_map_ptr;
 
   if (server_names.empty()) {
-    addFilterChainForApplicationProtocols(server_names_map[EMPTY_STRING][transport_protocol],
+    addFilterChainForApplicationProtocols(server_names_map.exact(EMPTY_STRING)[transport_protocol],
                                           application_protocols, source_type, source_ips,
                                           source_ports, filter_chain);
   } else {
     for (const auto& server_name_ptr : server_names) {
       if (isWildcardServerName(*server_name_ptr)) {
-        // Add mapping for the wildcard domain, i.e. ".example.com" for "*.example.com".
+        // Add mapping for the wildcard domain, i.e. "example.com" for "*.example.com".
         addFilterChainForApplicationProtocols(
-            server_names_map[server_name_ptr->substr(1)][transport_protocol], application_protocols,
-            source_type, source_ips, source_ports, filter_chain);
+            server_names_map.wildcard(absl::string_view(*server_name_ptr).substr(2))
+                [transport_protocol],
+            application_protocols, source_type, source_ips, source_ports, filter_chain);
       } else {
         addFilterChainForApplicationProtocols(
-            server_names_map[*server_name_ptr][transport_protocol], application_protocols,
+            server_names_map.exact(*server_name_ptr)[transport_protocol], application_protocols,
             source_type, source_ips, source_ports, filter_chain);
       }
     }
@@ -374,6 +375,11 @@ std::pair<T, std::vector<Network::Address::CidrRange>> makeCidrListEntry(const s
   return std::make_pair<T, std::vector<Network::Address::CidrRange>>(T(data), std::move(subnets));
 }
 
+// Whether the IP map only has the catch-all entry, in which case no trie is needed to match it.
+template <class T> bool hasOnlyCatchAllIp(const absl::flat_hash_map<std::string, T>& ips_map) {
+  return ips_map.size() == 1 && ips_map.begin()->first == EMPTY_STRING;
+}
+
 }; // namespace
 
 const Network::FilterChain*
@@ -384,28 +390,33 @@ FilterChainManagerImpl::findFilterChain(const Network::ConnectionSocket& socket)
   if (address->type() == Network::Address::Type::Ip) {
     const auto port_match = destination_ports_map_.find(address->ip()->port());
     if (port_match != destination_ports_map_.end()) {
-      return findFilterChainForDestinationIP(*port_match->second.second, socket);
+      return findFilterChainForDestinationIP(port_match->second, socket);
     }
   }
 
   // Match on catch-all port 0.
   const auto port_match = destination_ports_map_.find(0);
   if (port_match != destination_ports_map_.end()) {
-    return findFilterChainForDestinationIP(*port_match->second.second, socket);
+    return findFilterChainForDestinationIP(port_match->second, socket);
   }
 
   return nullptr;
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinationIP(
-    const DestinationIPsTrie& destination_ips_trie, const Network::ConnectionSocket& socket) const {
+    const DestinationIPsPair& destination_ips, const Network::ConnectionSocket& socket) const {
+  // Every address matches the catch-all entry.
+  if (destination_ips.second == nullptr) {
+    return findFilterChainForServerName(*destination_ips.first.begin()->second, socket);
+  }
+
   auto address = socket.localAddress();
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
   // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = destination_ips_trie.getData(address);
+  const auto& data = destination_ips.second->getData(address);
   if (!data.empty()) {
     ASSERT(data.size() == 1);
     return findFilterChainForServerName(*data.back(), socket);
@@ -416,29 +427,18 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForDestinatio
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName(
     const ServerNamesMap& server_names_map, const Network::ConnectionSocket& socket) const {
-  const std::string server_name(socket.requestedServerName());
-
-  // Match on exact server name, i.e. "www.example.com" for "www.example.com".
-  const auto server_name_exact_match = server_names_map.find(server_name);
-  if (server_name_exact_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_exact_match->second, socket);
-  }
-
-  // Match on all wildcard domains, i.e. ".example.com" and ".com" for "www.example.com".
-  size_t pos = server_name.find('.', 1);
-  while (pos < server_name.size() - 1 && pos != std::string::npos) {
-    const std::string wildcard = server_name.substr(pos);
-    const auto server_name_wildcard_match = server_names_map.find(wildcard);
-    if (server_name_wildcard_match != server_names_map.end()) {
-      return findFilterChainForTransportProtocol(server_name_wildcard_match->second, socket);
-    }
-    pos = server_name.find('.', pos + 1);
+  // Match on exact server name, i.e. "www.example.com" for "www.example.com", or else on the
+  // longest wildcard domain, i.e. "*.example.com" before "*.com" for "www.example.com".
+  const TransportProtocolsMap* server_name_match =
+      server_names_map.find(socket.requestedServerName());
+  if (server_name_match != nullptr) {
+    return findFilterChainForTransportProtocol(*server_name_match, socket);
   }
 
   // Match on a filter chain without server name requirements.
-  const auto server_name_catchall_match = server_names_map.find(EMPTY_STRING);
-  if (server_name_catchall_match != server_names_map.end()) {
-    return findFilterChainForTransportProtocol(server_name_catchall_match->second, socket);
+  const TransportProtocolsMap* server_name_catchall_match = server_names_map.find(EMPTY_STRING);
+  if (server_name_catchall_match != nullptr) {
+    return findFilterChainForTransportProtocol(*server_name_catchall_match, socket);
   }
 
   return nullptr;
@@ -447,7 +447,7 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForServerName
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForTransportProtocol(
     const TransportProtocolsMap& transport_protocols_map,
     const Network::ConnectionSocket& socket) const {
-  const std::string transport_protocol(socket.detectedTransportProtocol());
+  const absl::string_view transport_protocol = socket.detectedTransportProtocol();
 
   // Match on exact transport protocol, e.g. "tls".
   const auto transport_protocol_match = transport_protocols_map.find(transport_protocol);
@@ -501,38 +501,45 @@ const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceType
 
   if (is_local_connection) {
     if (!filter_chain_local.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_local.second, socket);
+      return findFilterChainForSourceIpAndPort(filter_chain_local, socket);
     }
   } else {
     if (!filter_chain_external.first.empty()) {
-      return findFilterChainForSourceIpAndPort(*filter_chain_external.second, socket);
+      return findFilterChainForSourceIpAndPort(filter_chain_external, socket);
     }
   }
 
   const auto& filter_chain_any = source_types[envoy::config::listener::v3::FilterChainMatch::ANY];
 
   if (!filter_chain_any.first.empty()) {
-    return findFilterChainForSourceIpAndPort(*filter_chain_any.second, socket);
+    return findFilterChainForSourceIpAndPort(filter_chain_any, socket);
   } else {
     return nullptr;
   }
 }
 
 const Network::FilterChain* FilterChainManagerImpl::findFilterChainForSourceIpAndPort(
-    const SourceIPsTrie& source_ips_trie, const Network::ConnectionSocket& socket) const {
+    const SourceIPsPair& source_ips, const Network::ConnectionSocket& socket) const {
   auto address = socket.remoteAddress();
   if (address->type() != Network::Address::Type::Ip) {
     address = fakeAddress();
   }
 
-  // Match on both: exact IP and wider CIDR ranges using LcTrie.
-  const auto& data = source_ips_trie.getData(address);
-  if (data.empty()) {
-    return nullptr;
+  const SourcePortsMap* source_ports_map_ptr;
+  if (source_ips.second == nullptr) {
+    // Every address matches the catch-all entry.
+    source_ports_map_ptr = source_ips.first.begin()->second.get();
+  } else {
+    // Match on both: exact IP and wider CIDR ranges using LcTrie.
+    const auto& data = source_ips.second->getData(address);
+    if (data.empty()) {
+      return nullptr;
+    }
+    ASSERT(data.size() == 1);
+    source_ports_map_ptr = data.back().get();
   }
 
-  ASSERT(data.size() == 1);
-  const auto& source_ports_map = *data.back();
+  const auto& source_ports_map = *source_ports_map_ptr;
   const uint32_t source_port = address->ip()->port();
   const auto port_match = source_ports_map.find(source_port);
 
@@ -557,21 +564,27 @@ void FilterChainManagerImpl::convertIPsToTries() {
     // These variables are used as we build up the destination CIDRs used for the trie.
     auto& destination_ips_pair = port.second;
     auto& destination_ips_map = destination_ips_pair.first;
+    const bool build_destination_ips_trie = !hasOnlyCatchAllIp(destination_ips_map);
     std::vector<std::pair<ServerNamesMapSharedPtr, std::vector<Network::Address::CidrRange>>>
         destination_ips_list;
     destination_ips_list.reserve(destination_ips_map.size());
 
     for (const auto& entry : destination_ips_map) {
-      destination_ips_list.push_back(makeCidrListEntry(entry.first, entry.second));
+      if (build_destination_ips_trie) {
+        destination_ips_list.push_back(makeCidrListEntry(entry.first, entry.second));
+      }
 
       // This hugely nested for loop greatly pains me, but I'm not sure how to make it better.
       // We need to get access to all of the source IP strings so that we can convert them into
       // a trie like we did for the destination IPs above.
-      for (auto& server_names_entry : *entry.second) {
-        for (auto& transport_protocols_entry : server_names_entry.second) {
+      entry.second->forEach([](TransportProtocolsMap& transport_protocols_map) {
+        for (auto& transport_protocols_entry : transport_protocols_map) {
           for (auto& application_protocols_entry : transport_protocols_entry.second) {
             for (auto& source_array_entry : application_protocols_entry.second) {
               auto& source_ips_map = source_array_entry.first;
+              if (source_ips_map.empty() || hasOnlyCatchAllIp(source_ips_map)) {
+                continue;
+              }
               std::vector<
                   std::pair<SourcePortsMapSharedPtr, std::vector<Network::Address::CidrRange>>>
                   source_ips_list;
@@ -585,10 +598,13 @@ void FilterChainManagerImpl::convertIPsToTries() {
             }
           }
         }
-      }
+      });
     }
 
-    destination_ips_pair.second = std::make_unique<DestinationIPsTrie>(destination_ips_list, true);
+    if (build_destination_ips_trie) {
+      destination_ips_pair.second =
+          std::make_unique<DestinationIPsTrie>(destination_ips_list, true);
+    }
   }
 }
 
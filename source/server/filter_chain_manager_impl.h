@@ -12,6 +12,7 @@
 #include "envoy/thread_local/thread_local.h"
 
 #include "common/common/logger.h"
+#include "common/common/server_name_trie.h"
 #include "common/init/manager_impl.h"
 #include "common/network/cidr_range.h"
 #include "common/network/lc_trie.h"
@@ -193,6 +194,10 @@ public:
       FilterChainFactoryBuilder& b, FilterChainFactoryContextCreator& context_creator);
   static bool isWildcardServerName(const std::string& name);
 
+  // Return the current view of filter chains, keyed by filter chain message. Used by the owning
+  // listener to calculate the intersection of filter chains with another listener.
+  const FcContextMap& filterChainsByMessage() const { return fc_contexts_; }
+
 private:
   void convertIPsToTries();
   using SourcePortsMap = absl::flat_hash_map<uint16_t, Network::FilterChainSharedPtr>;
@@ -200,19 +205,23 @@ private:
   using SourceIPsMap = absl::flat_hash_map<std::string, SourcePortsMapSharedPtr>;
   using SourceIPsTrie = Network::LcTrie::LcTrie<SourcePortsMapSharedPtr>;
   using SourceIPsTriePtr = std::unique_ptr<SourceIPsTrie>;
-  using SourceTypesArray = std::array<std::pair<SourceIPsMap, SourceIPsTriePtr>, 3>;
+  // The trie is only built when some filter chain has source IP requirements, otherwise the map
+  // only has the catch-all entry and is used directly.
+  using SourceIPsPair = std::pair<SourceIPsMap, SourceIPsTriePtr>;
+  using SourceTypesArray = std::array<SourceIPsPair, 3>;
   using ApplicationProtocolsMap = absl::flat_hash_map<std::string, SourceTypesArray>;
   using TransportProtocolsMap = absl::flat_hash_map<std::string, ApplicationProtocolsMap>;
-  // Both exact server names and wildcard domains are part of the same map, in which wildcard
-  // domains are prefixed with "." (i.e. ".example.com" for "*.example.com") to differentiate
-  // between exact and wildcard entries.
-  using ServerNamesMap = absl::flat_hash_map<std::string, TransportProtocolsMap>;
+  // Both exact server names and wildcard domains are part of the same trie. Filter chains without
+  // server name requirements are under the empty exact server name.
+  using ServerNamesMap = ServerNameTrie<TransportProtocolsMap>;
   using ServerNamesMapSharedPtr = std::shared_ptr<ServerNamesMap>;
   using DestinationIPsMap = absl::flat_hash_map<std::string, ServerNamesMapSharedPtr>;
   using DestinationIPsTrie = Network::LcTrie::LcTrie<ServerNamesMapSharedPtr>;
   using DestinationIPsTriePtr = std::unique_ptr<DestinationIPsTrie>;
-  using DestinationPortsMap =
-      absl::flat_hash_map<uint16_t, std::pair<DestinationIPsMap, DestinationIPsTriePtr>>;
+  // As for source IPs, the trie is only built when some filter chain has destination IP
+  // requirements.
+  using DestinationIPsPair = std::pair<DestinationIPsMap, DestinationIPsTriePtr>;
+  using DestinationPortsMap = absl::flat_hash_map<uint16_t, DestinationIPsPair>;
 
   void addFilterChainForDestinationPorts(
       DestinationPortsMap& destination_ports_map, uint16_t destination_port,
@@ -263,7 +272,7 @@ private:
                                     const Network::FilterChainSharedPtr& filter_chain);
 
   const Network::FilterChain*
-  findFilterChainForDestinationIP(const DestinationIPsTrie& destination_ips_trie,
+  findFilterChainForDestinationIP(const DestinationIPsPair& destination_ips,
                                   const Network::ConnectionSocket& socket) const;
   const Network::FilterChain*
   findFilterChainForServerName(const ServerNamesMap& server_names_map,
@@ -279,7 +288,7 @@ private:
                                 const Network::ConnectionSocket& socket) const;
 
   const Network::FilterChain*
-  findFilterChainForSourceIpAndPort(const SourceIPsTrie& source_ips_trie,
+  findFilterChainForSourceIpAndPort(const SourceIPsPair& source_ips,
                                     const Network::ConnectionSocket& socket) const;
 
   const FilterChainManagerImpl* getOriginFilterChainManager() {
@@ -10,15 +10,16 @@ using HotRestartMessage = envoy::HotRestartMessage;
 
 static constexpr uint64_t MaxSendmsgSize = 4096;
 
+// Right now we only allow a maximum of 3 concurrent envoy processes to be running. When the third
+// starts up it will kill the oldest parent.
+static constexpr uint64_t MaxConcurrentProcesses = 3;
+
 void HotRestartingBase::initDomainSocketAddress(sockaddr_un* address) {
   memset(address, 0, sizeof(*address));
   address->sun_family = AF_UNIX;
 }
 
 sockaddr_un HotRestartingBase::createDomainSocketAddress(uint64_t id, const std::string& role) {
-  // Right now we only allow a maximum of 3 concurrent envoy processes to be running. When the third
-  // starts up it will kill the oldest parent.
-  static constexpr uint64_t MaxConcurrentProcesses = 3;
   id = id % MaxConcurrentProcesses;
 
   // This creates an anonymous domain socket name (where the first byte of the name of \0).
@@ -31,6 +32,10 @@ sockaddr_un HotRestartingBase::createDomainSocketAddress(uint64_t id, const std:
   return address;
 }
 
+std::string HotRestartingBase::createSharedMemoryName(uint64_t id, const std::string& role) {
+  return fmt::format("/envoy_{}_shared_memory_{}", role, base_id_ + id % MaxConcurrentProcesses);
+}
+
 void HotRestartingBase::bindDomainSocket(uint64_t id, const std::string& role) {
   Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
   // This actually creates the socket and binds it. We use the socket in datagram mode so we can
@@ -1,7 +1,11 @@
 #include "server/hot_restarting_child.h"
 
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
 #include "common/common/utility.h"
 
+#include "server/hot_restarting_stats_snapshot.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -95,6 +99,11 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
     stat_merger_ = std::make_unique<Stats::StatMerger>(stats_store);
   }
 
+  if (!stats_proto.snapshot_name().empty()) {
+    mergeParentStatsSnapshot(stats_proto.snapshot_name(), stats_proto.snapshot_size());
+    return;
+  }
+
   // Convert the protobuf for serialized dynamic spans into the structure
   // required by StatMerger.
   Stats::StatMerger::DynamicsMap dynamics;
@@ -108,5 +117,45 @@ void HotRestartingChild::mergeParentStats(Stats::Store& stats_store,
   stat_merger_->mergeStats(stats_proto.counter_deltas(), stats_proto.gauges(), dynamics);
 }
 
+void HotRestartingChild::mergeParentStatsSnapshot(const std::string& region_name, uint64_t size) {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+  const Api::SysCallIntResult result =
+      hot_restart_os_sys_calls.shmOpen(region_name.c_str(), O_RDONLY, 0);
+  if (result.rc_ == -1) {
+    // The stats of the parent are lost, but that is no reason to fail the hot restart.
+    ENVOY_LOG(error,
+              "cannot open shared memory region {} with the parent stats, starting with fresh "
+              "stats: {}",
+              region_name, strerror(result.errno_));
+    return;
+  }
+  // Nobody else has a use for the region, it goes away once unmapped.
+  hot_restart_os_sys_calls.shmUnlink(region_name.c_str());
+
+  if (size > 0) {
+    const Api::SysCallPtrResult mmap_result =
+        os_sys_calls.mmap(nullptr, size, PROT_READ, MAP_SHARED, result.rc_, 0);
+    if (mmap_result.rc_ == MAP_FAILED) {
+      ENVOY_LOG(error,
+                "cannot map shared memory region {} with the parent stats, starting with fresh "
+                "stats: {}",
+                region_name, strerror(mmap_result.errno_));
+      os_sys_calls.close(result.rc_);
+      return;
+    }
+    StatsSnapshotReader::read(
+        static_cast<const uint8_t*>(mmap_result.rc_), size,
+        [this](absl::string_view name, uint64_t delta, const Stats::DynamicSpans& spans) {
+          stat_merger_->mergeCounter(name, delta, spans);
+        },
+        [this](absl::string_view name, uint64_t value, const Stats::DynamicSpans& spans) {
+          stat_merger_->mergeGauge(name, value, spans);
+        });
+    munmap(mmap_result.rc_, size);
+  }
+  os_sys_calls.close(result.rc_);
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -23,6 +23,8 @@ public:
                         const envoy::HotRestartMessage::Reply::Stats& stats_proto);
 
 private:
+  void mergeParentStatsSnapshot(const std::string& region_name, uint64_t size);
+
   const int restart_epoch_;
   bool parent_terminated_{};
   sockaddr_un parent_address_;
@@ -2,11 +2,14 @@
 
 #include "envoy/server/instance.h"
 
+#include "common/api/os_sys_calls_impl.h"
+#include "common/api/os_sys_calls_impl_hot_restart.h"
 #include "common/memory/stats.h"
 #include "common/network/utility.h"
 #include "common/stats/stat_merger.h"
 #include "common/stats/symbol_table_impl.h"
 
+#include "server/hot_restarting_stats_snapshot.h"
 #include "server/listener_impl.h"
 
 namespace Envoy {
@@ -15,7 +18,8 @@ namespace Server {
 using HotRestartMessage = envoy::HotRestartMessage;
 
 HotRestartingParent::HotRestartingParent(int base_id, int restart_epoch)
-    : HotRestartingBase(base_id), restart_epoch_(restart_epoch) {
+    : HotRestartingBase(base_id), restart_epoch_(restart_epoch),
+      stats_snapshot_name_(createSharedMemoryName(restart_epoch_, "stats")) {
   child_address_ = createDomainSocketAddress(restart_epoch_ + 1, "child");
   bindDomainSocket(restart_epoch_, "parent");
 }
@@ -55,7 +59,10 @@ void HotRestartingParent::onSocketEvent() {
 
     case HotRestartMessage::Request::kStats: {
       HotRestartMessage wrapped_reply;
-      internal_->exportStatsToChild(wrapped_reply.mutable_reply()->mutable_stats());
+      HotRestartMessage::Reply::Stats* stats = wrapped_reply.mutable_reply()->mutable_stats();
+      if (!internal_->exportStatsSnapshotToChild(stats_snapshot_name_, stats)) {
+        internal_->exportStatsToChild(stats);
+      }
       sendHotRestartMessage(child_address_, wrapped_reply);
       break;
     }
@@ -97,7 +104,10 @@ HotRestartingParent::Internal::Internal(Server::Instance* server) : server_(serv
   gauge.inc();
 }
 
+HotRestartingParent::Internal::~Internal() { clearExportedStats(); }
+
 HotRestartMessage HotRestartingParent::Internal::shutdownAdmin() {
+  clearExportedStats();
   server_->shutdownAdmin();
   HotRestartMessage wrapped_reply;
   wrapped_reply.mutable_reply()->mutable_shutdown_admin()->set_original_start_time_unix_seconds(
@@ -128,13 +138,65 @@ HotRestartingParent::Internal::getListenSocketsForChild(const HotRestartMessage:
 // TODO(fredlas) if there are enough stats for stat name length to become an issue, this current
 // implementation can negate the benefit of symbolized stat names by periodically reaching the
 // magnitude of memory usage that they are meant to avoid, since this map holds full-string
-// names. The problem can be solved by splitting the export up over many chunks.
+// names. The problem can be solved by splitting the export up over many chunks. The first export,
+// which carries all of the stats, avoids this by going through exportStatsSnapshotToChild().
 void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply::Stats* stats) {
+  exportStats(
+      stats,
+      [this, stats](Stats::Metric& counter, uint64_t delta) {
+        const std::string name = counter.name();
+        (*stats->mutable_counter_deltas())[name] = delta;
+        recordDynamics(stats, name, counter.statName());
+      },
+      [this, stats](Stats::Metric& gauge, uint64_t value) {
+        const std::string name = gauge.name();
+        (*stats->mutable_gauges())[name] = value;
+        recordDynamics(stats, name, gauge.statName());
+      });
+}
+
+bool HotRestartingParent::Internal::exportStatsSnapshotToChild(
+    const std::string& region_name, HotRestartMessage::Reply::Stats* stats) {
+  if (stats_exported_) {
+    return false;
+  }
+
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+  // A region which a previous child never got to open is of no use anymore.
+  hot_restart_os_sys_calls.shmUnlink(region_name.c_str());
+  const Api::SysCallIntResult result = hot_restart_os_sys_calls.shmOpen(
+      region_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (result.rc_ == -1) {
+    ENVOY_LOG(warn, "cannot open shared memory region {} for the stats of the child: {}",
+              region_name, strerror(result.errno_));
+    return false;
+  }
+
+  StatsSnapshotWriter writer(result.rc_);
+  exportStats(
+      stats,
+      [&writer](Stats::Metric& counter, uint64_t delta) {
+        writer.addCounter(counter.name(), delta,
+                          counter.symbolTable().getDynamicSpans(counter.statName()));
+      },
+      [&writer](Stats::Metric& gauge, uint64_t value) {
+        writer.addGauge(gauge.name(), value,
+                        gauge.symbolTable().getDynamicSpans(gauge.statName()));
+      });
+  stats->set_snapshot_size(writer.finish());
+  stats->set_snapshot_name(region_name);
+  os_sys_calls.close(result.rc_);
+  return true;
+}
+
+void HotRestartingParent::Internal::exportStats(HotRestartMessage::Reply::Stats* stats,
+                                                const ExportStatCb& on_counter,
+                                                const ExportStatCb& on_gauge) {
   for (const auto& gauge : server_->stats().gauges()) {
-    if (gauge->used()) {
-      const std::string name = gauge->name();
-      (*stats->mutable_gauges())[name] = gauge->value();
-      recordDynamics(stats, name, gauge->statName());
+    const uint64_t value = gauge->value();
+    if (gauge->used() && updateExportedGauge(*gauge, value)) {
+      on_gauge(*gauge, value);
     }
   }
 
@@ -144,14 +206,39 @@ void HotRestartingParent::Internal::exportStatsToChild(HotRestartMessage::Reply:
       // latching) by the time it begins exporting to the hot restart child.
       uint64_t latched_value = counter->latch();
       if (latched_value > 0) {
-        const std::string name = counter->name();
-        (*stats->mutable_counter_deltas())[name] = latched_value;
-        recordDynamics(stats, name, counter->statName());
+        on_counter(*counter, latched_value);
       }
     }
   }
   stats->set_memory_allocated(Memory::Stats::totalCurrentlyAllocated());
   stats->set_num_connections(server_->listenerManager().numConnections());
+  stats_exported_ = true;
+}
+
+bool HotRestartingParent::Internal::updateExportedGauge(Stats::Gauge& gauge, uint64_t value) {
+  auto iter = exported_gauge_values_.find(gauge.statName());
+  if (iter != exported_gauge_values_.end()) {
+    if (iter->second == value) {
+      return false;
+    }
+    iter->second = value;
+    return true;
+  }
+
+  // The gauge may go away before the next export, so its name needs storage of its own.
+  exported_symbol_table_ = &gauge.symbolTable();
+  auto inserted =
+      exported_gauge_names_.insert(Stats::StatNameStorage(gauge.statName(), gauge.symbolTable()));
+  exported_gauge_values_[inserted.first->statName()] = value;
+  return true;
+}
+
+void HotRestartingParent::Internal::clearExportedStats() {
+  stats_exported_ = false;
+  exported_gauge_values_.clear();
+  if (exported_symbol_table_ != nullptr) {
+    exported_gauge_names_.free(*exported_symbol_table_);
+  }
 }
 
 void HotRestartingParent::Internal::recordDynamics(HotRestartMessage::Reply::Stats* stats,
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <functional>
+
 #include "common/common/hash.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "server/hot_restarting_base.h"
 
@@ -20,28 +23,53 @@ public:
 
   // The hot restarting parent's hot restart logic. Each function is meant to be called to fulfill a
   // request from the child for that action.
-  class Internal {
+  class Internal : Logger::Loggable<Logger::Id::main> {
   public:
     explicit Internal(Server::Instance* server);
-    // Return value is the response to return to the child.
+    ~Internal();
+    // Return value is the response to return to the child. As a new child starts by sending this
+    // request, stats exports start over with it.
     envoy::HotRestartMessage shutdownAdmin();
     // Return value is the response to return to the child.
     envoy::HotRestartMessage
     getListenSocketsForChild(const envoy::HotRestartMessage::Request& request);
     // 'stats' is a field in the reply protobuf to be sent to the child, which we should populate.
+    // Only the counters and gauges which changed since the previous export are included.
     void exportStatsToChild(envoy::HotRestartMessage::Reply::Stats* stats);
+    // Like exportStatsToChild(), but lays out the counters and gauges in the shared memory region
+    // named 'region_name' rather than in the maps of 'stats'. Only the first export to a child,
+    // which carries all of the stats, is worth a region. Returns false if stats were already
+    // exported to the child, or if the region could not be created, in which case nothing was
+    // exported.
+    bool exportStatsSnapshotToChild(const std::string& region_name,
+                                    envoy::HotRestartMessage::Reply::Stats* stats);
     void recordDynamics(envoy::HotRestartMessage::Reply::Stats* stats, const std::string& name,
                         Stats::StatName stat_name);
     void drainListeners();
 
   private:
+    using ExportStatCb = std::function<void(Stats::Metric& metric, uint64_t value)>;
+
+    void exportStats(envoy::HotRestartMessage::Reply::Stats* stats, const ExportStatCb& on_counter,
+                     const ExportStatCb& on_gauge);
+    // Returns whether the gauge was never exported to the child or changed since, and remembers
+    // 'value' as exported.
+    bool updateExportedGauge(Stats::Gauge& gauge, uint64_t value);
+    void clearExportedStats();
+
     Server::Instance* const server_{};
+    bool stats_exported_{};
+    // The values of the gauges as last exported to the child, and the storage of their names.
+    Stats::StatNameHashMap<uint64_t> exported_gauge_values_;
+    Stats::StatNameStorageSet exported_gauge_names_;
+    Stats::SymbolTable* exported_symbol_table_{};
   };
 
 private:
   void onSocketEvent();
 
   const int restart_epoch_;
+  const std::string stats_snapshot_name_;
   sockaddr_un child_address_;
   Event::FileEventPtr socket_event_;
   std::unique_ptr<Internal> internal_;
@@ -0,0 +1,105 @@
+#include "server/hot_restarting_stats_snapshot.h"
+
+#include <cstring>
+
+#include "common/api/os_sys_calls_impl.h"
+#include "common/common/assert.h"
+#include "common/common/fmt.h"
+
+namespace Envoy {
+namespace Server {
+
+namespace {
+
+// Entries are written out once this much of them is buffered.
+constexpr uint64_t WriteChunkSize = 64 * 1024;
+
+uint64_t paddedSize(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+} // namespace
+
+void StatsSnapshotWriter::add(StatsSnapshotEntry::Type type, absl::string_view name,
+                              uint64_t value, const Stats::DynamicSpans& spans) {
+  ASSERT(spans.size() <= UINT16_MAX);
+  StatsSnapshotEntry entry;
+  entry.value_ = value;
+  entry.name_size_ = name.size();
+  entry.num_spans_ = spans.size();
+  entry.type_ = type;
+
+  const uint64_t offset = buffer_.size();
+  const uint64_t spans_size = spans.size() * 2 * sizeof(uint32_t);
+  // Padding bytes are zeroed by resize().
+  buffer_.resize(offset + sizeof(entry) + spans_size + paddedSize(name.size()));
+  uint8_t* next = buffer_.data() + offset;
+  memcpy(next, &entry, sizeof(entry));
+  next += sizeof(entry);
+  for (const Stats::DynamicSpan& span : spans) {
+    const uint32_t tokens[2] = {span.first, span.second};
+    memcpy(next, tokens, sizeof(tokens));
+    next += sizeof(tokens);
+  }
+  memcpy(next, name.data(), name.size());
+
+  if (buffer_.size() >= WriteChunkSize) {
+    write();
+  }
+}
+
+void StatsSnapshotWriter::write() {
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  uint64_t offset = 0;
+  while (offset < buffer_.size()) {
+    const Api::SysCallSizeResult result =
+        os_sys_calls.write(fd_, buffer_.data() + offset, buffer_.size() - offset);
+    RELEASE_ASSERT(result.rc_ != -1,
+                   fmt::format("failed to write stats snapshot, errno = {}", result.errno_));
+    offset += result.rc_;
+  }
+  written_ += buffer_.size();
+  buffer_.clear();
+}
+
+uint64_t StatsSnapshotWriter::finish() {
+  write();
+  return written_;
+}
+
+void StatsSnapshotReader::read(const uint8_t* data, uint64_t size, const StatCb& on_counter,
+                               const StatCb& on_gauge) {
+  Stats::DynamicSpans spans;
+  uint64_t offset = 0;
+  while (offset < size) {
+    StatsSnapshotEntry entry;
+    RELEASE_ASSERT(size - offset >= sizeof(entry), "truncated stats snapshot entry");
+    memcpy(&entry, data + offset, sizeof(entry));
+    offset += sizeof(entry);
+
+    const uint64_t spans_size = entry.num_spans_ * 2 * sizeof(uint32_t);
+    RELEASE_ASSERT(size - offset >= spans_size + paddedSize(entry.name_size_),
+                   "truncated stats snapshot entry");
+    spans.clear();
+    for (uint16_t i = 0; i < entry.num_spans_; ++i) {
+      uint32_t tokens[2];
+      memcpy(tokens, data + offset, sizeof(tokens));
+      offset += sizeof(tokens);
+      spans.emplace_back(tokens[0], tokens[1]);
+    }
+    const absl::string_view name(reinterpret_cast<const char*>(data + offset), entry.name_size_);
+    offset += paddedSize(entry.name_size_);
+
+    switch (entry.type_) {
+    case StatsSnapshotEntry::Type::Counter:
+      on_counter(name, entry.value_, spans);
+      break;
+    case StatsSnapshotEntry::Type::Gauge:
+      on_gauge(name, entry.value_, spans);
+      break;
+    default:
+      RELEASE_ASSERT(false, "unknown stats snapshot entry type");
+    }
+  }
+}
+
+} // namespace Server
+} // namespace Envoy
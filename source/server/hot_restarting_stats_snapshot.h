@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "envoy/common/platform.h"
+#include "envoy/stats/symbol_table.h"
+
+#include "absl/strings/string_view.h"
+
+namespace Envoy {
+namespace Server {
+
+/**
+ * The compact binary layout in which the hot restart parent hands all of its stats to the child at
+ * once, through a shared memory region rather than through protobufs over the domain socket. The
+ * region is a series of entries, each of which is a StatsSnapshotEntry, followed by the first and
+ * last token of each of the dynamic spans of the stat's name as uint32_t, followed by the name
+ * itself, padded to a multiple of 8 bytes. The parent and the child are running on the same host,
+ * and have the same hot restart version, so the layout is in host byte order.
+ */
+struct StatsSnapshotEntry {
+  enum class Type : uint16_t { Counter, Gauge };
+
+  // The counter's delta since the final latch before hot restart, or the gauge's value.
+  uint64_t value_;
+  uint32_t name_size_;
+  uint16_t num_spans_;
+  Type type_;
+};
+
+/**
+ * Writes a stats snapshot to a file, typically a shared memory object. Entries are buffered and
+ * written out in chunks, so the snapshot of a large stats store never needs to be held in memory.
+ */
+class StatsSnapshotWriter {
+public:
+  explicit StatsSnapshotWriter(os_fd_t fd) : fd_(fd) {}
+
+  void addCounter(absl::string_view name, uint64_t delta, const Stats::DynamicSpans& spans) {
+    add(StatsSnapshotEntry::Type::Counter, name, delta, spans);
+  }
+  void addGauge(absl::string_view name, uint64_t value, const Stats::DynamicSpans& spans) {
+    add(StatsSnapshotEntry::Type::Gauge, name, value, spans);
+  }
+
+  /**
+   * Writes out the entries which are still buffered.
+   * @return the size of the snapshot in bytes.
+   */
+  uint64_t finish();
+
+private:
+  void add(StatsSnapshotEntry::Type type, absl::string_view name, uint64_t value,
+           const Stats::DynamicSpans& spans);
+  void write();
+
+  const os_fd_t fd_;
+  std::vector<uint8_t> buffer_;
+  uint64_t written_{};
+};
+
+/**
+ * Reads a stats snapshot laid out by StatsSnapshotWriter, typically from a mapping of the shared
+ * memory object it was written to.
+ */
+class StatsSnapshotReader {
+public:
+  using StatCb = std::function<void(absl::string_view name, uint64_t value,
+                                    const Stats::DynamicSpans& spans)>;
+
+  /**
+   * Calls on_counter with every counter delta of the snapshot, and on_gauge with every gauge value.
+   */
+  static void read(const uint8_t* data, uint64_t size, const StatCb& on_counter,
+                   const StatCb& on_gauge);
+};
+
+} // namespace Server
+} // namespace Envoy
@@ -6,7 +6,6 @@
 #include <regex>
 #include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -49,6 +48,7 @@
 #include "common/network/listen_socket_impl.h"
 #include "common/network/utility.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/router/config_impl.h"
@@ -59,6 +59,10 @@
 
 #include "extensions/access_loggers/file/file_access_log_impl.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
@@ -69,6 +73,11 @@ namespace Server {
 
 namespace {
 
+// A prime frequency, so that sampling does not line up with periodic timers in the process.
+constexpr uint32_t DefaultSamplingFrequencyHz = 99;
+constexpr uint32_t MaxSamplingFrequencyHz = 1000;
+constexpr uint32_t DefaultCollapsedWindowSeconds = 60;
+
 /**
  * Favicon base64 image was harvested by screen-capturing the favicon from a Chrome tab
  * while visiting https://www.envoyproxy.io/. The resulting PNG was translated to base64
@@ -133,8 +142,6 @@ const char AdminHtmlEnd[] = R"(
 </body>
 )";
 
-const std::regex PromRegex("[^a-zA-Z0-9_]");
-
 const uint64_t RecentLookupsCapacity = 100;
 
 // Helper method to get filter parameter, or report an error for an invalid regex.
@@ -672,6 +679,10 @@ Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::ResponseHe
 
   bool enable = query_params.begin()->second == "y";
   if (enable && !Profiler::Cpu::profilerEnabled()) {
+    if (Profiler::SamplingCpu::isRunning()) {
+      response.add("the sampling profiler is running, disable it first\n");
+      return Http::Code::BadRequest;
+    }
     if (!Profiler::Cpu::startProfiler(profile_path_)) {
       response.add("failure to start the profiler");
       return Http::Code::InternalServerError;
@@ -685,6 +696,67 @@ Http::Code AdminImpl::handlerCpuProfiler(absl::string_view url, Http::ResponseHe
   return Http::Code::OK;
 }
 
+Http::Code AdminImpl::handlerCpuProfilerSampling(absl::string_view url, Http::ResponseHeaderMap&,
+                                                 Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::SamplingCpu::profilerAvailable()) {
+    response.add("The current platform does not support the sampling profiler");
+    return Http::Code::NotImplemented;
+  }
+
+  Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  const auto enable = query_params.find("enable");
+  const auto frequency_param = query_params.find("frequency");
+  uint32_t frequency = DefaultSamplingFrequencyHz;
+  if (enable == query_params.end() || (enable->second != "y" && enable->second != "n") ||
+      (frequency_param != query_params.end() &&
+       (!absl::SimpleAtoi(frequency_param->second, &frequency) || frequency == 0 ||
+        frequency > MaxSamplingFrequencyHz))) {
+    response.add(fmt::format("?enable=<y|n>&frequency=<1-{}, default {}>\n",
+                             MaxSamplingFrequencyHz, DefaultSamplingFrequencyHz));
+    return Http::Code::BadRequest;
+  }
+
+  if (enable->second == "n") {
+    Profiler::SamplingCpu::stop();
+  } else if (Profiler::Cpu::profilerEnabled()) {
+    response.add("the CPU profiler is running, disable it first\n");
+    return Http::Code::BadRequest;
+  } else if (!Profiler::SamplingCpu::start(frequency)) {
+    response.add("failure to start the sampling profiler\n");
+    return Http::Code::InternalServerError;
+  }
+
+  response.add("OK\n");
+  return Http::Code::OK;
+}
+
+Http::Code AdminImpl::handlerCpuProfilerCollapsed(absl::string_view url,
+                                                  Http::ResponseHeaderMap& response_headers,
+                                                  Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::SamplingCpu::profilerAvailable()) {
+    response.add("The current platform does not support the sampling profiler");
+    return Http::Code::NotImplemented;
+  }
+
+  Http::Utility::QueryParams query_params = Http::Utility::parseQueryString(url);
+  const auto seconds_param = query_params.find("seconds");
+  const auto per_thread = query_params.find("per_thread");
+  uint32_t seconds = DefaultCollapsedWindowSeconds;
+  if ((seconds_param != query_params.end() &&
+       !absl::SimpleAtoi(seconds_param->second, &seconds)) ||
+      (per_thread != query_params.end() && per_thread->second != "y" &&
+       per_thread->second != "n")) {
+    response.add("?seconds=<window>&per_thread=<y|n>\n");
+    return Http::Code::BadRequest;
+  }
+
+  response_headers.setReferenceContentType(Http::Headers::get().ContentTypeValues.Text);
+  response.add(Profiler::SamplingCpu::collapsedStacks(
+      std::chrono::seconds(seconds),
+      per_thread != query_params.end() && per_thread->second == "y"));
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::ResponseHeaderMap&,
                                           Buffer::Instance& response, AdminStream&) {
   if (!Profiler::Heap::profilerEnabled()) {
@@ -732,6 +804,17 @@ Http::Code AdminImpl::handlerHeapProfiler(absl::string_view url, Http::ResponseH
   return res;
 }
 
+Http::Code AdminImpl::handlerHeapProfilerSample(absl::string_view, Http::ResponseHeaderMap&,
+                                                Buffer::Instance& response, AdminStream&) {
+  if (!Profiler::Heap::profilerEnabled()) {
+    response.add("The current build does not support heap profiler");
+    return Http::Code::NotImplemented;
+  }
+
+  response.add(Profiler::Heap::sample());
+  return Http::Code::OK;
+}
+
 Http::Code AdminImpl::handlerHealthcheckFail(absl::string_view, Http::ResponseHeaderMap&,
                                              Buffer::Instance& response, AdminStream&) {
   server_.failHealthcheck(true);
@@ -957,14 +1040,19 @@ Http::Code AdminImpl::handlerPrometheusStats(absl::string_view path_and_query,
   }
   PrometheusStatsFormatter::statsAsPrometheus(server_.stats().counters(), server_.stats().gauges(),
                                               server_.stats().histograms(), response, used_only,
-                                              regex);
+                                              regex, prometheus_name_cache_);
   return Http::Code::OK;
 }
 
 std::string PrometheusStatsFormatter::sanitizeName(const std::string& name) {
   // The name must match the regex [a-zA-Z_][a-zA-Z0-9_]* as required by
   // prometheus. Refer to https://prometheus.io/docs/concepts/data_model/.
-  std::string stats_name = std::regex_replace(name, PromRegex, "_");
+  std::string stats_name = name;
+  for (char& c : stats_name) {
+    if (!absl::ascii_isalnum(c) && c != '_') {
+      c = '_';
+    }
+  }
   if (stats_name[0] >= '0' && stats_name[0] <= '9') {
     return absl::StrCat("_", stats_name);
   } else {
@@ -995,53 +1083,113 @@ std::string PrometheusStatsFormatter::metricName(const std::string& extracted_na
   return sanitizeName(fmt::format("envoy_{0}", extracted_name));
 }
 
+bool PrometheusStatsFormatter::NameCache::cacheable(Stats::Metric& metric) {
+  if (symbol_table_ == nullptr) {
+    symbol_table_ = &metric.symbolTable();
+  }
+  return symbol_table_ == &metric.symbolTable();
+}
+
+const std::string& PrometheusStatsFormatter::NameCache::lookup(EntryMap& entries,
+                                                                Stats::StatName name,
+                                                                Render render) {
+  auto it = entries.find(name);
+  if (it == entries.end()) {
+    std::string name_string = symbol_table_->toString(name);
+    auto storage = std::make_unique<Stats::StatNameManagedStorage>(name_string, *symbol_table_);
+    const Stats::StatName key = storage->statName();
+    std::string rendered = render != nullptr ? render(name_string) : name_string;
+    it = entries.emplace(key, Entry{std::move(storage), std::move(rendered), generation_}).first;
+  }
+  it->second.generation_ = generation_;
+  return it->second.rendered_;
+}
+
+absl::string_view PrometheusStatsFormatter::NameCache::metricName(Stats::Metric& metric) {
+  if (!cacheable(metric)) {
+    metric_name_ = PrometheusStatsFormatter::metricName(metric.tagExtractedName());
+    return metric_name_;
+  }
+  return lookup(metric_names_, metric.tagExtractedStatName(),
+                &PrometheusStatsFormatter::metricName);
+}
+
+absl::string_view PrometheusStatsFormatter::NameCache::tags(Stats::Metric& metric) {
+  if (!cacheable(metric)) {
+    tags_ = formattedTags(metric.tags());
+    return tags_;
+  }
+  tags_.clear();
+  metric.iterateTagStatNames([this](Stats::StatName name, Stats::StatName value) -> bool {
+    if (!tags_.empty()) {
+      tags_.push_back(',');
+    }
+    absl::StrAppend(&tags_, lookup(tag_names_, name, &sanitizeName), "=\"",
+                    lookup(tag_values_, value, nullptr), "\"");
+    return true;
+  });
+  return tags_;
+}
+
+void PrometheusStatsFormatter::NameCache::sweep() {
+  for (EntryMap* entries : {&metric_names_, &tag_names_, &tag_values_}) {
+    for (auto it = entries->begin(); it != entries->end();) {
+      if (it->second.generation_ != generation_) {
+        entries->erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+  ++generation_;
+}
+
 uint64_t PrometheusStatsFormatter::statsAsPrometheus(
     const std::vector<Stats::CounterSharedPtr>& counters,
     const std::vector<Stats::GaugeSharedPtr>& gauges,
     const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
     const bool used_only, const absl::optional<std::regex>& regex) {
-  std::unordered_set<std::string> metric_type_tracker;
-  for (const auto& counter : counters) {
-    if (!shouldShowMetric(*counter, used_only, regex)) {
-      continue;
-    }
+  NameCache cache;
+  return statsAsPrometheus(counters, gauges, histograms, response, used_only, regex, cache);
+}
 
-    const std::string tags = formattedTags(counter->tags());
-    const std::string metric_name = metricName(counter->tagExtractedName());
+uint64_t PrometheusStatsFormatter::statsAsPrometheus(
+    const std::vector<Stats::CounterSharedPtr>& counters,
+    const std::vector<Stats::GaugeSharedPtr>& gauges,
+    const std::vector<Stats::ParentHistogramSharedPtr>& histograms, Buffer::Instance& response,
+    const bool used_only, const absl::optional<std::regex>& regex, NameCache& cache) {
+  absl::flat_hash_set<std::string> metric_type_tracker;
+  const auto add_type = [&](absl::string_view metric_name, absl::string_view type) {
     if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} counter\n", metric_name));
+      metric_type_tracker.emplace(metric_name);
+      response.add(absl::StrCat("# TYPE ", metric_name, " ", type, "\n"));
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, counter->value()));
-  }
+  };
 
-  for (const auto& gauge : gauges) {
-    if (!shouldShowMetric(*gauge, used_only, regex)) {
-      continue;
-    }
+  const auto add_values = [&](const auto& metrics, absl::string_view type) {
+    for (const auto& metric : metrics) {
+      if (!shouldShowMetric(*metric, used_only, regex)) {
+        continue;
+      }
 
-    const std::string tags = formattedTags(gauge->tags());
-    const std::string metric_name = metricName(gauge->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} gauge\n", metric_name));
+      const absl::string_view metric_name = cache.metricName(*metric);
+      add_type(metric_name, type);
+      response.add(
+          absl::StrCat(metric_name, "{", cache.tags(*metric), "} ", metric->value(), "\n"));
     }
-    response.add(fmt::format("{0}{{{1}}} {2}\n", metric_name, tags, gauge->value()));
-  }
+  };
+  add_values(counters, "counter");
+  add_values(gauges, "gauge");
 
   for (const auto& histogram : histograms) {
     if (!shouldShowMetric(*histogram, used_only, regex)) {
       continue;
     }
 
-    const std::string tags = formattedTags(histogram->tags());
-    const std::string hist_tags = histogram->tags().empty() ? EMPTY_STRING : (tags + ",");
-
-    const std::string metric_name = metricName(histogram->tagExtractedName());
-    if (metric_type_tracker.find(metric_name) == metric_type_tracker.end()) {
-      metric_type_tracker.insert(metric_name);
-      response.add(fmt::format("# TYPE {0} histogram\n", metric_name));
-    }
+    const absl::string_view metric_name = cache.metricName(*histogram);
+    add_type(metric_name, "histogram");
+    const absl::string_view tags = cache.tags(*histogram);
+    const absl::string_view hist_tags_separator = tags.empty() ? "" : ",";
 
     const Stats::HistogramStatistics& stats = histogram->cumulativeStatistics();
     const std::vector<double>& supported_buckets = stats.supportedBuckets();
@@ -1054,16 +1202,21 @@ uint64_t PrometheusStatsFormatter::statsAsPrometheus(
       // 'g' operator which prints the number in general fixed point format or scientific format
       // with precision 50 to round the number up to 32 significant digits in fixed point format
       // which should cover pretty much all cases
-      response.add(fmt::format("{0}_bucket{{{1}le=\"{2:.32g}\"}} {3}\n", metric_name, hist_tags,
-                               bucket, value));
+      response.add(absl::StrCat(metric_name, "_bucket{", tags, hist_tags_separator, "le=\"",
+                                fmt::format("{:.32g}", bucket), "\"} ", value, "\n"));
     }
 
-    response.add(fmt::format("{0}_bucket{{{1}le=\"+Inf\"}} {2}\n", metric_name, hist_tags,
-                             stats.sampleCount()));
-    response.add(fmt::format("{0}_sum{{{1}}} {2:.32g}\n", metric_name, tags, stats.sampleSum()));
-    response.add(fmt::format("{0}_count{{{1}}} {2}\n", metric_name, tags, stats.sampleCount()));
+    response.add(absl::StrCat(metric_name, "_bucket{", tags, hist_tags_separator, "le=\"+Inf\"} ",
+                              stats.sampleCount(), "\n"));
+    response.add(absl::StrCat(metric_name, "_sum{", tags, "} ",
+                              fmt::format("{:.32g}", stats.sampleSum()), "\n"));
+    response.add(absl::StrCat(metric_name, "_count{", tags, "} ", stats.sampleCount(), "\n"));
   }
 
+  // A filtered scrape does not touch every stat, so it must not evict the names of the others.
+  if (!used_only && !regex.has_value()) {
+    cache.sweep();
+  }
   return metric_type_tracker.size();
 }
 
@@ -1340,8 +1493,14 @@ AdminImpl::AdminImpl(const std::string& profile_path, Server::Instance& server)
            MAKE_ADMIN_HANDLER(handlerContention), false, false},
           {"/cpuprofiler", "enable/disable the CPU profiler",
            MAKE_ADMIN_HANDLER(handlerCpuProfiler), false, true},
+          {"/cpuprofiler/sampling", "enable/disable the low overhead sampling CPU profiler",
+           MAKE_ADMIN_HANDLER(handlerCpuProfilerSampling), false, true},
+          {"/cpuprofiler/collapsed", "print the sampled CPU profile as collapsed stacks",
+           MAKE_ADMIN_HANDLER(handlerCpuProfilerCollapsed), false, false},
           {"/heapprofiler", "enable/disable the heap profiler",
            MAKE_ADMIN_HANDLER(handlerHeapProfiler), false, true},
+          {"/heapprofiler/sample", "print a sample of the live heap in pprof format",
+           MAKE_ADMIN_HANDLER(handlerHeapProfilerSample), false, false},
           {"/healthcheck/fail", "cause the server to fail health checks",
            MAKE_ADMIN_HANDLER(handlerHealthcheckFail), false, true},
           {"/healthcheck/ok", "cause the server to pass health checks",
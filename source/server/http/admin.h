@@ -3,6 +3,7 @@
 #include <chrono>
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -37,6 +38,7 @@
 #include "common/network/raw_buffer_socket.h"
 #include "common/router/scoped_config_impl.h"
 #include "common/stats/isolated_store_impl.h"
+#include "common/stats/symbol_table_impl.h"
 
 #include "server/http/admin_filter.h"
 #include "server/http/config_tracker_impl.h"
@@ -52,6 +54,108 @@ class AdminInternalAddressConfig : public Http::InternalAddressConfig {
   bool isInternalAddress(const Network::Address::Instance&) const override { return false; }
 };
 
+/**
+ * Formatter for metric/labels exported to Prometheus.
+ *
+ * See: https://prometheus.io/docs/concepts/data_model
+ */
+class PrometheusStatsFormatter {
+public:
+  /**
+   * Caches the rendered metric names, tag names and tag values of the stats across scrapes, so
+   * that a scrape only has to decode and sanitize the names of stats created since the previous
+   * one. Rendered names which an unfiltered scrape did not use are dropped at its end, so the cache
+   * does not outlive the stats it was built from. Only used from the main thread.
+   */
+  class NameCache {
+  public:
+    /**
+     * @return the rendered name of the metric, valid until the next call.
+     */
+    absl::string_view metricName(Stats::Metric& metric);
+
+    /**
+     * @return the rendered, comma separated tags of the metric, valid until the next call.
+     */
+    absl::string_view tags(Stats::Metric& metric);
+
+    /**
+     * Drop the rendered names which were not used since the previous call.
+     */
+    void sweep();
+
+  private:
+    struct Entry {
+      // Keeps the symbols of the name, which is the key of the entry, alive.
+      std::unique_ptr<Stats::StatNameManagedStorage> storage_;
+      std::string rendered_;
+      uint64_t generation_;
+    };
+    using EntryMap = Stats::StatNameHashMap<Entry>;
+    // Renders a decoded name, nullptr to keep the name as it is.
+    using Render = std::string (*)(const std::string& name);
+
+    bool cacheable(Stats::Metric& metric);
+    const std::string& lookup(EntryMap& entries, Stats::StatName name, Render render);
+
+    // All stats of a server share one symbol table. Metrics from another table, which only occur
+    // in tests, are rendered without the cache as equal StatNames may then stand for different
+    // names.
+    Stats::SymbolTable* symbol_table_{};
+    EntryMap metric_names_;
+    EntryMap tag_names_;
+    EntryMap tag_values_;
+    uint64_t generation_{};
+    std::string metric_name_;
+    std::string tags_;
+  };
+
+  /**
+   * Extracts counters and gauges and relevant tags, appending them to
+   * the response buffer after sanitizing the metric / label names.
+   * @return uint64_t total number of metric types inserted in response.
+   */
+  static uint64_t statsAsPrometheus(const std::vector<Stats::CounterSharedPtr>& counters,
+                                    const std::vector<Stats::GaugeSharedPtr>& gauges,
+                                    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                                    Buffer::Instance& response, const bool used_only,
+                                    const absl::optional<std::regex>& regex);
+  /**
+   * As above, rendering the metric and tag names through a cache kept across scrapes.
+   */
+  static uint64_t statsAsPrometheus(const std::vector<Stats::CounterSharedPtr>& counters,
+                                    const std::vector<Stats::GaugeSharedPtr>& gauges,
+                                    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
+                                    Buffer::Instance& response, const bool used_only,
+                                    const absl::optional<std::regex>& regex, NameCache& cache);
+  /**
+   * Format the given tags, returning a string as a comma-separated list
+   * of <tag_name>="<tag_value>" pairs.
+   */
+  static std::string formattedTags(const std::vector<Stats::Tag>& tags);
+  /**
+   * Format the given metric name, prefixed with "envoy_".
+   */
+  static std::string metricName(const std::string& extracted_name);
+
+private:
+  /**
+   * Take a string and sanitize it according to Prometheus conventions.
+   */
+  static std::string sanitizeName(const std::string& name);
+
+  /*
+   * Determine whether a metric has never been emitted and choose to
+   * not show it if we only wanted used metrics.
+   */
+  template <class StatType>
+  static bool shouldShowMetric(const StatType& metric, const bool used_only,
+                               const absl::optional<std::regex>& regex) {
+    return ((!used_only || metric.used()) &&
+            (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
+  }
+};
+
 /**
  * Implementation of Server::Admin.
  */
@@ -309,9 +413,18 @@ private:
   Http::Code handlerCpuProfiler(absl::string_view path_and_query,
                                 Http::ResponseHeaderMap& response_headers,
                                 Buffer::Instance& response, AdminStream&);
+  Http::Code handlerCpuProfilerSampling(absl::string_view path_and_query,
+                                        Http::ResponseHeaderMap& response_headers,
+                                        Buffer::Instance& response, AdminStream&);
+  Http::Code handlerCpuProfilerCollapsed(absl::string_view path_and_query,
+                                         Http::ResponseHeaderMap& response_headers,
+                                         Buffer::Instance& response, AdminStream&);
   Http::Code handlerHeapProfiler(absl::string_view path_and_query,
                                  Http::ResponseHeaderMap& response_headers,
                                  Buffer::Instance& response, AdminStream&);
+  Http::Code handlerHeapProfilerSample(absl::string_view path_and_query,
+                                       Http::ResponseHeaderMap& response_headers,
+                                       Buffer::Instance& response, AdminStream&);
   Http::Code handlerHealthcheckFail(absl::string_view path_and_query,
                                     Http::ResponseHeaderMap& response_headers,
                                     Buffer::Instance& response, AdminStream&);
@@ -492,51 +605,7 @@ private:
   Network::ListenSocketFactorySharedPtr socket_factory_;
   AdminListenerPtr listener_;
   const AdminInternalAddressConfig internal_address_config_;
-};
-
-/**
- * Formatter for metric/labels exported to Prometheus.
- *
- * See: https://prometheus.io/docs/concepts/data_model
- */
-class PrometheusStatsFormatter {
-public:
-  /**
-   * Extracts counters and gauges and relevant tags, appending them to
-   * the response buffer after sanitizing the metric / label names.
-   * @return uint64_t total number of metric types inserted in response.
-   */
-  static uint64_t statsAsPrometheus(const std::vector<Stats::CounterSharedPtr>& counters,
-                                    const std::vector<Stats::GaugeSharedPtr>& gauges,
-                                    const std::vector<Stats::ParentHistogramSharedPtr>& histograms,
-                                    Buffer::Instance& response, const bool used_only,
-                                    const absl::optional<std::regex>& regex);
-  /**
-   * Format the given tags, returning a string as a comma-separated list
-   * of <tag_name>="<tag_value>" pairs.
-   */
-  static std::string formattedTags(const std::vector<Stats::Tag>& tags);
-  /**
-   * Format the given metric name, prefixed with "envoy_".
-   */
-  static std::string metricName(const std::string& extracted_name);
-
-private:
-  /**
-   * Take a string and sanitize it according to Prometheus conventions.
-   */
-  static std::string sanitizeName(const std::string& name);
-
-  /*
-   * Determine whether a metric has never been emitted and choose to
-   * not show it if we only wanted used metrics.
-   */
-  template <class StatType>
-  static bool shouldShowMetric(const StatType& metric, const bool used_only,
-                               const absl::optional<std::regex>& regex) {
-    return ((!used_only || metric.used()) &&
-            (!regex.has_value() || std::regex_search(metric.name(), regex.value())));
-  }
+  PrometheusStatsFormatter::NameCache prometheus_name_cache_;
 };
 
 } // namespace Server
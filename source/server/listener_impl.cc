@@ -16,6 +16,7 @@
 #include "common/network/socket_option_factory.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
+#include "common/runtime/runtime_impl.h"
 
 #include "server/configuration_impl.h"
 #include "server/drain_manager_impl.h"
@@ -27,6 +28,8 @@
 #include "extensions/filters/listener/well_known_names.h"
 #include "extensions/transport_sockets/well_known_names.h"
 
+#include "absl/memory/memory.h"
+
 namespace Envoy {
 namespace Server {
 
@@ -234,28 +237,141 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
       }) {
   Network::Address::SocketType socket_type =
       Network::Utility::protobufAddressSocketType(config.address());
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, transparent, false)) {
+  buildListenSocketOptions(socket_type, concurrency);
+  buildUdpListenerFactory(socket_type, concurrency);
+  createListenerFilterFactories(socket_type);
+  buildAccessLog();
+  validateFilterChains(socket_type);
+  buildFilterChains();
+
+  if (socket_type == Network::Address::SocketType::Datagram) {
+    return;
+  }
+
+  // TCP specific setup.
+  buildConnectionBalancer();
+  buildSocketOptions();
+  buildOriginalDstListenerFilter();
+  buildProxyProtocolListenerFilter();
+  buildTlsInspectorListenerFilter();
+
+  if (!workers_started_) {
+    // Initialize dynamic_init_manager_ from Server's init manager if it's not initialized.
+    // NOTE: listener_init_target_ should be added to parent's initManager at the end of the
+    // listener constructor so that this listener's children entities could register their targets
+    // with their parent's initManager.
+    parent_.server_.initManager().add(listener_init_target_);
+  }
+}
+
+ListenerImpl::ListenerImpl(ListenerImpl& origin,
+                           const envoy::config::listener::v3::Listener& config,
+                           const std::string& version_info, ListenerManagerImpl& parent,
+                           const std::string& name, bool added_via_api, bool workers_started,
+                           uint64_t hash, uint32_t concurrency)
+    : parent_(parent), address_(origin.address_),
+      bind_to_port_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.deprecated_v1(), bind_to_port, true)),
+      hand_off_restored_destination_connections_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hidden_envoy_deprecated_use_original_dst, false)),
+      per_connection_buffer_limit_bytes_(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, per_connection_buffer_limit_bytes, 1024 * 1024)),
+      listener_tag_(origin.listener_tag_), name_(name), added_via_api_(added_via_api),
+      workers_started_(workers_started), hash_(hash),
+      validation_visitor_(
+          added_via_api_ ? parent_.server_.messageValidationContext().dynamicValidationVisitor()
+                         : parent_.server_.messageValidationContext().staticValidationVisitor()),
+      // listener_init_target_ is not used during in place update because we expect server started.
+      listener_init_target_("", nullptr),
+      dynamic_init_manager_(std::make_unique<Init::ManagerImpl>(
+          fmt::format("Listener-local-init-manager {} {}", name, hash))),
+      config_(config), version_info_(version_info),
+      listener_filters_timeout_(
+          PROTOBUF_GET_MS_OR_DEFAULT(config, listener_filters_timeout, 15000)),
+      continue_on_listener_filters_timeout_(config.continue_on_listener_filters_timeout()),
+      // The connection balancer is registered with the worker listeners, which outlive this
+      // listener config, so it is shared by all the generations of the listener.
+      connection_balancer_(origin.connection_balancer_),
+      listener_factory_context_(std::make_shared<PerListenerFactoryContextImpl>(
+          origin.listener_factory_context_->listener_factory_context_base_, this, *this)),
+      filter_chain_manager_(address_, origin.listener_factory_context_->parentFactoryContext(),
+                            initManager(), origin.filter_chain_manager_),
+      local_init_watcher_(fmt::format("Listener-local-init-watcher {}", name), [this] {
+        ASSERT(workers_started_);
+        parent_.inPlaceFilterChainUpdate(*this);
+      }) {
+  Network::Address::SocketType socket_type =
+      Network::Utility::protobufAddressSocketType(config.address());
+  // Only TCP listeners are updated in place, see supportUpdateFilterChain().
+  ASSERT(socket_type == Network::Address::SocketType::Stream);
+  ASSERT(workers_started_);
+  buildListenSocketOptions(socket_type, concurrency);
+  createListenerFilterFactories(socket_type);
+  buildAccessLog();
+  validateFilterChains(socket_type);
+  buildFilterChains();
+  buildSocketOptions();
+  buildOriginalDstListenerFilter();
+  buildProxyProtocolListenerFilter();
+  buildTlsInspectorListenerFilter();
+}
+
+void ListenerImpl::buildAccessLog() {
+  for (const auto& access_log : config_.access_log()) {
+    AccessLog::InstanceSharedPtr current_access_log =
+        AccessLog::AccessLogFactory::fromProto(access_log, *listener_factory_context_);
+    access_logs_.push_back(current_access_log);
+  }
+}
+
+void ListenerImpl::buildListenSocketOptions(Network::Address::SocketType socket_type,
+                                            uint32_t concurrency) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, transparent, false)) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpTransparentOptions());
   }
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, freebind, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, freebind, false)) {
     addListenSocketOptions(Network::SocketOptionFactory::buildIpFreebindOptions());
   }
-  if (config.reuse_port()) {
+  if (config_.reuse_port_steering() != envoy::config::listener::v3::Listener::KERNEL_DEFAULT &&
+      socket_type != Network::Address::SocketType::Stream) {
+    throw EnvoyException(
+        fmt::format("error adding listener '{}': reuse_port_steering is only supported for TCP "
+                    "listeners",
+                    address_->asString()));
+  }
+  if (config_.reuse_port_steering() != envoy::config::listener::v3::Listener::KERNEL_DEFAULT &&
+      !config_.reuse_port()) {
+    throw EnvoyException(
+        fmt::format("error adding listener '{}': reuse_port_steering requires reuse_port",
+                    address_->asString()));
+  }
+  if (config_.reuse_port()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildReusePortOptions());
+    // With a single worker there is nothing to steer between.
+    if (config_.reuse_port_steering() != envoy::config::listener::v3::Listener::KERNEL_DEFAULT &&
+        concurrency > 1) {
+      addListenSocketOptions(Network::SocketOptionFactory::buildReusePortSteeringOptions(
+          config_.reuse_port_steering(), concurrency));
+    }
   } else if (socket_type == Network::Address::SocketType::Datagram && concurrency > 1) {
     ENVOY_LOG(warn, "Listening on UDP without SO_REUSEPORT socket option may result to unstable "
                     "packet proxying. Consider configuring the reuse_port listener option.");
   }
-  if (!config.socket_options().empty()) {
+  if (!config_.socket_options().empty()) {
     addListenSocketOptions(
-        Network::SocketOptionFactory::buildLiteralOptions(config.socket_options()));
+        Network::SocketOptionFactory::buildLiteralOptions(config_.socket_options()));
   }
   if (socket_type == Network::Address::SocketType::Datagram) {
     // Needed for recvmsg to return destination address in IP header.
     addListenSocketOptions(Network::SocketOptionFactory::buildIpPacketInfoOptions());
     // Needed to return receive buffer overflown indicator.
     addListenSocketOptions(Network::SocketOptionFactory::buildRxQueueOverFlowOptions());
-    auto udp_config = config.udp_listener_config();
+  }
+}
+
+void ListenerImpl::buildUdpListenerFactory(Network::Address::SocketType socket_type,
+                                           uint32_t concurrency) {
+  if (socket_type == Network::Address::SocketType::Datagram) {
+    auto udp_config = config_.udp_listener_config();
     if (udp_config.udp_listener_name().empty()) {
       udp_config.set_udp_listener_name(UdpListenerNames::get().RawUdp);
     }
@@ -266,43 +382,41 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
         Config::Utility::translateToFactoryConfig(udp_config, validation_visitor_, config_factory);
     udp_listener_factory_ = config_factory.createActiveUdpListenerFactory(*message, concurrency);
   }
+}
 
-  if (!config.listener_filters().empty()) {
+void ListenerImpl::createListenerFilterFactories(Network::Address::SocketType socket_type) {
+  if (!config_.listener_filters().empty()) {
     switch (socket_type) {
     case Network::Address::SocketType::Datagram:
-      if (config.listener_filters().size() > 1) {
+      if (config_.listener_filters().size() > 1) {
         // Currently supports only 1 UDP listener
         throw EnvoyException(
             fmt::format("error adding listener '{}': Only 1 UDP filter per listener supported",
                         address_->asString()));
       }
       udp_listener_filter_factories_ = parent_.factory_.createUdpListenerFilterFactoryList(
-          config.listener_filters(), *listener_factory_context_);
+          config_.listener_filters(), *listener_factory_context_);
       break;
     case Network::Address::SocketType::Stream:
       listener_filter_factories_ = parent_.factory_.createListenerFilterFactoryList(
-          config.listener_filters(), *listener_factory_context_);
+          config_.listener_filters(), *listener_factory_context_);
       break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
   }
+}
 
-  for (const auto& access_log : config.access_log()) {
-    AccessLog::InstanceSharedPtr current_access_log =
-        AccessLog::AccessLogFactory::fromProto(access_log, *listener_factory_context_);
-    access_logs_.push_back(current_access_log);
-  }
-
-  if (config.filter_chains().empty() && (socket_type == Network::Address::SocketType::Stream ||
-                                         !udp_listener_factory_->isTransportConnectionless())) {
+void ListenerImpl::validateFilterChains(Network::Address::SocketType socket_type) {
+  if (config_.filter_chains().empty() && (socket_type == Network::Address::SocketType::Stream ||
+                                          !udp_listener_factory_->isTransportConnectionless())) {
     // If we got here, this is a tcp listener or connection-oriented udp listener, so ensure there
     // is a filter chain specified
     throw EnvoyException(fmt::format("error adding listener '{}': no filter chains specified",
                                      address_->asString()));
   } else if (udp_listener_factory_ != nullptr &&
              !udp_listener_factory_->isTransportConnectionless()) {
-    for (auto& filter_chain : config.filter_chains()) {
+    for (auto& filter_chain : config_.filter_chains()) {
       // Early fail if any filter chain doesn't have transport socket configured.
       if (!filter_chain.has_transport_socket()) {
         throw EnvoyException(fmt::format("error adding listener '{}': no transport socket "
@@ -311,7 +425,9 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
       }
     }
   }
+}
 
+void ListenerImpl::buildFilterChains() {
   Server::Configuration::TransportSocketFactoryContextImpl transport_factory_context(
       parent_.server_.admin(), parent_.server_.sslContextManager(), listenerScope(),
       parent_.server_.clusterManager(), parent_.server_.localInfo(), parent_.server_.dispatcher(),
@@ -322,28 +438,38 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
   // network filter chain update.
   // TODO(lambdai): create builder from filter_chain_manager to obtain the init manager
   ListenerFilterChainFactoryBuilder builder(*this, transport_factory_context);
-  filter_chain_manager_.addFilterChain(config.filter_chains(), builder, filter_chain_manager_);
-
-  if (socket_type == Network::Address::SocketType::Datagram) {
-    return;
-  }
+  filter_chain_manager_.addFilterChain(config_.filter_chains(), builder, filter_chain_manager_);
+}
 
-  // TCP specific setup.
-  if (config.has_connection_balance_config()) {
-    // Currently exact balance is the only supported type and there are no options.
-    ASSERT(config.connection_balance_config().has_exact_balance());
-    connection_balancer_ = std::make_unique<Network::ExactConnectionBalancerImpl>();
+void ListenerImpl::buildConnectionBalancer() {
+  if (config_.has_connection_balance_config()) {
+    // Neither of the balancer types has options.
+    switch (config_.connection_balance_config().balance_type_case()) {
+    case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kExactBalance:
+      connection_balancer_ = std::make_shared<Network::ExactConnectionBalancerImpl>();
+      break;
+    case envoy::config::listener::v3::Listener::ConnectionBalanceConfig::kTwoChoiceBalance:
+      connection_balancer_ =
+          std::make_shared<Network::TwoChoiceConnectionBalancerImpl>(parent_.server_.random());
+      break;
+    default:
+      NOT_REACHED_GCOVR_EXCL_LINE;
+    }
   } else {
-    connection_balancer_ = std::make_unique<Network::NopConnectionBalancerImpl>();
+    connection_balancer_ = std::make_shared<Network::NopConnectionBalancerImpl>();
   }
+}
 
-  if (config.has_tcp_fast_open_queue_length()) {
+void ListenerImpl::buildSocketOptions() {
+  if (config_.has_tcp_fast_open_queue_length()) {
     addListenSocketOptions(Network::SocketOptionFactory::buildTcpFastOpenOptions(
-        config.tcp_fast_open_queue_length().value()));
+        config_.tcp_fast_open_queue_length().value()));
   }
+}
 
+void ListenerImpl::buildOriginalDstListenerFilter() {
   // Add original dst listener filter if 'use_original_dst' flag is set.
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, hidden_envoy_deprecated_use_original_dst, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_, hidden_envoy_deprecated_use_original_dst, false)) {
     auto& factory =
         Config::Utility::getAndCheckFactoryByName<Configuration::NamedListenerFilterConfigFactory>(
             Extensions::ListenerFilters::ListenerFilterNames::get().OriginalDst);
@@ -352,11 +478,14 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
         Envoy::ProtobufWkt::Empty(),
         /*listener_filter_matcher=*/nullptr, *listener_factory_context_));
   }
+}
+
+void ListenerImpl::buildProxyProtocolListenerFilter() {
   // Add proxy protocol listener filter if 'use_proxy_proto' flag is set.
   // TODO(jrajahalme): This is the last listener filter on purpose. When filter chain matching
   //                   is implemented, this needs to be run after the filter chain has been
   //                   selected.
-  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.filter_chains()[0], use_proxy_proto, false)) {
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.filter_chains()[0], use_proxy_proto, false)) {
     auto& factory =
         Config::Utility::getAndCheckFactoryByName<Configuration::NamedListenerFilterConfigFactory>(
             Extensions::ListenerFilters::ListenerFilterNames::get().ProxyProtocol);
@@ -364,11 +493,13 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
         Envoy::ProtobufWkt::Empty(),
         /*listener_filter_matcher=*/nullptr, *listener_factory_context_));
   }
+}
 
+void ListenerImpl::buildTlsInspectorListenerFilter() {
   // TODO(zuercher) remove the deprecated TLS inspector name when the deprecated names are removed.
   const bool need_tls_inspector =
       std::any_of(
-          config.filter_chains().begin(), config.filter_chains().end(),
+          config_.filter_chains().begin(), config_.filter_chains().end(),
           [](const auto& filter_chain) {
             const auto& matcher = filter_chain.filter_chain_match();
             return matcher.transport_protocol() == "tls" ||
@@ -376,7 +507,7 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
                     (!matcher.server_names().empty() || !matcher.application_protocols().empty()));
           }) &&
       !std::any_of(
-          config.listener_filters().begin(), config.listener_filters().end(),
+          config_.listener_filters().begin(), config_.listener_filters().end(),
           [](const auto& filter) {
             return filter.name() ==
                        Extensions::ListenerFilters::ListenerFilterNames::get().TlsInspector ||
@@ -398,14 +529,6 @@ ListenerImpl::ListenerImpl(const envoy::config::listener::v3::Listener& config,
         Envoy::ProtobufWkt::Empty(),
         /*listener_filter_matcher=*/nullptr, *listener_factory_context_));
   }
-
-  if (!workers_started_) {
-    // Initialize dynamic_init_manager_ from Server's init manager if it's not initialized.
-    // NOTE: listener_init_target_ should be added to parent's initManager at the end of the
-    // listener constructor so that this listener's children entities could register their targets
-    // with their parent's initManager.
-    parent_.server_.initManager().add(listener_init_target_);
-  }
 }
 
 AccessLog::AccessLogManager& PerListenerFactoryContextImpl::accessLogManager() {
@@ -531,6 +654,70 @@ ListenerImpl::~ListenerImpl() {
 
 Init::Manager& ListenerImpl::initManager() { return *dynamic_init_manager_; }
 
+bool ListenerImpl::supportUpdateFilterChain(const envoy::config::listener::v3::Listener& config,
+                                            bool worker_started) {
+  if (!Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.listener_in_place_filterchain_update")) {
+    return false;
+  }
+
+  // The in place filter chain update depends on the active listener at worker.
+  if (!worker_started) {
+    return false;
+  }
+
+  // Currently we only support TCP filter chain update.
+  if (Network::Utility::protobufAddressSocketType(config_.address()) !=
+          Network::Address::SocketType::Stream ||
+      Network::Utility::protobufAddressSocketType(config.address()) !=
+          Network::Address::SocketType::Stream) {
+    return false;
+  }
+
+  // Full listener update currently rejects tcp listener having 0 filter chain. Keep the same
+  // behavior for the in place update. This also guards the below filter chain access.
+  if (config_.filter_chains().empty() || config.filter_chains().empty()) {
+    return false;
+  }
+
+  // The proxy protocol listener filter is injected according to the first filter chain, see
+  // buildProxyProtocolListenerFilter(). Fall back to a full update if that changes.
+  if (PROTOBUF_GET_WRAPPED_OR_DEFAULT(config_.filter_chains()[0], use_proxy_proto, false) !=
+      PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.filter_chains()[0], use_proxy_proto, false)) {
+    return false;
+  }
+
+  // Everything but the filter chains must be unchanged.
+  Protobuf::util::MessageDifferencer differencer;
+  differencer.set_message_field_comparison(Protobuf::util::MessageDifferencer::EQUIVALENT);
+  differencer.set_repeated_field_comparison(Protobuf::util::MessageDifferencer::AS_SET);
+  differencer.IgnoreField(
+      envoy::config::listener::v3::Listener::GetDescriptor()->FindFieldByName("filter_chains"));
+  return differencer.Compare(config_, config);
+}
+
+ListenerImplPtr
+ListenerImpl::newListenerWithFilterChain(const envoy::config::listener::v3::Listener& config,
+                                         const std::string& version_info, bool workers_started,
+                                         uint64_t hash) {
+  // Use WrapUnique since the constructor is private.
+  return absl::WrapUnique(new ListenerImpl(*this, config, version_info, parent_, name_,
+                                           added_via_api_, workers_started, hash,
+                                           parent_.server_.options().concurrency()));
+}
+
+void ListenerImpl::diffFilterChain(const ListenerImpl& another_listener,
+                                   std::function<void(Network::DrainableFilterChain&)> callback) {
+  for (const auto& message_and_filter_chain : filter_chain_manager_.filterChainsByMessage()) {
+    if (another_listener.filter_chain_manager_.filterChainsByMessage().find(
+            message_and_filter_chain.first) ==
+        another_listener.filter_chain_manager_.filterChainsByMessage().end()) {
+      // The filter chain exists in the current listener but not in the new listener.
+      callback(*message_and_filter_chain.second);
+    }
+  }
+}
+
 void ListenerImpl::setSocketFactory(const Network::ListenSocketFactorySharedPtr& socket_factory) {
   ASSERT(!socket_factory_);
   socket_factory_ = socket_factory;
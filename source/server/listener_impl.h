@@ -218,6 +218,29 @@ public:
                bool workers_started, uint64_t hash, uint32_t concurrency);
   ~ListenerImpl() override;
 
+  /**
+   * Execute in place filter chain update. The filter chain update is less expensive than full
+   * listener update because connections may not need to be drained. The update creates a new
+   * ListenerImpl with the listener tag of this one, so that the workers keep their listeners and
+   * only the connections of the filter chains that were removed or changed are drained.
+   */
+  std::unique_ptr<ListenerImpl>
+  newListenerWithFilterChain(const envoy::config::listener::v3::Listener& config,
+                             const std::string& version_info, bool workers_started,
+                             uint64_t hash);
+  /**
+   * Determine if in place filter chain update could be executed at this moment.
+   */
+  bool supportUpdateFilterChain(const envoy::config::listener::v3::Listener& config,
+                                bool worker_started);
+
+  /**
+   * Run the callback on each filter chain that exists in this listener but not in the passed
+   * listener config.
+   */
+  void diffFilterChain(const ListenerImpl& another_listener,
+                       std::function<void(Network::DrainableFilterChain&)> callback);
+
   /**
    * Helper functions to determine whether a listener is blocked for update or remove.
    */
@@ -296,6 +319,27 @@ public:
   SystemTime last_updated_;
 
 private:
+  /**
+   * Create a new listener from an existing listener and the new config message if the in place
+   * filter chain update is decided. Should be called only by newListenerWithFilterChain().
+   */
+  ListenerImpl(ListenerImpl& origin, const envoy::config::listener::v3::Listener& config,
+               const std::string& version_info, ListenerManagerImpl& parent,
+               const std::string& name, bool added_via_api, bool workers_started, uint64_t hash,
+               uint32_t concurrency);
+  // Helpers for constructor.
+  void buildAccessLog();
+  void buildListenSocketOptions(Network::Address::SocketType socket_type, uint32_t concurrency);
+  void buildUdpListenerFactory(Network::Address::SocketType socket_type, uint32_t concurrency);
+  void createListenerFilterFactories(Network::Address::SocketType socket_type);
+  void validateFilterChains(Network::Address::SocketType socket_type);
+  void buildFilterChains();
+  void buildConnectionBalancer();
+  void buildSocketOptions();
+  void buildOriginalDstListenerFilter();
+  void buildProxyProtocolListenerFilter();
+  void buildTlsInspectorListenerFilter();
+
   void addListenSocketOption(const Network::Socket::OptionConstSharedPtr& option) {
     ensureSocketOptions();
     listen_socket_options_->emplace_back(std::move(option));
@@ -336,12 +380,13 @@ private:
   const std::chrono::milliseconds listener_filters_timeout_;
   const bool continue_on_listener_filters_timeout_;
   Network::ActiveUdpListenerFactoryPtr udp_listener_factory_;
-  Network::ConnectionBalancerPtr connection_balancer_;
+  Network::ConnectionBalancerSharedPtr connection_balancer_;
   std::shared_ptr<PerListenerFactoryContextImpl> listener_factory_context_;
   FilterChainManagerImpl filter_chain_manager_;
 
   // This init watcher, if workers_started_ is false, notifies the "parent" listener manager when
-  // listener initialization is complete.
+  // listener initialization is complete. A listener created by newListenerWithFilterChain()
+  // asks the parent to execute the in place filter chain update instead.
   // Important: local_init_watcher_ must be the last field in the class to avoid unexpected watcher
   // callback during the destroy of ListenerImpl.
   Init::WatcherImpl local_init_watcher_;
@@ -398,9 +398,22 @@ bool ListenerManagerImpl::addOrUpdateListenerInternal(
     return false;
   }
 
-  ListenerImplPtr new_listener(new ListenerImpl(config, version_info, *this, name, added_via_api,
-                                                workers_started_, hash,
-                                                server_.options().concurrency()));
+  ListenerImplPtr new_listener = nullptr;
+  // In place filter chain update depends on the active listener at worker.
+  if (existing_active_listener != active_listeners_.end() &&
+      (*existing_active_listener)->supportUpdateFilterChain(config, workers_started_)) {
+    ListenerImpl& listener = *(*existing_active_listener);
+    ENVOY_LOG(debug, "use in place filter chain update path for listener name={} hash={}",
+              name, hash);
+    new_listener = listener.newListenerWithFilterChain(config, version_info, workers_started_,
+                                                       hash);
+    stats_.listener_in_place_updated_.inc();
+  } else {
+    ENVOY_LOG(debug, "use full listener update path for listener name={} hash={}", name, hash);
+    new_listener = std::make_unique<ListenerImpl>(config, version_info, *this, name, added_via_api,
+                                                  workers_started_, hash,
+                                                  server_.options().concurrency());
+  }
   ListenerImpl& new_listener_ref = *new_listener;
 
   // We mandate that a listener with the same name must have the same configured address. This
@@ -674,6 +687,73 @@ void ListenerManagerImpl::onListenerWarmed(ListenerImpl& listener) {
   updateWarmingActiveGauges();
 }
 
+void ListenerManagerImpl::inPlaceFilterChainUpdate(ListenerImpl& listener) {
+  auto existing_active_listener = getListenerByName(active_listeners_, listener.name());
+  auto existing_warming_listener = getListenerByName(warming_listeners_, listener.name());
+  ASSERT(existing_warming_listener != warming_listeners_.end());
+  ASSERT(existing_warming_listener->get() == &listener);
+
+  (*existing_warming_listener)->debugLog("execute in place filter chain update");
+
+  // An in place updated listener is only warmed while the listener it was created from is active.
+  // Removing that listener also removes the warming one, see removeListener().
+  ASSERT(existing_active_listener != active_listeners_.end());
+
+  // The workers keep accepting on the same socket. Only the listener config is swapped, so the
+  // connections of the filter chains that both generations share are left untouched.
+  for (const auto& worker : workers_) {
+    worker->updateListener(listener, nullptr);
+  }
+
+  // Finish active_listeners_ transformation before calling `drainFilterChains` as it depends on
+  // their state.
+  auto previous_listener = std::move(*existing_active_listener);
+  *existing_active_listener = std::move(*existing_warming_listener);
+  drainFilterChains(std::move(previous_listener), **existing_active_listener);
+
+  warming_listeners_.erase(existing_warming_listener);
+  updateWarmingActiveGauges();
+}
+
+void ListenerManagerImpl::drainFilterChains(ListenerImplPtr&& draining_listener,
+                                            ListenerImpl& new_listener) {
+  // The previous listener is kept until the workers are done with it, since the draining
+  // connections and the workers' pending config swap still reference it.
+  std::list<DrainingFilterChains>::iterator draining_it = draining_filter_chains_.emplace(
+      draining_filter_chains_.begin(), std::move(draining_listener), workers_.size());
+  draining_it->listener_->diffFilterChain(
+      new_listener, [&draining_it](Network::DrainableFilterChain& filter_chain) {
+        filter_chain.startDraining();
+        draining_it->filter_chains_.push_back(&filter_chain);
+      });
+  updateDrainingFilterChainsGauge();
+
+  draining_it->listener_->debugLog(
+      fmt::format("draining {} filter chains", draining_it->filter_chains_.size()));
+  draining_it->drain_timer_ = server_.dispatcher().createTimer([this, draining_it]() -> void {
+    draining_it->listener_->debugLog("removing draining filter chains");
+    for (const auto& worker : workers_) {
+      // Once the drain time has completed, we tell the workers to close the remaining connections
+      // of the removed filter chains.
+      worker->removeFilterChains(
+          draining_it->listener_->listenerTag(), draining_it->filter_chains_,
+          [this, draining_it]() -> void {
+            // The completion is called on the worker thread. We post back to the main thread to
+            // avoid locking. The worker runs it only after the closed connections have been
+            // destroyed, so the filter chains can go away with the listener.
+            server_.dispatcher().post([this, draining_it]() -> void {
+              if (--draining_it->workers_pending_removal_ == 0) {
+                draining_it->listener_->debugLog("draining filter chains removal complete");
+                draining_filter_chains_.erase(draining_it);
+                updateDrainingFilterChainsGauge();
+              }
+            });
+          });
+    }
+  });
+  draining_it->drain_timer_->enableTimer(server_.options().drainTime());
+}
+
 uint64_t ListenerManagerImpl::numConnections() const {
   uint64_t num_connections = 0;
   for (const auto& worker : workers_) {
@@ -8,6 +8,7 @@
 #include "envoy/config/core/v3/config_source.pb.h"
 #include "envoy/config/listener/v3/listener.pb.h"
 #include "envoy/config/listener/v3/listener_components.pb.h"
+#include "envoy/event/timer.h"
 #include "envoy/network/filter.h"
 #include "envoy/network/listen_socket.h"
 #include "envoy/server/api_listener.h"
@@ -112,9 +113,11 @@ using ListenerImplPtr = std::unique_ptr<ListenerImpl>;
   COUNTER(listener_added)                                                                          \
   COUNTER(listener_create_failure)                                                                 \
   COUNTER(listener_create_success)                                                                 \
+  COUNTER(listener_in_place_updated)                                                               \
   COUNTER(listener_modified)                                                                       \
   COUNTER(listener_removed)                                                                        \
   COUNTER(listener_stopped)                                                                        \
+  GAUGE(total_filter_chains_draining, NeverImport)                                                 \
   GAUGE(total_listeners_active, NeverImport)                                                       \
   GAUGE(total_listeners_draining, NeverImport)                                                     \
   GAUGE(total_listeners_warming, NeverImport)                                                      \
@@ -136,6 +139,7 @@ public:
                       WorkerFactory& worker_factory, bool enable_dispatcher_stats);
 
   void onListenerWarmed(ListenerImpl& listener);
+  void inPlaceFilterChainUpdate(ListenerImpl& listener);
 
   // Server::ListenerManager
   bool addOrUpdateListener(const envoy::config::listener::v3::Listener& config,
@@ -176,6 +180,20 @@ private:
     uint64_t workers_pending_removal_;
   };
 
+  /**
+   * The previous generation of a listener that was updated in place, kept alive until the workers
+   * have closed the connections of the filter chains that the update removed.
+   */
+  struct DrainingFilterChains {
+    DrainingFilterChains(ListenerImplPtr&& listener, uint64_t workers_pending_removal)
+        : listener_(std::move(listener)), workers_pending_removal_(workers_pending_removal) {}
+
+    ListenerImplPtr listener_;
+    std::list<const Network::FilterChain*> filter_chains_;
+    uint64_t workers_pending_removal_;
+    Event::TimerPtr drain_timer_;
+  };
+
   void addListenerToWorker(Worker& worker, ListenerImpl& listener,
                            ListenerCompletionCallback completion_callback);
   ProtobufTypes::MessagePtr dumpListenerConfigs();
@@ -191,6 +209,13 @@ private:
     stats_.total_listeners_warming_.set(warming_listeners_.size());
     stats_.total_listeners_active_.set(active_listeners_.size());
   }
+  void updateDrainingFilterChainsGauge() {
+    uint64_t total = 0;
+    for (const auto& draining : draining_filter_chains_) {
+      total += draining.filter_chains_.size();
+    }
+    stats_.total_filter_chains_draining_.set(total);
+  }
   bool listenersStopped(const envoy::config::listener::v3::Listener& config) {
     // Currently all listeners in a given direction are stopped because of the way admin
     // drain_listener functionality is implemented. This needs to be revisited, if that changes - if
@@ -207,6 +232,14 @@ private:
    */
   void drainListener(ListenerImplPtr&& listener);
 
+  /**
+   * Drain the filter chains of a listener that are not part of the listener that replaced it in
+   * place. Connections of the other filter chains are not affected.
+   * @param draining_listener supplies the replaced listener.
+   * @param new_listener supplies the listener that replaced it.
+   */
+  void drainFilterChains(ListenerImplPtr&& draining_listener, ListenerImpl& new_listener);
+
   /**
    * Stop a listener. The listener will stop accepting new connections and its socket will be
    * closed.
@@ -240,6 +273,9 @@ private:
   // connections are drained. Then after that time period the listener is removed from all workers
   // and any remaining connections are closed.
   std::list<DrainingListener> draining_listeners_;
+  // Listeners replaced by an in place filter chain update, along with the filter chains that are
+  // draining.
+  std::list<DrainingFilterChains> draining_filter_chains_;
   std::list<WorkerPtr> workers_;
   bool workers_started_{};
   absl::optional<StopListenersType> stop_listeners_type_;
@@ -28,13 +28,47 @@ public:
     return fired != isFired();
   }
 
-  bool isFired() const override { return value_.has_value() && value_ >= threshold_; }
+  double actionValue() const override { return isFired() ? 1 : 0; }
 
 private:
+  bool isFired() const { return value_.has_value() && value_ >= threshold_; }
+
   const double threshold_;
   absl::optional<double> value_;
 };
 
+class ScaledTriggerImpl : public OverloadAction::Trigger {
+public:
+  ScaledTriggerImpl(const envoy::config::overload::v3::ScaledTrigger& config)
+      : scaling_threshold_(config.scaling_threshold()),
+        saturation_threshold_(config.saturation_threshold()) {
+    if (scaling_threshold_ >= saturation_threshold_) {
+      throw EnvoyException("scaling_threshold must be less than saturation_threshold");
+    }
+  }
+
+  bool updateValue(double value) override {
+    const double action_value = actionValue();
+    value_ = value;
+    return action_value != actionValue();
+  }
+
+  double actionValue() const override {
+    if (!value_.has_value() || value_ < scaling_threshold_) {
+      return 0;
+    }
+    if (value_ >= saturation_threshold_) {
+      return 1;
+    }
+    return (value_.value() - scaling_threshold_) / (saturation_threshold_ - scaling_threshold_);
+  }
+
+private:
+  const double scaling_threshold_;
+  const double saturation_threshold_;
+  absl::optional<double> value_;
+};
+
 Stats::Counter& makeCounter(Stats::Scope& scope, absl::string_view a, absl::string_view b) {
   Stats::StatNameManagedStorage stat_name(absl::StrCat("overload.", a, ".", b),
                                           scope.symbolTable());
@@ -52,8 +86,11 @@ Stats::Gauge& makeGauge(Stats::Scope& scope, absl::string_view a, absl::string_v
 
 OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction& config,
                                Stats::Scope& stats_scope)
-    : active_gauge_(
-          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)) {
+    : state_(OverloadActionState::inactive()),
+      active_gauge_(
+          makeGauge(stats_scope, config.name(), "active", Stats::Gauge::ImportMode::Accumulate)),
+      scale_percent_gauge_(makeGauge(stats_scope, config.name(), "scale_percent",
+                                     Stats::Gauge::ImportMode::Accumulate)) {
   for (const auto& trigger_config : config.triggers()) {
     TriggerPtr trigger;
 
@@ -61,6 +98,9 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
     case envoy::config::overload::v3::Trigger::TriggerOneofCase::kThreshold:
       trigger = std::make_unique<ThresholdTriggerImpl>(trigger_config.threshold());
       break;
+    case envoy::config::overload::v3::Trigger::TriggerOneofCase::kScaled:
+      trigger = std::make_unique<ScaledTriggerImpl>(trigger_config.scaled());
+      break;
     default:
       NOT_REACHED_GCOVR_EXCL_LINE;
     }
@@ -72,29 +112,28 @@ OverloadAction::OverloadAction(const envoy::config::overload::v3::OverloadAction
   }
 
   active_gauge_.set(0);
+  scale_percent_gauge_.set(0);
 }
 
 bool OverloadAction::updateResourcePressure(const std::string& name, double pressure) {
-  const bool active = isActive();
+  const OverloadActionState old_state = getState();
 
   auto it = triggers_.find(name);
   ASSERT(it != triggers_.end());
-  if (it->second->updateValue(pressure)) {
-    if (it->second->isFired()) {
-      active_gauge_.set(1);
-      const auto result = fired_triggers_.insert(name);
-      ASSERT(result.second);
-    } else {
-      active_gauge_.set(0);
-      const auto result = fired_triggers_.erase(name);
-      ASSERT(result == 1);
-    }
+  if (!it->second->updateValue(pressure)) {
+    return false;
   }
 
-  return active != isActive();
-}
+  double action_value = 0;
+  for (const auto& trigger : triggers_) {
+    action_value = std::max(action_value, trigger.second->actionValue());
+  }
+  state_ = OverloadActionState(action_value);
+  active_gauge_.set(state_.isSaturated() ? 1 : 0);
+  scale_percent_gauge_.set(state_.value() * 100); // convert to percent
 
-bool OverloadAction::isActive() const { return !fired_triggers_.empty(); }
+  return state_ != old_state;
+}
 
 OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::Scope& stats_scope,
                                          ThreadLocal::SlotAllocator& slot_allocator,
@@ -104,7 +143,8 @@ OverloadManagerImpl::OverloadManagerImpl(Event::Dispatcher& dispatcher, Stats::S
     : started_(false), dispatcher_(dispatcher), tls_(slot_allocator.allocateSlot()),
       refresh_interval_(
           std::chrono::milliseconds(PROTOBUF_GET_MS_OR_DEFAULT(config, refresh_interval, 1000))) {
-  Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, api, validation_visitor);
+  Configuration::ResourceMonitorFactoryContextImpl context(dispatcher, api, validation_visitor,
+                                                           slot_allocator);
   for (const auto& resource : config.resource_monitors()) {
     const auto& name = resource.name();
     ENVOY_LOG(debug, "Adding resource monitor for {}", name);
@@ -202,11 +242,13 @@ void OverloadManagerImpl::updateResourcePressure(const std::string& resource, do
                   auto action_it = actions_.find(action);
                   ASSERT(action_it != actions_.end());
                   if (action_it->second.updateResourcePressure(resource, pressure)) {
-                    const bool is_active = action_it->second.isActive();
-                    const auto state =
-                        is_active ? OverloadActionState::Active : OverloadActionState::Inactive;
-                    ENVOY_LOG(info, "Overload action {} became {}", action,
-                              is_active ? "active" : "inactive");
+                    const auto state = action_it->second.getState();
+                    if (state.isSaturated() || state.isInactive()) {
+                      ENVOY_LOG(info, "Overload action {} became {}", action,
+                                state.isSaturated() ? "active" : "inactive");
+                    } else {
+                      ENVOY_LOG(debug, "Overload action {} scaled to {}", action, state.value());
+                    }
                     tls_->runOnAllThreads([this, action, state] {
                       tls_->getTyped<ThreadLocalOverloadState>().setState(action, state);
                     });
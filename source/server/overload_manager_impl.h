@@ -2,7 +2,6 @@
 
 #include <chrono>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 #include "envoy/api/api.h"
@@ -29,25 +28,28 @@ public:
   // has changed state.
   bool updateResourcePressure(const std::string& name, double pressure);
 
-  // Returns whether the action is currently active or not.
-  bool isActive() const;
+  // Returns the current state of the action, which is the highest state of its triggers.
+  OverloadActionState getState() const { return state_; }
 
   class Trigger {
   public:
     virtual ~Trigger() = default;
 
-    // Updates the current value of the metric and returns whether the trigger has changed state.
+    // Updates the current value of the metric and returns whether the trigger has changed its
+    // action value.
     virtual bool updateValue(double value) PURE;
 
-    // Returns whether the trigger is currently fired or not.
-    virtual bool isFired() const PURE;
+    // Returns the value in [0, 1] to which the trigger currently takes its action, where 0 means
+    // that it is not fired at all and 1 means that it is entirely fired.
+    virtual double actionValue() const PURE;
   };
   using TriggerPtr = std::unique_ptr<Trigger>;
 
 private:
   std::unordered_map<std::string, TriggerPtr> triggers_;
-  std::unordered_set<std::string> fired_triggers_;
+  OverloadActionState state_;
   Stats::Gauge& active_gauge_;
+  Stats::Gauge& scale_percent_gauge_;
 };
 
 class OverloadManagerImpl : Logger::Loggable<Logger::Id::main>, public OverloadManager {
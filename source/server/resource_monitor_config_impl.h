@@ -9,8 +9,10 @@ namespace Configuration {
 class ResourceMonitorFactoryContextImpl : public ResourceMonitorFactoryContext {
 public:
   ResourceMonitorFactoryContextImpl(Event::Dispatcher& dispatcher, Api::Api& api,
-                                    ProtobufMessage::ValidationVisitor& validation_visitor)
-      : dispatcher_(dispatcher), api_(api), validation_visitor_(validation_visitor) {}
+                                    ProtobufMessage::ValidationVisitor& validation_visitor,
+                                    ThreadLocal::SlotAllocator& thread_local)
+      : dispatcher_(dispatcher), api_(api), validation_visitor_(validation_visitor),
+        thread_local_(thread_local) {}
 
   Event::Dispatcher& dispatcher() override { return dispatcher_; }
 
@@ -20,10 +22,13 @@ public:
     return validation_visitor_;
   }
 
+  ThreadLocal::SlotAllocator& threadLocal() override { return thread_local_; }
+
 private:
   Event::Dispatcher& dispatcher_;
   Api::Api& api_;
   ProtobufMessage::ValidationVisitor& validation_visitor_;
+  ThreadLocal::SlotAllocator& thread_local_;
 };
 
 } // namespace Configuration
@@ -31,6 +31,7 @@
 #include "common/local_info/local_info_impl.h"
 #include "common/memory/stats.h"
 #include "common/network/address_impl.h"
+#include "common/network/caching_dns_resolver_impl.h"
 #include "common/protobuf/utility.h"
 #include "common/router/rds_impl.h"
 #include "common/runtime/runtime_impl.h"
@@ -392,6 +393,12 @@ void InstanceImpl::initialize(const Options& options,
 
   const bool use_tcp_for_dns_lookups = bootstrap_.use_tcp_for_dns_lookups();
   dns_resolver_ = dispatcher_->createDnsResolver({}, use_tcp_for_dns_lookups);
+  if (bootstrap_.has_dns_cache()) {
+    auto caching_dns_resolver = std::make_shared<Network::CachingDnsResolverImpl>(
+        dns_resolver_, time_source_, stats_store_, bootstrap_.dns_cache());
+    Network::registerSharedCachingDnsResolver(*singleton_manager_, caching_dns_resolver);
+    dns_resolver_ = caching_dns_resolver;
+  }
 
   cluster_manager_factory_ = std::make_unique<Upstream::ProdClusterManagerFactory>(
       *admin_, Runtime::LoaderSingleton::get(), stats_store_, thread_local_, *random_generator_,
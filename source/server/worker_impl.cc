@@ -50,6 +50,16 @@ void WorkerImpl::addListener(Network::ListenerConfig& listener, AddListenerCompl
   });
 }
 
+void WorkerImpl::updateListener(Network::ListenerConfig& listener,
+                                std::function<void()> completion) {
+  dispatcher_->post([this, &listener, completion]() -> void {
+    handler_->updateListener(listener);
+    if (completion) {
+      completion();
+    }
+  });
+}
+
 uint64_t WorkerImpl::numConnections() const {
   uint64_t ret = 0;
   if (handler_) {
@@ -69,6 +79,15 @@ void WorkerImpl::removeListener(Network::ListenerConfig& listener,
   });
 }
 
+void WorkerImpl::removeFilterChains(uint64_t listener_tag,
+                                    const std::list<const Network::FilterChain*>& filter_chains,
+                                    std::function<void()> completion) {
+  ASSERT(thread_);
+  dispatcher_->post([this, listener_tag, filter_chains, completion]() -> void {
+    handler_->removeFilterChains(listener_tag, filter_chains, completion);
+  });
+}
+
 void WorkerImpl::start(GuardDog& guard_dog) {
   ASSERT(!thread_);
   thread_ =
@@ -120,13 +139,12 @@ void WorkerImpl::threadRoutine(GuardDog& guard_dog) {
 }
 
 void WorkerImpl::stopAcceptingConnectionsCb(OverloadActionState state) {
-  switch (state) {
-  case OverloadActionState::Active:
+  // Connections are only rejected once the action is saturated, since listeners are either
+  // accepting connections or not.
+  if (state.isSaturated()) {
     handler_->disableListeners();
-    break;
-  case OverloadActionState::Inactive:
+  } else {
     handler_->enableListeners();
-    break;
   }
 }
 
@@ -1673,6 +1673,64 @@ TEST(AccessLogFormatterTest, JsonFormatterTypedTest) {
   EXPECT_THAT(output.fields().at("filter_state"), ProtoEq(expected));
 }
 
+TEST(AccessLogFormatterTest, JsonFormatterEscapeTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{
+      {"quoted", "say \"hi\"\\"}, {"control", std::string("a\tb\x01c", 6)}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+
+  std::unordered_map<std::string, std::string> key_mapping = {
+      {"quoted", "%REQ(quoted)%"},
+      {"control", "[%REQ(control)%]"},
+      {"key \"with\" quotes", "plain"}};
+
+  for (const bool preserve_types : {false, true}) {
+    JsonFormatterImpl formatter(key_mapping, preserve_types);
+
+    const std::string json =
+        formatter.format(request_header, response_header, response_trailer, stream_info);
+    EXPECT_NE(std::string::npos, json.find("\\u0001"));
+
+    ProtobufWkt::Struct output;
+    MessageUtil::loadFromJson(json, output);
+    const auto& fields = output.fields();
+    EXPECT_EQ("say \"hi\"\\", fields.at("quoted").string_value());
+    EXPECT_EQ(std::string("[a\tb\x01c]", 8), fields.at("control").string_value());
+    EXPECT_EQ("plain", fields.at("key \"with\" quotes").string_value());
+  }
+}
+
+TEST(AccessLogFormatterTest, JsonFormatterEmptyTest) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header;
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+
+  std::unordered_map<std::string, std::string> key_mapping;
+  JsonFormatterImpl formatter(key_mapping, false);
+
+  EXPECT_EQ("{}\n",
+            formatter.format(request_header, response_header, response_trailer, stream_info));
+}
+
+TEST(AccessLogFormatterTest, FormatToAppends) {
+  StreamInfo::MockStreamInfo stream_info;
+  Http::TestRequestHeaderMapImpl request_header{{":method", "GET"}};
+  Http::TestResponseHeaderMapImpl response_header;
+  Http::TestResponseTrailerMapImpl response_trailer;
+
+  FormatterImpl formatter("%REQ(:METHOD)%:%REQ(:METHOD):2%\n");
+  std::unordered_map<std::string, std::string> key_mapping = {{"method", "%REQ(:METHOD)%"}};
+  JsonFormatterImpl json_formatter(key_mapping, true);
+
+  std::string output = "prefix ";
+  formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  json_formatter.formatTo(request_header, response_header, response_trailer, stream_info, output);
+  EXPECT_EQ("prefix GET:GE\nGET:GE\n{\"method\":\"GET\"}\n", output);
+}
+
 TEST(AccessLogFormatterTest, CompositeFormatterSuccess) {
   StreamInfo::MockStreamInfo stream_info;
   Http::TestRequestHeaderMapImpl request_header{{"first", "GET"}, {":path", "/"}};
@@ -0,0 +1,81 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how access log writes scale when many workers log at once. Each benchmark thread acts
+// as a worker writing fixed size lines round robin into a set of access log files which are all
+// drained by the shared flush thread into /dev/null.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/access_log/access_log_manager_impl.h"
+#include "common/common/thread.h"
+#include "common/event/dispatcher_impl.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace {
+
+class AccessLogWriters {
+public:
+  AccessLogWriters(uint32_t num_files)
+      : api_(Api::createApiForTest(store_)), dispatcher_(api_->allocateDispatcher()),
+        access_log_manager_(std::chrono::milliseconds(1000), *api_, *dispatcher_, lock_, store_) {
+    // All files map to /dev/null, so give each a distinct spelling of the path to get a distinct
+    // AccessLogFile per name.
+    std::string path = "/dev/null";
+    for (uint32_t i = 0; i < num_files; ++i) {
+      files_.push_back(access_log_manager_.createAccessLog(path));
+      path = "/" + path;
+    }
+  }
+
+  std::vector<AccessLog::AccessLogFileSharedPtr>& files() { return files_; }
+
+private:
+  Stats::IsolatedStoreImpl store_;
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Thread::MutexBasicLockable lock_;
+  AccessLog::AccessLogManagerImpl access_log_manager_;
+  std::vector<AccessLog::AccessLogFileSharedPtr> files_;
+};
+
+AccessLogWriters* writers;
+
+} // namespace
+
+// Args: number of access log files.
+static void BM_ConcurrentAccessLogWrites(benchmark::State& state) {
+  // Thread 0 sets up before, and tears down after, all threads have run the loop.
+  if (state.thread_index == 0) {
+    writers = new AccessLogWriters(state.range(0));
+  }
+
+  const std::string line(200, 'x');
+  std::vector<AccessLog::AccessLogFileSharedPtr>& files = writers->files();
+  size_t next_file = state.thread_index;
+  for (auto _ : state) {
+    files[next_file++ % files.size()]->write(line);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * line.size());
+
+  if (state.thread_index == 0) {
+    delete writers;
+    writers = nullptr;
+  }
+}
+BENCHMARK(BM_ConcurrentAccessLogWrites)
+    ->Arg(1)
+    ->Arg(16)
+    ->ThreadRange(1, 64)
+    ->UseRealTime()
+    ->Unit(benchmark::kNanosecond);
+
+} // namespace Envoy
@@ -1,4 +1,7 @@
+#include <atomic>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common/access_log/access_log_manager_impl.h"
 #include "common/filesystem/file_shared_impl.h"
@@ -11,6 +14,9 @@
 #include "test/test_common/test_time.h"
 #include "test/test_common/utility.h"
 
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
@@ -158,9 +164,9 @@ TEST_F(AccessLogManagerImplTest, FlushToLogFileOnDemand) {
 
   EXPECT_CALL(*timer, enableTimer(timeout_40ms_, _));
 
-  // The first write to a given file will start the flush thread. Because AccessManagerImpl::write
-  // holds the write_lock_ when the thread is started, the thread will flush on its first loop, once
-  // it obtains the write_lock_. Perform a write to get all that out of the way.
+  // The first write to any file will start the flush thread. The thread drains all files on its
+  // first loop, so the data of that write gets flushed without a timer. Perform a write to get all
+  // that out of the way.
   EXPECT_CALL(*file_, write_(_))
       .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
         return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
@@ -518,6 +524,108 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+// Thread factory which counts the threads it creates.
+class CountingThreadFactory : public Thread::ThreadFactory {
+public:
+  CountingThreadFactory(Thread::ThreadFactory& parent) : parent_(parent) {}
+
+  Thread::ThreadPtr createThread(std::function<void()> thread_routine) override {
+    ++threads_created_;
+    return parent_.createThread(thread_routine);
+  }
+  Thread::ThreadId currentThreadId() override { return parent_.currentThreadId(); }
+
+  Thread::ThreadFactory& parent_;
+  std::atomic<uint32_t> threads_created_{};
+};
+
+TEST_F(AccessLogManagerImplTest, SingleFlushThreadForAllFiles) {
+  CountingThreadFactory thread_factory(thread_factory_);
+  EXPECT_CALL(api_, threadFactory()).WillRepeatedly(ReturnRef(thread_factory));
+  EXPECT_CALL(dispatcher_, createTimer_(_)).WillOnce(ReturnNew<NiceMock<Event::MockTimer>>());
+
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log = access_log_manager_.createAccessLog("foo");
+
+  NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+  EXPECT_CALL(file_system_, createFile("bar"))
+      .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+  EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log2 = access_log_manager_.createAccessLog("bar");
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  EXPECT_CALL(*file2, write_(_))
+      .WillRepeatedly(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  log->write("foo");
+  log2->write("bar");
+  log->flush();
+  log2->flush();
+  waitForCounterEq("filesystem.write_completed", 2);
+  EXPECT_EQ(1U, thread_factory.threads_created_.load());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+// Lines written concurrently from many threads all make it to the file, and lines from the same
+// thread stay in order.
+TEST_F(AccessLogManagerImplTest, ConcurrentWriters) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).WillOnce(ReturnNew<NiceMock<Event::MockTimer>>());
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog("foo");
+
+  Thread::MutexBasicLockable output_lock;
+  std::string output;
+  EXPECT_CALL(*file_, write_(_))
+      .WillRepeatedly(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+        Thread::LockGuard lock(output_lock);
+        output.append(data.data(), data.size());
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+
+  const uint32_t num_threads = AccessLogFileImpl::WRITE_SHARDS + 4;
+  const uint32_t lines_per_thread = 1000;
+  std::vector<Thread::ThreadPtr> threads;
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads.push_back(thread_factory_.createThread([&log_file, i]() {
+      for (uint32_t j = 0; j < lines_per_thread; ++j) {
+        log_file->write(absl::StrCat(i, ":", j, "\n"));
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+  log_file->flush();
+
+  std::vector<uint32_t> next_line(num_threads, 0);
+  {
+    Thread::LockGuard lock(output_lock);
+    for (absl::string_view line : absl::StrSplit(output, '\n', absl::SkipEmpty())) {
+      const std::vector<absl::string_view> parts = absl::StrSplit(line, ':');
+      ASSERT_EQ(2U, parts.size());
+      uint32_t thread_index;
+      uint32_t line_index;
+      ASSERT_TRUE(absl::SimpleAtoi(parts[0], &thread_index));
+      ASSERT_TRUE(absl::SimpleAtoi(parts[1], &line_index));
+      ASSERT_LT(thread_index, num_threads);
+      EXPECT_EQ(next_line[thread_index]++, line_index);
+    }
+  }
+  for (uint32_t lines : next_line) {
+    EXPECT_EQ(lines_per_thread, lines);
+  }
+  EXPECT_EQ(num_threads * lines_per_thread, store_.counter("filesystem.write_buffered").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <string>
+
+#include "common/common/server_name_trie.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+class ServerNameTrieTest : public testing::Test {
+public:
+  std::string find(absl::string_view name) const {
+    const std::string* value = trie_.find(name);
+    return value == nullptr ? "none" : *value;
+  }
+
+  ServerNameTrie<std::string> trie_;
+};
+
+TEST_F(ServerNameTrieTest, Exact) {
+  trie_.exact("www.example.com") = "www";
+  trie_.exact("example.com") = "example";
+
+  EXPECT_EQ("www", find("www.example.com"));
+  EXPECT_EQ("example", find("example.com"));
+  EXPECT_EQ("none", find("com"));
+  EXPECT_EQ("none", find("foo.example.com"));
+  EXPECT_EQ("none", find("www.example.com."));
+  EXPECT_EQ("none", find(""));
+}
+
+// A wildcard matches names with at least one more label, preferring the longest suffix.
+TEST_F(ServerNameTrieTest, Wildcard) {
+  trie_.wildcard("example.com") = "*.example.com";
+  trie_.wildcard("com") = "*.com";
+
+  EXPECT_EQ("*.example.com", find("www.example.com"));
+  EXPECT_EQ("*.example.com", find("a.b.example.com"));
+  EXPECT_EQ("*.example.com", find(".example.com"));
+  EXPECT_EQ("*.com", find("example.com"));
+  EXPECT_EQ("*.com", find("www.example2.com"));
+  EXPECT_EQ("none", find("com"));
+  EXPECT_EQ("none", find("www.example.org"));
+}
+
+// An exact name is preferred over any wildcard.
+TEST_F(ServerNameTrieTest, ExactBeforeWildcard) {
+  trie_.exact("www.example.com") = "www";
+  trie_.wildcard("example.com") = "*.example.com";
+  trie_.wildcard("www.example.com") = "*.www.example.com";
+
+  EXPECT_EQ("www", find("www.example.com"));
+  EXPECT_EQ("*.www.example.com", find("a.www.example.com"));
+  EXPECT_EQ("*.example.com", find("foo.example.com"));
+}
+
+TEST_F(ServerNameTrieTest, EmptyName) {
+  trie_.exact("") = "empty";
+  trie_.wildcard("com") = "*.com";
+
+  EXPECT_EQ("empty", find(""));
+  EXPECT_EQ("*.com", find("example.com"));
+  EXPECT_EQ("none", find("example.org"));
+}
+
+TEST_F(ServerNameTrieTest, ForEach) {
+  trie_.exact("") = "a";
+  trie_.exact("example.com") = "b";
+  trie_.wildcard("example.com") = "c";
+  trie_.exact("www.example.com") = "d";
+
+  std::string values;
+  trie_.forEach([&values](std::string& value) { values += value; });
+  std::sort(values.begin(), values.end());
+  EXPECT_EQ("abcd", values);
+}
+
+} // namespace
+} // namespace Envoy
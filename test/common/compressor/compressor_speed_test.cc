@@ -0,0 +1,135 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/compressor/brotli_compressor_impl.h"
+#include "common/compressor/zlib_compressor_impl.h"
+#include "common/compressor/zstd_compressor_impl.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Compressor {
+
+/**
+ * A JSON API response: an array of records sharing the same keys with varying values.
+ */
+static const std::string& jsonBody() {
+  static const std::string* body = [] {
+    auto* out = new std::string("[");
+    for (uint32_t i = 0; i < 2000; i++) {
+      absl::StrAppend(out, i == 0 ? "" : ",", "{\"id\":", i * 7919, ",\"name\":\"user-", i,
+                      "\",\"email\":\"user", i % 97, "@example.com\",\"active\":",
+                      i % 3 == 0 ? "true" : "false", ",\"score\":", (i * 31) % 1000,
+                      ".", i % 10, ",\"tags\":[\"alpha\",\"beta-", i % 5, "\"]}");
+    }
+    out->append("]");
+    return out;
+  }();
+  return *body;
+}
+
+/**
+ * An HTML page: repeated markup around varying text, similar to a rendered listing page.
+ */
+static const std::string& htmlBody() {
+  static const std::string* body = [] {
+    auto* out = new std::string("<!DOCTYPE html><html><head><title>Listing</title>"
+                                "<link rel=\"stylesheet\" href=\"/static/site.css\"></head><body>"
+                                "<ul class=\"results\">");
+    for (uint32_t i = 0; i < 1500; i++) {
+      absl::StrAppend(out, "<li class=\"result\"><a href=\"/item/", i * 13,
+                      "\">Item number ", i, "</a><span class=\"price\">$", (i * 17) % 500, ".",
+                      i % 100, "</span><p>Ships in ", i % 7 + 1, " days from warehouse ", i % 11,
+                      ".</p></li>");
+    }
+    out->append("</ul></body></html>");
+    return out;
+  }();
+  return *body;
+}
+
+static const std::string& body(int64_t index) { return index == 0 ? jsonBody() : htmlBody(); }
+
+// Bodies are streamed through the compressor in chunks of this size with a flush after each one,
+// the way the compressor filter sees them from upstream.
+static constexpr uint64_t ChunkSize = 16384;
+
+/**
+ * Compress a body with a freshly created compressor, flushing after every chunk and finishing
+ * with the last one. Returns the compressed size.
+ */
+static uint64_t compressBody(Compressor& compressor, const std::string& input) {
+  uint64_t compressed = 0;
+  for (uint64_t offset = 0; offset < input.size(); offset += ChunkSize) {
+    const uint64_t length = std::min<uint64_t>(ChunkSize, input.size() - offset);
+    Buffer::OwnedImpl buffer(input.data() + offset, length);
+    compressor.compress(buffer, offset + length == input.size() ? State::Finish : State::Flush);
+    compressed += buffer.length();
+  }
+  return compressed;
+}
+
+static void reportRatio(benchmark::State& state, const std::string& input, uint64_t compressed) {
+  state.SetBytesProcessed(state.iterations() * input.size());
+  state.counters["ratio"] = static_cast<double>(input.size()) / compressed;
+}
+
+// Args: body (0 = JSON, 1 = HTML), zlib compression level.
+static void CompressGzip(benchmark::State& state) {
+  const std::string& input = body(state.range(0));
+  uint64_t compressed = 0;
+  for (auto _ : state) {
+    ZlibCompressorImpl compressor;
+    compressor.init(static_cast<ZlibCompressorImpl::CompressionLevel>(state.range(1)),
+                    ZlibCompressorImpl::CompressionStrategy::Standard, 15 | 16, 8);
+    compressed = compressBody(compressor, input);
+  }
+  reportRatio(state, input, compressed);
+}
+BENCHMARK(CompressGzip)->Args({0, 1})->Args({0, 6})->Args({1, 1})->Args({1, 6});
+
+// Args: body (0 = JSON, 1 = HTML), brotli quality.
+static void CompressBrotli(benchmark::State& state) {
+  const std::string& input = body(state.range(0));
+  uint64_t compressed = 0;
+  for (auto _ : state) {
+    BrotliCompressorImpl compressor(state.range(1), 18, BrotliCompressorImpl::EncoderMode::Text,
+                                    4096);
+    compressed = compressBody(compressor, input);
+  }
+  reportRatio(state, input, compressed);
+}
+BENCHMARK(CompressBrotli)
+    ->Args({0, 1})
+    ->Args({0, 3})
+    ->Args({0, 5})
+    ->Args({1, 1})
+    ->Args({1, 3})
+    ->Args({1, 5});
+
+// Args: body (0 = JSON, 1 = HTML), zstd compression level.
+static void CompressZstd(benchmark::State& state) {
+  const std::string& input = body(state.range(0));
+  uint64_t compressed = 0;
+  for (auto _ : state) {
+    ZstdCompressorImpl compressor(state.range(1), 0, false, 4096);
+    compressed = compressBody(compressor, input);
+  }
+  reportRatio(state, input, compressed);
+}
+BENCHMARK(CompressZstd)
+    ->Args({0, 1})
+    ->Args({0, 3})
+    ->Args({0, 6})
+    ->Args({1, 1})
+    ->Args({1, 3})
+    ->Args({1, 6});
+
+} // namespace Compressor
+} // namespace Envoy
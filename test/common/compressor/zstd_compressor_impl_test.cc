@@ -0,0 +1,81 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/compressor/zstd_compressor_impl.h"
+#include "common/decompressor/zstd_decompressor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Compressor {
+namespace {
+
+class ZstdCompressorImplTest : public testing::Test {
+protected:
+  static constexpr uint32_t default_level{3};
+  static constexpr uint32_t default_window_log{0};
+  static constexpr uint32_t default_chunk_size{4096};
+};
+
+// Compress a body in several flushed pieces and make sure every flush is decodable on its own.
+TEST_F(ZstdCompressorImplTest, FlushedChunksRoundTrip) {
+  ZstdCompressorImpl compressor(default_level, default_window_log, true, default_chunk_size);
+  Decompressor::ZstdDecompressorImpl decompressor(default_chunk_size);
+
+  std::string original;
+  Buffer::OwnedImpl decompressed;
+  for (uint32_t i = 0; i < 50; i++) {
+    Buffer::OwnedImpl buffer;
+    TestUtility::feedBufferWithRandomCharacters(buffer, 1000 + i * 17, i);
+    original.append(buffer.toString());
+    compressor.compress(buffer, State::Flush);
+    ASSERT_GT(buffer.length(), 0U);
+    decompressor.decompress(buffer, decompressed);
+    EXPECT_EQ(original.size(), decompressed.length());
+  }
+
+  Buffer::OwnedImpl buffer;
+  compressor.compress(buffer, State::Finish);
+  decompressor.decompress(buffer, decompressed);
+  EXPECT_EQ(0, decompressor.decompression_error_);
+  EXPECT_EQ(original, decompressed.toString());
+}
+
+// Repetitive text should shrink and survive output chunks smaller than the result.
+TEST_F(ZstdCompressorImplTest, SmallChunkSize) {
+  ZstdCompressorImpl compressor(19, 20, false, 16);
+  Decompressor::ZstdDecompressorImpl decompressor(16);
+
+  std::string original;
+  for (uint32_t i = 0; i < 1000; i++) {
+    original.append("{\"key\": \"value\", \"index\": ");
+    original.append(std::to_string(i));
+    original.append("},");
+  }
+  Buffer::OwnedImpl buffer(original);
+  compressor.compress(buffer, State::Finish);
+  EXPECT_LT(buffer.length(), original.size() / 10);
+
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(buffer, decompressed);
+  EXPECT_EQ(0, decompressor.decompression_error_);
+  EXPECT_EQ(original, decompressed.toString());
+}
+
+TEST_F(ZstdCompressorImplTest, EmptyBodyFinish) {
+  ZstdCompressorImpl compressor(default_level, default_window_log, false, default_chunk_size);
+  Decompressor::ZstdDecompressorImpl decompressor(default_chunk_size);
+
+  Buffer::OwnedImpl buffer;
+  compressor.compress(buffer, State::Finish);
+  EXPECT_GT(buffer.length(), 0U);
+
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(buffer, decompressed);
+  EXPECT_EQ(0, decompressor.decompression_error_);
+  EXPECT_EQ(0U, decompressed.length());
+}
+
+} // namespace
+} // namespace Compressor
+} // namespace Envoy
@@ -0,0 +1,45 @@
+#include "common/buffer/buffer_impl.h"
+#include "common/compressor/brotli_compressor_impl.h"
+#include "common/decompressor/brotli_decompressor_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Decompressor {
+namespace {
+
+// Garbage input is reported through decompression_error_ rather than crashing.
+TEST(BrotliDecompressorImplTest, InvalidInput) {
+  Buffer::OwnedImpl input_buffer("not a brotli stream, not a brotli stream");
+  Buffer::OwnedImpl output_buffer;
+  BrotliDecompressorImpl decompressor(4096);
+  decompressor.decompress(input_buffer, output_buffer);
+  EXPECT_LT(decompressor.decompression_error_, 0);
+}
+
+// Compressed data split into single-byte slices decodes the same as in one piece.
+TEST(BrotliDecompressorImplTest, FragmentedInput) {
+  Buffer::OwnedImpl original;
+  TestUtility::feedBufferWithRandomCharacters(original, 10000);
+  const std::string expected = original.toString();
+
+  Compressor::BrotliCompressorImpl compressor(
+      5, 18, Compressor::BrotliCompressorImpl::EncoderMode::Generic, 4096);
+  compressor.compress(original, Compressor::State::Finish);
+
+  BrotliDecompressorImpl decompressor(100);
+  Buffer::OwnedImpl output_buffer;
+  const std::string compressed = original.toString();
+  for (const char c : compressed) {
+    Buffer::OwnedImpl byte(&c, 1);
+    decompressor.decompress(byte, output_buffer);
+  }
+  EXPECT_EQ(0, decompressor.decompression_error_);
+  EXPECT_EQ(expected, output_buffer.toString());
+}
+
+} // namespace
+} // namespace Decompressor
+} // namespace Envoy
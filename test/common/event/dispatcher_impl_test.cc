@@ -3,6 +3,7 @@
 #include "envoy/thread/thread.h"
 
 #include "common/api/api_impl.h"
+#include "common/api/os_sys_calls_impl.h"
 #include "common/common/lock_guard.h"
 #include "common/event/dispatcher_impl.h"
 #include "common/event/timer_impl.h"
@@ -17,8 +18,10 @@
 #include "gtest/gtest.h"
 
 using testing::_;
+using testing::AnyNumber;
 using testing::InSequence;
 using testing::NiceMock;
+using testing::Property;
 
 namespace Envoy {
 namespace Event {
@@ -124,13 +127,71 @@ protected:
 // TODO(mergeconflict): We also need integration testing to validate that the expected histograms
 // are written when `enable_dispatcher_stats` is true. See issue #6582.
 TEST_F(DispatcherImplTest, InitializeStats) {
+  EXPECT_CALL(scope_, histogram("test.dispatcher.file_event_duration_us",
+                                Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.loop_duration_us", Stats::Histogram::Unit::Microseconds));
   EXPECT_CALL(scope_,
               histogram("test.dispatcher.poll_delay_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_duration_us", Stats::Histogram::Unit::Microseconds));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.post_queue_depth", Stats::Histogram::Unit::Unspecified));
+  EXPECT_CALL(scope_,
+              histogram("test.dispatcher.timer_duration_us", Stats::Histogram::Unit::Microseconds));
   dispatcher_->initializeStats(scope_, "test.");
 }
 
+// Once stats are initialized, the time spent in each kind of event callback is recorded.
+TEST(DispatcherStatsTest, EventCallbackDurations) {
+  NiceMock<Stats::MockStore> store;
+  Api::ApiPtr api = Api::createApiForTest();
+  DispatcherPtr dispatcher(api->allocateDispatcher());
+  dispatcher->initializeStats(store, "test.");
+  // initializeStats() runs as a posted callback.
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+
+  const auto histogram_named = [](const std::string& name) {
+    return Property(&Stats::Metric::name, name);
+  };
+  EXPECT_CALL(store, deliverHistogramToSinks(_, _)).Times(AnyNumber());
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(histogram_named("test.dispatcher.post_queue_depth"), 2));
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(histogram_named("test.dispatcher.post_duration_us"), _));
+  // Posted callbacks are themselves run from a timer.
+  EXPECT_CALL(store,
+              deliverHistogramToSinks(histogram_named("test.dispatcher.timer_duration_us"), _))
+      .Times(2);
+  EXPECT_CALL(store, deliverHistogramToSinks(
+                         histogram_named("test.dispatcher.file_event_duration_us"), _));
+
+  ReadyWatcher post_ready;
+  EXPECT_CALL(post_ready, ready()).Times(2);
+  dispatcher->post([&post_ready]() { post_ready.ready(); });
+  dispatcher->post([&post_ready]() { post_ready.ready(); });
+
+  ReadyWatcher timer_ready;
+  EXPECT_CALL(timer_ready, ready());
+  TimerPtr timer = dispatcher->createTimer([&timer_ready]() { timer_ready.ready(); });
+  timer->enableTimer(std::chrono::milliseconds(0));
+
+  os_fd_t fds[2];
+  Api::OsSysCalls& os_sys_calls = Api::OsSysCallsSingleton::get();
+  ASSERT_EQ(0, os_sys_calls.socketpair(AF_UNIX, SOCK_STREAM, 0, fds).rc_);
+  ReadyWatcher file_ready;
+  EXPECT_CALL(file_ready, ready());
+  FileEventPtr file_event = dispatcher->createFileEvent(
+      fds[0], [&file_ready](uint32_t) { file_ready.ready(); }, FileTriggerType::Level,
+      FileReadyType::Read);
+  file_event->activate(FileReadyType::Read);
+
+  dispatcher->run(Dispatcher::RunType::NonBlock);
+  file_event.reset();
+  os_sys_calls.close(fds[0]);
+  os_sys_calls.close(fds[1]);
+}
+
 TEST_F(DispatcherImplTest, Post) {
   dispatcher_->post([this]() {
     {
@@ -11,6 +11,8 @@
 #include "common/network/address_impl.h"
 #include "common/network/utility.h"
 #include "common/runtime/runtime_impl.h"
+#include "common/stats/isolated_store_impl.h"
+#include "common/tracing/sampling_rate_limiter.h"
 
 #include "test/mocks/http/mocks.h"
 #include "test/mocks/local_info/mocks.h"
@@ -18,6 +20,7 @@
 #include "test/mocks/runtime/mocks.h"
 #include "test/mocks/ssl/mocks.h"
 #include "test/test_common/printers.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
@@ -157,8 +160,16 @@ public:
     envoy::type::v3::FractionalPercent percent2;
     percent2.set_numerator(10000);
     percent2.set_denominator(envoy::type::v3::FractionalPercent::TEN_THOUSAND);
-    tracing_config_ = {
-        Tracing::OperationName::Ingress, {}, percent1, percent2, percent1, false, 256};
+    tracing_config_ = {Tracing::OperationName::Ingress,
+                       {},
+                       percent1,
+                       percent2,
+                       percent1,
+                       false,
+                       256,
+                       nullptr,
+                       absl::nullopt,
+                       false};
     ON_CALL(config_, tracingConfig()).WillByDefault(Return(&tracing_config_));
 
     ON_CALL(config_, via()).WillByDefault(ReturnRef(via_));
@@ -1202,6 +1213,101 @@ TEST_F(ConnectionManagerUtilityTest, SamplingWithRouteOverride) {
   EXPECT_EQ(TraceStatus::NoTrace, request_id_extension_->getTraceStatus(request_headers));
 }
 
+// Sampling, over the random sampling rate limit, global on.
+TEST_F(ConnectionManagerUtilityTest, NoTraceWhenRandomSamplingRateLimited) {
+  Event::SimulatedTimeSystem time_system;
+  Stats::IsolatedStoreImpl stats_store;
+  ConnectionManagerTracingStats tracing_stats{CONN_MAN_TRACING_STATS(POOL_COUNTER(stats_store))};
+  ON_CALL(config_, tracingStats()).WillByDefault(ReturnRef(tracing_stats));
+  tracing_config_.random_sampling_limiter_ =
+      std::make_shared<Tracing::SamplingRateLimiter>(1, time_system);
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.random_sampling", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+
+  Http::TestRequestHeaderMapImpl request_headers1{
+      {"x-request-id", "125a4afb-6f55-44ba-ad80-413f09f48a28"}};
+  EXPECT_CALL(*request_id_extension_,
+              setTraceStatus(testing::Ref(request_headers1), TraceStatus::Sampled));
+  callMutateRequestHeaders(request_headers1, Protocol::Http2);
+  EXPECT_EQ(TraceStatus::Sampled, request_id_extension_->getTraceStatus(request_headers1));
+
+  Http::TestRequestHeaderMapImpl request_headers2{
+      {"x-request-id", "125a4afb-6f55-44ba-ad80-413f09f48a28"}};
+  EXPECT_CALL(*request_id_extension_, setTraceStatus(testing::Ref(request_headers2), _)).Times(0);
+  callMutateRequestHeaders(request_headers2, Protocol::Http2);
+  EXPECT_EQ(TraceStatus::NoTrace, request_id_extension_->getTraceStatus(request_headers2));
+  EXPECT_EQ(1U, tracing_stats.random_sampling_limited_.value());
+}
+
+// Requests rejected by overall sampling are not charged against the random sampling rate limit.
+TEST_F(ConnectionManagerUtilityTest, RandomSamplingRateLimitNotChargedWhenGlobalOff) {
+  Event::SimulatedTimeSystem time_system;
+  Stats::IsolatedStoreImpl stats_store;
+  ConnectionManagerTracingStats tracing_stats{CONN_MAN_TRACING_STATS(POOL_COUNTER(stats_store))};
+  ON_CALL(config_, tracingStats()).WillByDefault(ReturnRef(tracing_stats));
+  tracing_config_.random_sampling_limiter_ =
+      std::make_shared<Tracing::SamplingRateLimiter>(1, time_system);
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.random_sampling", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .WillOnce(Return(false))
+      .WillOnce(Return(true));
+
+  Http::TestRequestHeaderMapImpl request_headers1{
+      {"x-request-id", "125a4afb-6f55-44ba-ad80-413f09f48a28"}};
+  callMutateRequestHeaders(request_headers1, Protocol::Http2);
+  EXPECT_EQ(TraceStatus::NoTrace, request_id_extension_->getTraceStatus(request_headers1));
+
+  Http::TestRequestHeaderMapImpl request_headers2{
+      {"x-request-id", "125a4afb-6f55-44ba-ad80-413f09f48a28"}};
+  callMutateRequestHeaders(request_headers2, Protocol::Http2);
+  EXPECT_EQ(TraceStatus::Sampled, request_id_extension_->getTraceStatus(request_headers2));
+  EXPECT_EQ(0U, tracing_stats.random_sampling_limited_.value());
+}
+
+// Tail sampling is subject to overall sampling and to the random sampling rate limit.
+TEST_F(ConnectionManagerUtilityTest, TailSamplingEnabled) {
+  Event::SimulatedTimeSystem time_system;
+  Stats::IsolatedStoreImpl stats_store;
+  ConnectionManagerTracingStats tracing_stats{CONN_MAN_TRACING_STATS(POOL_COUNTER(stats_store))};
+  ON_CALL(config_, tracingStats()).WillByDefault(ReturnRef(tracing_stats));
+  tracing_config_.random_sampling_limiter_ =
+      std::make_shared<Tracing::SamplingRateLimiter>(1, time_system);
+  EXPECT_CALL(
+      runtime_.snapshot_,
+      featureEnabled("tracing.global_enabled", An<const envoy::type::v3::FractionalPercent&>(), _))
+      .WillOnce(Return(false))
+      .WillRepeatedly(Return(true));
+
+  Http::TestRequestHeaderMapImpl request_headers{
+      {"x-request-id", "125a4afb-6f55-44ba-ad80-413f09f48a28"}};
+  EXPECT_FALSE(
+      ConnectionManagerUtility::tailSamplingEnabled(request_headers, runtime_, config_, nullptr));
+  EXPECT_TRUE(
+      ConnectionManagerUtility::tailSamplingEnabled(request_headers, runtime_, config_, nullptr));
+  EXPECT_FALSE(
+      ConnectionManagerUtility::tailSamplingEnabled(request_headers, runtime_, config_, nullptr));
+  EXPECT_EQ(1U, tracing_stats.random_sampling_limited_.value());
+
+  // Requests without a valid request ID cannot be traced.
+  Http::TestRequestHeaderMapImpl no_request_id_headers;
+  EXPECT_FALSE(ConnectionManagerUtility::tailSamplingEnabled(no_request_id_headers, runtime_,
+                                                             config_, nullptr));
+}
+
 // Sampling must not be done on client traced.
 TEST_F(ConnectionManagerUtilityTest, SamplingMustNotBeDoneOnClientTraced) {
   EXPECT_CALL(
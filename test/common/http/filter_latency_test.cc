@@ -0,0 +1,182 @@
+#include <memory>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/http/filter_latency.h"
+
+#include "test/mocks/access_log/mocks.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::InSequence;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Property;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class FilterLatencyTest : public testing::Test {
+public:
+  FilterLatencyConfigSharedPtr createConfig(uint64_t sampling) {
+    return std::make_shared<FilterLatencyConfig>("http.test.filter_latency.foo.", store_, sampling,
+                                                 random_, time_system_);
+  }
+
+  // Returns an action that takes the given time to run and then returns status.
+  template <class Status> auto takes(std::chrono::microseconds duration, Status status) {
+    return Invoke([this, duration, status](auto&&...) {
+      time_system_.sleep(duration);
+      return status;
+    });
+  }
+
+  void expectHistogram(const std::string& name, uint64_t value) {
+    EXPECT_CALL(store_, deliverHistogramToSinks(Property(&Stats::Metric::name, name), value));
+  }
+
+  NiceMock<Stats::MockStore> store_;
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  Event::SimulatedTimeSystem time_system_;
+  MockFilterChainFactoryCallbacks callbacks_;
+};
+
+// Filters of streams which are not sampled are added as they are.
+TEST_F(FilterLatencyTest, NotSampled) {
+  auto decoder_filter = std::make_shared<MockStreamDecoderFilter>();
+  FilterFactoryCb factory =
+      FilterLatencyConfig::wrapFactory([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }, createConfig(5000));
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(15000));
+  EXPECT_CALL(callbacks_, addStreamDecoderFilter(StreamDecoderFilterSharedPtr(decoder_filter)));
+  factory(callbacks_);
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(14999));
+  StreamDecoderFilterSharedPtr added;
+  EXPECT_CALL(callbacks_, addStreamDecoderFilter(_)).WillOnce(SaveArg<0>(&added));
+  factory(callbacks_);
+  EXPECT_NE(decoder_filter, added);
+}
+
+TEST_F(FilterLatencyTest, DisabledSampling) {
+  auto decoder_filter = std::make_shared<MockStreamDecoderFilter>();
+  FilterFactoryCb factory =
+      FilterLatencyConfig::wrapFactory([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }, createConfig(0));
+
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_CALL(callbacks_, addStreamDecoderFilter(StreamDecoderFilterSharedPtr(decoder_filter)));
+  factory(callbacks_);
+}
+
+TEST_F(FilterLatencyTest, DecoderFilter) {
+  auto decoder_filter = std::make_shared<MockStreamDecoderFilter>();
+  FilterFactoryCb factory =
+      FilterLatencyConfig::wrapFactory([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamDecoderFilter(decoder_filter);
+      }, createConfig(10000));
+
+  StreamDecoderFilterSharedPtr timed;
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_CALL(callbacks_, addStreamDecoderFilter(_)).WillOnce(SaveArg<0>(&timed));
+  factory(callbacks_);
+
+  NiceMock<MockStreamDecoderFilterCallbacks> decoder_callbacks;
+  EXPECT_CALL(*decoder_filter, setDecoderFilterCallbacks(_));
+  timed->setDecoderFilterCallbacks(decoder_callbacks);
+
+  TestRequestHeaderMapImpl headers;
+  Buffer::OwnedImpl data;
+  TestRequestTrailerMapImpl trailers;
+  EXPECT_CALL(*decoder_filter, decodeHeaders(_, false))
+      .WillOnce(takes(std::chrono::microseconds(10), FilterHeadersStatus::StopIteration));
+  EXPECT_CALL(*decoder_filter, decodeData(_, false))
+      .WillOnce(takes(std::chrono::microseconds(20), FilterDataStatus::Continue));
+  EXPECT_CALL(*decoder_filter, decodeTrailers(_))
+      .WillOnce(takes(std::chrono::microseconds(30), FilterTrailersStatus::Continue));
+  EXPECT_EQ(FilterHeadersStatus::StopIteration, timed->decodeHeaders(headers, false));
+  EXPECT_EQ(FilterDataStatus::Continue, timed->decodeData(data, false));
+  time_system_.sleep(std::chrono::milliseconds(5));
+  EXPECT_EQ(FilterTrailersStatus::Continue, timed->decodeTrailers(trailers));
+
+  // Only the time spent in the filter is recorded, and only for the decoding direction.
+  InSequence s;
+  EXPECT_CALL(*decoder_filter, onDestroy());
+  expectHistogram("http.test.filter_latency.foo.decode_us", 60);
+  timed->onDestroy();
+}
+
+TEST_F(FilterLatencyTest, EncoderFilter) {
+  auto encoder_filter = std::make_shared<MockStreamEncoderFilter>();
+  FilterFactoryCb factory =
+      FilterLatencyConfig::wrapFactory([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamEncoderFilter(encoder_filter);
+      }, createConfig(10000));
+
+  StreamEncoderFilterSharedPtr timed;
+  EXPECT_CALL(callbacks_, addStreamEncoderFilter(_)).WillOnce(SaveArg<0>(&timed));
+  factory(callbacks_);
+
+  TestResponseHeaderMapImpl continue_headers;
+  TestResponseHeaderMapImpl headers;
+  EXPECT_CALL(*encoder_filter, encode100ContinueHeaders(_))
+      .WillOnce(takes(std::chrono::microseconds(7), FilterHeadersStatus::Continue));
+  EXPECT_CALL(*encoder_filter, encodeHeaders(_, true))
+      .WillOnce(takes(std::chrono::microseconds(8), FilterHeadersStatus::Continue));
+  EXPECT_EQ(FilterHeadersStatus::Continue, timed->encode100ContinueHeaders(continue_headers));
+  EXPECT_EQ(FilterHeadersStatus::Continue, timed->encodeHeaders(headers, true));
+
+  InSequence s;
+  EXPECT_CALL(*encoder_filter, onDestroy());
+  expectHistogram("http.test.filter_latency.foo.encode_us", 15);
+  timed->onDestroy();
+}
+
+TEST_F(FilterLatencyTest, StreamFilter) {
+  auto stream_filter = std::make_shared<MockStreamFilter>();
+  auto access_log = std::make_shared<AccessLog::MockInstance>();
+  FilterFactoryCb factory =
+      FilterLatencyConfig::wrapFactory([&](FilterChainFactoryCallbacks& callbacks) -> void {
+        callbacks.addStreamFilter(stream_filter);
+        callbacks.addAccessLogHandler(access_log);
+      }, createConfig(10000));
+
+  StreamFilterSharedPtr timed;
+  EXPECT_CALL(callbacks_, addStreamFilter(_)).WillOnce(SaveArg<0>(&timed));
+  EXPECT_CALL(callbacks_, addAccessLogHandler(AccessLog::InstanceSharedPtr(access_log)));
+  factory(callbacks_);
+
+  TestRequestHeaderMapImpl request_headers;
+  TestResponseHeaderMapImpl response_headers;
+  Buffer::OwnedImpl data;
+  EXPECT_CALL(*stream_filter, decodeHeaders(_, true))
+      .WillOnce(takes(std::chrono::microseconds(100), FilterHeadersStatus::Continue));
+  EXPECT_CALL(*stream_filter, encodeHeaders(_, false))
+      .WillOnce(takes(std::chrono::microseconds(200), FilterHeadersStatus::Continue));
+  EXPECT_CALL(*stream_filter, encodeData(_, true))
+      .WillOnce(takes(std::chrono::microseconds(300), FilterDataStatus::Continue));
+  EXPECT_EQ(FilterHeadersStatus::Continue, timed->decodeHeaders(request_headers, true));
+  EXPECT_EQ(FilterHeadersStatus::Continue, timed->encodeHeaders(response_headers, false));
+  EXPECT_EQ(FilterDataStatus::Continue, timed->encodeData(data, true));
+
+  EXPECT_CALL(*stream_filter, onDestroy());
+  expectHistogram("http.test.filter_latency.foo.decode_us", 100);
+  expectHistogram("http.test.filter_latency.foo.encode_us", 500);
+  timed->onDestroy();
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
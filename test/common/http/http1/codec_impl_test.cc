@@ -1424,6 +1424,78 @@ TEST_F(Http1ServerConnectionImplTest, DoubleRequest) {
   EXPECT_EQ(0U, buffer.length());
 }
 
+TEST_F(Http1ServerConnectionImplTest, PipelinedResponsesWrittenInOrder) {
+  codec_settings_.max_pipelined_requests_ = 2;
+  initialize();
+
+  std::string output;
+  ON_CALL(connection_, write(_, _)).WillByDefault(AddBufferToString(&output));
+
+  NiceMock<MockRequestDecoder> decoder1;
+  NiceMock<MockRequestDecoder> decoder2;
+  Http::ResponseEncoder* response_encoder1 = nullptr;
+  Http::ResponseEncoder* response_encoder2 = nullptr;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder1 = &encoder;
+        return decoder1;
+      }))
+      .WillOnce(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoder2 = &encoder;
+        return decoder2;
+      }));
+  EXPECT_CALL(decoder1, decodeHeaders_(_, true));
+  EXPECT_CALL(decoder2, decodeHeaders_(_, true));
+
+  // The second request is decoded while the first one is still outstanding.
+  Buffer::OwnedImpl buffer("GET /1 HTTP/1.1\r\n\r\nGET /2 HTTP/1.1\r\n\r\n");
+  codec_->dispatch(buffer);
+  codec_->dispatch(buffer);
+  EXPECT_EQ(0U, buffer.length());
+
+  // The second response is held back until the first one is complete.
+  response_encoder2->encodeHeaders(TestResponseHeaderMapImpl{{":status", "404"}}, true);
+  EXPECT_EQ("", output);
+
+  response_encoder1->encodeHeaders(TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\n", output);
+
+  Buffer::OwnedImpl data("Hello World");
+  response_encoder1->encodeData(data, true);
+  EXPECT_EQ("HTTP/1.1 200 OK\r\ntransfer-encoding: chunked\r\n\r\nb\r\nHello "
+            "World\r\n0\r\n\r\nHTTP/1.1 404 Not Found\r\ncontent-length: 0\r\n\r\n",
+            output);
+}
+
+TEST_F(Http1ServerConnectionImplTest, PipelinedRequestsResetTogether) {
+  codec_settings_.max_pipelined_requests_ = 2;
+  initialize();
+
+  NiceMock<MockRequestDecoder> decoder;
+  std::vector<Http::ResponseEncoder*> response_encoders;
+  EXPECT_CALL(callbacks_, newStream(_, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](ResponseEncoder& encoder, bool) -> RequestDecoder& {
+        response_encoders.push_back(&encoder);
+        return decoder;
+      }));
+
+  Buffer::OwnedImpl buffer("GET /1 HTTP/1.1\r\n\r\nGET /2 HTTP/1.1\r\n\r\n");
+  codec_->dispatch(buffer);
+  codec_->dispatch(buffer);
+  ASSERT_EQ(2U, response_encoders.size());
+
+  Http::MockStreamCallbacks callbacks1;
+  Http::MockStreamCallbacks callbacks2;
+  response_encoders[0]->getStream().addCallbacks(callbacks1);
+  response_encoders[1]->getStream().addCallbacks(callbacks2);
+
+  // Resetting either stream tears down the connection, so both streams see the reset.
+  EXPECT_CALL(callbacks1, onResetStream(StreamResetReason::LocalReset, _));
+  EXPECT_CALL(callbacks2, onResetStream(StreamResetReason::LocalReset, _));
+  response_encoders[0]->getStream().resetStream(StreamResetReason::LocalReset);
+}
+
 TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersDropped) { expectTrailersTest(false); }
 
 TEST_F(Http1ServerConnectionImplTest, RequestWithTrailersKept) { expectTrailersTest(true); }
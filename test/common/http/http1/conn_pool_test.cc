@@ -832,6 +832,122 @@ TEST_F(Http1ConnPoolImplTest, ConcurrentConnections) {
   EXPECT_EQ(2U, cluster_->stats_.upstream_cx_destroy_remote_.value());
 }
 
+/**
+ * Test that connections are prefetched ahead of demand as configured by the prefetch ratio.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchRatio) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  cluster_->per_upstream_prefetch_ratio_ = 2;
+  InSequence s;
+
+  // Request 1 kicks off a connection for itself, and a prefetched one.
+  NiceMock<MockResponseDecoder> outer_decoder1;
+  ConnPoolCallbacks callbacks1;
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  EXPECT_NE(nullptr, conn_pool_.newStream(outer_decoder1, callbacks1));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  NiceMock<MockRequestEncoder> request_encoder;
+  ResponseDecoder* inner_decoder1;
+  EXPECT_CALL(*conn_pool_.test_clients_[0].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder1), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks1.pool_ready_, ready());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // Request 2 is bound to the prefetched connection right away, and kicks off another prefetch,
+  // which is as many connections as the circuit breaker allows.
+  NiceMock<MockResponseDecoder> outer_decoder2;
+  ConnPoolCallbacks callbacks2;
+  ResponseDecoder* inner_decoder2;
+  EXPECT_CALL(*conn_pool_.test_clients_[1].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder2), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks2.pool_ready_, ready());
+  conn_pool_.expectClientCreate();
+  EXPECT_EQ(nullptr, conn_pool_.newStream(outer_decoder2, callbacks2));
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_overflow_.value());
+
+  for (auto* callbacks : {&callbacks1, &callbacks2}) {
+    callbacks->outer_encoder_->encodeHeaders(
+        TestRequestHeaderMapImpl{{":path", "/"}, {":method", "GET"}}, true);
+  }
+  for (auto* inner_decoder : {inner_decoder1, inner_decoder2}) {
+    inner_decoder->decodeHeaders(
+        ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, true);
+  }
+
+  // The last prefetched connection goes away without ever being used.
+  EXPECT_CALL(conn_pool_, onClientDestroy()).Times(3);
+  conn_pool_.test_clients_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
+/**
+ * Test that connections which go away are replaced ahead of demand, unless they failed to connect.
+ */
+TEST_F(Http1ConnPoolImplTest, PrefetchOnClose) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->max_requests_per_connection_ = 1;
+  cluster_->prefetch_min_idle_connections_ = 1;
+  InSequence s;
+
+  // Request 1 kicks off a connection for itself, and a prefetched one to keep idle.
+  NiceMock<MockResponseDecoder> outer_decoder;
+  ConnPoolCallbacks callbacks;
+  conn_pool_.expectClientCreate();
+  conn_pool_.expectClientCreate();
+  EXPECT_NE(nullptr, conn_pool_.newStream(outer_decoder, callbacks));
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  NiceMock<MockRequestEncoder> request_encoder;
+  ResponseDecoder* inner_decoder;
+  EXPECT_CALL(*conn_pool_.test_clients_[0].codec_, newStream(_))
+      .WillOnce(DoAll(SaveArgAddress(&inner_decoder), ReturnRef(request_encoder)));
+  EXPECT_CALL(callbacks.pool_ready_, ready());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The prefetched connection fails to connect, and is not replaced.
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Completing request 1 closes its connection at the request limit, which leaves no idle
+  // connection, so one is prefetched.
+  callbacks.outer_encoder_->encodeHeaders(
+      TestRequestHeaderMapImpl{{":path", "/"}, {":method", "GET"}}, true);
+  conn_pool_.expectClientCreate();
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  inner_decoder->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, true);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_max_requests_.value());
+
+  // The idle connection is closed by the upstream after connecting, and is replaced.
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.expectClientCreate();
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Stop prefetching, so that the last connection is not replaced.
+  cluster_->prefetch_min_idle_connections_ = 0;
+  EXPECT_CALL(conn_pool_, onClientDestroy());
+  conn_pool_.test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
 TEST_F(Http1ConnPoolImplTest, DrainCallback) {
   InSequence s;
   ReadyWatcher drained;
@@ -566,6 +566,45 @@ TEST_P(Http2CodecImplTest, TrailingHeadersLargeBody) {
   response_encoder_->encodeTrailers(TestResponseTrailerMapImpl{{"trailing", "header"}});
 }
 
+// Verify that DATA payloads moved out of the dispatched buffer arrive intact, both when frames
+// line up with buffer slices and when they are split across several dispatches.
+TEST_P(Http2CodecImplTest, LargeBodyDispatchedInPieces) {
+  initialize();
+
+  Buffer::OwnedImpl wire;
+  ON_CALL(client_connection_, write(_, _))
+      .WillByDefault(Invoke([&](Buffer::Instance& data, bool) -> void { wire.move(data); }));
+
+  TestRequestHeaderMapImpl request_headers;
+  HttpTestUtility::addDefaultHeaders(request_headers);
+  request_encoder_->encodeHeaders(request_headers, false);
+  std::string body;
+  for (uint32_t i = 0; i < 64 * 1024; i++) {
+    body.push_back('a' + i % 26);
+  }
+  Buffer::OwnedImpl request_body(body);
+  request_encoder_->encodeData(request_body, true);
+
+  std::string received;
+  EXPECT_CALL(request_decoder_, decodeHeaders_(_, false));
+  EXPECT_CALL(request_decoder_, decodeData(_, _))
+      .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) -> void {
+        received.append(data.toString());
+      }));
+
+  // Hand the server the first half of the wire bytes in one piece, and the rest in uneven chunks.
+  setupDefaultConnectionMocks();
+  uint64_t chunk = wire.length() / 2;
+  while (wire.length() > 0) {
+    Buffer::OwnedImpl piece;
+    piece.move(wire, std::min<uint64_t>(chunk, wire.length()));
+    server_wrapper_.dispatch(piece, *server_);
+    EXPECT_EQ(0U, server_wrapper_.buffer_.length());
+    chunk = 4093;
+  }
+  EXPECT_EQ(body, received);
+}
+
 TEST_P(Http2CodecImplTest, SmallMetadataVecTest) {
   allow_metadata_ = true;
   initialize();
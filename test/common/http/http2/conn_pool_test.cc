@@ -92,8 +92,9 @@ public:
       EXPECT_CALL(*test_clients_.back().connection_, setBufferLimits(*buffer_limits));
     }
     EXPECT_CALL(pool_, createCodecClient_(_))
-        .WillOnce(Invoke([this](Upstream::Host::CreateConnectionData&) -> CodecClient* {
-          return test_clients_.back().codec_client_;
+        .WillOnce(Invoke([this, index = test_clients_.size() - 1](
+                             Upstream::Host::CreateConnectionData&) -> CodecClient* {
+          return test_clients_[index].codec_client_;
         }));
     EXPECT_CALL(*test_client.connect_timer_, enableTimer(_, _));
   }
@@ -286,6 +287,128 @@ TEST_F(Http2ConnPoolImplTest, DrainConnectionConnecting) {
   pool_.drainConnections();
 }
 
+/**
+ * Verify that an idle connection is kept around for the next request as configured by the
+ * prefetch policy.
+ */
+TEST_F(Http2ConnPoolImplTest, PrefetchMinIdleConnections) {
+  // A single stream per connection, so that a connection with a request has no idle capacity.
+  cluster_->http2_options_.mutable_max_concurrent_streams()->set_value(1);
+  cluster_->prefetch_min_idle_connections_ = 1;
+
+  // The first request kicks off a connection for itself, and a prefetched one to keep idle.
+  {
+    InSequence s;
+    expectClientCreate();
+    expectClientCreate();
+  }
+  ActiveTestRequest r1(*this, 0, false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+  expectClientConnect(0, r1);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request takes the idle connection, so another one is prefetched.
+  expectClientCreate();
+  ActiveTestRequest r2(*this, 1, true);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+
+  completeRequest(r1);
+  completeRequest(r2);
+
+  // Stop prefetching, so that the closed connections are not replaced.
+  cluster_->prefetch_min_idle_connections_ = 0;
+  closeClient(2);
+  closeClient(1);
+  closeClient(0);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
+/**
+ * Verify that idle capacity is counted in streams, so that a connecting client which several
+ * pending streams wait for is not idle, and that one prefetched connection is enough for them.
+ */
+TEST_F(Http2ConnPoolImplTest, PrefetchMinIdleConnectionsWithPendingStreams) {
+  cluster_->http2_options_.mutable_max_concurrent_streams()->set_value(4);
+  cluster_->prefetch_min_idle_connections_ = 1;
+
+  // The first stream kicks off a connection for itself, and a prefetched one to keep idle.
+  {
+    InSequence s;
+    expectClientCreate();
+    expectClientCreate();
+  }
+  ActiveTestRequest r1(*this, 0, false);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // The next streams fit on the connecting client, next to the prefetched connection.
+  ActiveTestRequest r2(*this, 0, false);
+  ActiveTestRequest r3(*this, 0, false);
+  ActiveTestRequest r4(*this, 0, false);
+  EXPECT_EQ(2U, test_clients_.size());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Once the pending streams take all of the first connection, only the prefetched one is idle.
+  {
+    InSequence s;
+    expectStreamConnect(0, r1);
+    expectStreamConnect(0, r2);
+    expectStreamConnect(0, r3);
+    expectStreamConnect(0, r4);
+    EXPECT_CALL(*test_clients_[0].connect_timer_, disableTimer());
+  }
+  test_clients_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(2U, test_clients_.size());
+
+  completeRequest(r1);
+  completeRequest(r2);
+  completeRequest(r3);
+  completeRequest(r4);
+
+  // Stop prefetching, so that the closed connections are not replaced.
+  cluster_->prefetch_min_idle_connections_ = 0;
+  closeClient(1);
+  closeClient(0);
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
+/**
+ * Verify that the connections closed by drainConnections() are not replaced ahead of demand.
+ */
+TEST_F(Http2ConnPoolImplTest, NoPrefetchAfterDrain) {
+  cluster_->http2_options_.mutable_max_concurrent_streams()->set_value(1);
+  cluster_->prefetch_min_idle_connections_ = 1;
+
+  {
+    InSequence s;
+    expectClientCreate();
+    expectClientCreate();
+  }
+  ActiveTestRequest r(*this, 0, false);
+  expectClientConnect(0, r);
+  EXPECT_CALL(*test_clients_[1].connect_timer_, disableTimer());
+  test_clients_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Draining closes the idle connection right away, and the busy one once its stream completes.
+  // Neither of them is replaced.
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(*this, onClientDestroy());
+  pool_.drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_CALL(*this, onClientDestroy());
+  completeRequest(r);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
 /**
  * Verify that connections are drained when requested.
  */
@@ -0,0 +1,122 @@
+#include <string>
+#include <vector>
+
+#include "common/http/http2/header_interner.h"
+
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+namespace {
+
+absl::string_view nameOf(const nghttp2_nv& nv) {
+  return absl::string_view(reinterpret_cast<const char*>(nv.name), nv.namelen);
+}
+
+absl::string_view valueOf(const nghttp2_nv& nv) {
+  return absl::string_view(reinterpret_cast<const char*>(nv.value), nv.valuelen);
+}
+
+constexpr uint8_t NoCopy = NGHTTP2_NV_FLAG_NO_COPY_NAME | NGHTTP2_NV_FLAG_NO_COPY_VALUE;
+
+TEST(HeaderInternerTest, InternsRecurringPairs) {
+  HeaderInterner interner;
+  TestResponseHeaderMapImpl headers{{"x-custom", "value"}};
+
+  // The first sighting is copied by nghttp2 as usual.
+  std::vector<nghttp2_nv> first;
+  interner.buildHeaders(first, headers);
+  ASSERT_EQ(1U, first.size());
+  EXPECT_EQ(0, first[0].flags);
+  EXPECT_EQ("x-custom", nameOf(first[0]));
+  EXPECT_EQ("value", valueOf(first[0]));
+  EXPECT_EQ(0U, interner.size());
+
+  // The second sighting is interned and no longer points at the header map.
+  std::vector<nghttp2_nv> second;
+  interner.buildHeaders(second, headers);
+  ASSERT_EQ(1U, second.size());
+  EXPECT_EQ(NoCopy, second[0].flags);
+  EXPECT_EQ("x-custom", nameOf(second[0]));
+  EXPECT_EQ("value", valueOf(second[0]));
+  EXPECT_NE(first[0].value, second[0].value);
+  EXPECT_EQ(1U, interner.size());
+
+  // Later sightings reuse the same storage, even from a different header map.
+  TestResponseHeaderMapImpl other_headers{{"x-custom", "value"}};
+  std::vector<nghttp2_nv> third;
+  interner.buildHeaders(third, other_headers);
+  ASSERT_EQ(1U, third.size());
+  EXPECT_EQ(NoCopy, third[0].flags);
+  EXPECT_EQ(second[0].name, third[0].name);
+  EXPECT_EQ(second[0].value, third[0].value);
+  EXPECT_EQ(1U, interner.size());
+}
+
+TEST(HeaderInternerTest, DistinguishesValues) {
+  HeaderInterner interner;
+  for (int i = 0; i < 2; ++i) {
+    std::vector<nghttp2_nv> nva;
+    interner.buildHeaders(nva, TestResponseHeaderMapImpl{{"x-custom", "a"}});
+  }
+
+  std::vector<nghttp2_nv> nva;
+  interner.buildHeaders(nva, TestResponseHeaderMapImpl{{"x-custom", "b"}});
+  ASSERT_EQ(1U, nva.size());
+  EXPECT_EQ(0, nva[0].flags);
+  EXPECT_EQ("b", valueOf(nva[0]));
+  EXPECT_EQ(1U, interner.size());
+}
+
+TEST(HeaderInternerTest, BoundedByEntryCount) {
+  HeaderInterner interner(1, HeaderInterner::DEFAULT_MAX_ENTRY_SIZE);
+  TestResponseHeaderMapImpl headers{{"x-first", "1"}, {"x-second", "2"}};
+  for (int i = 0; i < 3; ++i) {
+    std::vector<nghttp2_nv> nva;
+    interner.buildHeaders(nva, headers);
+  }
+
+  std::vector<nghttp2_nv> nva;
+  interner.buildHeaders(nva, headers);
+  ASSERT_EQ(2U, nva.size());
+  EXPECT_EQ(NoCopy, nva[0].flags);
+  EXPECT_EQ(0, nva[1].flags);
+  EXPECT_EQ(1U, interner.size());
+}
+
+TEST(HeaderInternerTest, SkipsLargeEntries) {
+  HeaderInterner interner(HeaderInterner::DEFAULT_MAX_ENTRIES, 16);
+  TestResponseHeaderMapImpl headers{{"x-token", std::string(32, 'a')}};
+  for (int i = 0; i < 3; ++i) {
+    std::vector<nghttp2_nv> nva;
+    interner.buildHeaders(nva, headers);
+    ASSERT_EQ(1U, nva.size());
+    EXPECT_EQ(0, nva[0].flags);
+  }
+  EXPECT_EQ(0U, interner.size());
+}
+
+TEST(HeaderInternerTest, ReferenceHeadersAreNotCopied) {
+  HeaderInterner interner;
+  const LowerCaseString key("x-static");
+  const std::string value("static");
+  ResponseHeaderMapImpl headers;
+  headers.addReference(key, value);
+
+  for (int i = 0; i < 3; ++i) {
+    std::vector<nghttp2_nv> nva;
+    interner.buildHeaders(nva, headers);
+    ASSERT_EQ(1U, nva.size());
+    EXPECT_EQ(NoCopy, nva[0].flags);
+    EXPECT_EQ(value.data(), reinterpret_cast<const char*>(nva[0].value));
+  }
+  EXPECT_EQ(0U, interner.size());
+}
+
+} // namespace
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
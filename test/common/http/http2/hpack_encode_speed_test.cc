@@ -0,0 +1,119 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <memory>
+#include <vector>
+
+#include "common/http/header_map_impl.h"
+#include "common/http/http2/header_interner.h"
+
+#include "benchmark/benchmark.h"
+#include "nghttp2/nghttp2.h"
+
+namespace Envoy {
+namespace Http {
+namespace Http2 {
+
+/**
+ * Minimal nghttp2 session which HPACK encodes submitted header blocks and discards the output.
+ * A client session is used since it can open streams without a peer; header blocks are deflated
+ * the same way for both session types.
+ */
+class HpackEncoder {
+public:
+  HpackEncoder() {
+    nghttp2_session_callbacks* callbacks;
+    nghttp2_session_callbacks_new(&callbacks);
+    nghttp2_session_callbacks_set_send_callback(
+        callbacks,
+        [](nghttp2_session*, const uint8_t*, size_t length, int, void* user_data) -> ssize_t {
+          static_cast<HpackEncoder*>(user_data)->bytes_sent_ += length;
+          return length;
+        });
+    nghttp2_session_client_new(&session_, callbacks, this);
+    nghttp2_session_callbacks_del(callbacks);
+  }
+  ~HpackEncoder() { nghttp2_session_del(session_); }
+
+  void encode(const std::vector<nghttp2_nv>& final_headers) {
+    nghttp2_submit_headers(session_, NGHTTP2_FLAG_END_STREAM, -1, nullptr, final_headers.data(),
+                           final_headers.size(), nullptr);
+    nghttp2_session_send(session_);
+  }
+
+  uint64_t bytes_sent_{};
+
+private:
+  nghttp2_session* session_;
+};
+
+/**
+ * Populate a typical response header block. Values are copied into the map as they would be for a
+ * proxied response.
+ */
+static void addResponseHeaders(ResponseHeaderMapImpl& headers) {
+  headers.setStatus(200);
+  headers.addCopy(LowerCaseString("date"), "Wed, 23 Jan 2019 04:00:00 GMT");
+  headers.addCopy(LowerCaseString("server"), "envoy");
+  headers.addCopy(LowerCaseString("content-type"), "application/json");
+  headers.addCopy(LowerCaseString("content-length"), "1024");
+  headers.addCopy(LowerCaseString("cache-control"), "private, max-age=0");
+  headers.addCopy(LowerCaseString("x-envoy-upstream-service-time"), "3");
+  headers.addCopy(LowerCaseString("x-custom-header-1"), "example 1");
+  headers.addCopy(LowerCaseString("x-custom-header-2"), "example 2");
+}
+
+// Connections are rolled over periodically so that stream state in the session does not grow
+// without bound; each new connection starts with an empty HPACK table and interning table.
+static constexpr uint32_t StreamsPerConnection = 1000;
+
+/**
+ * Measure building nghttp2 header arrays and HPACK encoding a response header block. The Arg
+ * selects whether recurring header pairs are interned (1) or copied by nghttp2 for every
+ * stream (0).
+ */
+static void HpackEncodeResponseHeaders(benchmark::State& state) {
+  const bool intern = state.range(0) != 0;
+  ResponseHeaderMapImpl headers;
+  addResponseHeaders(headers);
+
+  std::unique_ptr<HeaderInterner> interner;
+  std::unique_ptr<HpackEncoder> encoder;
+  uint64_t bytes_sent = 0;
+  uint32_t streams = 0;
+  for (auto _ : state) {
+    if (streams++ % StreamsPerConnection == 0) {
+      if (encoder != nullptr) {
+        bytes_sent += encoder->bytes_sent_;
+      }
+      // The interner must outlive the session that references it.
+      encoder.reset();
+      interner = std::make_unique<HeaderInterner>();
+      encoder = std::make_unique<HpackEncoder>();
+    }
+
+    std::vector<nghttp2_nv> final_headers;
+    if (intern) {
+      interner->buildHeaders(final_headers, headers);
+    } else {
+      final_headers.reserve(headers.size());
+      headers.iterate(
+          [](const HeaderEntry& header, void* context) -> HeaderMap::Iterate {
+            HeaderInterner::insertHeader(*static_cast<std::vector<nghttp2_nv>*>(context), header);
+            return HeaderMap::Iterate::Continue;
+          },
+          &final_headers);
+    }
+    encoder->encode(final_headers);
+  }
+  if (encoder != nullptr) {
+    bytes_sent += encoder->bytes_sent_;
+  }
+  state.counters["bytes_per_stream"] =
+      benchmark::Counter(bytes_sent, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(HpackEncodeResponseHeaders)->Arg(0)->Arg(1);
+
+} // namespace Http2
+} // namespace Http
+} // namespace Envoy
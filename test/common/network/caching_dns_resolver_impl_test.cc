@@ -0,0 +1,288 @@
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+
+#include "envoy/config/bootstrap/v3/bootstrap.pb.h"
+
+#include "common/network/caching_dns_resolver_impl.h"
+#include "common/network/utility.h"
+#include "common/stats/isolated_store_impl.h"
+
+#include "test/mocks/network/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::Invoke;
+using testing::Return;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class CachingDnsResolverImplTest : public testing::Test {
+public:
+  void initialize() {
+    resolver_ = std::make_unique<CachingDnsResolverImpl>(mock_resolver_, time_system_, store_,
+                                                         config_);
+  }
+
+  // Resolves the name, recording the status and the addresses which the callback is called with.
+  ActiveDnsQuery* resolve(const std::string& name) {
+    return resolver_->resolve(
+        name, DnsLookupFamily::V4Only,
+        [this](DnsResolver::ResolutionStatus status, std::list<DnsResponse>&& response) {
+          statuses_.push_back(status);
+          responses_.push_back(std::move(response));
+        });
+  }
+
+  // Expects a lookup of the name by the wrapped resolver, whose callback is saved in callback_.
+  void expectLookup(const std::string& name) {
+    EXPECT_CALL(*mock_resolver_, resolve(name, DnsLookupFamily::V4Only, _))
+        .WillOnce(DoAll(SaveArg<2>(&callback_), Return(&mock_resolver_->active_query_)));
+  }
+
+  static std::list<DnsResponse> makeResponse(const std::string& address,
+                                             std::chrono::seconds ttl) {
+    std::list<DnsResponse> response;
+    response.emplace_back(Utility::parseInternetAddress(address), ttl);
+    return response;
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(store_, "dns_resolver_cache." + name)->value();
+  }
+
+  envoy::config::bootstrap::v3::DnsCache config_;
+  std::shared_ptr<MockDnsResolver> mock_resolver_{std::make_shared<MockDnsResolver>()};
+  Event::SimulatedTimeSystem time_system_;
+  Stats::IsolatedStoreImpl store_;
+  std::unique_ptr<CachingDnsResolverImpl> resolver_;
+  DnsResolver::ResolveCb callback_;
+  std::vector<DnsResolver::ResolutionStatus> statuses_;
+  std::vector<std::list<DnsResponse>> responses_;
+};
+
+// Concurrent lookups of a name go to the wrapped resolver once, and later ones hit the cache.
+TEST_F(CachingDnsResolverImplTest, CoalesceAndCache) {
+  initialize();
+  expectLookup("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  EXPECT_TRUE(statuses_.empty());
+
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(30)));
+  ASSERT_EQ(2, responses_.size());
+  for (const auto& response : responses_) {
+    ASSERT_EQ(1, response.size());
+    EXPECT_EQ("10.0.0.1:0", response.front().address_->asString());
+    EXPECT_EQ(std::chrono::seconds(30), response.front().ttl_);
+  }
+
+  // The cache hands out the remaining part of the TTL.
+  time_system_.sleep(std::chrono::seconds(10));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  ASSERT_EQ(3, responses_.size());
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_.back());
+  EXPECT_EQ(std::chrono::seconds(20), responses_.back().front().ttl_);
+
+  // Once the answer expired, the name is looked up again.
+  time_system_.sleep(std::chrono::seconds(20));
+  expectLookup("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+
+  EXPECT_EQ(2, counter("misses"));
+  EXPECT_EQ(1, counter("coalesced"));
+  EXPECT_EQ(1, counter("hits"));
+  EXPECT_EQ(0, TestUtility::findGauge(store_, "dns_resolver_cache.num_entries")->value());
+}
+
+// The TTL of answers is clamped to the configured range, and answers with a TTL of 0 are not
+// cached.
+TEST_F(CachingDnsResolverImplTest, TtlBounds) {
+  config_.mutable_max_ttl()->set_seconds(60);
+  config_.mutable_prefetch_threshold()->set_value(0);
+  initialize();
+
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(3600)));
+  time_system_.sleep(std::chrono::seconds(59));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  time_system_.sleep(std::chrono::seconds(1));
+  expectLookup("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(0)));
+  expectLookup("foo.com");
+  EXPECT_NE(nullptr, resolve("foo.com"));
+
+  config_.mutable_min_ttl()->set_seconds(5);
+  initialize();
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(0)));
+  time_system_.sleep(std::chrono::seconds(4));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+}
+
+// Failures and empty answers are cached for the negative TTL.
+TEST_F(CachingDnsResolverImplTest, NegativeCaching) {
+  initialize();
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Failure, {});
+
+  time_system_.sleep(std::chrono::seconds(4));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+  EXPECT_EQ(1, counter("negative_hits"));
+
+  time_system_.sleep(std::chrono::seconds(1));
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Success, {});
+  // Empty answers are replayed with the status they came with.
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_.back());
+  EXPECT_TRUE(responses_.back().empty());
+  EXPECT_EQ(2, counter("negative_hits"));
+}
+
+// A hit close to expiry is served from the cache and looks the name up again in the background.
+TEST_F(CachingDnsResolverImplTest, Prefetch) {
+  initialize();
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(100)));
+
+  time_system_.sleep(std::chrono::seconds(85));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(0, counter("prefetches"));
+
+  time_system_.sleep(std::chrono::seconds(10));
+  expectLookup("foo.com");
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  // The prefetch is already pending.
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1, counter("prefetches"));
+  EXPECT_EQ(4, statuses_.size());
+
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.2", std::chrono::seconds(100)));
+  EXPECT_EQ(4, statuses_.size());
+  time_system_.sleep(std::chrono::seconds(50));
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ("10.0.0.2:0", responses_.back().front().address_->asString());
+  EXPECT_EQ(std::chrono::seconds(50), responses_.back().front().ttl_);
+}
+
+// A failed prefetch keeps the answer it was to replace.
+TEST_F(CachingDnsResolverImplTest, PrefetchFailure) {
+  initialize();
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(100)));
+
+  time_system_.sleep(std::chrono::seconds(95));
+  expectLookup("foo.com");
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(1, counter("prefetches"));
+  callback_(DnsResolver::ResolutionStatus::Failure, {});
+
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Success, statuses_.back());
+  EXPECT_EQ("10.0.0.1:0", responses_.back().front().address_->asString());
+  EXPECT_EQ(0, counter("negative_hits"));
+
+  // Once the answer expired, the failure of the next lookup is cached.
+  time_system_.sleep(std::chrono::seconds(5));
+  expectLookup("foo.com");
+  resolve("foo.com");
+  callback_(DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(DnsResolver::ResolutionStatus::Failure, statuses_.back());
+  EXPECT_EQ(1, counter("negative_hits"));
+}
+
+// The lookup of the wrapped resolver is cancelled along with the last of its waiters.
+TEST_F(CachingDnsResolverImplTest, Cancel) {
+  initialize();
+  expectLookup("foo.com");
+  ActiveDnsQuery* first = resolve("foo.com");
+  ActiveDnsQuery* second = resolve("foo.com");
+
+  EXPECT_CALL(mock_resolver_->active_query_, cancel()).Times(0);
+  first->cancel();
+  EXPECT_CALL(mock_resolver_->active_query_, cancel());
+  second->cancel();
+
+  expectLookup("foo.com");
+  first = resolve("foo.com");
+  resolve("foo.com");
+  first->cancel();
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.1", std::chrono::seconds(30)));
+  EXPECT_EQ(1, statuses_.size());
+}
+
+// Lookups which the wrapped resolver completes inline complete inline.
+TEST_F(CachingDnsResolverImplTest, InlineCompletion) {
+  initialize();
+  EXPECT_CALL(*mock_resolver_, resolve("10.0.0.1", DnsLookupFamily::V4Only, _))
+      .WillOnce(Invoke([](const std::string&, DnsLookupFamily, DnsResolver::ResolveCb callback) {
+        callback(DnsResolver::ResolutionStatus::Success,
+                 makeResponse("10.0.0.1", std::chrono::seconds(30)));
+        return nullptr;
+      }));
+  EXPECT_EQ(nullptr, resolve("10.0.0.1"));
+  EXPECT_EQ(nullptr, resolve("10.0.0.1"));
+  EXPECT_EQ(2, statuses_.size());
+  EXPECT_EQ(1, counter("hits"));
+}
+
+// A full cache evicts the least recently used answer to make room for a new one.
+TEST_F(CachingDnsResolverImplTest, Eviction) {
+  config_.mutable_max_entries()->set_value(2);
+  initialize();
+  for (const std::string name : {"foo.com", "bar.com"}) {
+    expectLookup(name);
+    resolve(name);
+    callback_(DnsResolver::ResolutionStatus::Success,
+              makeResponse("10.0.0.1", std::chrono::seconds(30)));
+  }
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+
+  expectLookup("baz.com");
+  resolve("baz.com");
+  callback_(DnsResolver::ResolutionStatus::Success,
+            makeResponse("10.0.0.2", std::chrono::seconds(60)));
+  EXPECT_EQ(1, counter("evictions"));
+  EXPECT_EQ(2, TestUtility::findGauge(store_, "dns_resolver_cache.num_entries")->value());
+  EXPECT_EQ(nullptr, resolve("foo.com"));
+  EXPECT_EQ(nullptr, resolve("baz.com"));
+  expectLookup("bar.com");
+  EXPECT_NE(nullptr, resolve("bar.com"));
+}
+
+TEST_F(CachingDnsResolverImplTest, MinTtlAboveMaxTtl) {
+  config_.mutable_min_ttl()->set_seconds(600);
+  EXPECT_THROW_WITH_MESSAGE(initialize(), EnvoyException,
+                            "DNS cache min_ttl of 600000ms exceeds its max_ttl of 300000ms");
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
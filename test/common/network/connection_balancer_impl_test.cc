@@ -0,0 +1,89 @@
+#include <atomic>
+
+#include "common/network/connection_balancer_impl.h"
+
+#include "test/mocks/runtime/mocks.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class TestBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  explicit TestBalancedConnectionHandler(uint64_t num_connections)
+      : num_connections_(num_connections) {}
+
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(Network::ConnectionSocketPtr&&) override {}
+
+  std::atomic<uint64_t> num_connections_;
+};
+
+class TwoChoiceConnectionBalancerTest : public testing::Test {
+public:
+  NiceMock<Runtime::MockRandomGenerator> random_;
+  TwoChoiceConnectionBalancerImpl balancer_{random_};
+  TestBalancedConnectionHandler handler0_{0};
+  TestBalancedConnectionHandler handler1_{0};
+  TestBalancedConnectionHandler handler2_{0};
+};
+
+// With a single handler there is nothing to choose from.
+TEST_F(TwoChoiceConnectionBalancerTest, SingleHandler) {
+  balancer_.registerHandler(handler0_);
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(1U, handler0_.numConnections());
+}
+
+TEST_F(TwoChoiceConnectionBalancerTest, PicksLessLoadedHandler) {
+  balancer_.registerHandler(handler0_);
+  balancer_.registerHandler(handler1_);
+  balancer_.registerHandler(handler2_);
+  handler0_.num_connections_ = 5;
+  handler1_.num_connections_ = 7;
+  handler2_.num_connections_ = 3;
+
+  // The other handler has more connections, so the connection stays.
+  EXPECT_CALL(random_, random()).WillOnce(Return(4));
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(6U, handler0_.numConnections());
+
+  // Picking the current handler keeps the connection as well.
+  EXPECT_CALL(random_, random()).WillOnce(Return(3));
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(7U, handler0_.numConnections());
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(5));
+  EXPECT_EQ(&handler2_, &balancer_.pickTargetHandler(handler0_));
+  EXPECT_EQ(7U, handler0_.numConnections());
+  EXPECT_EQ(4U, handler2_.numConnections());
+}
+
+// Unregistered handlers are no longer picked.
+TEST_F(TwoChoiceConnectionBalancerTest, UnregisterHandler) {
+  balancer_.registerHandler(handler0_);
+  balancer_.registerHandler(handler1_);
+  balancer_.registerHandler(handler2_);
+  balancer_.unregisterHandler(handler1_);
+  handler0_.num_connections_ = 5;
+
+  EXPECT_CALL(random_, random()).WillOnce(Return(1));
+  EXPECT_EQ(&handler2_, &balancer_.pickTargetHandler(handler0_));
+
+  balancer_.unregisterHandler(handler2_);
+  EXPECT_CALL(random_, random()).Times(0);
+  EXPECT_EQ(&handler0_, &balancer_.pickTargetHandler(handler0_));
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
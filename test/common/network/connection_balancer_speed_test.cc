@@ -0,0 +1,87 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how many connections per second the connection balancers can place when every worker
+// accepts connections at the same time.
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/network/connection_balancer_impl.h"
+#include "common/runtime/runtime_impl.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+// Connections each worker keeps open, the oldest one is closed for every new one.
+constexpr uint32_t OpenConnectionsPerWorker = 1000;
+
+class TestBalancedConnectionHandler : public BalancedConnectionHandler {
+public:
+  // Network::BalancedConnectionHandler
+  uint64_t numConnections() const override { return num_connections_; }
+  void incNumConnections() override { ++num_connections_; }
+  void post(Network::ConnectionSocketPtr&&) override {}
+
+  void decNumConnections() { --num_connections_; }
+
+private:
+  std::atomic<uint64_t> num_connections_{};
+};
+
+Runtime::RandomGeneratorImpl random_generator;
+std::unique_ptr<ConnectionBalancer> balancer;
+std::vector<std::unique_ptr<TestBalancedConnectionHandler>> handlers;
+
+std::unique_ptr<ConnectionBalancer> createBalancer(int64_t type) {
+  if (type == 0) {
+    return std::make_unique<ExactConnectionBalancerImpl>();
+  }
+  return std::make_unique<TwoChoiceConnectionBalancerImpl>(random_generator);
+}
+
+} // namespace
+
+// Args: 0 for the exact balancer, 1 for the two choice balancer. Runs with one thread per worker.
+static void BM_PickTargetHandler(benchmark::State& state) {
+  if (state.thread_index == 0) {
+    balancer = createBalancer(state.range(0));
+    handlers.clear();
+    for (int i = 0; i < state.threads; ++i) {
+      handlers.push_back(std::make_unique<TestBalancedConnectionHandler>());
+      balancer->registerHandler(*handlers.back());
+    }
+  }
+
+  std::vector<TestBalancedConnectionHandler*> open_connections(OpenConnectionsPerWorker);
+  uint32_t next = 0;
+  for (auto _ : state) {
+    TestBalancedConnectionHandler& current_handler = *handlers[state.thread_index];
+    TestBalancedConnectionHandler*& connection = open_connections[next++ % open_connections.size()];
+    if (connection != nullptr) {
+      connection->decNumConnections();
+    }
+    connection = static_cast<TestBalancedConnectionHandler*>(
+        &balancer->pickTargetHandler(current_handler));
+  }
+  for (TestBalancedConnectionHandler* connection : open_connections) {
+    if (connection != nullptr) {
+      connection->decNumConnections();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index == 0) {
+    for (const auto& handler : handlers) {
+      balancer->unregisterHandler(*handler);
+    }
+  }
+}
+BENCHMARK(BM_PickTargetHandler)->Arg(0)->Arg(1)->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+
+} // namespace Network
+} // namespace Envoy
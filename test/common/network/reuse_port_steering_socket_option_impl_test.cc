@@ -0,0 +1,250 @@
+#include <algorithm>
+
+#include "envoy/common/platform.h"
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/listener/v3/listener.pb.h"
+
+#include "common/network/io_socket_handle_impl.h"
+#include "common/network/reuse_port_steering_socket_option_impl.h"
+
+#include "test/common/network/socket_option_test.h"
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+#include "common/api/os_sys_calls_impl_linux.h"
+#endif
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+using testing::Return;
+using testing::ReturnRef;
+
+// A listen socket with its own fd, as the option puts the fd of the socket into the map.
+class TestListenSocket {
+public:
+  explicit TestListenSocket(os_fd_t fd) : io_handle_(fd) {
+    ON_CALL(socket_, ioHandle()).WillByDefault(ReturnRef(io_handle_));
+    ON_CALL(testing::Const(socket_), ioHandle()).WillByDefault(ReturnRef(io_handle_));
+  }
+
+  IoSocketHandleImpl io_handle_;
+  NiceMock<MockListenSocket> socket_;
+};
+
+class ReusePortSteeringSocketOptionImplTest : public SocketOptionTest {
+public:
+  ReusePortSteeringSocketOptionImplTest() {
+    // The fds of the sockets, the maps and the programs are closed through the mock.
+    EXPECT_CALL(os_sys_calls_, close(_))
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(Api::SysCallIntResult{0, 0}));
+  }
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+  struct MapUpdate {
+    int map_fd_;
+    uint32_t key_;
+    uint64_t value_;
+  };
+
+  // Plays the kernel side of bpf(2): hands out the given fds for the next map and program, keeps
+  // the attributes and the program they are created with, and records the updates of the maps.
+  void expectLoad(int map_fd, int prog_fd) {
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, sizeof(bpf_attr)))
+        .WillOnce(Invoke([this, map_fd](int, bpf_attr* attr, unsigned int) {
+          map_attr_ = *attr;
+          return Api::SysCallIntResult{map_fd, 0};
+        }));
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, sizeof(bpf_attr)))
+        .WillOnce(Invoke([this, prog_fd](int, bpf_attr* attr, unsigned int) {
+          prog_type_ = attr->prog_type;
+          const auto* insns = reinterpret_cast<const bpf_insn*>(attr->insns);
+          program_.assign(insns, insns + attr->insn_cnt);
+          return Api::SysCallIntResult{prog_fd, 0};
+        }));
+    ON_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, sizeof(bpf_attr)))
+        .WillByDefault(Invoke([this](int, bpf_attr* attr, unsigned int) {
+          EXPECT_EQ(static_cast<uint64_t>(BPF_ANY), attr->flags);
+          map_updates_.push_back({static_cast<int>(attr->map_fd),
+                                  *reinterpret_cast<const uint32_t*>(attr->key),
+                                  *reinterpret_cast<const uint64_t*>(attr->value)});
+          return Api::SysCallIntResult{0, 0};
+        }));
+  }
+
+  // Expects the program to be attached to the socket once it listens.
+  void expectListen(const ReusePortSteeringSocketOptionImpl& socket_option,
+                    TestListenSocket& listen_socket, int prog_fd) {
+    EXPECT_CALL(os_sys_calls_, setsockopt_(listen_socket.io_handle_.fd(), SOL_SOCKET,
+                                           SO_ATTACH_REUSEPORT_EBPF, _, sizeof(int)))
+        .WillOnce(Invoke([prog_fd](os_fd_t, int, int, const void* optval, socklen_t) -> int {
+          EXPECT_EQ(prog_fd, *static_cast<const int*>(optval));
+          return 0;
+        }));
+    EXPECT_TRUE(socket_option.setOption(listen_socket.socket_,
+                                        envoy::config::core::v3::SocketOption::STATE_LISTENING));
+  }
+
+  bool hasInstruction(uint8_t code, int32_t imm) const {
+    return std::any_of(program_.begin(), program_.end(), [code, imm](const bpf_insn& insn) {
+      return insn.code == code && insn.imm == imm;
+    });
+  }
+
+  // Checks the part of the program which selects the socket out of the map.
+  void checkSelect(uint32_t socket_count, int map_fd) const {
+    EXPECT_TRUE(hasInstruction(BPF_ALU | BPF_MOD | BPF_K, socket_count));
+    EXPECT_TRUE(hasInstruction(BPF_JMP | BPF_CALL, BPF_FUNC_sk_select_reuseport));
+    const auto map_load =
+        std::find_if(program_.begin(), program_.end(), [](const bpf_insn& insn) {
+          return insn.code == (BPF_LD | BPF_DW | BPF_IMM);
+        });
+    ASSERT_NE(program_.end(), map_load);
+    EXPECT_EQ(BPF_PSEUDO_MAP_FD, static_cast<int>(map_load->src_reg));
+    EXPECT_EQ(map_fd, map_load->imm);
+    // Connections are passed on whether a socket was selected or not.
+    ASSERT_LE(2U, program_.size());
+    EXPECT_EQ(BPF_ALU64 | BPF_MOV | BPF_K, program_[program_.size() - 2].code);
+    EXPECT_EQ(SK_PASS, program_[program_.size() - 2].imm);
+    EXPECT_EQ(BPF_JMP | BPF_EXIT, program_.back().code);
+  }
+
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls_;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls_{&linux_os_sys_calls_};
+  bpf_attr map_attr_{};
+  uint32_t prog_type_{};
+  std::vector<bpf_insn> program_;
+  std::vector<MapUpdate> map_updates_;
+#endif
+};
+
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+// Sockets are only added to the map and attached to once they listen.
+TEST_F(ReusePortSteeringSocketOptionImplTest, OnlyAppliedWhenListening) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 4};
+  TestListenSocket listen_socket(10);
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_TRUE(socket_option.setOption(listen_socket.socket_,
+                                      envoy::config::core::v3::SocketOption::STATE_PREBIND));
+  EXPECT_TRUE(socket_option.setOption(listen_socket.socket_,
+                                      envoy::config::core::v3::SocketOption::STATE_BOUND));
+  EXPECT_TRUE(map_updates_.empty());
+}
+
+TEST_F(ReusePortSteeringSocketOptionImplTest, SourceIp) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::SOURCE_IP,
+                                                  4};
+  EXPECT_TRUE(socket_option.isSupported());
+  EXPECT_EQ(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, map_attr_.map_type);
+  EXPECT_EQ(sizeof(uint32_t), map_attr_.key_size);
+  EXPECT_EQ(sizeof(uint64_t), map_attr_.value_size);
+  EXPECT_EQ(4U, map_attr_.max_entries);
+  EXPECT_EQ(BPF_PROG_TYPE_SK_REUSEPORT, prog_type_);
+  EXPECT_TRUE(hasInstruction(BPF_JMP | BPF_CALL, BPF_FUNC_skb_load_bytes_relative));
+  checkSelect(4, 100);
+}
+
+TEST_F(ReusePortSteeringSocketOptionImplTest, Cpu) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 3};
+  EXPECT_EQ(3U, map_attr_.max_entries);
+  EXPECT_TRUE(hasInstruction(BPF_JMP | BPF_CALL, BPF_FUNC_get_smp_processor_id));
+  checkSelect(3, 100);
+}
+
+// A hot restart child, or a new version of a listener, joins the group of the sockets the parent
+// still listens on. Each of them only puts its own sockets into its own map, so the program the
+// child attaches last never selects a socket of the parent.
+TEST_F(ReusePortSteeringSocketOptionImplTest, ParentAndChildShareGroup) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl parent_option{envoy::config::listener::v3::Listener::CPU, 2};
+  TestListenSocket parent_socket_0(10);
+  TestListenSocket parent_socket_1(11);
+  expectListen(parent_option, parent_socket_0, 101);
+  expectListen(parent_option, parent_socket_1, 101);
+
+  expectLoad(200, 201);
+  ReusePortSteeringSocketOptionImpl child_option{envoy::config::listener::v3::Listener::CPU, 2};
+  checkSelect(2, 200);
+  TestListenSocket child_socket_0(20);
+  TestListenSocket child_socket_1(21);
+  expectListen(child_option, child_socket_0, 201);
+  expectListen(child_option, child_socket_1, 201);
+
+  ASSERT_EQ(4U, map_updates_.size());
+  for (uint32_t slot = 0; slot < 2; ++slot) {
+    EXPECT_EQ(100, map_updates_[slot].map_fd_);
+    EXPECT_EQ(slot, map_updates_[slot].key_);
+    EXPECT_EQ(10 + slot, map_updates_[slot].value_);
+    EXPECT_EQ(200, map_updates_[2 + slot].map_fd_);
+    EXPECT_EQ(slot, map_updates_[2 + slot].key_);
+    EXPECT_EQ(20 + slot, map_updates_[2 + slot].value_);
+  }
+}
+
+// Sockets beyond the size of the map are still attached to, but never selected by the program.
+TEST_F(ReusePortSteeringSocketOptionImplTest, MoreSocketsThanSlots) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 1};
+  TestListenSocket listen_socket_0(10);
+  TestListenSocket listen_socket_1(11);
+  expectListen(socket_option, listen_socket_0, 101);
+  EXPECT_LOG_CONTAINS("warning", "slots of the reuse_port_steering map are taken",
+                      expectListen(socket_option, listen_socket_1, 101));
+  ASSERT_EQ(1U, map_updates_.size());
+  EXPECT_EQ(10U, map_updates_[0].value_);
+}
+
+// Without the program, e.g. as the process lacks the privileges to load it, the kernel picks the
+// sockets.
+TEST_F(ReusePortSteeringSocketOptionImplTest, LoadFailure) {
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{100, 0}));
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_PROG_LOAD, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EPERM}));
+  EXPECT_CALL(os_sys_calls_, close(100));
+  EXPECT_LOG_CONTAINS("warning", "Loading the reuse_port_steering program failed", {
+    ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 2};
+    EXPECT_FALSE(socket_option.isSupported());
+    TestListenSocket listen_socket(10);
+    EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _)).Times(0);
+    EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+    EXPECT_TRUE(socket_option.setOption(listen_socket.socket_,
+                                        envoy::config::core::v3::SocketOption::STATE_LISTENING));
+    EXPECT_FALSE(socket_option
+                     .getOptionDetails(listen_socket.socket_,
+                                       envoy::config::core::v3::SocketOption::STATE_LISTENING)
+                     .has_value());
+  });
+}
+
+TEST_F(ReusePortSteeringSocketOptionImplTest, MapUpdateFailure) {
+  expectLoad(100, 101);
+  ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 2};
+  TestListenSocket listen_socket(10);
+  EXPECT_CALL(linux_os_sys_calls_, bpf(BPF_MAP_UPDATE_ELEM, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{-1, EINVAL}));
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+  EXPECT_LOG_CONTAINS("warning", "Adding socket to the reuse_port_steering map failed",
+                      EXPECT_FALSE(socket_option.setOption(
+                          listen_socket.socket_,
+                          envoy::config::core::v3::SocketOption::STATE_LISTENING)));
+}
+#else
+TEST_F(ReusePortSteeringSocketOptionImplTest, Unsupported) {
+  EXPECT_LOG_CONTAINS("warning", "reuse_port_steering is not supported on this platform", {
+    ReusePortSteeringSocketOptionImpl socket_option{envoy::config::listener::v3::Listener::CPU, 2};
+    EXPECT_FALSE(socket_option.isSupported());
+    EXPECT_CALL(os_sys_calls_, setsockopt_(_, _, _, _, _)).Times(0);
+    EXPECT_TRUE(socket_option.setOption(socket_,
+                                        envoy::config::core::v3::SocketOption::STATE_LISTENING));
+  });
+}
+#endif
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
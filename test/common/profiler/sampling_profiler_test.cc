@@ -0,0 +1,77 @@
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+
+#include "common/common/utility.h"
+#include "common/profiler/sampling_profiler.h"
+
+#include "absl/strings/numbers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Profiler {
+namespace {
+
+TEST(SamplingCpuTest, InvalidFrequency) {
+  EXPECT_FALSE(SamplingCpu::start(0));
+  EXPECT_FALSE(SamplingCpu::start(1001));
+  EXPECT_FALSE(SamplingCpu::isRunning());
+  // Stopping a profiler that is not running is a no-op.
+  SamplingCpu::stop();
+}
+
+TEST(SamplingCpuTest, CollapsedStacks) {
+  if (!SamplingCpu::profilerAvailable()) {
+    return;
+  }
+
+  ASSERT_TRUE(SamplingCpu::start(1000));
+  // Keep the CPU busy for long enough to get a handful of samples.
+  const auto start = std::chrono::steady_clock::now();
+  volatile uint64_t sum = 0;
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) {
+    sum = sum + 1;
+  }
+  SamplingCpu::stop();
+
+  const std::string stacks = SamplingCpu::collapsedStacks(std::chrono::seconds(60), true);
+  EXPECT_THAT(stacks, testing::StartsWith("thread_"));
+  // Every line is a stack followed by a sample count.
+  for (absl::string_view line : StringUtil::splitToken(stacks, "\n")) {
+    uint64_t count;
+    EXPECT_TRUE(absl::SimpleAtoi(line.substr(line.rfind(' ') + 1), &count)) << line;
+    EXPECT_GT(count, 0U);
+  }
+  // Samples older than the window are left out.
+  EXPECT_EQ("", SamplingCpu::collapsedStacks(std::chrono::seconds(0), false));
+}
+
+#ifdef SAMPLING_PROFILER_AVAILABLE
+// Stopping the profiler restores the disposition SIGPROF had before it was started, including the
+// default one.
+TEST(SamplingCpuTest, RestoresSignalDisposition) {
+  struct sigaction original;
+  ASSERT_EQ(0, sigaction(SIGPROF, nullptr, &original));
+  struct sigaction default_action;
+  std::memset(&default_action, 0, sizeof(default_action));
+  default_action.sa_handler = SIG_DFL;
+  ASSERT_EQ(0, sigaction(SIGPROF, &default_action, nullptr));
+
+  ASSERT_TRUE(SamplingCpu::start(1000));
+  struct sigaction current;
+  ASSERT_EQ(0, sigaction(SIGPROF, nullptr, &current));
+  EXPECT_TRUE(current.sa_flags & SA_SIGINFO);
+  SamplingCpu::stop();
+
+  ASSERT_EQ(0, sigaction(SIGPROF, nullptr, &current));
+  EXPECT_FALSE(current.sa_flags & SA_SIGINFO);
+  EXPECT_EQ(SIG_DFL, current.sa_handler);
+  ASSERT_EQ(0, sigaction(SIGPROF, &original, nullptr));
+}
+#endif
+
+} // namespace
+} // namespace Profiler
+} // namespace Envoy
@@ -0,0 +1,149 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Simulates request latency against an upstream which closes every connection after a single
+// request, so that the pool has to keep replacing its connections. Each iteration is one tick of
+// simulated time in which one request arrives, and connections take connect_delay ticks to
+// connect. The wait_ticks counter reports the average number of ticks a request waited for a
+// connection, comparing connections opened on demand against connections prefetched to keep
+// min_idle of them around; connections_per_request reports what the prefetching costs.
+
+#include <list>
+
+#include "common/tcp/conn_pool.h"
+
+#include "test/common/upstream/utility.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/network/mocks.h"
+#include "test/mocks/upstream/mocks.h"
+
+#include "benchmark/benchmark.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Tcp {
+namespace {
+
+// Don't inherit from the mock implementation at all, because a timer is created for every
+// connection, and none of them ever fires.
+class FastMockTimer : public Event::Timer {
+public:
+  void disableTimer() override {}
+  void enableTimer(const std::chrono::milliseconds&, const ScopeTrackedObject*) override {}
+  void enableHRTimer(const std::chrono::microseconds&, const ScopeTrackedObject*) override {}
+  bool enabled() override { return false; }
+};
+
+// Hands out upstream connections which connect after a fixed number of ticks.
+class FakeUpstreamDispatcher : public Event::MockDispatcher {
+public:
+  FakeUpstreamDispatcher(uint64_t connect_delay, const uint64_t& now)
+      : connect_delay_(connect_delay), now_(now) {}
+
+  Event::TimerPtr createTimer(Event::TimerCb) override { return std::make_unique<FastMockTimer>(); }
+
+  Network::ClientConnectionPtr
+  createClientConnection(Network::Address::InstanceConstSharedPtr,
+                         Network::Address::InstanceConstSharedPtr, Network::TransportSocketPtr&&,
+                         const Network::ConnectionSocket::OptionsSharedPtr&) override {
+    auto connection = std::make_unique<NiceMock<Network::MockClientConnection>>();
+    connecting_.emplace_back(connection.get(), now_ + connect_delay_);
+    connections_created_++;
+    return connection;
+  }
+
+  // Raises the connected event on the connections whose connect delay has passed.
+  void completeConnects() {
+    while (!connecting_.empty() && connecting_.front().second <= now_) {
+      Network::MockClientConnection* connection = connecting_.front().first;
+      connecting_.pop_front();
+      connection->raiseEvent(Network::ConnectionEvent::Connected);
+    }
+  }
+
+  const uint64_t connect_delay_;
+  const uint64_t& now_;
+  std::list<std::pair<Network::MockClientConnection*, uint64_t>> connecting_;
+  uint64_t connections_created_{};
+};
+
+class Request : public ConnectionPool::Callbacks {
+public:
+  Request(uint64_t& total_wait, uint64_t arrival, const uint64_t& now)
+      : total_wait_(total_wait), arrival_(arrival), now_(now) {}
+
+  // ConnectionPool::Callbacks
+  // Requests only fail when the pool closes its connections on destruction.
+  void onPoolFailure(ConnectionPool::PoolFailureReason,
+                     Upstream::HostDescriptionConstSharedPtr) override {}
+  void onPoolReady(ConnectionPool::ConnectionDataPtr&& conn_data,
+                   Upstream::HostDescriptionConstSharedPtr) override {
+    total_wait_ += now_ - arrival_;
+    conn_data_ = std::move(conn_data);
+  }
+
+  uint64_t& total_wait_;
+  const uint64_t arrival_;
+  const uint64_t& now_;
+  ConnectionPool::ConnectionDataPtr conn_data_;
+};
+
+static void BM_ConnPoolUpstreamChurn(benchmark::State& state) {
+  const uint64_t connect_delay = state.range(0);
+  const uint32_t min_idle_connections = state.range(1);
+
+  uint64_t now = 0;
+  uint64_t total_wait = 0;
+  uint64_t requests_served = 0;
+  NiceMock<FakeUpstreamDispatcher> dispatcher(connect_delay, now);
+  auto cluster = std::make_shared<NiceMock<Upstream::MockClusterInfo>>();
+  cluster->resetResourceManager(1024, 1024, 1024, 1, 1);
+  cluster->max_requests_per_connection_ = 1;
+  cluster->prefetch_min_idle_connections_ = min_idle_connections;
+  std::list<Request> requests;
+  auto pool = std::make_unique<ConnPoolImpl>(
+      dispatcher, Upstream::makeTestHost(cluster, "tcp://127.0.0.1:9000"),
+      Upstream::ResourcePriority::Default, nullptr, nullptr);
+
+  // Releases the requests which got a connection, which the upstream then closes.
+  auto release_served = [&]() {
+    for (auto it = requests.begin(); it != requests.end();) {
+      if (it->conn_data_ != nullptr) {
+        requests_served++;
+        it = requests.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  };
+
+  for (auto _ : state) {
+    release_served();
+    dispatcher.completeConnects();
+    requests.emplace_back(total_wait, now, now);
+    pool->newConnection(requests.back());
+    dispatcher.clearDeferredDeleteList();
+    now++;
+  }
+
+  release_served();
+  pool.reset();
+  dispatcher.clearDeferredDeleteList();
+
+  state.counters["wait_ticks"] =
+      requests_served == 0 ? 0 : static_cast<double>(total_wait) / requests_served;
+  state.counters["connections_per_request"] =
+      static_cast<double>(dispatcher.connections_created_) / now;
+}
+BENCHMARK(BM_ConnPoolUpstreamChurn)
+    ->Args({5, 0})
+    ->Args({5, 2})
+    ->Args({5, 5})
+    ->Args({5, 8})
+    ->Args({20, 0})
+    ->Args({20, 20});
+
+} // namespace
+} // namespace Tcp
+} // namespace Envoy
@@ -98,8 +98,10 @@ public:
     EXPECT_CALL(mock_dispatcher_, createClientConnection_(_, _, _, _))
         .WillOnce(Return(test_conn.connection_));
     EXPECT_CALL(*test_conn.connection_, addReadFilter(_))
-        .WillOnce(Invoke(
-            [&](Network::ReadFilterSharedPtr filter) -> void { test_conn.filter_ = filter; }));
+        .WillOnce(Invoke([this, index = test_conns_.size() - 1](
+                             Network::ReadFilterSharedPtr filter) -> void {
+          test_conns_[index].filter_ = filter;
+        }));
     EXPECT_CALL(*test_conn.connection_, connect());
     EXPECT_CALL(*test_conn.connect_timer_, enableTimer(_, _));
   }
@@ -791,6 +793,132 @@ TEST_F(TcpConnPoolImplTest, ConcurrentConnections) {
   dispatcher_.clearDeferredDeleteList();
 }
 
+/**
+ * Test that an idle connection is kept around for the next request as configured by the prefetch
+ * policy.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchMinIdleConnections) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  cluster_->prefetch_min_idle_connections_ = 1;
+
+  // The first request kicks off a connection for itself, and a prefetched one to keep idle.
+  {
+    InSequence s;
+    conn_pool_.expectConnCreate();
+    conn_pool_.expectConnCreate();
+  }
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+  c1.completeConnection();
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+
+  // The second request takes the idle connection, so another one is prefetched.
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c2(*this, 1, ActiveTestConn::Type::Immediate);
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest()).Times(2);
+  c1.releaseConn();
+  c2.releaseConn();
+
+  // The last prefetched connection goes away without ever being used. Prefetching is stopped, so
+  // that the closed connections are not replaced.
+  cluster_->prefetch_min_idle_connections_ = 0;
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest()).Times(3);
+  conn_pool_.test_conns_[2].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
+/**
+ * Test that connections which go away are replaced ahead of demand, unless they failed to connect.
+ */
+TEST_F(TcpConnPoolImplTest, PrefetchOnClose) {
+  cluster_->resetResourceManager(2, 1024, 1024, 1, 1);
+  cluster_->max_requests_per_connection_ = 1;
+  cluster_->prefetch_min_idle_connections_ = 1;
+  InSequence s;
+
+  // The first request kicks off a connection for itself, and a prefetched one to keep idle.
+  conn_pool_.expectConnCreate();
+  conn_pool_.expectConnCreate();
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+  c1.completeConnection();
+
+  // The prefetched connection fails to connect, and is not replaced.
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Releasing the first connection closes it at the request limit, which leaves no idle
+  // connection, so one is prefetched.
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest());
+  conn_pool_.expectConnCreate();
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  c1.releaseConn();
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(2U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_max_requests_.value());
+
+  // The idle connection is closed by the upstream after connecting, and is replaced.
+  EXPECT_CALL(*conn_pool_.test_conns_[0].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  conn_pool_.expectConnCreate();
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Stop prefetching, so that the last connection is not replaced.
+  cluster_->prefetch_min_idle_connections_ = 0;
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  conn_pool_.test_conns_[0].connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(0U, cluster_->stats_.upstream_cx_prefetch_hit_.value());
+  EXPECT_EQ(3U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
+/**
+ * Test that the connections closed by drainConnections() are not replaced ahead of demand.
+ */
+TEST_F(TcpConnPoolImplTest, NoPrefetchAfterDrain) {
+  cluster_->resetResourceManager(3, 1024, 1024, 1, 1);
+  cluster_->prefetch_min_idle_connections_ = 1;
+
+  // The first request kicks off a connection for itself, and a prefetched one to keep idle.
+  {
+    InSequence s;
+    conn_pool_.expectConnCreate();
+    conn_pool_.expectConnCreate();
+  }
+  ActiveTestConn c1(*this, 0, ActiveTestConn::Type::Pending);
+  c1.completeConnection();
+  EXPECT_CALL(*conn_pool_.test_conns_[1].connect_timer_, disableTimer());
+  conn_pool_.test_conns_[1].connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+
+  // Draining closes the idle connection right away, and the busy one once it is released. Neither
+  // of them is replaced.
+  EXPECT_CALL(dispatcher_, createClientConnection_(_, _, _, _)).Times(0);
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  conn_pool_.drainConnections();
+  dispatcher_.clearDeferredDeleteList();
+
+  EXPECT_CALL(conn_pool_, onConnReleasedForTest());
+  EXPECT_CALL(conn_pool_, onConnDestroyedForTest());
+  c1.releaseConn();
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_.value());
+  EXPECT_EQ(1U, cluster_->stats_.upstream_cx_prefetch_miss_.value());
+}
+
 /**
  * Tests ConnectionState lifecycle with multiple concurrent connections.
  */
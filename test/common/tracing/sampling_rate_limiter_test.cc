@@ -0,0 +1,40 @@
+#include <chrono>
+
+#include "common/tracing/sampling_rate_limiter.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Tracing {
+namespace {
+
+TEST(SamplingRateLimiterTest, LimitsSamplesPerSecond) {
+  Event::SimulatedTimeSystem time_system;
+  time_system.setMonotonicTime(std::chrono::seconds(10));
+  SamplingRateLimiter limiter(2, time_system);
+
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_FALSE(limiter.trySample());
+
+  // The budget is per second, not per rolling window.
+  time_system.setMonotonicTime(std::chrono::milliseconds(10999));
+  EXPECT_FALSE(limiter.trySample());
+
+  time_system.setMonotonicTime(std::chrono::seconds(11));
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_FALSE(limiter.trySample());
+
+  // Idle seconds do not accumulate budget.
+  time_system.setMonotonicTime(std::chrono::seconds(20));
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_TRUE(limiter.trySample());
+  EXPECT_FALSE(limiter.trySample());
+}
+
+} // namespace
+} // namespace Tracing
+} // namespace Envoy
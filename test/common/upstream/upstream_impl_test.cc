@@ -2320,6 +2320,29 @@ TEST_F(ClusterInfoImplTest, TestTrackTimeoutBudgets) {
             cluster->info()->timeoutBudgetStats()->upstream_rq_timeout_budget_percent_used_.unit());
 }
 
+TEST_F(ClusterInfoImplTest, PrefetchPolicy) {
+  const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+  )EOF";
+
+  // Without a prefetch policy, connections are only opened on demand.
+  auto cluster = makeCluster(yaml);
+  EXPECT_EQ(1.0, cluster->info()->perUpstreamPrefetchRatio());
+  EXPECT_EQ(0U, cluster->info()->prefetchMinIdleConnections());
+
+  const std::string prefetch_policy = R"EOF(
+    prefetch_policy:
+      per_upstream_prefetch_ratio: 1.5
+      min_idle_connections: 2
+  )EOF";
+  cluster = makeCluster(yaml + prefetch_policy);
+  EXPECT_EQ(1.5, cluster->info()->perUpstreamPrefetchRatio());
+  EXPECT_EQ(2U, cluster->info()->prefetchMinIdleConnections());
+}
+
 // Validates HTTP2 SETTINGS config.
 TEST_F(ClusterInfoImplTest, Http2ProtocolOptions) {
   const std::string yaml = R"EOF(
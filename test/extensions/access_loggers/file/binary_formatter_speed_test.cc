@@ -0,0 +1,77 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Compares producing a log line with the default text format against producing the binary
+// HTTPAccessLogEntry record for the same request. Each iteration formats one entry, so the
+// reported time is ns/entry; the bytes_per_entry counter reports the resulting log volume.
+
+#include "envoy/extensions/access_loggers/file/v3/file.pb.h"
+
+#include "common/access_log/access_log_formatter.h"
+#include "common/network/address_impl.h"
+
+#include "extensions/access_loggers/file/binary_formatter.h"
+
+#include "test/common/stream_info/test_util.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+namespace {
+
+std::unique_ptr<TestStreamInfo> makeStreamInfo() {
+  auto stream_info = std::make_unique<TestStreamInfo>();
+  stream_info->setDownstreamRemoteAddress(
+      std::make_shared<Network::Address::Ipv4Instance>("203.0.113.1"));
+  stream_info->response_code_ = 200;
+  stream_info->protocol(Http::Protocol::Http11);
+  return stream_info;
+}
+
+void formatEntries(benchmark::State& state, const AccessLog::Formatter& formatter) {
+  std::unique_ptr<TestStreamInfo> stream_info = makeStreamInfo();
+  Http::TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"},
+      {":path", "/api/v1/resources/12345?expand=true"},
+      {":authority", "service.example.com"},
+      {"user-agent", "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko)"},
+      {"x-forwarded-for", "198.51.100.7"},
+      {"x-request-id", "5d8f7a8e-3c61-4e5a-9b0d-8c0d3b8f2f3e"}};
+  Http::TestResponseHeaderMapImpl response_headers{{":status", "200"},
+                                                   {"x-envoy-upstream-service-time", "12"}};
+  Http::TestResponseTrailerMapImpl response_trailers;
+
+  size_t output_bytes = 0;
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    formatter.formatTo(request_headers, response_headers, response_trailers, *stream_info, output);
+    output_bytes += output.size();
+  }
+  state.counters["bytes_per_entry"] =
+      benchmark::Counter(output_bytes, benchmark::Counter::kAvgIterations);
+}
+
+} // namespace
+
+static void BM_TextFormat(benchmark::State& state) {
+  AccessLog::FormatterPtr formatter = AccessLog::AccessLogFormatUtils::defaultAccessLogFormatter();
+  formatEntries(state, *formatter);
+}
+BENCHMARK(BM_TextFormat);
+
+static void BM_BinaryFormat(benchmark::State& state) {
+  BinaryFormatterImpl formatter(
+      envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat{});
+  formatEntries(state, formatter);
+}
+BENCHMARK(BM_BinaryFormat);
+
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
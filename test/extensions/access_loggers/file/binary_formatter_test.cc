@@ -0,0 +1,84 @@
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+#include "envoy/extensions/access_loggers/file/v3/file.pb.h"
+
+#include "common/protobuf/protobuf.h"
+
+#include "extensions/access_loggers/file/binary_formatter.h"
+
+#include "test/mocks/stream_info/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace AccessLoggers {
+namespace File {
+namespace {
+
+// Parse all length-delimited entries in the given output.
+std::vector<envoy::data::accesslog::v3::HTTPAccessLogEntry> parseEntries(const std::string& data) {
+  std::vector<envoy::data::accesslog::v3::HTTPAccessLogEntry> entries;
+  Protobuf::io::ArrayInputStream array_stream(data.data(), data.size());
+  Protobuf::io::CodedInputStream coded_stream(&array_stream);
+  uint32_t entry_size;
+  while (coded_stream.ReadVarint32(&entry_size)) {
+    const auto limit = coded_stream.PushLimit(entry_size);
+    entries.emplace_back();
+    EXPECT_TRUE(entries.back().ParseFromCodedStream(&coded_stream));
+    EXPECT_TRUE(coded_stream.ConsumedEntireMessage());
+    coded_stream.PopLimit(limit);
+  }
+  EXPECT_EQ(data.size(), coded_stream.CurrentPosition());
+  return entries;
+}
+
+TEST(BinaryFormatterTest, LengthDelimitedEntries) {
+  envoy::extensions::access_loggers::file::v3::FileAccessLog::BinaryFormat config;
+  config.add_additional_request_headers_to_log("x-custom-request");
+  config.add_additional_response_headers_to_log("x-custom-response");
+  config.add_additional_response_trailers_to_log("x-custom-trailer");
+  BinaryFormatterImpl formatter(config);
+
+  NiceMock<StreamInfo::MockStreamInfo> stream_info;
+  stream_info.response_code_ = 200;
+  stream_info.protocol_ = Http::Protocol::Http2;
+  Http::TestRequestHeaderMapImpl request_headers{{":method", "GET"},
+                                                 {":path", "/foo"},
+                                                 {":authority", "example.com"},
+                                                 {"x-custom-request", "request"}};
+  Http::TestResponseHeaderMapImpl response_headers{{":status", "200"},
+                                                   {"x-custom-response", "response"}};
+  Http::TestResponseTrailerMapImpl response_trailers{{"x-custom-trailer", "trailer"}};
+
+  std::string output;
+  formatter.formatTo(request_headers, response_headers, response_trailers, stream_info, output);
+  const size_t first_entry_size = output.size();
+  request_headers.setPath("/bar");
+  output += formatter.format(request_headers, response_headers, response_trailers, stream_info);
+  EXPECT_GT(output.size(), first_entry_size);
+
+  const auto entries = parseEntries(output);
+  ASSERT_EQ(2U, entries.size());
+  EXPECT_EQ("/foo", entries[0].request().path());
+  EXPECT_EQ("/bar", entries[1].request().path());
+  for (const auto& entry : entries) {
+    EXPECT_EQ(envoy::data::accesslog::v3::HTTPAccessLogEntry::HTTP2, entry.protocol_version());
+    EXPECT_EQ("example.com", entry.request().authority());
+    EXPECT_EQ(envoy::config::core::v3::GET, entry.request().request_method());
+    EXPECT_EQ("request", entry.request().request_headers().at("x-custom-request"));
+    EXPECT_EQ(200U, entry.response().response_code().value());
+    EXPECT_EQ("response", entry.response().response_headers().at("x-custom-response"));
+    EXPECT_EQ("trailer", entry.response().response_trailers().at("x-custom-trailer"));
+  }
+}
+
+} // namespace
+} // namespace File
+} // namespace AccessLoggers
+} // namespace Extensions
+} // namespace Envoy
@@ -136,6 +136,23 @@ TEST(FileAccessLogConfigTest, FileAccessLogTypedJsonTest) {
   EXPECT_NE(nullptr, dynamic_cast<FileAccessLog*>(log.get()));
 }
 
+TEST(FileAccessLogConfigTest, FileAccessLogBinaryTest) {
+  envoy::config::accesslog::v3::AccessLog config;
+
+  envoy::extensions::access_loggers::file::v3::FileAccessLog fal_config;
+  fal_config.set_path("/dev/null");
+  fal_config.mutable_binary_format()->add_additional_request_headers_to_log("x-request");
+
+  config.mutable_typed_config()->PackFrom(fal_config);
+  config.set_name(AccessLogNames::get().File);
+
+  NiceMock<Server::Configuration::MockFactoryContext> context;
+  AccessLog::InstanceSharedPtr log = AccessLog::AccessLogFactory::fromProto(config, context);
+
+  EXPECT_NE(nullptr, log);
+  EXPECT_NE(nullptr, dynamic_cast<FileAccessLog*>(log.get()));
+}
+
 TEST(FileAccessLogConfigTest, FileAccessLogJsonWithBoolValueTest) {
   {
     // Make sure we fail if you set a bool value in the format dictionary
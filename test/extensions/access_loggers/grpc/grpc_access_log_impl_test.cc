@@ -7,6 +7,7 @@
 
 #include "common/buffer/zero_copy_input_stream_impl.h"
 #include "common/network/address_impl.h"
+#include "common/stats/isolated_store_impl.h"
 
 #include "extensions/access_loggers/grpc/http_grpc_access_log_impl.h"
 
@@ -21,6 +22,7 @@ using testing::_;
 using testing::InSequence;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 
 namespace Envoy {
 namespace Extensions {
@@ -36,12 +38,36 @@ public:
   using AccessLogCallbacks =
       Grpc::AsyncStreamCallbacks<envoy::service::accesslog::v3::StreamAccessLogsResponse>;
 
-  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes) {
+  void initLogger(std::chrono::milliseconds buffer_flush_interval_msec, size_t buffer_size_bytes,
+                  size_t max_pending_bytes = 0,
+                  GrpcAccessLoggerImpl::OverflowPolicy overflow_policy =
+                      envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::
+                          DROP_NEWEST,
+                  GrpcAccessLoggerImpl::MessageCompression message_compression =
+                      envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::
+                          NONE) {
     timer_ = new Event::MockTimer(&dispatcher_);
     EXPECT_CALL(*timer_, enableTimer(buffer_flush_interval_msec, _));
-    logger_ = std::make_unique<GrpcAccessLoggerImpl>(Grpc::RawAsyncClientPtr{async_client_},
-                                                     log_name_, buffer_flush_interval_msec,
-                                                     buffer_size_bytes, dispatcher_, local_info_);
+    logger_ = std::make_unique<GrpcAccessLoggerImpl>(
+        Grpc::RawAsyncClientPtr{async_client_}, log_name_, buffer_flush_interval_msec,
+        buffer_size_bytes, max_pending_bytes, overflow_policy, message_compression, dispatcher_,
+        local_info_, stats_store_);
+  }
+
+  void expectStreamStartFailure() {
+    EXPECT_CALL(*async_client_, startRaw(_, _, _, _))
+        .WillOnce(Invoke([](absl::string_view, absl::string_view,
+                            Grpc::RawAsyncStreamCallbacks& callbacks,
+                            const Http::AsyncClient::StreamOptions&) {
+          callbacks.onRemoteClose(Grpc::Status::Internal, "bad");
+          return nullptr;
+        }));
+  }
+
+  uint64_t counter(const std::string& name) {
+    return TestUtility::findCounter(stats_store_,
+                                    "access_logs.grpc_access_log.test_log_name." + name)
+        ->value();
   }
 
   void expectStreamStart(MockAccessLogStream& stream, AccessLogCallbacks** callbacks_to_set) {
@@ -71,6 +97,7 @@ public:
   Event::MockTimer* timer_ = nullptr;
   Event::MockDispatcher dispatcher_;
   Grpc::MockAsyncClient* async_client_{new Grpc::MockAsyncClient};
+  Stats::IsolatedStoreImpl stats_store_;
   std::unique_ptr<GrpcAccessLoggerImpl> logger_;
 };
 
@@ -140,16 +167,186 @@ TEST_F(GrpcAccessLoggerImplTest, StreamFailure) {
   InSequence s;
   initLogger(FlushInterval, 0);
 
-  EXPECT_CALL(*async_client_, startRaw(_, _, _, _))
-      .WillOnce(
-          Invoke([](absl::string_view, absl::string_view, Grpc::RawAsyncStreamCallbacks& callbacks,
-                    const Http::AsyncClient::StreamOptions&) {
-            callbacks.onRemoteClose(Grpc::Status::Internal, "bad");
-            return nullptr;
-          }));
+  expectStreamStartFailure();
+  EXPECT_CALL(local_info_, node());
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path("/test/path1");
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(0, counter("logs_written"));
+  EXPECT_EQ(1, counter("logs_dropped"));
+
+  // Entries logged before the flush timer retries the stream are discarded right away.
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(2, counter("logs_dropped"));
+}
+
+// Test that entries are kept within max_pending_bytes while the stream cannot be started and
+// that the newest entries are discarded by default.
+TEST_F(GrpcAccessLoggerImplTest, PendingDropNewest) {
+  InSequence s;
+  initLogger(FlushInterval, 0, 100);
+
+  expectStreamStartFailure();
   EXPECT_CALL(local_info_, node());
+  const std::string path1(40, '1');
+  const std::string path2(40, '2');
+  const std::string path3(40, '3');
   envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path(path1);
   logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path2);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path3);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(1, counter("logs_dropped"));
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  expectStreamMessage(stream, fmt::format(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+  - request:
+      path: "{}"
+  - request:
+      path: "{}"
+)EOF",
+                                          path1, path2));
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(2, counter("logs_written"));
+  EXPECT_EQ(1, counter("logs_dropped"));
+}
+
+// Test that the oldest pending entries are discarded with the DROP_OLDEST policy.
+TEST_F(GrpcAccessLoggerImplTest, PendingDropOldest) {
+  InSequence s;
+  initLogger(FlushInterval, 0, 100,
+             envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::DROP_OLDEST);
+
+  expectStreamStartFailure();
+  EXPECT_CALL(local_info_, node());
+  const std::string path1(40, '1');
+  const std::string path2(40, '2');
+  const std::string path3(40, '3');
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path(path1);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path2);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path3);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(1, counter("logs_dropped"));
+
+  // The retry fails as well and the entries stay pending.
+  expectStreamStartFailure();
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(1, counter("logs_dropped"));
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  expectStreamMessage(stream, fmt::format(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+  - request:
+      path: "{}"
+  - request:
+      path: "{}"
+)EOF",
+                                          path2, path3));
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(2, counter("logs_written"));
+}
+
+// Test that every other pending entry is discarded with the SAMPLE policy, so that the entries
+// kept are spread over the time the stream was unavailable.
+TEST_F(GrpcAccessLoggerImplTest, PendingSample) {
+  InSequence s;
+  initLogger(FlushInterval, 0, 100,
+             envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::SAMPLE);
+
+  expectStreamStartFailure();
+  EXPECT_CALL(local_info_, node());
+  const std::string path1(40, '1');
+  const std::string path2(40, '2');
+  const std::string path3(40, '3');
+  const std::string path4(40, '4');
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path(path1);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path2);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  entry.mutable_request()->set_path(path3);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(1, counter("logs_dropped"));
+  entry.mutable_request()->set_path(path4);
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(2, counter("logs_dropped"));
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  expectStreamMessage(stream, fmt::format(R"EOF(
+identifier:
+  node:
+    id: node_name
+    cluster: cluster_name
+    locality:
+      zone: zone_name
+  log_name: test_log_name
+http_logs:
+  log_entry:
+  - request:
+      path: "{}"
+  - request:
+      path: "{}"
+)EOF",
+                                          path1, path4));
+  EXPECT_CALL(*timer_, enableTimer(FlushInterval, _));
+  timer_->invokeCallback();
+  EXPECT_EQ(2, counter("logs_written"));
+}
+
+// Test that the stream requests the configured message compression.
+TEST_F(GrpcAccessLoggerImplTest, MessageCompression) {
+  InSequence s;
+  initLogger(FlushInterval, 0, 0,
+             envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::DROP_NEWEST,
+             envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::GZIP);
+
+  MockAccessLogStream stream;
+  AccessLogCallbacks* callbacks;
+  expectStreamStart(stream, &callbacks);
+  EXPECT_CALL(local_info_, node());
+  EXPECT_CALL(stream, sendMessageRaw_(_, false));
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path("/test/path1");
+  logger_->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+
+  Http::TestRequestHeaderMapImpl metadata;
+  callbacks->onCreateInitialMetadata(metadata);
+  EXPECT_EQ("gzip", metadata.get_("grpc-internal-encoding-request"));
 }
 
 // Test that log entries are batched.
@@ -245,7 +442,7 @@ class GrpcAccessLoggerCacheImplTest : public testing::Test {
 public:
   GrpcAccessLoggerCacheImplTest() {
     logger_cache_ = std::make_unique<GrpcAccessLoggerCacheImpl>(async_client_manager_, scope_, tls_,
-                                                                local_info_);
+                                                                local_info_, tls_.dispatcher_);
   }
 
   void expectClientCreation() {
@@ -260,13 +457,13 @@ public:
         }));
   }
 
+  NiceMock<Stats::MockIsolatedStatsStore> scope_;
   LocalInfo::MockLocalInfo local_info_;
   NiceMock<ThreadLocal::MockInstance> tls_;
   Grpc::MockAsyncClientManager async_client_manager_;
   Grpc::MockAsyncClient* async_client_ = nullptr;
   Grpc::MockAsyncClientFactory* factory_ = nullptr;
   std::unique_ptr<GrpcAccessLoggerCacheImpl> logger_cache_;
-  NiceMock<Stats::MockIsolatedStatsStore> scope_;
 };
 
 TEST_F(GrpcAccessLoggerCacheImplTest, Deduplication) {
@@ -299,6 +496,32 @@ TEST_F(GrpcAccessLoggerCacheImplTest, Deduplication) {
   EXPECT_NE(logger1, logger_cache_->getOrCreateLogger(config, GrpcAccessLoggerType::HTTP));
 }
 
+// Test that a logger sharing its stream across workers hands its entries to a single logger
+// created on the main thread.
+TEST_F(GrpcAccessLoggerCacheImplTest, SharedStream) {
+  envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig config;
+  config.set_log_name("log-1");
+  config.mutable_grpc_service()->mutable_envoy_grpc()->set_cluster_name("cluster-1");
+  config.mutable_buffer_size_bytes()->set_value(0);
+  config.mutable_max_pending_bytes()->set_value(0);
+  config.set_share_stream_across_workers(true);
+
+  GrpcAccessLoggerSharedPtr logger =
+      logger_cache_->getOrCreateLogger(config, GrpcAccessLoggerType::HTTP);
+  EXPECT_NE(nullptr, dynamic_cast<SharedStreamGrpcAccessLogger*>(logger.get()));
+
+  // The shared logger and its client are only created once the first batch reaches the main
+  // thread, and are reused afterwards.
+  expectClientCreation();
+  EXPECT_CALL(*async_client_, startRaw(_, _, _, _)).WillOnce(Return(nullptr));
+  envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+  entry.mutable_request()->set_path("/test/path1");
+  logger->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  logger->log(envoy::data::accesslog::v3::HTTPAccessLogEntry(entry));
+  EXPECT_EQ(2, TestUtility::findCounter(scope_, "access_logs.grpc_access_log.log-1.logs_dropped")
+                   ->value());
+}
+
 } // namespace
 } // namespace GrpcCommon
 } // namespace AccessLoggers
@@ -8,6 +8,7 @@
 #include "extensions/access_loggers/well_known_names.h"
 
 #include "test/mocks/server/mocks.h"
+#include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -58,6 +59,23 @@ TEST_F(HttpGrpcAccessLogConfigTest, Ok) {
   EXPECT_NE(nullptr, dynamic_cast<HttpGrpcAccessLog*>(instance.get()));
 }
 
+// Message compression is only supported by the Google gRPC client.
+TEST_F(HttpGrpcAccessLogConfigTest, MessageCompressionRequiresGoogleGrpc) {
+  auto* common_config = http_grpc_access_log_.mutable_common_config();
+  common_config->set_message_compression(
+      envoy::extensions::access_loggers::grpc::v3::CommonGrpcAccessLogConfig::GZIP);
+  TestUtility::jsonConvert(http_grpc_access_log_, *message_);
+  EXPECT_THROW_WITH_MESSAGE(
+      factory_->createAccessLogInstance(*message_, std::move(filter_), context_), EnvoyException,
+      "gRPC access log 'foo': message_compression requires google_grpc");
+
+  auto* google_grpc = common_config->mutable_grpc_service()->mutable_google_grpc();
+  google_grpc->set_target_uri("bar");
+  google_grpc->set_stat_prefix("bar");
+  TestUtility::jsonConvert(http_grpc_access_log_, *message_);
+  EXPECT_NE(nullptr, factory_->createAccessLogInstance(*message_, nullptr, context_));
+}
+
 } // namespace
 } // namespace HttpGrpc
 } // namespace AccessLoggers
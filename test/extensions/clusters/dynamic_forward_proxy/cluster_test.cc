@@ -47,8 +47,9 @@ public:
     // actually correct. It's possible this will have to change in the future.
     EXPECT_CALL(*dns_cache_manager_->dns_cache_, addUpdateCallbacks_(_))
         .WillOnce(DoAll(SaveArgAddress(&update_callbacks_), Return(nullptr)));
-    cluster_ = std::make_shared<Cluster>(cluster_config, config, runtime_, *this, local_info_,
-                                         factory_context, std::move(scope), false);
+    update_timer_ = new Event::MockTimer(&dispatcher_);
+    cluster_ = std::make_shared<Cluster>(cluster_config, config, runtime_, *this, factory_context,
+                                         std::move(scope), false);
     thread_aware_lb_ = std::make_unique<Cluster::ThreadAwareLoadBalancer>(*cluster_);
     lb_factory_ = thread_aware_lb_->factory();
     refreshLb();
@@ -125,6 +126,7 @@ public:
   NiceMock<Upstream::MockLoadBalancerContext> lb_context_;
   Http::TestRequestHeaderMapImpl downstream_headers_;
   Extensions::Common::DynamicForwardProxy::DnsCache::UpdateCallbacks* update_callbacks_{};
+  Event::MockTimer* update_timer_{};
   absl::flat_hash_map<std::string,
                       std::shared_ptr<Extensions::Common::DynamicForwardProxy::MockDnsHostInfo>>
       host_map_;
@@ -151,18 +153,20 @@ TEST_F(ClusterTest, BasicFlow) {
   // Verify no host LB cases.
   EXPECT_EQ(nullptr, lb_->chooseHost(setHostAndReturnContext("foo")));
 
-  // LB will not resolve host1 until it has been updated.
-  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(1), SizeIs(0)));
+  // LB will resolve host1 right away, the priority set is updated once the update timer fires.
+  EXPECT_CALL(*update_timer_, enableTimer(std::chrono::milliseconds(0), _));
   update_callbacks_->onDnsHostAddOrUpdate("host1", host_map_["host1"]);
-  EXPECT_EQ(nullptr, lb_->chooseHost(setHostAndReturnContext("host1")));
+  EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_CALL(*host_map_["host1"], touch());
+  EXPECT_EQ("1.2.3.4:0", lb_->chooseHost(setHostAndReturnContext("host1"))->address()->asString());
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(1), SizeIs(0)));
+  update_timer_->invokeCallback();
   EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
   EXPECT_EQ("1.2.3.4:0",
             cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]->address()->asString());
-  refreshLb();
-  EXPECT_CALL(*host_map_["host1"], touch());
-  EXPECT_EQ("1.2.3.4:0", lb_->chooseHost(setHostAndReturnContext("host1"))->address()->asString());
 
-  // After changing the address, LB will immediately resolve the new address with a refresh.
+  // After changing the address, LB will immediately resolve the new address without any update of
+  // the priority set.
   updateTestHostAddress("host1", "2.3.4.5");
   update_callbacks_->onDnsHostAddOrUpdate("host1", host_map_["host1"]);
   EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
@@ -171,14 +175,48 @@ TEST_F(ClusterTest, BasicFlow) {
   EXPECT_CALL(*host_map_["host1"], touch());
   EXPECT_EQ("2.3.4.5:0", lb_->chooseHost(setHostAndReturnContext("host1"))->address()->asString());
 
-  // Remove the host, LB will still resolve until it is refreshed.
-  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(0), SizeIs(1)));
+  // Remove the host, LB will stop resolving it right away.
+  EXPECT_CALL(*update_timer_, enableTimer(std::chrono::milliseconds(0), _));
   update_callbacks_->onDnsHostRemove("host1");
-  EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
-  EXPECT_CALL(*host_map_["host1"], touch());
-  EXPECT_EQ("2.3.4.5:0", lb_->chooseHost(setHostAndReturnContext("host1"))->address()->asString());
-  refreshLb();
   EXPECT_EQ(nullptr, lb_->chooseHost(setHostAndReturnContext("host1")));
+  EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(0), SizeIs(1)));
+  update_timer_->invokeCallback();
+  EXPECT_EQ(0UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
+// Changes which happen before the update timer fires are applied to the priority set at once.
+TEST_F(ClusterTest, BatchedUpdates) {
+  initialize(default_yaml_config_, false);
+  makeTestHost("host1", "1.2.3.4");
+  makeTestHost("host2", "1.2.3.5");
+  makeTestHost("host3", "1.2.3.6");
+  InSequence s;
+
+  EXPECT_CALL(*update_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  update_callbacks_->onDnsHostAddOrUpdate("host1", host_map_["host1"]);
+  update_callbacks_->onDnsHostAddOrUpdate("host2", host_map_["host2"]);
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(2), SizeIs(0)));
+  update_timer_->invokeCallback();
+  EXPECT_EQ(2UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+
+  // A host which comes and goes within a batch never makes it to the priority set.
+  EXPECT_CALL(*update_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  update_callbacks_->onDnsHostAddOrUpdate("host3", host_map_["host3"]);
+  update_callbacks_->onDnsHostRemove("host3");
+  update_callbacks_->onDnsHostRemove("host1");
+  EXPECT_CALL(*this, onMemberUpdateCb(SizeIs(0), SizeIs(1)));
+  update_timer_->invokeCallback();
+  EXPECT_EQ(1UL, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ("1.2.3.5:0",
+            cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]->address()->asString());
+
+  // Nothing to do if the changes cancel out.
+  EXPECT_CALL(*update_timer_, enableTimer(std::chrono::milliseconds(0), _));
+  update_callbacks_->onDnsHostAddOrUpdate("host3", host_map_["host3"]);
+  update_callbacks_->onDnsHostRemove("host3");
+  EXPECT_CALL(*this, onMemberUpdateCb(_, _)).Times(0);
+  update_timer_->invokeCallback();
 }
 
 // Various invalid LB context permutations in case the cluster is used outside of HTTP.
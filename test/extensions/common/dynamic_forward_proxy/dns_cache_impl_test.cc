@@ -30,7 +30,8 @@ public:
     config_.set_dns_lookup_family(envoy::config::cluster::v3::Cluster::V4_ONLY);
 
     EXPECT_CALL(dispatcher_, createDnsResolver(_, _)).WillOnce(Return(resolver_));
-    dns_cache_ = std::make_unique<DnsCacheImpl>(dispatcher_, tls_, random_, store_, config_);
+    dns_cache_ =
+        std::make_unique<DnsCacheImpl>(dispatcher_, tls_, random_, store_, nullptr, config_);
     update_callbacks_handle_ = dns_cache_->addUpdateCallbacks(update_callbacks_);
   }
 
@@ -642,13 +643,73 @@ TEST_F(DnsCacheImplTest, MaxHostOverflow) {
   EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
 }
 
+// When full, the cache evicts the least recently used host rather than overflowing.
+TEST_F(DnsCacheImplTest, EvictLeastRecentlyUsed) {
+  config_.mutable_max_hosts()->set_value(2);
+  config_.set_evict_least_recently_used(true);
+  initialize();
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  Network::DnsResolver::ResolveCb resolve_cb;
+  for (const std::string host : {"foo.com", "bar.com"}) {
+    EXPECT_CALL(*resolver_, resolve(host, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+    auto result = dns_cache_->loadDnsCacheEntry(host, 80, callbacks);
+    EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+    EXPECT_CALL(update_callbacks_, onDnsHostAddOrUpdate(host, _));
+    EXPECT_CALL(callbacks, onLoadDnsCacheComplete());
+    resolve_cb(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"10.0.0.1"}));
+  }
+
+  // foo.com was used since it was added, so it gets a second chance and bar.com is evicted.
+  simTime().sleep(std::chrono::milliseconds(1000));
+  dns_cache_->hosts()["foo.com"]->touch();
+  EXPECT_CALL(update_callbacks_, onDnsHostRemove("bar.com"));
+  EXPECT_CALL(*resolver_, resolve("baz.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&resolve_cb), Return(&resolver_->active_query_)));
+  auto result = dns_cache_->loadDnsCacheEntry("baz.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  checkStats(3 /* attempt */, 2 /* success */, 0 /* failure */, 2 /* address changed */,
+             3 /* added */, 1 /* removed */, 2 /* num hosts */);
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+
+  // Hosts whose first resolution is in progress are not evicted, so foo.com goes next even though
+  // it was used again.
+  simTime().sleep(std::chrono::milliseconds(1000));
+  dns_cache_->hosts()["foo.com"]->touch();
+  EXPECT_CALL(update_callbacks_, onDnsHostRemove("foo.com"));
+  EXPECT_CALL(*resolver_, resolve("qux.com", _, _)).WillOnce(Return(&resolver_->active_query_));
+  result = dns_cache_->loadDnsCacheEntry("qux.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+  EXPECT_EQ(2, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  EXPECT_EQ(0, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+
+  // Both hosts are in their first resolution, so there is nothing to evict and the cache
+  // overflows instead of going above max hosts. The request waiting for the host is told so.
+  MockLoadDnsCacheEntryCallbacks overflow_callbacks;
+  Event::PostCb post_cb;
+  EXPECT_CALL(dispatcher_, post(_)).WillOnce(SaveArg<0>(&post_cb));
+  auto overflow_result = dns_cache_->loadDnsCacheEntry("quux.com", 80, overflow_callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, overflow_result.status_);
+  EXPECT_CALL(*resolver_, resolve("quux.com", _, _)).Times(0);
+  EXPECT_CALL(overflow_callbacks, onLoadDnsCacheComplete()).Times(0);
+  EXPECT_CALL(overflow_callbacks, onLoadDnsCacheOverflow());
+  post_cb();
+  EXPECT_EQ(1, TestUtility::findCounter(store_, "dns_cache.foo.host_overflow")->value());
+  EXPECT_EQ(2, TestUtility::findCounter(store_, "dns_cache.foo.host_evicted")->value());
+  EXPECT_EQ(2, TestUtility::findGauge(store_, "dns_cache.foo.num_hosts")->value());
+
+  EXPECT_CALL(resolver_->active_query_, cancel()).Times(2);
+}
+
 // DNS cache manager config tests.
 TEST(DnsCacheManagerImplTest, LoadViaConfig) {
   NiceMock<Event::MockDispatcher> dispatcher;
   NiceMock<ThreadLocal::MockInstance> tls;
   NiceMock<Runtime::MockRandomGenerator> random;
   Stats::IsolatedStoreImpl store;
-  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, store);
+  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, store, nullptr);
 
   envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config1;
   config1.set_name("foo");
@@ -673,6 +734,26 @@ TEST(DnsCacheManagerImplTest, LoadViaConfig) {
                             "config specified DNS cache 'foo' with different settings");
 }
 
+// The caches use the server's caching resolver instead of their own if there is one.
+TEST(DnsCacheManagerImplTest, SharedResolver) {
+  NiceMock<Event::MockDispatcher> dispatcher;
+  NiceMock<ThreadLocal::MockInstance> tls;
+  NiceMock<Runtime::MockRandomGenerator> random;
+  Stats::IsolatedStoreImpl store;
+  auto resolver = std::make_shared<Network::MockDnsResolver>();
+  DnsCacheManagerImpl cache_manager(dispatcher, tls, random, store, resolver);
+
+  envoy::extensions::common::dynamic_forward_proxy::v3::DnsCacheConfig config;
+  config.set_name("foo");
+  EXPECT_CALL(dispatcher, createDnsResolver(_, _)).Times(0);
+  DnsCacheSharedPtr cache = cache_manager.getCache(config);
+
+  MockLoadDnsCacheEntryCallbacks callbacks;
+  EXPECT_CALL(*resolver, resolve("foo.com", _, _)).WillOnce(Return(&resolver->active_query_));
+  auto result = cache->loadDnsCacheEntry("foo.com", 80, callbacks);
+  EXPECT_EQ(DnsCache::LoadDnsCacheEntryStatus::Loading, result.status_);
+}
+
 // Note: this test is done here, rather than a TYPED_TEST_SUITE in
 // //test/common/config:utility_test, because we did not want to include an extension type in
 // non-extension test suites.
@@ -88,6 +88,7 @@ public:
   ~MockLoadDnsCacheEntryCallbacks() override;
 
   MOCK_METHOD(void, onLoadDnsCacheComplete, ());
+  MOCK_METHOD(void, onLoadDnsCacheOverflow, ());
 };
 
 } // namespace DynamicForwardProxy
@@ -0,0 +1,72 @@
+#include <string>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+
+#include "extensions/common/dynamic_forward_proxy/sharded_host_map.h"
+
+#include "test/test_common/thread_factory_for_test.h"
+
+#include "absl/strings/str_cat.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Common {
+namespace DynamicForwardProxy {
+namespace {
+
+TEST(ShardedHostMapTest, Basic) {
+  ShardedHostMap<int> map;
+  EXPECT_FALSE(map.find("foo.com").has_value());
+  EXPECT_FALSE(map.contains("foo.com"));
+  EXPECT_EQ(0UL, map.size());
+
+  EXPECT_TRUE(map.insert("foo.com", 1));
+  EXPECT_FALSE(map.insert("foo.com", 2));
+  EXPECT_TRUE(map.insert("bar.com", 3));
+  EXPECT_EQ(1, map.find("foo.com").value());
+  EXPECT_TRUE(map.contains("bar.com"));
+  EXPECT_EQ(2UL, map.size());
+
+  int sum = 0;
+  map.forEach([&sum](const std::string&, int value) { sum += value; });
+  EXPECT_EQ(4, sum);
+
+  EXPECT_TRUE(map.erase("foo.com"));
+  EXPECT_FALSE(map.erase("foo.com"));
+  EXPECT_FALSE(map.contains("foo.com"));
+  EXPECT_EQ(1UL, map.size());
+}
+
+// Concurrent updates and lookups of different hosts keep the map consistent.
+TEST(ShardedHostMapTest, Concurrent) {
+  ShardedHostMap<int> map;
+  std::vector<Thread::ThreadPtr> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.push_back(Thread::threadFactoryForTest().createThread([&map, i]() {
+      for (int j = 0; j < 1000; j++) {
+        const std::string host = absl::StrCat("host", i, "_", j, ".com");
+        EXPECT_TRUE(map.insert(host, j));
+        EXPECT_EQ(j, map.find(host).value());
+        if (j % 2 == 1) {
+          EXPECT_TRUE(map.erase(host));
+        }
+      }
+    }));
+  }
+  for (Thread::ThreadPtr& thread : threads) {
+    thread->join();
+  }
+
+  size_t num_hosts = 0;
+  map.forEach([&num_hosts](const std::string&, int) { num_hosts++; });
+  EXPECT_EQ(2000UL, num_hosts);
+  EXPECT_EQ(2000UL, map.size());
+}
+
+} // namespace
+} // namespace DynamicForwardProxy
+} // namespace Common
+} // namespace Extensions
+} // namespace Envoy
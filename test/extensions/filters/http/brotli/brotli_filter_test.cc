@@ -0,0 +1,115 @@
+#include <memory>
+
+#include "envoy/extensions/filters/http/brotli/v3/brotli.pb.h"
+
+#include "common/decompressor/brotli_decompressor_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/brotli/brotli_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Brotli {
+namespace {
+
+class BrotliFilterTest : public testing::Test {
+protected:
+  void SetUp() override { setUpFilter("{}"); }
+
+  void setUpFilter(const std::string& json) {
+    envoy::extensions::filters::http::brotli::v3::Brotli brotli;
+    TestUtility::loadFromJson(json, brotli);
+    config_ = std::make_shared<BrotliFilterConfig>(brotli, "test.", stats_, runtime_);
+    filter_ = std::make_unique<Common::Compressors::CompressorFilter>(config_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  }
+
+  void doRequest(Http::TestRequestHeaderMapImpl&& headers) {
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  }
+
+  std::shared_ptr<BrotliFilterConfig> config_;
+  std::unique_ptr<Common::Compressors::CompressorFilter> filter_;
+  Stats::TestUtil::TestStore stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+};
+
+TEST_F(BrotliFilterTest, DefaultConfigValues) {
+  EXPECT_EQ(3U, config_->quality());
+  EXPECT_EQ(18U, config_->windowBits());
+  EXPECT_EQ(4096U, config_->chunkSize());
+  EXPECT_EQ(Compressor::BrotliCompressorImpl::EncoderMode::Generic, config_->encoderMode());
+  EXPECT_EQ(30U, config_->minimumLength());
+  EXPECT_EQ("br", config_->contentEncoding());
+}
+
+TEST_F(BrotliFilterTest, CustomConfigValues) {
+  setUpFilter(R"EOF(
+{
+  "quality": 9,
+  "window_bits": 22,
+  "encoder_mode": "TEXT",
+  "chunk_size": 8192,
+  "compressor": {
+    "content_length": 100
+  }
+}
+)EOF");
+  EXPECT_EQ(9U, config_->quality());
+  EXPECT_EQ(22U, config_->windowBits());
+  EXPECT_EQ(8192U, config_->chunkSize());
+  EXPECT_EQ(Compressor::BrotliCompressorImpl::EncoderMode::Text, config_->encoderMode());
+  EXPECT_EQ(100U, config_->minimumLength());
+}
+
+// A response is brotli encoded when the user agent asks for it, and decodes back to the original.
+TEST_F(BrotliFilterTest, AcceptEncodingBrotli) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip;q=0.5, br"}});
+
+  Buffer::OwnedImpl data;
+  TestUtility::feedBufferWithRandomCharacters(data, 1000);
+  const std::string expected = data.toString();
+
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "1000"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ("br", headers.get_("content-encoding"));
+  EXPECT_EQ("", headers.get_("content-length"));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+
+  Decompressor::BrotliDecompressorImpl decompressor(4096);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(data, decompressed);
+  EXPECT_EQ(expected, decompressed.toString());
+  EXPECT_EQ(1U, stats_.counter("test.brotli.compressed").value());
+  EXPECT_EQ(1U, stats_.counter("test.brotli.header_compressor_used").value());
+  EXPECT_EQ(1000U, stats_.counter("test.brotli.total_uncompressed_bytes").value());
+  EXPECT_EQ(data.length(), stats_.counter("test.brotli.total_compressed_bytes").value());
+}
+
+TEST_F(BrotliFilterTest, AcceptEncodingGzipOnly) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "1000"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_EQ(1U, stats_.counter("test.brotli.not_compressed").value());
+}
+
+} // namespace
+} // namespace Brotli
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -899,6 +899,145 @@ TEST_F(CompressorFilterTest, RemoveAcceptEncodingHeader) {
   }
 }
 
+// Compressor that counts its invocations and marks the end of the stream, so that tests can tell
+// whether a body came out of the compressor or out of the response cache.
+class CountingCompressor : public Compressor::Compressor {
+public:
+  explicit CountingCompressor(uint32_t& calls) : calls_(calls) {}
+
+  void compress(Buffer::Instance& buffer, ::Envoy::Compressor::State state) override {
+    calls_++;
+    if (state == ::Envoy::Compressor::State::Finish) {
+      buffer.add("|end");
+    }
+  }
+
+private:
+  uint32_t& calls_;
+};
+
+class CountingCompressorFilterConfig : public CompressorFilterConfig {
+public:
+  CountingCompressorFilterConfig(
+      const envoy::extensions::filters::http::compressor::v3::Compressor& compressor,
+      Stats::Scope& scope, Runtime::Loader& runtime)
+      : CompressorFilterConfig(compressor, "test.test.", scope, runtime, "test") {}
+
+  std::unique_ptr<Compressor::Compressor> makeCompressor() override {
+    return std::make_unique<CountingCompressor>(compress_calls_);
+  }
+
+  uint32_t compress_calls_{};
+};
+
+class CompressorFilterResponseCacheTest : public testing::Test {
+protected:
+  void SetUp() override {
+    envoy::extensions::filters::http::compressor::v3::Compressor compressor;
+    TestUtility::loadFromJson(R"EOF(
+{
+  "response_cache": {
+    "max_entries": 2,
+    "max_entry_bytes": 1000
+  }
+}
+)EOF",
+                              compressor);
+    config_ = std::make_shared<CountingCompressorFilterConfig>(compressor, stats_, runtime_);
+  }
+
+  // Run a response through a new filter instance, sending the body in two frames, and return what
+  // the filter passed on.
+  std::string doResponse(Http::TestResponseHeaderMapImpl&& headers, const std::string& body) {
+    CompressorFilter filter(config_);
+    NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks;
+    NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks;
+    filter.setDecoderFilterCallbacks(decoder_callbacks);
+    filter.setEncoderFilterCallbacks(encoder_callbacks);
+
+    Http::TestRequestHeaderMapImpl request_headers{{":method", "get"},
+                                                   {":authority", "example.com"},
+                                                   {":path", "/static/app.js"},
+                                                   {"accept-encoding", "test"}};
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter.decodeHeaders(request_headers, false));
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter.encodeHeaders(headers, false));
+    EXPECT_EQ("test", headers.get_("content-encoding"));
+    response_content_length_ = headers.get_("content-length");
+
+    std::string output;
+    Buffer::OwnedImpl first(body.substr(0, body.size() / 2));
+    if (filter.encodeData(first, false) == Http::FilterDataStatus::Continue) {
+      output.append(first.toString());
+    }
+    Buffer::OwnedImpl second(body.substr(body.size() / 2));
+    EXPECT_EQ(Http::FilterDataStatus::Continue, filter.encodeData(second, true));
+    output.append(second.toString());
+    return output;
+  }
+
+  std::shared_ptr<CountingCompressorFilterConfig> config_;
+  std::string response_content_length_;
+  Stats::TestUtil::TestStore stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+};
+
+// A second response with the same strong etag for the same resource is served from the cache
+// without running the compressor, and gets an exact content-length.
+TEST_F(CompressorFilterResponseCacheTest, StrongEtagHit) {
+  const std::string body(300, 'a');
+  EXPECT_EQ(body + "|end", doResponse({{":status", "200"},
+                                       {"content-length", "300"},
+                                       {"content-type", "text/html"},
+                                       {"etag", "\"v1\""}},
+                                      body));
+  EXPECT_EQ(1U, config_->compress_calls_);
+  EXPECT_EQ("", response_content_length_);
+
+  EXPECT_EQ(body + "|end", doResponse({{":status", "200"},
+                                       {"content-length", "300"},
+                                       {"content-type", "text/html"},
+                                       {"etag", "\"v1\""}},
+                                      body));
+  EXPECT_EQ(1U, config_->compress_calls_);
+  EXPECT_EQ("304", response_content_length_);
+  EXPECT_EQ(1U, stats_.counter("test.test.response_cache_hit").value());
+  EXPECT_EQ(1U, stats_.counter("test.test.response_cache_miss").value());
+}
+
+// Responses without an etag are matched on their content.
+TEST_F(CompressorFilterResponseCacheTest, ContentHashHit) {
+  const std::string body(300, 'a');
+  const std::string other(300, 'b');
+  Http::TestResponseHeaderMapImpl headers{
+      {":status", "200"}, {"content-length", "300"}, {"content-type", "text/html"}};
+  EXPECT_EQ(body + "|end", doResponse(Http::TestResponseHeaderMapImpl(headers), body));
+  EXPECT_EQ(body + "|end", doResponse(Http::TestResponseHeaderMapImpl(headers), body));
+  EXPECT_EQ(1U, config_->compress_calls_);
+  EXPECT_EQ(other + "|end", doResponse(Http::TestResponseHeaderMapImpl(headers), other));
+  EXPECT_EQ(2U, config_->compress_calls_);
+  EXPECT_EQ(1U, stats_.counter("test.test.response_cache_hit").value());
+  EXPECT_EQ(2U, stats_.counter("test.test.response_cache_miss").value());
+}
+
+// Responses larger than max_entry_bytes, and non-200 responses, are streamed through the
+// compressor as usual.
+TEST_F(CompressorFilterResponseCacheTest, NotCacheable) {
+  const std::string large(2000, 'a');
+  Http::TestResponseHeaderMapImpl large_headers{
+      {":status", "200"}, {"content-length", "2000"}, {"content-type", "text/html"}};
+  EXPECT_EQ(large + "|end", doResponse(Http::TestResponseHeaderMapImpl(large_headers), large));
+  EXPECT_EQ(large + "|end", doResponse(Http::TestResponseHeaderMapImpl(large_headers), large));
+  EXPECT_EQ(4U, config_->compress_calls_);
+
+  const std::string body(300, 'a');
+  Http::TestResponseHeaderMapImpl not_found_headers{
+      {":status", "404"}, {"content-length", "300"}, {"content-type", "text/html"}};
+  EXPECT_EQ(body + "|end", doResponse(Http::TestResponseHeaderMapImpl(not_found_headers), body));
+  EXPECT_EQ(6U, config_->compress_calls_);
+  EXPECT_EQ(0U, stats_.counter("test.test.response_cache_hit").value());
+  EXPECT_EQ(0U, stats_.counter("test.test.response_cache_miss").value());
+}
+
 } // namespace Compressors
 } // namespace Common
 } // namespace HttpFilters
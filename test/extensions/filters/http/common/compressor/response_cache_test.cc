@@ -0,0 +1,80 @@
+#include "common/buffer/buffer_impl.h"
+
+#include "extensions/filters/http/common/compressor/response_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Common {
+namespace Compressors {
+namespace {
+
+TEST(ResponseCacheTest, EvictsLeastRecentlyUsed) {
+  ResponseCache cache(2, 1000, 1000);
+  cache.insert("a", std::make_shared<const std::string>("A"));
+  cache.insert("b", std::make_shared<const std::string>("B"));
+  // Touch "a" so that "b" becomes the eviction candidate.
+  EXPECT_EQ("A", *cache.lookup("a"));
+  cache.insert("c", std::make_shared<const std::string>("C"));
+
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_EQ(nullptr, cache.lookup("b"));
+  EXPECT_EQ("A", *cache.lookup("a"));
+  EXPECT_EQ("C", *cache.lookup("c"));
+}
+
+TEST(ResponseCacheTest, ReplaceExisting) {
+  ResponseCache cache(2, 1000, 1000);
+  cache.insert("a", std::make_shared<const std::string>("A"));
+  ResponseCache::BodySharedPtr held = cache.lookup("a");
+  cache.insert("a", std::make_shared<const std::string>("A2"));
+
+  EXPECT_EQ(1U, cache.size());
+  EXPECT_EQ("A2", *cache.lookup("a"));
+  // Bodies handed out earlier stay valid.
+  EXPECT_EQ("A", *held);
+}
+
+TEST(ResponseCacheTest, EvictsToStayWithinTotalBytes) {
+  // Each entry takes 1 byte of key and 4 bytes of body.
+  ResponseCache cache(10, 1000, 12);
+  cache.insert("a", std::make_shared<const std::string>("AAAA"));
+  cache.insert("b", std::make_shared<const std::string>("BBBB"));
+  EXPECT_EQ(10U, cache.bytes());
+  cache.insert("c", std::make_shared<const std::string>("CCCC"));
+
+  EXPECT_EQ(2U, cache.size());
+  EXPECT_EQ(10U, cache.bytes());
+  EXPECT_EQ(nullptr, cache.lookup("a"));
+
+  // An entry larger than the whole cache is not inserted, and does not evict anything.
+  cache.insert("d", std::make_shared<const std::string>("DDDDDDDDDDDDDDDD"));
+  EXPECT_EQ(nullptr, cache.lookup("d"));
+  EXPECT_EQ(2U, cache.size());
+}
+
+TEST(ResponseCacheTest, LookupByContent) {
+  ResponseCache cache(2, 1000, 1000);
+  cache.insert("hash", std::make_shared<const std::string>("compressed"), "content");
+  EXPECT_EQ(18U, cache.bytes());
+
+  // A lookup with the same key but different content, as with a hash collision, misses.
+  Buffer::OwnedImpl other("contenu");
+  EXPECT_EQ(nullptr, cache.lookup("hash", other));
+
+  // The content matches however the buffer is put together.
+  Buffer::OwnedImpl content("con");
+  Buffer::OwnedImpl rest("tent");
+  content.move(rest);
+  ASSERT_NE(nullptr, cache.lookup("hash", content));
+  EXPECT_EQ("compressed", *cache.lookup("hash", content));
+}
+
+} // namespace
+} // namespace Compressors
+} // namespace Common
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
@@ -122,6 +122,33 @@ TEST_F(ProxyFilterTest, CacheOverflow) {
   filter_->onDestroy();
 }
 
+// Cache overflow once the cache tries to add the host, which it can only do on the main thread.
+TEST_F(ProxyFilterTest, CacheOverflowWhileLoading) {
+  InSequence s;
+
+  EXPECT_CALL(callbacks_, route());
+  EXPECT_CALL(cm_, get(_));
+  EXPECT_CALL(*transport_socket_factory_, implementsSecureTransport()).WillOnce(Return(true));
+  Extensions::Common::DynamicForwardProxy::MockLoadDnsCacheEntryHandle* handle =
+      new Extensions::Common::DynamicForwardProxy::MockLoadDnsCacheEntryHandle();
+  EXPECT_CALL(*dns_cache_manager_->dns_cache_, loadDnsCacheEntry_(Eq("foo"), 443, _))
+      .WillOnce(Return(MockLoadDnsCacheEntryResult{LoadDnsCacheEntryStatus::Loading, handle}));
+  EXPECT_EQ(Http::FilterHeadersStatus::StopAllIterationAndWatermark,
+            filter_->decodeHeaders(request_headers_, false));
+
+  EXPECT_CALL(callbacks_, continueDecoding()).Times(0);
+  EXPECT_CALL(callbacks_, sendLocalReply(Http::Code::ServiceUnavailable, Eq("DNS cache overflow"),
+                                         _, _, Eq("DNS cache overflow")));
+  EXPECT_CALL(callbacks_, encodeHeaders_(_, false));
+  EXPECT_CALL(callbacks_, encodeData(_, true));
+  filter_->onLoadDnsCacheOverflow();
+  EXPECT_TRUE(
+      cm_.thread_local_cluster_.cluster_.info_->resource_manager_->pendingRequests().canCreate());
+
+  EXPECT_CALL(*handle, onDestroy());
+  filter_->onDestroy();
+}
+
 // Circuit breaker overflow
 TEST_F(ProxyFilterTest, CircuitBreakerOverflow) {
   InSequence s;
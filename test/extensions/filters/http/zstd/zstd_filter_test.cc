@@ -0,0 +1,115 @@
+#include <memory>
+
+#include "envoy/extensions/filters/http/zstd/v3/zstd.pb.h"
+
+#include "common/decompressor/zstd_decompressor_impl.h"
+#include "common/protobuf/utility.h"
+
+#include "extensions/filters/http/zstd/zstd_filter.h"
+
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/stats/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::NiceMock;
+
+namespace Envoy {
+namespace Extensions {
+namespace HttpFilters {
+namespace Zstd {
+namespace {
+
+class ZstdFilterTest : public testing::Test {
+protected:
+  void SetUp() override { setUpFilter("{}"); }
+
+  void setUpFilter(const std::string& json) {
+    envoy::extensions::filters::http::zstd::v3::Zstd zstd;
+    TestUtility::loadFromJson(json, zstd);
+    config_ = std::make_shared<ZstdFilterConfig>(zstd, "test.", stats_, runtime_);
+    filter_ = std::make_unique<Common::Compressors::CompressorFilter>(config_);
+    filter_->setEncoderFilterCallbacks(encoder_callbacks_);
+    filter_->setDecoderFilterCallbacks(decoder_callbacks_);
+  }
+
+  void doRequest(Http::TestRequestHeaderMapImpl&& headers) {
+    EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->decodeHeaders(headers, false));
+  }
+
+  std::shared_ptr<ZstdFilterConfig> config_;
+  std::unique_ptr<Common::Compressors::CompressorFilter> filter_;
+  Stats::TestUtil::TestStore stats_;
+  NiceMock<Runtime::MockLoader> runtime_;
+  NiceMock<Http::MockStreamEncoderFilterCallbacks> encoder_callbacks_;
+  NiceMock<Http::MockStreamDecoderFilterCallbacks> decoder_callbacks_;
+};
+
+TEST_F(ZstdFilterTest, DefaultConfigValues) {
+  EXPECT_EQ(3U, config_->compressionLevel());
+  EXPECT_EQ(0U, config_->windowLog());
+  EXPECT_FALSE(config_->enableChecksum());
+  EXPECT_EQ(4096U, config_->chunkSize());
+  EXPECT_EQ(30U, config_->minimumLength());
+  EXPECT_EQ("zstd", config_->contentEncoding());
+}
+
+TEST_F(ZstdFilterTest, CustomConfigValues) {
+  setUpFilter(R"EOF(
+{
+  "compression_level": 19,
+  "window_log": 20,
+  "enable_checksum": true,
+  "chunk_size": 8192,
+  "compressor": {
+    "content_length": 100
+  }
+}
+)EOF");
+  EXPECT_EQ(19U, config_->compressionLevel());
+  EXPECT_EQ(20U, config_->windowLog());
+  EXPECT_TRUE(config_->enableChecksum());
+  EXPECT_EQ(8192U, config_->chunkSize());
+  EXPECT_EQ(100U, config_->minimumLength());
+}
+
+// A response is zstd encoded when the user agent asks for it, and decodes back to the original.
+TEST_F(ZstdFilterTest, AcceptEncodingZstd) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip;q=0.5, zstd"}});
+
+  Buffer::OwnedImpl data;
+  TestUtility::feedBufferWithRandomCharacters(data, 1000);
+  const std::string expected = data.toString();
+
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "1000"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_EQ("zstd", headers.get_("content-encoding"));
+  EXPECT_EQ("", headers.get_("content-length"));
+  EXPECT_EQ(Http::FilterDataStatus::Continue, filter_->encodeData(data, true));
+
+  Decompressor::ZstdDecompressorImpl decompressor(4096);
+  Buffer::OwnedImpl decompressed;
+  decompressor.decompress(data, decompressed);
+  EXPECT_EQ(expected, decompressed.toString());
+  EXPECT_EQ(1U, stats_.counter("test.zstd.compressed").value());
+  EXPECT_EQ(1U, stats_.counter("test.zstd.header_compressor_used").value());
+  EXPECT_EQ(1000U, stats_.counter("test.zstd.total_uncompressed_bytes").value());
+  EXPECT_EQ(data.length(), stats_.counter("test.zstd.total_compressed_bytes").value());
+}
+
+TEST_F(ZstdFilterTest, AcceptEncodingGzipOnly) {
+  doRequest({{":method", "get"}, {"accept-encoding", "gzip"}});
+
+  Http::TestResponseHeaderMapImpl headers{{":status", "200"}, {"content-length", "1000"}};
+  EXPECT_EQ(Http::FilterHeadersStatus::Continue, filter_->encodeHeaders(headers, false));
+  EXPECT_FALSE(headers.has("content-encoding"));
+  EXPECT_EQ(1U, stats_.counter("test.zstd.not_compressed").value());
+}
+
+} // namespace
+} // namespace Zstd
+} // namespace HttpFilters
+} // namespace Extensions
+} // namespace Envoy
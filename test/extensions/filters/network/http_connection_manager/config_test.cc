@@ -7,7 +7,9 @@
 #include "common/buffer/buffer_impl.h"
 #include "common/http/date_provider_impl.h"
 #include "common/http/request_id_extension_uuid_impl.h"
+#include "common/router/router.h"
 
+#include "extensions/filters/http/dynamo/dynamo_filter.h"
 #include "extensions/filters/network/http_connection_manager/config.h"
 
 #include "test/extensions/filters/network/http_connection_manager/config.pb.h"
@@ -28,6 +30,7 @@ using testing::Eq;
 using testing::NotNull;
 using testing::Pointee;
 using testing::Return;
+using testing::SaveArg;
 using testing::WhenDynamicCastTo;
 
 namespace Envoy {
@@ -498,6 +501,9 @@ TEST_F(HttpConnectionManagerConfigTest, SamplingDefault) {
   EXPECT_EQ(100, config.tracingConfig()->overall_sampling_.numerator());
   EXPECT_EQ(envoy::type::v3::FractionalPercent::HUNDRED,
             config.tracingConfig()->overall_sampling_.denominator());
+  EXPECT_EQ(nullptr, config.tracingConfig()->random_sampling_limiter_);
+  EXPECT_EQ(absl::nullopt, config.tracingConfig()->tail_sampling_min_duration_);
+  EXPECT_FALSE(config.tracingConfig()->tail_sampling_server_errors_);
 }
 
 TEST_F(HttpConnectionManagerConfigTest, SamplingConfigured) {
@@ -534,6 +540,29 @@ TEST_F(HttpConnectionManagerConfigTest, SamplingConfigured) {
             config.tracingConfig()->overall_sampling_.denominator());
 }
 
+TEST_F(HttpConnectionManagerConfigTest, RateLimitedAndTailSamplingConfigured) {
+  const std::string yaml_string = R"EOF(
+  stat_prefix: ingress_http
+  route_config:
+    name: local_route
+  tracing:
+    max_random_samples_per_second: 10
+    tail_sampling:
+      min_duration: 0.5s
+      server_errors: true
+  http_filters:
+  - name: envoy.filters.http.router
+  )EOF";
+
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(yaml_string), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_);
+
+  EXPECT_NE(nullptr, config.tracingConfig()->random_sampling_limiter_);
+  EXPECT_EQ(std::chrono::milliseconds(500), config.tracingConfig()->tail_sampling_min_duration_);
+  EXPECT_TRUE(config.tracingConfig()->tail_sampling_server_errors_);
+}
+
 TEST_F(HttpConnectionManagerConfigTest, FractionalSamplingConfigured) {
   const std::string yaml_string = R"EOF(
   stat_prefix: ingress_http
@@ -1569,6 +1598,46 @@ TEST_F(FilterChainTest, CreateFilterChain) {
   config.createFilterChain(callbacks);
 }
 
+TEST_F(FilterChainTest, CreateFilterChainWithFilterLatencyStats) {
+  auto hcm_config = parseHttpConnectionManagerFromV2Yaml(basic_config_);
+  hcm_config.mutable_filter_latency_stats()->mutable_sampling()->set_value(50);
+  HttpConnectionManagerConfig config(hcm_config, context_, date_provider_,
+                                     route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_);
+
+  EXPECT_TRUE(context_.scope_
+                  .findHistogramByString(
+                      "http.router.filter_latency.envoy.filters.http.dynamo.decode_us")
+                  .has_value());
+  EXPECT_TRUE(context_.scope_
+                  .findHistogramByString(
+                      "http.router.filter_latency.envoy.filters.http.router.encode_us")
+                  .has_value());
+
+  // Each filter is sampled separately, the router is timed while Dynamo is not.
+  EXPECT_CALL(context_.random_, random()).WillOnce(Return(5000)).WillOnce(Return(4999));
+  Http::StreamFilterSharedPtr dynamo_filter;
+  Http::StreamDecoderFilterSharedPtr router_filter;
+  Http::MockFilterChainFactoryCallbacks callbacks;
+  EXPECT_CALL(callbacks, addStreamFilter(_)).WillOnce(SaveArg<0>(&dynamo_filter));
+  EXPECT_CALL(callbacks, addStreamDecoderFilter(_)).WillOnce(SaveArg<0>(&router_filter));
+  config.createFilterChain(callbacks);
+
+  EXPECT_NE(nullptr, dynamic_cast<HttpFilters::Dynamo::DynamoFilter*>(dynamo_filter.get()));
+  EXPECT_EQ(nullptr, dynamic_cast<Router::ProdFilter*>(router_filter.get()));
+}
+
+TEST_F(FilterChainTest, CreateFilterChainWithoutFilterLatencyStats) {
+  HttpConnectionManagerConfig config(parseHttpConnectionManagerFromV2Yaml(basic_config_), context_,
+                                     date_provider_, route_config_provider_manager_,
+                                     scoped_routes_config_provider_manager_, http_tracer_manager_);
+
+  EXPECT_FALSE(context_.scope_
+                   .findHistogramByString(
+                       "http.router.filter_latency.envoy.filters.http.dynamo.decode_us")
+                   .has_value());
+}
+
 // Tests where upgrades are configured on via the HCM.
 TEST_F(FilterChainTest, CreateUpgradeFilterChain) {
   auto hcm_config = parseHttpConnectionManagerFromV2Yaml(basic_config_);
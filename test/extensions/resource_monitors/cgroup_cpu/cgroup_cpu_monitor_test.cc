@@ -0,0 +1,116 @@
+#include "envoy/config/resource_monitor/cgroup_cpu/v2alpha/cgroup_cpu.pb.h"
+
+#include "extensions/resource_monitors/cgroup_cpu/cgroup_cpu_monitor.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Return;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupCpuMonitor {
+namespace {
+
+class MockCgroupStatsReader : public Common::CgroupStatsReader {
+public:
+  MOCK_METHOD(uint64_t, memoryUsage, ());
+  MOCK_METHOD(absl::optional<uint64_t>, memoryLimit, ());
+  MOCK_METHOD(std::chrono::microseconds, cpuUsage, ());
+  MOCK_METHOD(absl::optional<double>, cpuLimit, ());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+  std::string error() const { return error_->what(); }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+class CgroupCpuMonitorTest : public testing::Test {
+protected:
+  std::unique_ptr<CgroupCpuMonitor> createMonitor() {
+    auto stats_reader = std::make_unique<MockCgroupStatsReader>();
+    stats_reader_ = stats_reader.get();
+    return std::make_unique<CgroupCpuMonitor>(config_, std::move(stats_reader), time_system_);
+  }
+
+  ResourcePressure update(CgroupCpuMonitor& monitor) {
+    ResourcePressure resource;
+    monitor.updateResourceUsage(resource);
+    return resource;
+  }
+
+  envoy::config::resource_monitor::cgroup_cpu::v2alpha::CgroupCpuConfig config_;
+  Event::SimulatedTimeSystem time_system_;
+  MockCgroupStatsReader* stats_reader_; // not owned
+};
+
+TEST_F(CgroupCpuMonitorTest, ComputesUsageRelativeToQuota) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, cpuLimit()).WillRepeatedly(Return(2.0));
+
+  // There is no interval to measure the usage over yet.
+  EXPECT_CALL(*stats_reader_, cpuUsage()).WillOnce(Return(std::chrono::seconds(10)));
+  ResourcePressure resource = update(*monitor);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_EQ(0, resource.pressure());
+
+  // 1.5 CPU seconds in one second, out of a quota of two CPUs.
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_CALL(*stats_reader_, cpuUsage()).WillOnce(Return(std::chrono::milliseconds(11500)));
+  resource = update(*monitor);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.75, resource.pressure());
+
+  time_system_.sleep(std::chrono::milliseconds(500));
+  EXPECT_CALL(*stats_reader_, cpuUsage()).WillOnce(Return(std::chrono::milliseconds(12500)));
+  resource = update(*monitor);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(1, resource.pressure());
+}
+
+TEST_F(CgroupCpuMonitorTest, UsesConfiguredLimitWithoutQuota) {
+  config_.set_max_cpus(4);
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, cpuLimit()).WillRepeatedly(Return(absl::nullopt));
+
+  EXPECT_CALL(*stats_reader_, cpuUsage()).WillOnce(Return(std::chrono::seconds(0)));
+  update(*monitor);
+  time_system_.sleep(std::chrono::seconds(1));
+  EXPECT_CALL(*stats_reader_, cpuUsage()).WillOnce(Return(std::chrono::seconds(1)));
+  ResourcePressure resource = update(*monitor);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+}
+
+TEST_F(CgroupCpuMonitorTest, FailsWithoutQuota) {
+  auto monitor = createMonitor();
+  EXPECT_CALL(*stats_reader_, cpuLimit()).WillOnce(Return(absl::nullopt));
+
+  ResourcePressure resource = update(*monitor);
+  ASSERT_TRUE(resource.hasError());
+  EXPECT_EQ("cgroup has no CPU quota", resource.error());
+}
+
+} // namespace
+} // namespace CgroupCpuMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,101 @@
+#include "envoy/config/resource_monitor/cgroup_memory/v2alpha/cgroup_memory.pb.h"
+
+#include "extensions/resource_monitors/cgroup_memory/cgroup_memory_monitor.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::Return;
+using testing::Throw;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace CgroupMemoryMonitor {
+namespace {
+
+class MockCgroupStatsReader : public Common::CgroupStatsReader {
+public:
+  MOCK_METHOD(uint64_t, memoryUsage, ());
+  MOCK_METHOD(absl::optional<uint64_t>, memoryLimit, ());
+  MOCK_METHOD(std::chrono::microseconds, cpuUsage, ());
+  MOCK_METHOD(absl::optional<double>, cpuLimit, ());
+};
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException& error) override { error_ = error; }
+
+  bool hasPressure() const { return pressure_.has_value(); }
+  bool hasError() const { return error_.has_value(); }
+
+  double pressure() const { return *pressure_; }
+  std::string error() const { return error_->what(); }
+
+private:
+  absl::optional<double> pressure_;
+  absl::optional<EnvoyException> error_;
+};
+
+TEST(CgroupMemoryMonitorTest, ComputesCorrectUsage) {
+  envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig config;
+  auto stats_reader = std::make_unique<MockCgroupStatsReader>();
+  EXPECT_CALL(*stats_reader, memoryLimit()).WillOnce(Return(1000));
+  EXPECT_CALL(*stats_reader, memoryUsage()).WillOnce(Return(700));
+  CgroupMemoryMonitor monitor(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.7, resource.pressure());
+}
+
+TEST(CgroupMemoryMonitorTest, UsesConfiguredLimitWithoutCgroupLimit) {
+  envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig config;
+  config.set_max_memory_bytes(2000);
+  auto stats_reader = std::make_unique<MockCgroupStatsReader>();
+  EXPECT_CALL(*stats_reader, memoryLimit()).WillOnce(Return(absl::nullopt));
+  EXPECT_CALL(*stats_reader, memoryUsage()).WillOnce(Return(500));
+  CgroupMemoryMonitor monitor(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasPressure());
+  EXPECT_DOUBLE_EQ(0.25, resource.pressure());
+}
+
+TEST(CgroupMemoryMonitorTest, FailsWithoutLimit) {
+  envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig config;
+  auto stats_reader = std::make_unique<MockCgroupStatsReader>();
+  EXPECT_CALL(*stats_reader, memoryLimit()).WillOnce(Return(absl::nullopt));
+  CgroupMemoryMonitor monitor(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasError());
+  EXPECT_EQ("cgroup has no memory limit", resource.error());
+}
+
+TEST(CgroupMemoryMonitorTest, FailsOnReadError) {
+  envoy::config::resource_monitor::cgroup_memory::v2alpha::CgroupMemoryConfig config;
+  auto stats_reader = std::make_unique<MockCgroupStatsReader>();
+  EXPECT_CALL(*stats_reader, memoryLimit())
+      .WillOnce(Throw(EnvoyException("unable to open memory.max")));
+  CgroupMemoryMonitor monitor(config, std::move(stats_reader));
+
+  ResourcePressure resource;
+  monitor.updateResourceUsage(resource);
+  ASSERT_TRUE(resource.hasError());
+  EXPECT_EQ("unable to open memory.max", resource.error());
+}
+
+} // namespace
+} // namespace CgroupMemoryMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,138 @@
+#include <fstream>
+#include <string>
+
+#include "extensions/resource_monitors/common/cgroup_stats_reader.h"
+
+#include "test/test_common/environment.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace Common {
+namespace {
+
+class CgroupStatsReaderTest : public testing::Test {
+protected:
+  // Writes the file in place, the way the kernel updates cgroup files, so that the file descriptors
+  // the reader keeps open see the new contents.
+  void writeFile(const std::string& path, const std::string& contents) {
+    const std::string full_path = absl::StrCat(root_, "/", path);
+    TestEnvironment::createPath(full_path.substr(0, full_path.rfind('/')));
+    std::ofstream file(full_path, std::ios_base::out | std::ios_base::trunc);
+    file << contents;
+  }
+
+  const std::string root_{TestEnvironment::temporaryPath(
+      absl::StrCat("cgroup_", testing::UnitTest::GetInstance()->current_test_info()->name()))};
+};
+
+TEST_F(CgroupStatsReaderTest, V2) {
+  writeFile("cgroup.controllers", "cpu memory\n");
+  writeFile("memory.current", "3000\n");
+  writeFile("memory.max", "8000\n");
+  writeFile("memory.stat", "anon 2000\nfile 1000\ninactive_file 600\nactive_file 400\n");
+  writeFile("cpu.stat", "usage_usec 250000\nuser_usec 200000\nsystem_usec 50000\n");
+  writeFile("cpu.max", "150000 100000\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/missing"));
+  EXPECT_EQ(2400, reader.memoryUsage());
+  EXPECT_EQ(8000, reader.memoryLimit());
+  EXPECT_EQ(std::chrono::microseconds(250000), reader.cpuUsage());
+  EXPECT_DOUBLE_EQ(1.5, reader.cpuLimit().value());
+
+  // The files are read again on each call.
+  writeFile("memory.current", "5000\n");
+  writeFile("memory.max", "max\n");
+  writeFile("cpu.max", "max 100000\n");
+  EXPECT_EQ(4400, reader.memoryUsage());
+  EXPECT_FALSE(reader.memoryLimit().has_value());
+  EXPECT_FALSE(reader.cpuLimit().has_value());
+}
+
+TEST_F(CgroupStatsReaderTest, V1) {
+  writeFile("memory/memory.usage_in_bytes", "3000\n");
+  writeFile("memory/memory.limit_in_bytes", "8000\n");
+  writeFile("memory/memory.stat", "cache 1000\nrss 2000\ntotal_inactive_file 500\n");
+  writeFile("cpuacct/cpuacct.usage", "250000000\n");
+  writeFile("cpu/cpu.cfs_quota_us", "50000\n");
+  writeFile("cpu/cpu.cfs_period_us", "100000\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/missing"));
+  EXPECT_EQ(2500, reader.memoryUsage());
+  EXPECT_EQ(8000, reader.memoryLimit());
+  EXPECT_EQ(std::chrono::microseconds(250000), reader.cpuUsage());
+  EXPECT_DOUBLE_EQ(0.5, reader.cpuLimit().value());
+
+  writeFile("memory/memory.limit_in_bytes", "9223372036854771712\n");
+  writeFile("cpu/cpu.cfs_quota_us", "-1\n");
+  EXPECT_FALSE(reader.memoryLimit().has_value());
+  EXPECT_FALSE(reader.cpuLimit().has_value());
+}
+
+// The files of the cgroup of the process are read, rather than those of the root cgroup.
+TEST_F(CgroupStatsReaderTest, V2NestedCgroup) {
+  writeFile("cgroup.controllers", "cpu memory\n");
+  writeFile("memory.current", "1\n");
+  writeFile("kubepods/pod1/memory.current", "3000\n");
+  writeFile("kubepods/pod1/memory.stat", "inactive_file 600\n");
+  writeFile("proc_cgroup", "0::/kubepods/pod1\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/proc_cgroup"));
+  EXPECT_EQ(2400, reader.memoryUsage());
+}
+
+TEST_F(CgroupStatsReaderTest, V1NestedCgroup) {
+  writeFile("memory/docker/abc/memory.usage_in_bytes", "3000\n");
+  writeFile("memory/docker/abc/memory.stat", "total_inactive_file 500\n");
+  writeFile("cpuacct/docker/abc/cpuacct.usage", "250000000\n");
+  writeFile("cpu/docker/abc/cpu.cfs_quota_us", "50000\n");
+  writeFile("cpu/docker/abc/cpu.cfs_period_us", "100000\n");
+  writeFile("proc_cgroup", "12:pids:/docker/abc\n"
+                           "4:memory:/docker/abc\n"
+                           "3:cpu,cpuacct:/docker/abc\n"
+                           "0::/system.slice/docker.service\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/proc_cgroup"));
+  EXPECT_EQ(2500, reader.memoryUsage());
+  EXPECT_EQ(std::chrono::microseconds(250000), reader.cpuUsage());
+  EXPECT_DOUBLE_EQ(0.5, reader.cpuLimit().value());
+}
+
+// Without a cgroup namespace, the cgroup of the container is mounted at the root of the hierarchy
+// while /proc/self/cgroup has its full path.
+TEST_F(CgroupStatsReaderTest, CgroupNotMounted) {
+  writeFile("memory/memory.usage_in_bytes", "3000\n");
+  writeFile("memory/memory.stat", "total_inactive_file 500\n");
+  writeFile("proc_cgroup", "4:memory:/docker/abc\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/proc_cgroup"));
+  EXPECT_EQ(2500, reader.memoryUsage());
+}
+
+TEST_F(CgroupStatsReaderTest, Errors) {
+  writeFile("cgroup.controllers", "cpu memory\n");
+  writeFile("memory.current", "lots\n");
+  writeFile("memory.stat", "anon 2000\n");
+  writeFile("cpu.max", "100000\n");
+
+  CgroupStatsReaderImpl reader(root_, absl::StrCat(root_, "/missing"));
+  EXPECT_THROW_WITH_MESSAGE(reader.memoryUsage(), EnvoyException,
+                            absl::StrCat("invalid value in ", root_, "/memory.current"));
+  EXPECT_THROW_WITH_REGEX(reader.memoryLimit(), EnvoyException, "unable to open .*/memory.max");
+  EXPECT_THROW_WITH_REGEX(reader.cpuUsage(), EnvoyException, "unable to open .*/cpu.stat");
+  EXPECT_THROW_WITH_MESSAGE(reader.cpuLimit(), EnvoyException, "invalid cgroup CPU quota");
+
+  writeFile("memory.current", "3000\n");
+  EXPECT_THROW_WITH_MESSAGE(
+      reader.memoryUsage(), EnvoyException,
+      absl::StrCat("unable to find inactive_file in ", root_, "/memory.stat"));
+}
+
+} // namespace
+} // namespace Common
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
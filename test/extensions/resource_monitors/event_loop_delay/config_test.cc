@@ -0,0 +1,42 @@
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.validate.h"
+#include "envoy/registry/registry.h"
+
+#include "server/resource_monitor_config_impl.h"
+
+#include "extensions/resource_monitors/event_loop_delay/config.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/thread_local/mocks.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+namespace {
+
+TEST(EventLoopDelayMonitorFactoryTest, CreateMonitor) {
+  auto factory =
+      Registry::FactoryRegistry<Server::Configuration::ResourceMonitorFactory>::getFactory(
+          "envoy.resource_monitors.event_loop_delay");
+  ASSERT_NE(factory, nullptr);
+
+  envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig config;
+  config.mutable_max_delay()->set_seconds(1);
+  Event::MockDispatcher dispatcher;
+  Api::ApiPtr api = Api::createApiForTest();
+  ThreadLocal::MockInstance tls;
+  EXPECT_CALL(tls, allocateSlot());
+  Server::Configuration::ResourceMonitorFactoryContextImpl context(
+      dispatcher, *api, ProtobufMessage::getStrictValidationVisitor(), tls);
+  auto monitor = factory->createResourceMonitor(config, context);
+  EXPECT_NE(monitor, nullptr);
+}
+
+} // namespace
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
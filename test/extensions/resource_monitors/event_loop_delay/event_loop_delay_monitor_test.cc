@@ -0,0 +1,115 @@
+#include "envoy/config/resource_monitor/event_loop_delay/v2alpha/event_loop_delay.pb.h"
+
+#include "extensions/resource_monitors/event_loop_delay/event_loop_delay_monitor.h"
+
+#include "test/mocks/thread_local/mocks.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "absl/types/optional.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::DoAll;
+using testing::NiceMock;
+using testing::SaveArg;
+
+namespace Envoy {
+namespace Extensions {
+namespace ResourceMonitors {
+namespace EventLoopDelayMonitor {
+namespace {
+
+class ResourcePressure : public Server::ResourceMonitor::Callbacks {
+public:
+  void onSuccess(const Server::ResourceUsage& usage) override {
+    pressure_ = usage.resource_pressure_;
+  }
+
+  void onFailure(const EnvoyException&) override { FAIL(); }
+
+  double pressure() const { return *pressure_; }
+
+private:
+  absl::optional<double> pressure_;
+};
+
+class EventLoopDelayMonitorTest : public testing::Test {
+protected:
+  EventLoopDelayMonitorTest() {
+    envoy::config::resource_monitor::event_loop_delay::v2alpha::EventLoopDelayConfig config;
+    config.mutable_max_delay()->set_seconds(1);
+    monitor_ = std::make_unique<EventLoopDelayMonitor>(config, time_system_, tls_);
+  }
+
+  // Updates the monitor, expecting it to post a probe, which is held instead of being run.
+  double updateAndHoldProbe() {
+    EXPECT_CALL(tls_, runOnAllThreads(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&probe_), SaveArg<1>(&probe_complete_)));
+    return update();
+  }
+
+  double update() {
+    ResourcePressure resource;
+    monitor_->updateResourceUsage(resource);
+    return resource.pressure();
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  NiceMock<ThreadLocal::MockInstance> tls_;
+  std::unique_ptr<EventLoopDelayMonitor> monitor_;
+  Event::PostCb probe_;
+  Event::PostCb probe_complete_;
+};
+
+TEST_F(EventLoopDelayMonitorTest, ReportsDelayOfSlowestThread) {
+  EXPECT_EQ(0, updateAndHoldProbe());
+
+  // Two threads run the probe, the slowest one after 500ms.
+  time_system_.sleep(std::chrono::milliseconds(200));
+  probe_();
+  time_system_.sleep(std::chrono::milliseconds(300));
+  probe_();
+  probe_complete_();
+
+  EXPECT_DOUBLE_EQ(0.5, updateAndHoldProbe());
+
+  // The next probe runs without delay.
+  probe_();
+  probe_complete_();
+  EXPECT_DOUBLE_EQ(0, updateAndHoldProbe());
+  probe_();
+  probe_complete_();
+}
+
+TEST_F(EventLoopDelayMonitorTest, ReportsPendingProbe) {
+  EXPECT_EQ(0, updateAndHoldProbe());
+
+  // A thread which doesn't get to the probe is reported without waiting for it, and no further
+  // probes are posted until it does.
+  time_system_.sleep(std::chrono::milliseconds(700));
+  EXPECT_CALL(tls_, runOnAllThreads(_, _)).Times(0);
+  EXPECT_DOUBLE_EQ(0.7, update());
+  time_system_.sleep(std::chrono::milliseconds(800));
+  EXPECT_DOUBLE_EQ(1.5, update());
+
+  probe_();
+  probe_complete_();
+  EXPECT_DOUBLE_EQ(1.5, updateAndHoldProbe());
+  probe_();
+  probe_complete_();
+}
+
+TEST_F(EventLoopDelayMonitorTest, ProbeOutlivesMonitor) {
+  updateAndHoldProbe();
+  monitor_.reset();
+  time_system_.sleep(std::chrono::milliseconds(100));
+  probe_();
+  probe_complete_();
+}
+
+} // namespace
+} // namespace EventLoopDelayMonitor
+} // namespace ResourceMonitors
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,97 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures how fast the reporter can turn a full span buffer into a collector request body, for
+// each of the collector endpoint versions.
+
+#include "envoy/config/trace/v3/trace.pb.h"
+
+#include "common/buffer/buffer_impl.h"
+#include "common/network/utility.h"
+
+#include "extensions/tracers/zipkin/span_buffer.h"
+#include "extensions/tracers/zipkin/zipkin_core_constants.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace Tracers {
+namespace Zipkin {
+namespace {
+
+Span createSpan(TimeSource& time_source, uint64_t id) {
+  Endpoint endpoint;
+  endpoint.setAddress(Network::Utility::parseInternetAddress("1.2.3.4", 8080, false));
+  endpoint.setServiceName("service1");
+
+  Annotation client_send;
+  client_send.setValue(CLIENT_SEND);
+  client_send.setTimestamp(1584324295476870);
+  client_send.setEndpoint(endpoint);
+  Annotation client_recv;
+  client_recv.setValue(CLIENT_RECV);
+  client_recv.setTimestamp(1584324295477870);
+  client_recv.setEndpoint(endpoint);
+
+  std::vector<BinaryAnnotation> tags;
+  for (const auto& tag : std::vector<std::pair<std::string, std::string>>{
+           {"component", "proxy"},
+           {"node_id", "node1"},
+           {"http.method", "GET"},
+           {"http.url", "https://example.com/some/path?with=query"},
+           {"http.status_code", "200"},
+           {"upstream_cluster", "service2"}}) {
+    BinaryAnnotation binary_annotation;
+    binary_annotation.setKey(tag.first);
+    binary_annotation.setValue(tag.second);
+    tags.push_back(binary_annotation);
+  }
+
+  Span span(time_source);
+  span.setName("egress example.com");
+  span.setId(id);
+  span.setTraceId(id);
+  span.setParentId(id + 1);
+  span.setDuration(1000);
+  span.setAnnotations({client_send, client_recv});
+  span.setBinaryAnnotations(tags);
+  return span;
+}
+
+void serializeSpans(benchmark::State& state,
+                    envoy::config::trace::v3::ZipkinConfig::CollectorEndpointVersion version) {
+  Event::SimulatedTimeSystem time_system;
+  const uint64_t num_spans = state.range(0);
+  SpanBuffer span_buffer(version, false, num_spans);
+  for (uint64_t i = 0; i < num_spans; ++i) {
+    span_buffer.addSpan(createSpan(time_system, i));
+  }
+
+  for (auto _ : state) {
+    Buffer::OwnedImpl body;
+    span_buffer.serialize(body);
+    benchmark::DoNotOptimize(body.length());
+  }
+  state.SetItemsProcessed(state.iterations() * num_spans);
+}
+
+} // namespace
+
+// Args: number of spans per flush.
+static void BM_SerializeJsonV2(benchmark::State& state) {
+  serializeSpans(state, envoy::config::trace::v3::ZipkinConfig::HTTP_JSON);
+}
+BENCHMARK(BM_SerializeJsonV2)->Arg(1)->Arg(100)->Arg(1000);
+
+static void BM_SerializeProto(benchmark::State& state) {
+  serializeSpans(state, envoy::config::trace::v3::ZipkinConfig::HTTP_PROTO);
+}
+BENCHMARK(BM_SerializeProto)->Arg(1)->Arg(100)->Arg(1000);
+
+} // namespace Zipkin
+} // namespace Tracers
+} // namespace Extensions
+} // namespace Envoy
@@ -1,5 +1,6 @@
 #include "envoy/config/trace/v3/trace.pb.h"
 
+#include "common/buffer/buffer_impl.h"
 #include "common/network/utility.h"
 #include "common/protobuf/utility.h"
 
@@ -447,6 +448,66 @@ TEST(ZipkinSpanBufferTest, TestSerializeTimestampInTheFuture) {
   EXPECT_THAT(bufferJsonV2.serialize(), Not(HasSubstr(R"("duration":"2584324295476870")")));
 }
 
+// Span names and tag values come from requests, so they must be escaped when written as JSON.
+// A tag that is set more than once keeps its last value.
+TEST(ZipkinSpanBufferTest, SerializeEscapedStringsAndRepeatedTags) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, false, 2);
+  Span span = createSpan({"cs"}, IpType::V4);
+  span.setName("GET \"/a\\b\"\n");
+  BinaryAnnotation tag;
+  tag.setKey("component");
+  tag.setValue("proxy\x01");
+  span.setBinaryAnnotations({createTag(), tag});
+  buffer.addSpan(std::move(span));
+
+  EXPECT_THAT(wrapAsObject(R"([{)"
+                           R"("traceId":"0000000000000001",)"
+                           R"("id":"0000000000000001",)"
+                           R"("kind":"CLIENT",)"
+                           R"("name":"GET \"/a\\b\"\n",)"
+                           R"("timestamp":DEFAULT_TEST_TIMESTAMP,)"
+                           R"("duration":DEFAULT_TEST_DURATION,)"
+                           R"("localEndpoint":{)"
+                           R"("serviceName":"service1",)"
+                           R"("ipv4":"1.2.3.4",)"
+                           R"("port":8080},)"
+                           R"("tags":{)"
+                           R"("component":"proxy\u0001"})"
+                           R"(}])"),
+              JsonStringEq(wrapAsObject(buffer.serialize())));
+}
+
+// Serialized spans are appended to what the output buffer already holds.
+TEST(ZipkinSpanBufferTest, SerializeAppendsToBuffer) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, false, 2);
+  buffer.addSpan(createSpan({"cs"}, IpType::V4));
+  const std::string serialized = buffer.serialize();
+
+  Buffer::OwnedImpl output("prefix");
+  buffer.serialize(output);
+  EXPECT_EQ(absl::StrCat("prefix", serialized), output.toString());
+}
+
+// JSON spans larger than a single reservation of the output buffer are written across several
+// slices.
+TEST(ZipkinSpanBufferTest, SerializeAcrossBufferSlices) {
+  SpanBuffer buffer(envoy::config::trace::v3::ZipkinConfig::HTTP_JSON, false, 2);
+  Span span = createSpan({"cs"}, IpType::V4);
+  const std::string value(40000, 'v');
+  BinaryAnnotation tag;
+  tag.setKey("component");
+  tag.setValue(value);
+  span.setBinaryAnnotations({tag});
+  buffer.addSpan(std::move(span));
+
+  Buffer::OwnedImpl output;
+  buffer.serialize(output);
+  EXPECT_GT(output.getRawSlices().size(), 1U);
+  EXPECT_THAT(output.toString(),
+              HasSubstr(absl::StrCat(R"("tags":{"component":")", value, R"("})")));
+  EXPECT_EQ(buffer.serialize(), output.toString());
+}
+
 } // namespace
 } // namespace Zipkin
 } // namespace Tracers
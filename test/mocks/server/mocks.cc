@@ -133,6 +133,13 @@ MockWorker::MockWorker() {
             remove_listener_completion_ = completion;
           }));
 
+  ON_CALL(*this, removeFilterChains(_, _, _))
+      .WillByDefault(Invoke([this](uint64_t, const std::list<const Network::FilterChain*>&,
+                                   std::function<void()> completion) -> void {
+        EXPECT_EQ(nullptr, remove_filter_chains_completion_);
+        remove_filter_chains_completion_ = completion;
+      }));
+
   ON_CALL(*this, stopListener(_, _))
       .WillByDefault(Invoke([](Network::ListenerConfig&, std::function<void()> completion) -> void {
         if (completion != nullptr) {
@@ -57,7 +57,7 @@ public:
           hand_off_restored_destination_connections_(hand_off_restored_destination_connections),
           name_(name), listener_filters_timeout_(listener_filters_timeout),
           continue_on_listener_filters_timeout_(continue_on_listener_filters_timeout),
-          connection_balancer_(std::make_unique<Network::NopConnectionBalancerImpl>()) {
+          connection_balancer_(std::make_shared<Network::NopConnectionBalancerImpl>()) {
       envoy::config::listener::v3::UdpListenerConfig dummy;
       std::string listener_name("raw_udp_listener");
       dummy.set_udp_listener_name(listener_name);
@@ -106,7 +106,7 @@ public:
     const std::chrono::milliseconds listener_filters_timeout_;
     const bool continue_on_listener_filters_timeout_;
     std::unique_ptr<Network::ActiveUdpListenerFactory> udp_listener_factory_;
-    Network::ConnectionBalancerPtr connection_balancer_;
+    Network::ConnectionBalancerSharedPtr connection_balancer_;
     const std::vector<AccessLog::InstanceSharedPtr> empty_access_logs_;
   };
 
@@ -243,6 +243,60 @@ TEST_F(ConnectionHandlerTest, RemoveListener) {
   handler_->removeListeners(0);
 }
 
+// Verify that updating a listener in place keeps its connections, and that removing filter chains
+// only closes the connections of those filter chains.
+TEST_F(ConnectionHandlerTest, UpdateListenerAndRemoveFilterChains) {
+  Network::ListenerCallbacks* listener_callbacks;
+  auto listener = new NiceMock<Network::MockListener>();
+  TestListener* test_listener =
+      addListener(1, true, false, "test_listener", listener, &listener_callbacks);
+  EXPECT_CALL(*socket_factory_, localAddress()).WillRepeatedly(ReturnRef(local_address_));
+  handler_->addListener(*test_listener);
+
+  const Network::FilterChainSharedPtr other_filter_chain =
+      Network::Test::createEmptyFilterChainWithRawBufferSockets();
+  EXPECT_CALL(factory_, createNetworkFilterChain(_, _)).WillRepeatedly(Return(true));
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(filter_chain_.get()));
+  EXPECT_CALL(dispatcher_, createServerConnection_())
+      .WillOnce(Return(new NiceMock<Network::MockConnection>()));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+
+  EXPECT_CALL(manager_, findFilterChain(_)).WillOnce(Return(other_filter_chain.get()));
+  EXPECT_CALL(dispatcher_, createServerConnection_())
+      .WillOnce(Return(new NiceMock<Network::MockConnection>()));
+  listener_callbacks->onAccept(
+      Network::ConnectionSocketPtr{new NiceMock<Network::MockConnectionSocket>()});
+  EXPECT_EQ(2UL, handler_->numConnections());
+
+  // The new config shares the tag and the connection balancer of the listener it replaces.
+  auto updated_listener = std::make_unique<TestListener>(
+      *this, 1, true, false, "test_listener", Network::Address::SocketType::Stream,
+      std::chrono::milliseconds(15000), false, socket_factory_);
+  updated_listener->connection_balancer_ = test_listener->connection_balancer_;
+  handler_->updateListener(*updated_listener);
+  EXPECT_EQ(2UL, handler_->numConnections());
+  listeners_.emplace_back(std::move(updated_listener));
+
+  bool completed = false;
+  handler_->removeFilterChains(1, {filter_chain_.get()}, [&completed]() { completed = true; });
+  EXPECT_EQ(1UL, handler_->numConnections());
+  // The completion runs once the closed connection has been destroyed.
+  EXPECT_FALSE(completed);
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_TRUE(completed);
+
+  // Removing the filter chains of a listener which is already gone only runs the completion.
+  completed = false;
+  handler_->removeFilterChains(2, {other_filter_chain.get()}, [&completed]() { completed = true; });
+  dispatcher_.clearDeferredDeleteList();
+  EXPECT_TRUE(completed);
+  EXPECT_EQ(1UL, handler_->numConnections());
+
+  EXPECT_CALL(*listener, onDestroy());
+}
+
 TEST_F(ConnectionHandlerTest, DisableListener) {
   InSequence s;
 
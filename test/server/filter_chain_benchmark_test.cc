@@ -162,6 +162,11 @@ const char YamlSingleDstPortBottom[] = R"EOF(
           session_ticket_keys:
             keys:
             - filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/ticket_key_a")EOF";
+const char YamlSniTop[] = R"EOF(
+    - filter_chain_match:
+        transport_protocol: "tls"
+        server_names: ")EOF";
+const char YamlSniBottom[] = R"EOF(")EOF";
 } // namespace
 
 class FilterChainBenchmarkFixture : public benchmark::Fixture {
@@ -229,6 +234,77 @@ BENCHMARK_REGISTER_F(FilterChainBenchmarkFixture, FilterChainFindTest)
         {1, 4096},
     });
 
+// Filter chains which only differ by server name, as used to serve many TLS certificates from one
+// listener.
+class FilterChainSniBenchmarkFixture : public benchmark::Fixture {
+public:
+  void SetUp(const ::benchmark::State& state) override {
+    int64_t input_size = state.range(0);
+    std::vector<std::string> sni_chains;
+    sni_chains.reserve(input_size);
+    for (int i = 0; i < input_size; i++) {
+      sni_chains.push_back(absl::StrCat(YamlSniTop, serverName(i), YamlSniBottom));
+    }
+    listener_yaml_config_ = TestEnvironment::substitute(
+        absl::StrCat(YamlHeader, absl::StrJoin(sni_chains, "")), Network::Address::IpVersion::v4);
+    TestUtility::loadFromYaml(listener_yaml_config_, listener_config_);
+    filter_chains_ = listener_config_.filter_chains();
+  }
+
+  static std::string serverName(int i) { return absl::StrCat("server", i, ".example.com"); }
+
+  std::string listener_yaml_config_;
+  envoy::config::listener::v3::Listener listener_config_;
+  absl::Span<const envoy::config::listener::v3::FilterChain* const> filter_chains_;
+  MockFilterChainFactoryBuilder dummy_builder_;
+  Init::ManagerImpl init_manager_{"fcm_sni_benchmark"};
+};
+
+// NOLINTNEXTLINE(readability-redundant-member-init)
+BENCHMARK_DEFINE_F(FilterChainSniBenchmarkFixture, FilterChainManagerBuildTest)
+(::benchmark::State& state) {
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  for (auto _ : state) {
+    FilterChainManagerImpl filter_chain_manager{
+        std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+        init_manager_};
+    filter_chain_manager.addFilterChain(filter_chains_, dummy_builder_, filter_chain_manager);
+  }
+}
+
+BENCHMARK_DEFINE_F(FilterChainSniBenchmarkFixture, FilterChainFindTest)
+(::benchmark::State& state) {
+  std::vector<MockConnectionSocket> sockets;
+  sockets.reserve(state.range(0));
+  for (int i = 0; i < state.range(0); i++) {
+    sockets.push_back(std::move(*MockConnectionSocket::createMockConnectionSocket(
+        1234, "127.0.0.1", serverName(i), "tls", {}, "8.8.8.8", 111)));
+  }
+  NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  FilterChainManagerImpl filter_chain_manager{
+      std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 1234), factory_context,
+      init_manager_};
+
+  filter_chain_manager.addFilterChain(filter_chains_, dummy_builder_, filter_chain_manager);
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      filter_chain_manager.findFilterChain(sockets[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_REGISTER_F(FilterChainSniBenchmarkFixture, FilterChainManagerBuildTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 10000},
+    })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_REGISTER_F(FilterChainSniBenchmarkFixture, FilterChainFindTest)
+    ->Ranges({
+        // scale of the chains
+        {1, 10000},
+    });
+
 /*
 clang-format off
 
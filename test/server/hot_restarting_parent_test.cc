@@ -1,5 +1,7 @@
 #include <memory>
 
+#include "common/api/os_sys_calls_impl_hot_restart.h"
+
 #include "server/hot_restarting_child.h"
 #include "server/hot_restarting_parent.h"
 
@@ -20,6 +22,9 @@ using HotRestartMessage = envoy::HotRestartMessage;
 
 class HotRestartingParentTest : public testing::Test {
 public:
+  // The parent keeps the names of the gauges it exported, so the store must outlive it.
+  Stats::SymbolTableImpl symbol_table_;
+  Stats::TestUtil::TestStore store_{symbol_table_};
   NiceMock<MockInstance> server_;
   HotRestartingParent::Internal hot_restarting_parent_{&server_};
 };
@@ -62,18 +67,17 @@ TEST_F(HotRestartingParentTest, GetListenSocketsForChildNotBindPort) {
 }
 
 TEST_F(HotRestartingParentTest, ExportStatsToChild) {
-  Stats::TestUtil::TestStore store;
   MockListenerManager listener_manager;
   EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
   EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
-  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store_));
 
   {
-    store.counter("c1").inc();
-    store.counter("c2").add(2);
-    store.gauge("g0", Stats::Gauge::ImportMode::Accumulate).set(0);
-    store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
-    store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).set(456);
+    store_.counter("c1").inc();
+    store_.counter("c2").add(2);
+    store_.gauge("g0", Stats::Gauge::ImportMode::Accumulate).set(0);
+    store_.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+    store_.gauge("g2", Stats::Gauge::ImportMode::Accumulate).set(456);
     HotRestartMessage::Reply::Stats stats;
     hot_restarting_parent_.exportStatsToChild(&stats);
     EXPECT_EQ(1, stats.counter_deltas().at("c1"));
@@ -82,26 +86,27 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
     EXPECT_EQ(123, stats.gauges().at("g1"));
     EXPECT_EQ(456, stats.gauges().at("g2"));
   }
-  // When a counter has not changed since its last export, it should not be included in the message.
+  // When a counter or gauge has not changed since its last export, it should not be included in
+  // the message.
   {
-    store.counter("c2").add(2);
-    store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).add(1);
-    store.gauge("g2", Stats::Gauge::ImportMode::Accumulate).sub(1);
+    store_.counter("c2").add(2);
+    store_.gauge("g1", Stats::Gauge::ImportMode::Accumulate).add(1);
+    store_.gauge("g2", Stats::Gauge::ImportMode::Accumulate).sub(1);
     HotRestartMessage::Reply::Stats stats;
     hot_restarting_parent_.exportStatsToChild(&stats);
     EXPECT_EQ(stats.counter_deltas().end(), stats.counter_deltas().find("c1"));
     EXPECT_EQ(2, stats.counter_deltas().at("c2")); // 4 is the value, but 2 is the delta
-    EXPECT_EQ(0, stats.gauges().at("g0"));
+    EXPECT_EQ(stats.gauges().end(), stats.gauges().find("g0"));
     EXPECT_EQ(124, stats.gauges().at("g1"));
     EXPECT_EQ(455, stats.gauges().at("g2"));
   }
 
   // When a counter and gauge are not used, they should not be included in the message.
   {
-    store.counter("unused_counter");
-    store.counter("used_counter").inc();
-    store.gauge("unused_gauge", Stats::Gauge::ImportMode::Accumulate);
-    store.gauge("used_gauge", Stats::Gauge::ImportMode::Accumulate).add(1);
+    store_.counter("unused_counter");
+    store_.counter("used_counter").inc();
+    store_.gauge("unused_gauge", Stats::Gauge::ImportMode::Accumulate);
+    store_.gauge("used_gauge", Stats::Gauge::ImportMode::Accumulate).add(1);
     HotRestartMessage::Reply::Stats stats;
     hot_restarting_parent_.exportStatsToChild(&stats);
     EXPECT_EQ(stats.counter_deltas().end(), stats.counter_deltas().find("unused_counter"));
@@ -113,20 +118,18 @@ TEST_F(HotRestartingParentTest, ExportStatsToChild) {
 
 TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   MockListenerManager listener_manager;
-  Stats::SymbolTableImpl parent_symbol_table;
-  Stats::TestUtil::TestStore parent_store(parent_symbol_table);
 
   EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
   EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(0));
-  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(parent_store));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store_));
 
   HotRestartMessage::Reply::Stats stats_proto;
   {
-    Stats::StatNameDynamicPool dynamic(parent_store.symbolTable());
-    parent_store.counter("c1").inc();
-    parent_store.counterFromStatName(dynamic.add("c2")).inc();
-    parent_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
-    parent_store.gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate).set(42);
+    Stats::StatNameDynamicPool dynamic(store_.symbolTable());
+    store_.counter("c1").inc();
+    store_.counterFromStatName(dynamic.add("c2")).inc();
+    store_.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+    store_.gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate).set(42);
     hot_restarting_parent_.exportStatsToChild(&stats_proto);
   }
 
@@ -149,6 +152,90 @@ TEST_F(HotRestartingParentTest, RetainDynamicStats) {
   }
 }
 
+TEST_F(HotRestartingParentTest, ExportStatsSnapshotToChild) {
+  MockListenerManager listener_manager;
+  EXPECT_CALL(server_, listenerManager()).WillRepeatedly(ReturnRef(listener_manager));
+  EXPECT_CALL(listener_manager, numConnections()).WillRepeatedly(Return(7));
+  EXPECT_CALL(server_, stats()).WillRepeatedly(ReturnRef(store_));
+  const std::string region_name = fmt::format("/envoy_test_stats_shared_memory_{}", getpid());
+
+  Stats::StatNameDynamicPool dynamic(store_.symbolTable());
+  store_.counter("c1").inc();
+  store_.counterFromStatName(dynamic.add("c2")).add(2);
+  store_.counter("unused_counter");
+  store_.gauge("g1", Stats::Gauge::ImportMode::Accumulate).set(123);
+  store_.gaugeFromStatName(dynamic.add("g2"), Stats::Gauge::ImportMode::Accumulate).set(42);
+  HotRestartMessage::Reply::Stats stats_proto;
+  EXPECT_TRUE(hot_restarting_parent_.exportStatsSnapshotToChild(region_name, &stats_proto));
+  EXPECT_EQ(region_name, stats_proto.snapshot_name());
+  EXPECT_LT(0U, stats_proto.snapshot_size());
+  EXPECT_EQ(7, stats_proto.num_connections());
+  EXPECT_TRUE(stats_proto.counter_deltas().empty());
+  EXPECT_TRUE(stats_proto.gauges().empty());
+
+  // Only the first export to a child goes through shared memory.
+  HotRestartMessage::Reply::Stats delta_proto;
+  EXPECT_FALSE(hot_restarting_parent_.exportStatsSnapshotToChild(region_name, &delta_proto));
+  store_.counter("c1").inc();
+  store_.gauge("g1", Stats::Gauge::ImportMode::Accumulate).add(1);
+  hot_restarting_parent_.exportStatsToChild(&delta_proto);
+  EXPECT_EQ(1, delta_proto.counter_deltas().at("c1"));
+  EXPECT_EQ(delta_proto.counter_deltas().end(), delta_proto.counter_deltas().find("c2"));
+  EXPECT_EQ(124, delta_proto.gauges().at("g1"));
+  EXPECT_EQ(delta_proto.gauges().end(), delta_proto.gauges().find("g2"));
+
+  {
+    Stats::SymbolTableImpl child_symbol_table;
+    Stats::TestUtil::TestStore child_store(child_symbol_table);
+    Stats::StatNameDynamicPool child_dynamic(child_store.symbolTable());
+    Stats::Counter& c1 = child_store.counter("c1");
+    Stats::Counter& c2 = child_store.counterFromStatName(child_dynamic.add("c2"));
+    Stats::Gauge& g1 = child_store.gauge("g1", Stats::Gauge::ImportMode::Accumulate);
+    Stats::Gauge& g2 =
+        child_store.gaugeFromStatName(child_dynamic.add("g2"),
+                                      Stats::Gauge::ImportMode::Accumulate);
+
+    HotRestartingChild hot_restarting_child(1, 0);
+    hot_restarting_child.mergeParentStats(child_store, stats_proto);
+    EXPECT_EQ(1, c1.value());
+    EXPECT_EQ(2, c2.value());
+    EXPECT_EQ(123, g1.value());
+    EXPECT_EQ(42, g2.value());
+
+    hot_restarting_child.mergeParentStats(child_store, delta_proto);
+    EXPECT_EQ(2, c1.value());
+    EXPECT_EQ(2, c2.value());
+    EXPECT_EQ(124, g1.value());
+    EXPECT_EQ(42, g2.value());
+  }
+
+  // The child unlinked the region once it opened it.
+  Api::HotRestartOsSysCalls& hot_restart_os_sys_calls = Api::HotRestartOsSysCallsSingleton::get();
+  EXPECT_EQ(-1, hot_restart_os_sys_calls.shmOpen(region_name.c_str(), O_RDONLY, 0).rc_);
+
+  // A new child starts over with a snapshot.
+  EXPECT_CALL(server_, shutdownAdmin());
+  hot_restarting_parent_.shutdownAdmin();
+  HotRestartMessage::Reply::Stats new_child_proto;
+  EXPECT_TRUE(hot_restarting_parent_.exportStatsSnapshotToChild(region_name, &new_child_proto));
+  hot_restart_os_sys_calls.shmUnlink(region_name.c_str());
+}
+
+// A snapshot the child cannot open is not fatal, the child starts with fresh stats.
+TEST_F(HotRestartingParentTest, MissingStatsSnapshot) {
+  HotRestartMessage::Reply::Stats stats_proto;
+  stats_proto.set_snapshot_name(
+      fmt::format("/envoy_test_missing_stats_shared_memory_{}", getpid()));
+  stats_proto.set_snapshot_size(64);
+
+  Stats::SymbolTableImpl child_symbol_table;
+  Stats::TestUtil::TestStore child_store(child_symbol_table);
+  Stats::Counter& c1 = child_store.counter("c1");
+  HotRestartingChild hot_restarting_child(1, 0);
+  hot_restarting_child.mergeParentStats(child_store, stats_proto);
+  EXPECT_EQ(0, c1.value());
+}
+
 TEST_F(HotRestartingParentTest, DrainListeners) {
   EXPECT_CALL(server_, drainListeners());
   hot_restarting_parent_.drainListeners();
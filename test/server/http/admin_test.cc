@@ -17,6 +17,7 @@
 #include "common/http/message_impl.h"
 #include "common/json/json_loader.h"
 #include "common/profiler/profiler.h"
+#include "common/profiler/sampling_profiler.h"
 #include "common/protobuf/protobuf.h"
 #include "common/protobuf/utility.h"
 #include "common/stats/symbol_table_creator.h"
@@ -614,6 +615,41 @@ TEST_P(AdminInstanceTest, AdminCpuProfiler) {
   EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
 }
 
+TEST_P(AdminInstanceTest, AdminSamplingCpuProfiler) {
+  Buffer::OwnedImpl data;
+  Http::ResponseHeaderMapImpl header_map;
+
+#ifdef SAMPLING_PROFILER_AVAILABLE
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler/sampling", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=0", header_map, data));
+  EXPECT_EQ(Http::Code::BadRequest,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=1001", header_map, data));
+  EXPECT_FALSE(Profiler::SamplingCpu::isRunning());
+
+  EXPECT_EQ(Http::Code::OK,
+            postCallback("/cpuprofiler/sampling?enable=y&frequency=1000", header_map, data));
+  EXPECT_TRUE(Profiler::SamplingCpu::isRunning());
+  // Both profilers are driven by SIGPROF, so only one can run at a time.
+  EXPECT_EQ(Http::Code::BadRequest, postCallback("/cpuprofiler?enable=y", header_map, data));
+  EXPECT_FALSE(Profiler::Cpu::profilerEnabled());
+
+  EXPECT_EQ(Http::Code::BadRequest,
+            getCallback("/cpuprofiler/collapsed?seconds=x", header_map, data));
+  EXPECT_EQ(Http::Code::OK,
+            getCallback("/cpuprofiler/collapsed?seconds=10&per_thread=y", header_map, data));
+  EXPECT_EQ(Http::Headers::get().ContentTypeValues.Text,
+            header_map.ContentType()->value().getStringView());
+
+  EXPECT_EQ(Http::Code::OK, postCallback("/cpuprofiler/sampling?enable=n", header_map, data));
+  EXPECT_FALSE(Profiler::SamplingCpu::isRunning());
+#else
+  EXPECT_EQ(Http::Code::NotImplemented,
+            postCallback("/cpuprofiler/sampling?enable=y", header_map, data));
+  EXPECT_EQ(Http::Code::NotImplemented, getCallback("/cpuprofiler/collapsed", header_map, data));
+#endif
+}
+
 TEST_P(AdminInstanceTest, AdminHeapProfilerOnRepeatedRequest) {
   Buffer::OwnedImpl data;
   Http::ResponseHeaderMapImpl header_map;
@@ -1987,5 +2023,43 @@ envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 0
   EXPECT_EQ(expected_output, response.toString());
 }
 
+TEST_F(PrometheusStatsFormatterTest, OutputWithNameCache) {
+  addCounter("cluster.test_1.upstream_cx_total",
+             {{makeStat("a.tag-name"), makeStat("a.tag-value")}});
+  addGauge("cluster.test_2.upstream_cx_total",
+           {{makeStat("another_tag_name"), makeStat("another_tag-value")}});
+  counters_[0]->add(3);
+  gauges_[0]->set(4);
+
+  const std::string expected_output = R"EOF(# TYPE envoy_cluster_test_1_upstream_cx_total counter
+envoy_cluster_test_1_upstream_cx_total{a_tag_name="a.tag-value"} 3
+# TYPE envoy_cluster_test_2_upstream_cx_total gauge
+envoy_cluster_test_2_upstream_cx_total{another_tag_name="another_tag-value"} 4
+)EOF";
+
+  PrometheusStatsFormatter::NameCache cache;
+  for (int i = 0; i < 2; ++i) {
+    Buffer::OwnedImpl response;
+    EXPECT_EQ(2UL, PrometheusStatsFormatter::statsAsPrometheus(
+                       counters_, gauges_, histograms_, response, false, absl::nullopt, cache));
+    EXPECT_EQ(expected_output, response.toString());
+  }
+
+  // The names of the gauge stay cached until a scrape of all stats no longer includes it.
+  gauges_.clear();
+  const uint64_t cached_symbols = symbol_table_->numSymbols();
+  {
+    Buffer::OwnedImpl response;
+    PrometheusStatsFormatter::statsAsPrometheus(
+        counters_, gauges_, histograms_, response, false,
+        absl::optional<std::regex>{std::regex("cluster.test_1.upstream_cx_total")}, cache);
+    EXPECT_EQ(cached_symbols, symbol_table_->numSymbols());
+  }
+  Buffer::OwnedImpl response;
+  PrometheusStatsFormatter::statsAsPrometheus(counters_, gauges_, histograms_, response, false,
+                                              absl::nullopt, cache);
+  EXPECT_GT(cached_symbols, symbol_table_->numSymbols());
+}
+
 } // namespace Server
 } // namespace Envoy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/buffer/buffer_impl.h"
+#include "common/stats/allocator_impl.h"
+#include "common/stats/symbol_table_creator.h"
+#include "common/stats/symbol_table_impl.h"
+
+#include "server/http/admin.h"
+
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+// Counters per cluster, each cluster tags its counters with its name.
+inline constexpr uint32_t CountersPerCluster = 100;
+
+class PrometheusStats {
+public:
+  PrometheusStats(uint32_t num_counters)
+      : symbol_table_(Stats::SymbolTableCreator::makeSymbolTable()), alloc_(*symbol_table_),
+        pool_(*symbol_table_) {
+    const Stats::StatName cluster_name_tag = pool_.add("envoy.cluster_name");
+    counters_.reserve(num_counters);
+    for (uint32_t i = 0; i < num_counters; ++i) {
+      const std::string cluster = absl::StrCat("cluster_", i / CountersPerCluster);
+      const std::string counter = absl::StrCat("upstream_rq_", i % CountersPerCluster);
+      const Stats::StatName name = pool_.add(absl::StrCat("cluster.", cluster, ".", counter));
+      const Stats::StatName tag_extracted_name = pool_.add(absl::StrCat("cluster.", counter));
+      counters_.push_back(alloc_.makeCounter(name, tag_extracted_name,
+                                             {{cluster_name_tag, pool_.add(cluster)}}));
+      counters_.back()->add(i);
+    }
+  }
+
+  ~PrometheusStats() {
+    // The cache holds symbols of the table, so it must go before the table does.
+    cache_.reset();
+    counters_.clear();
+    pool_.clear();
+  }
+
+  uint64_t scrape(bool cached) {
+    Buffer::OwnedImpl response;
+    if (cached) {
+      PrometheusStatsFormatter::statsAsPrometheus(counters_, {}, {}, response, false,
+                                                  absl::nullopt, *cache_);
+    } else {
+      PrometheusStatsFormatter::statsAsPrometheus(counters_, {}, {}, response, false,
+                                                  absl::nullopt);
+    }
+    return response.length();
+  }
+
+private:
+  Stats::SymbolTablePtr symbol_table_;
+  Stats::AllocatorImpl alloc_;
+  Stats::StatNamePool pool_;
+  std::vector<Stats::CounterSharedPtr> counters_;
+  std::unique_ptr<PrometheusStatsFormatter::NameCache> cache_{
+      std::make_unique<PrometheusStatsFormatter::NameCache>()};
+};
+
+// Args: number of counters, whether the rendered names are cached across scrapes.
+inline void prometheusScrapeBenchmark(benchmark::State& state) {
+  PrometheusStats stats(state.range(0));
+  const bool cached = state.range(1) != 0;
+  uint64_t bytes = 0;
+  for (auto _ : state) {
+    bytes += stats.scrape(cached);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+} // namespace Server
+} // namespace Envoy
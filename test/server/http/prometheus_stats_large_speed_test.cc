@@ -0,0 +1,22 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the latency of a /stats/prometheus scrape over a million tagged counters. Creating and
+// scraping that many counters takes too long to run as part of the tests, so unlike
+// prometheus_stats_speed_test this benchmark has no test target and is only run by hand.
+
+#include "test/server/http/prometheus_stats_benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+static void BM_PrometheusScrapeLarge(benchmark::State& state) {
+  prometheusScrapeBenchmark(state);
+}
+BENCHMARK(BM_PrometheusScrapeLarge)
+    ->Args({1000000, 0})
+    ->Args({1000000, 1})
+    ->Unit(benchmark::kMillisecond);
+
+} // namespace Server
+} // namespace Envoy
@@ -0,0 +1,17 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+//
+// Measures the latency of a /stats/prometheus scrape over a large number of tagged counters, the
+// way a server with many clusters exposes them. See prometheus_stats_large_speed_test.cc for a
+// million counters.
+
+#include "test/server/http/prometheus_stats_benchmark.h"
+
+namespace Envoy {
+namespace Server {
+
+static void BM_PrometheusScrape(benchmark::State& state) { prometheusScrapeBenchmark(state); }
+BENCHMARK(BM_PrometheusScrape)->Args({1000, 0})->Args({1000, 1})->Unit(benchmark::kMillisecond);
+
+} // namespace Server
+} // namespace Envoy
@@ -1,5 +1,9 @@
 #include "test/server/listener_manager_impl_test.h"
 
+#if defined(__linux__)
+#include <linux/bpf.h>
+#endif
+
 #include <chrono>
 #include <memory>
 #include <string>
@@ -30,6 +34,7 @@
 #include "test/server/utility.h"
 #include "test/test_common/network_utility.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/strings/escaping.h"
@@ -1489,7 +1494,7 @@ filter_chains:
     config: {}
   )EOF";
 
-  ListenerHandle* listener_foo_update1 = expectListenerCreate(true, true);
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(true);
   EXPECT_CALL(listener_foo_update1->target_, initialize());
   EXPECT_TRUE(
       manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
@@ -1512,6 +1517,144 @@ filter_chains:
   checkStats(2, 1, 2, 0, 0, 0);
 }
 
+// Validates that an update which only changes filter chains is executed in place, and that only the
+// removed filter chains are drained.
+TEST_F(ListenerManagerImplTest, InPlaceFilterChainUpdate) {
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+  ON_CALL(server_.options_, drainTime()).WillByDefault(Return(std::chrono::seconds(600)));
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false, true);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true}));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 0, 0, 0, 1, 0);
+  const uint64_t listener_tag = manager_->listeners().front().get().listenerTag();
+
+  // Replace the filter chain. The new listener reuses the socket, the tag and the drain manager of
+  // the active listener, and the workers swap it in without draining the listener.
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters:
+  - name: fake
+    config: {}
+  )EOF";
+
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(false, listener_foo);
+  EXPECT_CALL(*worker_, updateListener(_, _));
+  auto* filter_chain_drain_timer = new Event::MockTimer(&server_.dispatcher_);
+  EXPECT_CALL(*filter_chain_drain_timer, enableTimer(std::chrono::milliseconds(600000), _));
+  EXPECT_TRUE(
+      manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
+  EXPECT_EQ(1UL, manager_->listeners().size());
+  EXPECT_EQ(listener_tag, manager_->listeners().front().get().listenerTag());
+  checkStats(1, 1, 0, 0, 1, 0);
+  EXPECT_EQ(1, server_.stats_store_.counterFromString("listener_manager.listener_in_place_updated")
+                   .value());
+  EXPECT_EQ(1, server_.stats_store_
+                   .gauge("listener_manager.total_filter_chains_draining",
+                          Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+
+  // Only the removed filter chain drains.
+  EXPECT_TRUE(listener_foo->context_->drainDecision().drainClose());
+  EXPECT_CALL(*listener_foo->drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_CALL(server_.drain_manager_, drainClose()).WillOnce(Return(false));
+  EXPECT_FALSE(listener_foo_update1->context_->drainDecision().drainClose());
+
+  // Once the drain time is over the workers close the remaining connections of the removed filter
+  // chain, and the previous listener is destroyed along with it.
+  EXPECT_CALL(*worker_, removeFilterChains(listener_tag, _, _));
+  filter_chain_drain_timer->invokeCallback();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callRemoveFilterChainsCompletion();
+  EXPECT_EQ(0, server_.stats_store_
+                   .gauge("listener_manager.total_filter_chains_draining",
+                          Stats::Gauge::ImportMode::NeverImport)
+                   .value());
+  checkStats(1, 1, 0, 0, 1, 0);
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
+// Validates that the in place filter chain update can be disabled by runtime.
+TEST_F(ListenerManagerImplTest, InPlaceFilterChainUpdateDisabledByRuntime) {
+  TestScopedRuntime scoped_runtime;
+  Runtime::LoaderSingleton::getExisting()->mergeValues(
+      {{"envoy.reloadable_features.listener_in_place_filterchain_update", "false"}});
+
+  InSequence s;
+
+  EXPECT_CALL(*worker_, start(_));
+  manager_->startWorkers(guard_dog_);
+
+  const std::string listener_foo_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters: []
+  )EOF";
+
+  ListenerHandle* listener_foo = expectListenerCreate(false, true);
+  EXPECT_CALL(listener_factory_, createListenSocket(_, _, _, {true}));
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_TRUE(manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_yaml), "", true));
+  worker_->callAddCompletion(true);
+
+  const std::string listener_foo_update1_yaml = R"EOF(
+name: foo
+address:
+  socket_address:
+    address: 127.0.0.1
+    port_value: 1234
+filter_chains:
+- filters:
+  - name: fake
+    config: {}
+  )EOF";
+
+  // The whole listener is replaced and drained.
+  ListenerHandle* listener_foo_update1 = expectListenerCreate(false, true);
+  EXPECT_CALL(*worker_, addListener(_, _));
+  EXPECT_CALL(*worker_, stopListener(_, _));
+  EXPECT_CALL(*listener_foo->drain_manager_, startDrainSequence(_));
+  EXPECT_TRUE(
+      manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
+  worker_->callAddCompletion(true);
+  checkStats(1, 1, 0, 0, 1, 1);
+  EXPECT_EQ(0, server_.stats_store_.counterFromString("listener_manager.listener_in_place_updated")
+                   .value());
+
+  EXPECT_CALL(*worker_, removeListener(_, _));
+  listener_foo->drain_manager_->drain_sequence_completion_();
+  EXPECT_CALL(*listener_foo, onDestroy());
+  worker_->callRemovalCompletion();
+  checkStats(1, 1, 0, 0, 1, 0);
+
+  EXPECT_CALL(*listener_foo_update1, onDestroy());
+}
+
 // Validates that StopListener functionality works correctly when only inbound listeners are
 // stopped.
 TEST_F(ListenerManagerImplTest, StopListeners) {
@@ -1700,7 +1843,7 @@ filter_chains:
     config: {}
   )EOF";
 
-  ListenerHandle* listener_foo_update1 = expectListenerCreate(true, true);
+  ListenerHandle* listener_foo_update1 = expectListenerOverridden(true);
   EXPECT_CALL(listener_foo_update1->target_, initialize());
   EXPECT_TRUE(
       manager_->addOrUpdateListener(parseListenerFromV2Yaml(listener_foo_update1_yaml), "", true));
@@ -3576,6 +3719,73 @@ TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerEnabledForTcp) {
                    /* expected_creation_params */ {true, false});
 }
 
+#if defined(SO_ATTACH_REUSEPORT_EBPF) && defined(__linux__)
+// Validate that reuse_port_steering loads a program with a map that has a slot for every worker
+// socket. The program is only attached once the sockets listen on the workers.
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortSteeringListenerEnabled) {
+  auto listener = createIPv4Listener("ReusePortSteeringListener");
+  listener.set_reuse_port(true);
+  listener.set_reuse_port_steering(envoy::config::listener::v3::Listener::CPU);
+  listener.mutable_address()->mutable_socket_address()->set_port_value(0);
+
+  NiceMock<Api::MockLinuxOsSysCalls> linux_os_sys_calls;
+  TestThreadsafeSingletonInjector<Api::LinuxOsSysCallsImpl> linux_os_calls(&linux_os_sys_calls);
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_MAP_CREATE, _, _))
+      .WillOnce(Invoke([](int, bpf_attr* attr, unsigned int) -> Api::SysCallIntResult {
+        EXPECT_EQ(BPF_MAP_TYPE_REUSEPORT_SOCKARRAY, attr->map_type);
+        EXPECT_EQ(4U, attr->max_entries);
+        return {100, 0};
+      }));
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_PROG_LOAD, _, _))
+      .WillOnce(Return(Api::SysCallIntResult{101, 0}));
+  EXPECT_CALL(linux_os_sys_calls, bpf(BPF_MAP_UPDATE_ELEM, _, _)).Times(0);
+
+  expectCreateListenSocket(envoy::config::core::v3::SocketOption::STATE_PREBIND,
+                           /* expected_num_options */ 2,
+                           /* expected_creation_params */ {true, false});
+  expectSetsockopt(os_sys_calls_,
+                   /* expected_sockopt_level */ SOL_SOCKET,
+                   /* expected_sockopt_name */ SO_REUSEPORT,
+                   /* expected_value */ 1);
+  EXPECT_CALL(os_sys_calls_, setsockopt_(_, SOL_SOCKET, SO_ATTACH_REUSEPORT_EBPF, _, _)).Times(0);
+
+  server_.options_.concurrency_ = 4;
+  manager_->addOrUpdateListener(listener, "", true);
+  EXPECT_EQ(1U, manager_->listeners().size());
+}
+#endif
+
+// With a single worker there is nothing to steer, so no program is attached.
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortSteeringSingleWorker) {
+  auto listener = createIPv4Listener("ReusePortSteeringListener");
+  listener.set_reuse_port(true);
+  listener.set_reuse_port_steering(envoy::config::listener::v3::Listener::SOURCE_IP);
+  listener.mutable_address()->mutable_socket_address()->set_port_value(0);
+  testSocketOption(listener, envoy::config::core::v3::SocketOption::STATE_PREBIND,
+                   ENVOY_SOCKET_SO_REUSEPORT, /* expected_value */ 1,
+                   /* expected_num_options */ 1,
+                   /* expected_creation_params */ {true, false});
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortSteeringUdpListener) {
+  auto listener = createIPv4Listener("UdpListener");
+  listener.mutable_address()->mutable_socket_address()->set_protocol(
+      envoy::config::core::v3::SocketAddress::UDP);
+  listener.set_reuse_port(true);
+  listener.set_reuse_port_steering(envoy::config::listener::v3::Listener::CPU);
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1111': reuse_port_steering is only "
+                            "supported for TCP listeners");
+}
+
+TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortSteeringWithoutReusePort) {
+  auto listener = createIPv4Listener("ReusePortSteeringListener");
+  listener.set_reuse_port_steering(envoy::config::listener::v3::Listener::SOURCE_IP);
+  EXPECT_THROW_WITH_MESSAGE(manager_->addOrUpdateListener(listener, "", true), EnvoyException,
+                            "error adding listener '127.0.0.1:1111': reuse_port_steering requires "
+                            "reuse_port");
+}
+
 TEST_F(ListenerManagerImplWithRealFiltersTest, ReusePortListenerDisabled) {
 
   auto listener = createIPv4Listener("UdpListener");
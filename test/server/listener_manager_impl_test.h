@@ -133,6 +133,36 @@ protected:
     return raw_listener;
   }
 
+  /**
+   * Create a listener which is updated in place from an active listener. It shares the drain
+   * manager of the active listener, and only creates network filters for new filter chains.
+   */
+  ListenerHandle* expectListenerOverridden(bool need_init, ListenerHandle* origin = nullptr) {
+    auto raw_listener = new ListenerHandle(false);
+    // Simulate ListenerImpl: drain manager is copied from origin.
+    if (origin != nullptr) {
+      raw_listener->drain_manager_ = origin->drain_manager_;
+    }
+    // Overridden listener is always added by api.
+    EXPECT_CALL(server_.validation_context_, staticValidationVisitor()).Times(0);
+    EXPECT_CALL(server_.validation_context_, dynamicValidationVisitor());
+
+    EXPECT_CALL(listener_factory_, createNetworkFilterFactoryList(_, _))
+        .WillOnce(Invoke(
+            [raw_listener, need_init](
+                const Protobuf::RepeatedPtrField<envoy::config::listener::v3::Filter>&,
+                Server::Configuration::FilterChainFactoryContext& filter_chain_factory_context)
+                -> std::vector<Network::FilterFactoryCb> {
+              std::shared_ptr<ListenerHandle> notifier(raw_listener);
+              raw_listener->context_ = &filter_chain_factory_context;
+              if (need_init) {
+                filter_chain_factory_context.initManager().add(notifier->target_);
+              }
+              return {[notifier](Network::FilterManager&) -> void {}};
+            }));
+    return raw_listener;
+  }
+
   const Network::FilterChain*
   findFilterChain(uint16_t destination_port, const std::string& destination_address,
                   const std::string& server_name, const std::string& transport_protocol,
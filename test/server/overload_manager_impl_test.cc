@@ -156,7 +156,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   int cb_count = 0;
   manager->registerForAction("envoy.overload_actions.dummy_action", dispatcher_,
                              [&](OverloadActionState state) {
-                               is_active = state == OverloadActionState::Active;
+                               is_active = state == OverloadActionState::saturated();
                                cb_count++;
                              });
   manager->registerForAction("envoy.overload_actions.unknown_action", dispatcher_,
@@ -177,7 +177,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.5);
   timer_cb_();
   EXPECT_FALSE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Inactive);
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
   EXPECT_EQ(0, cb_count);
   EXPECT_EQ(0, active_gauge.value());
   EXPECT_EQ(50, pressure_gauge1.value());
@@ -185,7 +185,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.95);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(1, active_gauge.value());
   EXPECT_EQ(95, pressure_gauge1.value());
@@ -194,7 +194,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory1_.monitor_->setPressure(0.94);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(94, pressure_gauge1.value());
 
@@ -203,7 +203,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory2_.monitor_->setPressure(0.9);
   timer_cb_();
   EXPECT_TRUE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Active);
+  EXPECT_EQ(action_state, OverloadActionState::saturated());
   EXPECT_EQ(1, cb_count);
   EXPECT_EQ(50, pressure_gauge1.value());
   EXPECT_EQ(90, pressure_gauge2.value());
@@ -211,7 +211,7 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   factory2_.monitor_->setPressure(0.4);
   timer_cb_();
   EXPECT_FALSE(is_active);
-  EXPECT_EQ(action_state, OverloadActionState::Inactive);
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
   EXPECT_EQ(2, cb_count);
   EXPECT_EQ(0, active_gauge.value());
   EXPECT_EQ(40, pressure_gauge2.value());
@@ -219,6 +219,105 @@ TEST_F(OverloadManagerImplTest, CallbackOnlyFiresWhenStateChanges) {
   manager->stop();
 }
 
+TEST_F(OverloadManagerImplTest, ScaledTrigger) {
+  setDispatcherExpectation();
+
+  const std::string config = R"EOF(
+    resource_monitors {
+      name: "envoy.resource_monitors.fake_resource1"
+    }
+    resource_monitors {
+      name: "envoy.resource_monitors.fake_resource2"
+    }
+    actions {
+      name: "envoy.overload_actions.dummy_action"
+      triggers {
+        name: "envoy.resource_monitors.fake_resource1"
+        scaled {
+          scaling_threshold: 0.5
+          saturation_threshold: 0.9
+        }
+      }
+      triggers {
+        name: "envoy.resource_monitors.fake_resource2"
+        threshold {
+          value: 0.95
+        }
+      }
+    }
+  )EOF";
+
+  auto manager(createOverloadManager(config));
+  std::vector<double> values;
+  manager->registerForAction("envoy.overload_actions.dummy_action", dispatcher_,
+                             [&](OverloadActionState state) { values.push_back(state.value()); });
+  manager->start();
+
+  Stats::Gauge& active_gauge = stats_.gauge("overload.envoy.overload_actions.dummy_action.active",
+                                            Stats::Gauge::ImportMode::Accumulate);
+  Stats::Gauge& scale_percent_gauge =
+      stats_.gauge("overload.envoy.overload_actions.dummy_action.scale_percent",
+                   Stats::Gauge::ImportMode::Accumulate);
+  const OverloadActionState& action_state =
+      manager->getThreadLocalOverloadState().getState("envoy.overload_actions.dummy_action");
+
+  factory1_.monitor_->setPressure(0.4);
+  timer_cb_();
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
+  EXPECT_TRUE(values.empty());
+
+  factory1_.monitor_->setPressure(0.6);
+  timer_cb_();
+  EXPECT_DOUBLE_EQ(0.25, action_state.value());
+  ASSERT_EQ(1U, values.size());
+  EXPECT_DOUBLE_EQ(0.25, values.back());
+  EXPECT_EQ(0, active_gauge.value());
+  EXPECT_EQ(25, scale_percent_gauge.value());
+
+  // A fired threshold trigger saturates the action regardless of the scaled trigger.
+  factory2_.monitor_->setPressure(0.96);
+  timer_cb_();
+  EXPECT_TRUE(action_state.isSaturated());
+  EXPECT_EQ(2U, values.size());
+  EXPECT_EQ(1, active_gauge.value());
+  EXPECT_EQ(100, scale_percent_gauge.value());
+
+  factory2_.monitor_->setPressure(0.1);
+  factory1_.monitor_->setPressure(0.95);
+  timer_cb_();
+  EXPECT_TRUE(action_state.isSaturated());
+
+  factory1_.monitor_->setPressure(0.3);
+  timer_cb_();
+  EXPECT_EQ(action_state, OverloadActionState::inactive());
+  EXPECT_EQ(0, values.back());
+  EXPECT_EQ(0, active_gauge.value());
+  EXPECT_EQ(0, scale_percent_gauge.value());
+
+  manager->stop();
+}
+
+TEST_F(OverloadManagerImplTest, ScaledTriggerThresholdsOutOfOrder) {
+  const std::string config = R"EOF(
+    resource_monitors {
+      name: "envoy.resource_monitors.fake_resource1"
+    }
+    actions {
+      name: "envoy.overload_actions.dummy_action"
+      triggers {
+        name: "envoy.resource_monitors.fake_resource1"
+        scaled {
+          scaling_threshold: 0.9
+          saturation_threshold: 0.8
+        }
+      }
+    }
+  )EOF";
+
+  EXPECT_THROW_WITH_MESSAGE(createOverloadManager(config), EnvoyException,
+                            "scaling_threshold must be less than saturation_threshold");
+}
+
 TEST_F(OverloadManagerImplTest, FailedUpdates) {
   setDispatcherExpectation();
   auto manager(createOverloadManager(getConfig()));
@@ -129,6 +129,33 @@ TEST_F(WorkerImplTest, BasicFlow) {
   });
   ci.waitReady();
 
+  // Updating a listener in place and removing its filter chains also happen on the worker thread.
+  NiceMock<Network::MockListenerConfig> listener3_update;
+  ON_CALL(listener3_update, listenerTag()).WillByDefault(Return(3UL));
+  EXPECT_CALL(*handler_, updateListener(_))
+      .WillOnce(Invoke([current_thread_id](Network::ListenerConfig& config) -> void {
+        EXPECT_EQ(config.listenerTag(), 3UL);
+        EXPECT_NE(current_thread_id, std::this_thread::get_id());
+      }));
+  worker_.updateListener(listener3_update, [current_thread_id, &ci]() -> void {
+    EXPECT_NE(current_thread_id, std::this_thread::get_id());
+    ci.setReady();
+  });
+  ci.waitReady();
+
+  EXPECT_CALL(*handler_, removeFilterChains(3, _, _))
+      .WillOnce(Invoke([current_thread_id](uint64_t,
+                                           const std::list<const Network::FilterChain*>&,
+                                           std::function<void()> completion) -> void {
+        EXPECT_NE(current_thread_id, std::this_thread::get_id());
+        completion();
+      }));
+  worker_.removeFilterChains(3, {}, [current_thread_id, &ci]() -> void {
+    EXPECT_NE(current_thread_id, std::this_thread::get_id());
+    ci.setReady();
+  });
+  ci.waitReady();
+
   EXPECT_CALL(*handler_, removeListeners(3))
       .WillOnce(InvokeWithoutArgs([current_thread_id]() -> void {
         EXPECT_NE(current_thread_id, std::this_thread::get_id());
@@ -0,0 +1,53 @@
+/**
+ * Utility to convert a binary access log, written by the file access logger with binary_format,
+ * into one JSON object per line.
+ *
+ * Usage:
+ *
+ * access_log_reader <binary access log path>
+ */
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include "envoy/data/accesslog/v3/accesslog.pb.h"
+
+#include "common/protobuf/protobuf.h"
+#include "common/protobuf/utility.h"
+
+// NOLINT(namespace-envoy)
+int main(int argc, char** argv) {
+  if (argc != 2) {
+    std::cerr << "Usage: " << argv[0] << " <binary access log path>" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream log_file(argv[1], std::ios::binary);
+  if (!log_file) {
+    std::cerr << "Unable to open " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  Envoy::Protobuf::io::IstreamInputStream input_stream(&log_file);
+  uint64_t entries = 0;
+  while (true) {
+    // Use a fresh CodedInputStream per entry so that its total bytes limit is never reached on
+    // large logs.
+    Envoy::Protobuf::io::CodedInputStream coded_stream(&input_stream);
+    uint32_t entry_size;
+    if (!coded_stream.ReadVarint32(&entry_size)) {
+      break;
+    }
+    const auto limit = coded_stream.PushLimit(entry_size);
+    envoy::data::accesslog::v3::HTTPAccessLogEntry entry;
+    if (!entry.ParseFromCodedStream(&coded_stream) || !coded_stream.ConsumedEntireMessage()) {
+      // A partially written trailing entry is expected if the log is read while being written.
+      std::cerr << "Truncated or corrupt entry after " << entries << " entries" << std::endl;
+      return EXIT_FAILURE;
+    }
+    coded_stream.PopLimit(limit);
+    std::cout << Envoy::MessageUtil::getJsonStringFromMessage(entry, false, true) << "\n";
+    ++entries;
+  }
+  return EXIT_SUCCESS;
+}